@@ -0,0 +1,33 @@
+# Times KOMONDOR on every validation scenario (nodes x system file) and prints the wall time of each
+# run in seconds. Run it from the input folder before and after a change to compare the simulation speed.
+# The per-notification model handlers are benchmarked in isolation by tests/bench_model_dispatch.
+
+# define execution parameters
+SIM_TIME=100
+SEED=1
+REPETITIONS=3
+
+# compile KOMONDOR
+cd ..
+cd main
+./build_local
+mkdir -p ../output
+
+echo 'scenario;system;repetition;wall_time_s'
+for scenarios in basic_scenarios complex_scenarios
+do
+	for nodes_file in ../input/validation/$scenarios/nodes/*
+	do
+		for system_file in ../input/validation/$scenarios/system/*
+		do
+			for (( repetition=0; repetition < REPETITIONS; repetition++))
+			do
+				start=$(date +%s.%N)
+				./komondor_main $system_file $nodes_file ../output/script_output_benchmark.txt benchmark.csv 0 0 0 0 $SIM_TIME $SEED > /dev/null
+				end=$(date +%s.%N)
+				echo "$(basename $nodes_file);$(basename $system_file);$repetition;$(echo "$end - $start" | bc)"
+			done
+		done
+	done
+done
+rm -f ../output/script_output_benchmark.txt
@@ -104,10 +104,10 @@ class GraphColoring {
 			GraphColoringOptimization(configuration_array);
 
 			if(save_controller_logs) {
-				fprintf(central_controller_logger.file, "%.15f;%s;CC;%s GraphColoring: "
+				LogPrintf(central_controller_logger, "%.15f;%s;CC;%s GraphColoring: "
 					"New configurations provided\n", sim_time, LOG_C00, LOG_LVL2);
 				for (int i = 0; i < agents_number; ++ i) {
-					fprintf(central_controller_logger.file, "%.15f;%s;CC;%s Agent %d - Assigned channel %d\n",
+					LogPrintf(central_controller_logger, "%.15f;%s;CC;%s Agent %d - Assigned channel %d\n",
 					sim_time, LOG_C00, LOG_LVL3, i,	configuration_array[i].selected_primary_channel);
 				}
 			}
@@ -50,8 +50,8 @@
 #include "../list_of_macros.h"
 #include "../structures/node_configuration.h"
 #include "../structures/performance_metrics.h"
-#include "/graph_coloring/graph_coloring.h"
-#include "/multi_armed_bandits/multi_armed_bandits.h"
+#include "graph_coloring/graph_coloring.h"
+#include "multi_armed_bandits/multi_armed_bandits.h"
 
 #ifndef _AUX_ML_METHOD_
 #define _AUX_ML_METHOD_
@@ -195,28 +195,28 @@ class MultiArmedBandit {
 				}
 				// Write logs in agent's output file
 				case WRITE_LOG:{
-					if(save_agent_logs) fprintf(agent_logger.file, "%.15f;A%d;%s;%s Reward per arm: ",
+					if(save_agent_logs) LogPrintf(agent_logger, "%.15f;A%d;%s;%s Reward per arm: ",
 						sim_time, agent_id, LOG_C00, LOG_LVL3);
 					for(int n = 0; n < num_actions; n++){
 						 if(save_agent_logs){
-							 fprintf(agent_logger.file, "%f  ", reward_per_arm[n]);
+							 LogPrintf(agent_logger, "%f  ", reward_per_arm[n]);
 						 }
 					}
-					if(save_agent_logs) fprintf(agent_logger.file, "\n%.15f;A%d;%s;%s Cumulative reward per arm: ",
+					if(save_agent_logs) LogPrintf(agent_logger, "\n%.15f;A%d;%s;%s Cumulative reward per arm: ",
 						sim_time, agent_id, LOG_C00, LOG_LVL3);
 					for(int n = 0; n < num_actions; n++){
 						 if(save_agent_logs){
-							 fprintf(agent_logger.file, "%f  ", cumulative_reward_per_arm[n]);
+							 LogPrintf(agent_logger, "%f  ", cumulative_reward_per_arm[n]);
 						 }
 					}
-					fprintf(agent_logger.file, "\n%.15f;A%d;%s;%s Times each arm has been selected: ",
+					LogPrintf(agent_logger, "\n%.15f;A%d;%s;%s Times each arm has been selected: ",
 									sim_time, agent_id, LOG_C00, LOG_LVL3);
 					for(int n = 0; n < num_actions; n++){
 						if(save_agent_logs){
-							fprintf(agent_logger.file, "%d ", times_arm_has_been_selected[n]);
+							LogPrintf(agent_logger, "%d ", times_arm_has_been_selected[n]);
 						}
 					}
-					if(save_agent_logs) fprintf(agent_logger.file, "\n");
+					if(save_agent_logs) LogPrintf(agent_logger, "\n");
 					break;
 				}
 			}
@@ -89,8 +89,161 @@
 #define WRITE_LOG				1	// Write log in file
 #define SAVE_LOG_NONE			0	// Don't save logs
 #define SAVE_LOG				1	// Save logs
+#define SAVE_LOG_BINARY_TRACE	2	// Save logs as a binary event trace (see 'trace_decoder')
+#define SAVE_LOG_FLIGHT_RECORDER	3	// Keep the last events in memory and write them only when a trigger fires
 #define LOG_HEADER_NODE_SIZE	30	// Node log header size
 
+// Binary event trace
+#define TRACE_MAGIC				"KMDTRC02"	// Trace file signature (8 bytes)
+#define TRACE_MAGIC_SIZE		8			// Size of the trace file signature
+#define TRACE_BUFFER_SIZE		65536		// Bytes buffered per trace writer before flushing to the log sink
+#define TRACE_RECORD_FORMAT		1			// Record defining a call site: site id (uint32), then format, LOG code and level strings (length as uint32, bytes)
+#define TRACE_RECORD_EVENT		2			// Record of a log event: site id (uint32) followed by its arguments
+#define TRACE_RECORD_LOG		3			// Record of a node log line: LOG code id (uint16), site id (uint32), timestamp (double), node id (uint32), state (int32), then the remaining arguments
+#define TRACE_LOG_HEADER		"%.15f;N%d;S%d;%s;%s"	// Header of the node log lines written as TRACE_RECORD_LOG
+#define TRACE_NO_CODE			0xFFFF		// LOG code id of the lines without a LOG_Xnn code
+#define TRACE_ARG_NONE			0			// Conversion without argument (e.g., '%%')
+#define TRACE_ARG_INT			1			// Signed integer conversion (d, i, c), stored as int64
+#define TRACE_ARG_UINT			2			// Unsigned integer conversion (u, x, X, o), stored as uint64
+#define TRACE_ARG_DOUBLE		3			// Floating point conversion (f, F, e, E, g, G, a, A), stored as double
+#define TRACE_ARG_STRING		4			// String conversion (s), stored as length (uint32) and bytes
+#define TRACE_ARG_POINTER		5			// Pointer conversion (p), stored as uint64
+#define TRACE_ARG_STAR			6			// '*' width or precision argument (int), stored as int32
+
+// Log writer
+#define LOG_WRITER_SYNC			0			// Logs are written with fprintf from the simulation thread
+#define LOG_WRITER_ASYNC_BLOCK	1			// Logs are queued to the writer thread (simulation waits if the ring is full)
+#define LOG_WRITER_ASYNC_DROP	2			// Logs are queued to the writer thread (messages are dropped and counted if the ring is full)
+#define LOG_RING_SIZE			1048576		// Bytes of the log ring of each log sink shard (power of two)
+#define LOG_RING_MAX_RECORD		65536		// Longer messages are queued as several records
+#define LOG_WRITER_IDLE_WAIT_US	1000		// Time the writer thread sleeps when all rings are empty [us]
+
+// Log filtering (LOGS lines are classified at compile time by their LOG_LVLx and LOG_Xnn arguments)
+#define LOG_FILTER_NO_LEVEL		0			// Level of lines without a LOG_LVLx argument
+#define LOG_FILTER_NO_CATEGORY	26			// Category of lines without a LOG_Xnn code (categories 0-25: 'A'-'Z')
+
+// Sharded log sink (node, agent and central controller logs)
+#define LOG_SINK_DEFAULT_SHARDS		8			// Number of segment files
+#define LOG_SINK_SHARD_BUFFER_SIZE	1048576		// Bytes buffered per segment before appending a chunk to its file
+#define LOG_SINK_RECORD_HEADER_SIZE	8			// Record header: owner id (uint32) and length (uint32)
+
+// Output schema (script output built from a list of metric@scope[:format] entries)
+#define OUTPUT_SCOPE_NODE		0			// One column per node
+#define OUTPUT_SCOPE_WLAN		1			// One column per WLAN (metric of its AP)
+#define OUTPUT_SCOPE_GLOBAL		2			// One column for the whole network
+
+// Seed aggregator (main/seed_aggregator.cc)
+#define AGGREGATOR_DEFAULT_CI_TARGET	0.05	// Relative half-width of the confidence intervals to reach
+#define AGGREGATOR_DEFAULT_CONFIDENCE	0.95	// Confidence level of the intervals
+#define AGGREGATOR_DEFAULT_MIN_SEEDS	3		// Seeds run before checking the intervals
+#define AGGREGATOR_DEFAULT_MAX_SEEDS	30		// Seeds run at most
+#define AGGREGATOR_SEED_TOKEN			"SEED"	// Replaced by the seed in the simulation arguments
+
+// Batch scheduler (main/komondor_batch.cc)
+#define BATCH_OUTPUT_TOKEN				"OUTPUT"			// Replaced by the script output file of each job
+#define BATCH_DEFAULT_SIMULATOR			"./komondor_main"
+#define BATCH_DEFAULT_RETRIES			2					// Retries of a failed job
+
+// Post-processor of script outputs (main/log_post_processor.cc)
+#define POST_PROCESSOR_DEFAULT_SIM_TIME			25		// Simulation time of the processed runs [s]
+#define POST_PROCESSOR_DEFAULT_THROUGHPUT_DELTA	0.05	// Load is achieved if |throughput - generation rate| < delta * load
+#define POST_PROCESSOR_DEFAULT_DELAY_DELTA		1		// Delay difference to declare a winner [ms]
+
+// Compiled scenarios (binary nodes/system records and path gains, see structures/scenario_file.h)
+#define SCENARIO_FILE_MAGIC			"KOMSCN"	// First bytes of a compiled scenario
+#define SCENARIO_FILE_VERSION		2			// Increase whenever the records or the path gain models change
+#define SCENARIO_FILE_EXTENSION		".kscn"
+#define SCENARIO_STRING_LENGTH		64			// Maximum length of node and WLAN codes (and 4x for filenames)
+
+// Procedural scenario generator (see structures/scenario_generator.h)
+#define SCENARIO_GENERATOR_PREFIX			"generate:"	// Nodes "filename" holding a generator spec
+#define TOPOLOGY_GRID						0	// APs on a square grid
+#define TOPOLOGY_RANDOM						1	// APs uniformly distributed (with a minimum distance)
+#define TOPOLOGY_ENTERPRISE					2	// Grids of ceiling-mounted APs on several floors
+#define TOPOLOGY_STADIUM					3	// Rings of APs around a pitch
+#define CHANNEL_RULE_SINGLE					0	// Every WLAN in channel 0
+#define CHANNEL_RULE_ROUND_ROBIN			1	// WLAN i in channel i % num_channels
+#define CHANNEL_RULE_RANDOM					2	// Uniformly random channel
+#define CHANNEL_RULE_REUSE					3	// Greedy least-interfered channel among the neighboring APs
+#define POWER_RULE_FIXED					0	// Same transmission power for every WLAN
+#define POWER_RULE_RANDOM					1	// Uniformly random transmission power (1 dB steps)
+#define GENERATOR_DEFAULT_APS				10
+#define GENERATOR_DEFAULT_STAS_PER_AP		5
+#define GENERATOR_DEFAULT_AP_DISTANCE		20		// [m]
+#define GENERATOR_DEFAULT_MIN_AP_DISTANCE	10		// [m]
+#define GENERATOR_DEFAULT_STA_DISTANCE		5		// [m]
+#define GENERATOR_DEFAULT_FLOORS			3
+#define GENERATOR_DEFAULT_FLOOR_HEIGHT		3		// [m]
+#define GENERATOR_DEFAULT_PITCH_RADIUS		60		// [m]
+#define GENERATOR_DEFAULT_TIERS				4
+#define GENERATOR_DEFAULT_TIER_HEIGHT		4		// [m]
+#define GENERATOR_DEFAULT_TX_POWER			20		// [dBm]
+#define GENERATOR_DEFAULT_CCA				-82		// [dBm]
+#define GENERATOR_DEFAULT_TRAFFIC_LOAD		1000	// [packets/s]
+#define GENERATOR_CEILING_OFFSET			0.5		// Distance between the ceiling and the APs (enterprise) [m]
+#define GENERATOR_STA_HEIGHT				1		// Height of the STAs over their floor (enterprise) [m]
+#define GENERATOR_MAX_ATTEMPTS				100		// Positions drawn per AP to honor the minimum distance (random)
+
+// Parameter sweeps (see structures/sweep.h)
+#define SWEEP_DESIGN_CARTESIAN				0	// Every combination of the values of the parameters
+#define SWEEP_DESIGN_LISTED					1	// Point k takes the k-th value of every parameter
+#define SWEEP_PARAMETER_TX_POWER			0	// Default transmission power [dBm]
+#define SWEEP_PARAMETER_CCA					1	// Default CCA threshold [dBm]
+#define SWEEP_PARAMETER_TRAFFIC_LOAD		2	// Traffic load [packets/s]
+#define SWEEP_PARAMETER_PRIMARY_CHANNEL		3	// Primary channel
+#define SWEEP_PARAMETER_CW					4	// Minimum contention window
+#define SWEEP_PARAMETER_SEED				5	// Simulation seed (target ignored)
+#define SWEEP_TARGET_ALL					"*"	// Sweep target matching every node
+
+// Result cache (see structures/result_cache.h)
+#define RESULT_CACHE_MAGIC					"KOMRES1"	// First word of a cached result (increase when the entries change)
+#define RESULT_CACHE_EXTENSION				".kres"
+#define RESULT_CACHE_STATS_FILENAME			"stats.log"
+#define RESULT_CACHE_DEFAULT_MAX_MB			1024	// Size of the entries beyond which the LRU ones are evicted [MB]
+#define RESULT_CACHE_EVICTION_TARGET		0.9		// Eviction stops at this fraction of the maximum size
+#ifndef KOMONDOR_BUILD_VERSION
+#define KOMONDOR_BUILD_VERSION				__DATE__ " " __TIME__	// Part of the result keys: results of another
+																	// build are not reused (set it with -D to share them)
+#endif
+
+// Node mobility (see structures/mobility.h)
+#define MOBILITY_DEFAULT_SPEED				1		// [m/s]
+#define MOBILITY_DEFAULT_FRACTION			1		// Every STA moves
+#define MOBILITY_MIN_RADIUS					1		// Minimum distance a STA can move away from its AP [m]
+
+// Node renumbering (see structures/node_order.h)
+#define NODE_ORDER_FILE						0	// Node ids follow the rows of the nodes file
+#define NODE_ORDER_MORTON					1	// WLANs ordered along the Morton (Z-order) curve of their AP positions
+#define NODE_ORDER_HILBERT					2	// WLANs ordered along the Hilbert curve of their AP positions
+#define NODE_ORDER_CURVE_BITS				16	// Bits per coordinate of the curve cells
+
+// Analytical estimation mode (see methods/analytical_methods.h)
+#define ANALYTICAL_MODEL_BIANCHI			0		// Single contention domain: Bianchi's fixed point
+#define ANALYTICAL_MODEL_CTMN				1		// DCB or partially overlapping WLANs: continuous-time Markov network
+#define ANALYTICAL_DEFAULT_MAX_STATES		200000	// Max. number of states of a CTMN
+#define ANALYTICAL_MAX_ITERATIONS			10000	// Max. iterations of the fixed points and of the CTMN solver
+#define ANALYTICAL_LOAD_ITERATIONS			50		// Max. iterations of the offered load (and inter-group interference) fixed point
+#define ANALYTICAL_TOLERANCE				1e-9	// Convergence tolerance of the iterations
+#define ANALYTICAL_LOAD_TOLERANCE			1e-6	// Convergence tolerance of the offered load fixed point
+
+// Delay histograms (log-bucketed, fixed memory)
+#define DELAY_HISTOGRAM_UNIT				0.000001	// Resolution of the histograms [s] (1 us)
+#define DELAY_HISTOGRAM_SUB_BUCKET_BITS		7			// 64 buckets per power of two: relative error < 1.6%
+#define DELAY_HISTOGRAM_MAX_EXPONENT		36			// Delays above 2^36 units (~19 h) fall in the last bucket
+
+// Flight recorder (save_node_logs == SAVE_LOG_FLIGHT_RECORDER)
+#define FLIGHT_RECORDER_DEFAULT_EVENTS			256		// Events kept per node
+#define FLIGHT_RECORDER_DEFAULT_MAX_DUMPS		10		// Dumps written per node (avoids flooding the disk with frequent triggers)
+#define FLIGHT_RECORDER_MAX_ARGS				16		// Arguments kept per event (checked at compile time for LOGS lines)
+#define FLIGHT_RECORDER_STRING_SIZE				64		// Bytes per event for copies of the strings passed by pointer
+#define FLIGHT_RECORDER_ABORT_BUFFER_SIZE		65536	// Bytes of the buffer used to write the abort dump
+#define FLIGHT_RECORDER_TRIGGER_BO_COLLISION	0x01	// Slotted backoff collision
+#define FLIGHT_RECORDER_TRIGGER_ACK_TIMEOUT		0x02	// ACK timeout
+#define FLIGHT_RECORDER_TRIGGER_CTS_TIMEOUT		0x04	// CTS timeout
+#define FLIGHT_RECORDER_TRIGGER_NACK			0x08	// Logical NACK received
+#define FLIGHT_RECORDER_TRIGGER_ABORT			0x10	// Process aborted (e.g., failed assert in CostSimEng::Run)
+#define FLIGHT_RECORDER_TRIGGER_ALL				0x1F
+
 // Transmission initiated or finished
 #define TX_INITIATED		0	// Transmission is initiated ('inportSomeNodeStartTX()')
 #define TX_FINISHED			1	// Transmission is finished ('inportSomeNodeFinishTX()')
@@ -150,6 +303,7 @@
 #define FIRST_TRUE_IN_ARRAY 			0	// Search first element '1' in an array
 #define LAST_TRUE_IN_ARRAY			1	// Search last element '1' in an array
 #define NUM_OPTIONS_CHANNEL_LENGTH	4	// Number of options of channel lengths (1, 2, 4, 8)
+#define MAX_NUM_CHANNELS_BITMASK	32	// Max. number of channels represented in a channel bitmask (bits of an unsigned int)
 
 // Channel free - occupied
 #define CHANNEL_OCCUPIED	0
@@ -216,6 +370,13 @@
 
 #define PACKET_BUFFER_SIZE		100		// Size of the packets buffer
 
+// Burst size model (only applies to TRAFFIC_POISSON_BURST)
+#define BURST_SIZE_DETERMINISTIC	0	// Every burst carries the average burst size (its floor or ceiling if it is fractional)
+#define BURST_SIZE_POISSON			1	// Burst size follows a Poisson distribution with mean equal to the average burst size
+#define BURST_SIZE_UNIFORM			2	// Burst size is uniformly distributed in [1, 2*average burst size - 1]
+#define DEFAULT_BURST_SIZE_MODEL	BURST_SIZE_DETERMINISTIC	// Used when the system file does not specify it
+#define DEFAULT_BURST_SIZE			10	// Average number of packets per burst (used when not specified in the system file)
+
 // Protocols
 #define INCREASE_CW 1		// Command to increase contention window
 #define RESET_CW 2			// Command to reset the contention window
@@ -224,6 +385,19 @@
 // CE Model
 #define CE_DEFAULT			0	//
 #define CE_IEEE_802_11		1	//
+#define CE_LINK_ABSTRACTION	2	// As CE_DEFAULT, but DATA frames are lost according to per-MCS SINR-to-PER tables
+
+// Capture outcome of a frame arriving while another one is being received (see SelectCaptureEffectModel())
+#define CAPTURE_NONE				0	// The ongoing reception is not affected
+#define CAPTURE_COLLISION			1	// Both frames are lost (pure or backoff collision)
+#define CAPTURE_SWITCH				2	// The new frame is captured: start decoding it instead
+#define CAPTURE_LOST_INTERFERENCE	3	// The ongoing reception is lost due to interference
+#define CAPTURE_LOST_CAPTURE_EFFECT	4	// The ongoing reception is lost because a stronger frame captured the receiver
+
+// Link abstraction (SINR-to-PER tables, see link_abstraction_methods.h)
+#define PER_TABLE_SINR_MIN_DB		-10		// Lowest SINR in the PER tables [dB] (PER saturates below)
+#define PER_TABLE_SINR_MAX_DB		50		// Highest SINR in the PER tables [dB] (PER saturates above)
+#define PER_TABLE_SINR_STEP_DB		0.25	// SINR resolution of the PER tables [dB]
 
 // Node type
 #define NODE_TYPE_UNKWNOW	-1	// Unknown (none) node type
@@ -250,6 +424,7 @@
 #define MODULATION_256QAM_5_6	10
 #define MODULATION_1024QAM_3_4	11
 #define MODULATION_1024QAM_5_6	12
+#define NUM_MODULATIONS			12	// Number of usable modulations (MODULATION_BPSK_1_2 to MODULATION_1024QAM_5_6)
 
 // Information detail level
 #define INFO_DETAIL_LEVEL_0		0
@@ -378,6 +553,8 @@
 #define DEFAULT_WRITE_NODE_LOGS		0
 #define DEFAULT_PRINT_SYSTEM_LOGS	1
 #define DEFAULT_PRINT_NODE_LOGS		1
+#define DEFAULT_LOG_WRITER_MODE		LOG_WRITER_SYNC	// Used when the system file does not specify it (asynchronous is opt-in)
+#define DEFAULT_SCRIPT_OUTPUT_INDEX	13			// Legacy script output layout (used when no output schema is entered)
 
 // File types
 #define FILE_TYPE_UNKNOWN		-1
@@ -403,6 +580,10 @@
 #define IX_CW_ADAPTATION			15
 #define IX_PIFS_ACTIVATION			16
 #define IX_CAPTURE_EFFECT_MODEL		17
+#define IX_BURST_SIZE_MODEL			18	// Optional
+#define IX_BURST_SIZE				19	// Optional
+#define IX_PER_TABLES_FILENAME		20	// Optional (only used with CE_LINK_ABSTRACTION)
+#define IX_LOG_WRITER_MODE			21	// Optional
 
 // Nodes file
 #define IX_NODE_CODE				1
@@ -448,6 +629,11 @@
 #define IX_AGENT_LEARNING_MECHANISM		9
 #define IX_AGENT_SELECTED_STRATEGY 		10
 
+// Sweep file
+#define IX_SWEEP_PARAMETER				1
+#define IX_SWEEP_TARGET					2
+#define IX_SWEEP_VALUES					3
+
 /* *********************
  * * LOG TYPE ENCODING *
  * *********************
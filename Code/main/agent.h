@@ -58,6 +58,7 @@
 #include "../list_of_macros.h"
 #include "../structures/node_configuration.h"
 #include "../structures/performance_metrics.h"
+#include "../structures/metrics.h"
 #include "../structures/action.h"
 #include "../methods/auxiliary_methods.h"
 #include "../methods/agent_methods.h"
@@ -125,6 +126,7 @@ component Agent : public TypeII{
 		// Print/write variables
 		int save_agent_logs;
 		int print_agent_logs;
+		int log_writer_mode;				// Synchronous or asynchronous (blocking or dropping) log writing
 		std::string simulation_code;		// Simulation code
 
 	// Private items (just for node operation)
@@ -147,8 +149,6 @@ component Agent : public TypeII{
 		Configuration configuration_from_controller;
 
 		// File for writting node logs
-		FILE *output_log_file;				// File for logs in which the agent is involved
-		char own_file_path[32];				// Name of the file for agent logs
 		Logger agent_logger;				// struct containing the attributes needed for writting logs in a file
 		char *header_string;				// Header string for the logger
 
@@ -169,6 +169,8 @@ component Agent : public TypeII{
 		// INPORT (centralized system only)
 		inport void inline InportReceivingRequestFromController(int destination_agent_id);
 		inport void inline InportReceiveConfigurationFromController(int destination_agent_id, Configuration &new_configuration);
+		// INPORT (metrics sampler only)
+		inport void inline InportMetricsRequested(MetricsSnapshot &snapshot);
 		// OUTPORT connections for sending notifications
 		outport void outportRequestInformationToAp();
 		outport void outportSendConfigurationToAp(Configuration &new_configuration);
@@ -200,15 +202,18 @@ void Agent :: Start(){
 	// Create agent logs file if required
 	if(save_agent_logs) {
 		// Name agent log file accordingly to the agent_id
-		sprintf(own_file_path,"%s_A%d_%s.txt","../output/logs_output", agent_id, wlan_code.c_str());
-		remove(own_file_path);
-		output_log_file = fopen(own_file_path, "at");
+		// Logs are appended to the sharded log sink: 'log_extractor' regenerates this per-agent file
+		char log_filename[CHAR_BUFFER_SIZE];
+		snprintf(log_filename, sizeof(log_filename), "%s_A%d_%s.txt","../output/logs_output", agent_id, wlan_code.c_str());
 		agent_logger.save_logs = save_agent_logs;
-		agent_logger.file = output_log_file;
+		agent_logger.sink_owner = log_sink.RegisterOwner(log_filename);
 		agent_logger.SetVoidHeadString();
+		if(log_writer_mode != LOG_WRITER_SYNC) {
+			agent_logger.ring = async_log_writer.OpenRing(agent_logger.sink_owner, log_writer_mode);
+		}
 	}
 	
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.18f;A%d;%s;%s Start()\n", SimTime(), agent_id, LOG_B00, LOG_LVL1);
 
 	if(communication_level == PURE_CENTRALIZED) {
@@ -232,13 +237,13 @@ void Agent :: Start(){
  */
 void Agent :: Stop(){
 
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s Agent Stop()\n", SimTime(), agent_id, LOG_C00, LOG_LVL1);
 
 	PrintOrWriteAgentStatistics();
 
 	// Close node logs file
-	if(save_agent_logs) fclose(agent_logger.file);
+	if(save_agent_logs) CloseLogRing(agent_logger);
 
 };
 
@@ -256,11 +261,11 @@ void Agent :: RequestInformationToAp(trigger_t &){
 
 //	printf("%s Agent #%d: Requesting information to AP\n", LOG_LVL1, agent_id);
 
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s RequestInformationToAp() (request #%d)\n",
 		SimTime(), agent_id, LOG_F00, LOG_LVL1, num_requests);
 
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s Requesting information to AP\n", SimTime(), agent_id, LOG_C00, LOG_LVL2);
 
 	outportRequestInformationToAp();
@@ -280,11 +285,11 @@ void Agent :: InportReceivingInformationFromAp(Configuration &received_configura
 
 //	printf("%s Agent #%d: Message received from the AP\n", LOG_LVL1, agent_id);
 
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s InportReceivingInformationFromAp()\n",
 		SimTime(), agent_id, LOG_F00, LOG_LVL1);
 
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s New information has been received from the AP\n",
 		SimTime(), agent_id, LOG_C00, LOG_LVL2);
 
@@ -298,7 +303,7 @@ void Agent :: InportReceivingInformationFromAp(Configuration &received_configura
 
 	if (communication_level == PURE_CENTRALIZED ||  communication_level == HYBRID_CENTRALIZED_DECENTRALIZED) {
 		// Forward the information to the controller
-		LOGS(save_agent_logs, agent_logger.file,
+		LOGS(save_agent_logs, agent_logger,
 			"%.15f;A%d;%s;%s Answering to the controller with current information\n",
 			SimTime(), agent_id, LOG_F02, LOG_LVL2);
 		outportAnswerToController(configuration, performance, agent_id);
@@ -320,11 +325,11 @@ void Agent :: SendNewConfigurationToAp(Configuration &configuration_to_send){
 
 //	printf("%s Agent #%d: Sending new configuration to AP\n", LOG_LVL1, agent_id);
 
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s SendNewConfigurationToAp()\n",
 		SimTime(), agent_id, LOG_F00, LOG_LVL1);
 
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s Sending a new configuration to the AP\n",
 		SimTime(), agent_id, LOG_C00, LOG_LVL2);
 
@@ -335,12 +340,12 @@ void Agent :: SendNewConfigurationToAp(Configuration &configuration_to_send){
 
 	// Set trigger for next request in case of being an independent agent (not controlled by a central entity)
 	if (!communication_level) {
-		LOGS(save_agent_logs, agent_logger.file,
+		LOGS(save_agent_logs, agent_logger,
 			"%.15f;A%d;%s;%s Next request to be sent at %f\n",
 			SimTime(), agent_id, LOG_C00, LOG_LVL2, fix_time_offset(SimTime() + time_between_requests,13,12));
 		trigger_request_information_to_ap.Set(fix_time_offset(SimTime() + time_between_requests,13,12));
 	} else {
-		LOGS(save_agent_logs, agent_logger.file,
+		LOGS(save_agent_logs, agent_logger,
 			"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
 	}
 
@@ -363,10 +368,10 @@ void Agent :: InportReceivingRequestFromController(int destination_agent_id) {
 
 //		printf("%s Agent #%d: New information request received from the Controller\n", LOG_LVL1, agent_id);
 
-		LOGS(save_agent_logs, agent_logger.file,
+		LOGS(save_agent_logs, agent_logger,
 			"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
 
-		LOGS(save_agent_logs, agent_logger.file,
+		LOGS(save_agent_logs, agent_logger,
 			"%.15f;A%d;%s;%s New information request received from the Controller for Agent %d\n",
 			SimTime(), agent_id, LOG_F02, LOG_LVL2, destination_agent_id);
 
@@ -390,7 +395,7 @@ void Agent :: InportReceiveConfigurationFromController(int destination_agent_id,
 
 	if(agent_id == destination_agent_id) {
 
-		LOGS(save_agent_logs, agent_logger.file,
+		LOGS(save_agent_logs, agent_logger,
 			"%.15f;A%d;%s;%s New configuration received from the Controller to Agent %d\n",
 			SimTime(), agent_id, LOG_F02, LOG_LVL2, destination_agent_id);
 
@@ -403,6 +408,19 @@ void Agent :: InportReceiveConfigurationFromController(int destination_agent_id,
 
 }
 
+/*
+ * InportMetricsRequested(): called when the metrics sampler takes a sample
+ * INPUT:
+ * - snapshot: state of all the agents, where the entry of this agent is filled
+ */
+void Agent :: InportMetricsRequested(MetricsSnapshot &snapshot) {
+
+	AgentMetrics &metrics = snapshot.agents[agent_id];
+	metrics.agent_id = agent_id;
+	metrics.selected_arm = ML_output;
+
+}
+
 /***************************/
 /***************************/
 /*  GENERATE A NEW CONFIG. */
@@ -415,7 +433,7 @@ void Agent :: InportReceiveConfigurationFromController(int destination_agent_id,
  */
 void Agent :: ComputeNewConfiguration(){
 
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s ComputeNewConfiguration()\n", SimTime(), agent_id, LOG_F00, LOG_LVL1);
 
 	// Process the configuration and performance reports obtained from the WLAN
@@ -462,6 +480,7 @@ void Agent :: InitializeAgent() {
 	//printf("Agent #%d says: I'm alive!\n", agent_id);
 
 	num_requests = 0;
+	ML_output = -1;
 
 	list_of_channels = new int[num_actions_channel];
 	list_of_pd_values = new double[num_actions_sensitivity];
@@ -574,22 +593,22 @@ void Agent :: PrintAgentInfo(){
  * WriteConfiguration(): writes Agent info
  */
 void Agent :: WriteConfiguration(Configuration configuration_to_write) {
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s Configuration:\n", SimTime(), agent_id, LOG_C03, LOG_LVL2);
 	// Selected primary channel
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s selected_primary_channel = %d\n", SimTime(), agent_id, LOG_C03, LOG_LVL3,
 		configuration_to_write.selected_primary_channel);
 	// Select Packet Detect (PD) threshold
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s selected_pd = %f dBm\n", SimTime(), agent_id, LOG_C03, LOG_LVL3,
 		ConvertPower(PW_TO_DBM,configuration_to_write.selected_pd));
 	// Selected Transmit Power
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s selected_tx_power = %f dBm\n", SimTime(), agent_id, LOG_C03, LOG_LVL3,
 		ConvertPower(PW_TO_DBM,configuration_to_write.selected_tx_power));
 	// Selected DCB policy
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s selected_dcb_policy = %d\n", SimTime(), agent_id, LOG_C03, LOG_LVL3,
 		configuration_to_write.selected_dcb_policy);
 }
@@ -598,10 +617,10 @@ void Agent :: WriteConfiguration(Configuration configuration_to_write) {
  * WritePerformance(): writes performance
  */
 void Agent :: WritePerformance(Performance performance_to_write) {
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s Performance:\n", SimTime(), agent_id, LOG_C03, LOG_LVL2);
 	// Throughput (Mbps)
-	LOGS(save_agent_logs, agent_logger.file,
+	LOGS(save_agent_logs, agent_logger,
 		"%.15f;A%d;%s;%s throughput = %.2f\n", SimTime(), agent_id, LOG_C03, LOG_LVL3,
 		performance_to_write.throughput * pow(10,-6));
 }
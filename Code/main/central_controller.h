@@ -108,6 +108,7 @@ component CentralController : public TypeII{
 
 		int save_controller_logs;
 		int print_controller_logs;
+		int log_writer_mode;				// Synchronous or asynchronous (blocking or dropping) log writing
 
 		int type_of_reward;
 		int learning_mechanism;
@@ -132,8 +133,6 @@ component CentralController : public TypeII{
 		PreProcessor pre_processor;
 
 		// File for writting node logs
-		FILE *output_log_file;				// File for logs in which the agent is involved
-		char own_file_path[32];				// Name of the file for agent logs
 		Logger central_controller_logger;	// struct containing the attributes needed for writting logs in a file
 		char *header_string;				// Header string for the logger
 
@@ -184,15 +183,16 @@ void CentralController :: Start(){
 
 	// Create CC logs file (if required)
 	if(save_controller_logs) {
-		sprintf(own_file_path,"%s_CENTRAL_CONTROLLER.txt","../output/logs_output");
-		remove(own_file_path);
-		output_log_file = fopen(own_file_path, "at");
+		// Logs are appended to the sharded log sink: 'log_extractor' regenerates this file
 		central_controller_logger.save_logs = save_controller_logs;
-		central_controller_logger.file = output_log_file;
+		central_controller_logger.sink_owner = log_sink.RegisterOwner("../output/logs_output_CENTRAL_CONTROLLER.txt");
 		central_controller_logger.SetVoidHeadString();
+		if(log_writer_mode != LOG_WRITER_SYNC) {
+			central_controller_logger.ring = async_log_writer.OpenRing(central_controller_logger.sink_owner, log_writer_mode);
+		}
 	}
 
-	LOGS(save_controller_logs,central_controller_logger.file,
+	LOGS(save_controller_logs, central_controller_logger,
 		"%.18f;CC;%s;%s Start()\n", SimTime(), LOG_B00, LOG_LVL1);
 
 	// Initialize the PP and the ML Method
@@ -215,7 +215,7 @@ void CentralController :: Start(){
  */
 void CentralController :: Stop() {
 
-	LOGS(save_controller_logs,central_controller_logger.file,
+	LOGS(save_controller_logs, central_controller_logger,
 		"%.15f;CC;%s;%s Central Controller Stop()\n", SimTime(), LOG_C00, LOG_LVL1);
 
 	// Print and write node statistics
@@ -223,7 +223,7 @@ void CentralController :: Stop() {
 	PrintOrWriteControllerStatistics(WRITE_LOG);
 
 	// Close node logs file
-	if(save_controller_logs) fclose(central_controller_logger.file);
+	if(save_controller_logs) CloseLogRing(central_controller_logger);
 
 };
 
@@ -237,11 +237,11 @@ void CentralController :: Stop() {
  * RequestInformationToAgents(): requests information (conf. & perform.) from agents upon trigger-based activation
  */
 void CentralController :: RequestInformationToAgents(trigger_t &){
-	LOGS(save_controller_logs,central_controller_logger.file,
+	LOGS(save_controller_logs, central_controller_logger,
 		"%.15f;CC;%s;%s Requesting information to Agents\n", SimTime(), LOG_C00, LOG_LVL1);
 	// Request information to every agent associated to the CC
 	for (int ix = 0 ; ix < agents_number ; ++ix ) {
-		LOGS(save_controller_logs,central_controller_logger.file,
+		LOGS(save_controller_logs, central_controller_logger,
 			"%.15f;CC;%s;%s Requesting information to Agent %d\n", SimTime(), LOG_C00, LOG_LVL2, ix);
 		outportRequestInformationToAgent(ix);
 		++ num_requests[ix] ;
@@ -256,10 +256,10 @@ void CentralController :: RequestInformationToAgents(trigger_t &){
 void CentralController :: InportReceivingInformationFromAgent(Configuration &received_configuration,
 	Performance &received_performance, int agent_id){
 
-	LOGS(save_controller_logs,central_controller_logger.file,
+	LOGS(save_controller_logs, central_controller_logger,
 		"%.15f;CC;%s;%s InportReceivingInformationFromAgent()\n", SimTime(), LOG_F00, LOG_LVL1);
 
-	LOGS(save_controller_logs,central_controller_logger.file,
+	LOGS(save_controller_logs, central_controller_logger,
 		"%.15f;CC;%s;%s New information has been received from Agent %d\n", SimTime(), LOG_C00, LOG_LVL2, agent_id);
 
 	// Update the configuration and performance received
@@ -298,7 +298,7 @@ void CentralController :: InportReceivingInformationFromAgent(Configuration &rec
  * -
  */
 void CentralController :: GenerateAndSendNewConfiguration(trigger_t &){
-	LOGS(save_controller_logs,central_controller_logger.file,
+	LOGS(save_controller_logs, central_controller_logger,
 		"%.15f;CC;%s;%s GenerateAndSendNewConfiguration()\n", SimTime(), LOG_F00, LOG_LVL1);
 	// Compute the new configuration according to the ML method used
 	ml_method.ComputeGlobalConfiguration(configuration_array, performance_array,
@@ -307,7 +307,7 @@ void CentralController :: GenerateAndSendNewConfiguration(trigger_t &){
 	SendConfigurationToAllAgents();
 	// Set trigger for next request
 	trigger_request_information_to_agents.Set(fix_time_offset(SimTime() + time_between_requests,13,12));
-	LOGS(save_controller_logs,central_controller_logger.file,
+	LOGS(save_controller_logs, central_controller_logger,
 		"%.15f;CC;%s;%s Next request to be sent at %f\n",
 		SimTime(), LOG_C00, LOG_LVL2, fix_time_offset(SimTime() + time_between_requests,13,12));
 }
@@ -331,7 +331,7 @@ void CentralController :: SendConfigurationToAllAgents(){
  * - new_conf: new configuration to be applied by the destination agent
  */
 void CentralController :: SendConfigurationToSingleAgent(int destination_agent_id, Configuration new_conf){
-	LOGS(save_controller_logs,central_controller_logger.file,
+	LOGS(save_controller_logs, central_controller_logger,
 		"%.15f;CC;%s;%s Sending a new configuration to Agent %d\n",
 		SimTime(), LOG_C00, LOG_LVL2, destination_agent_id);
 	// TODO (LOW PRIORITY): generate a trigger to simulate delays in the agent-node communication
@@ -426,22 +426,22 @@ void CentralController :: PrintOrWriteControllerInfo(int print_or_write) {
 
 		case WRITE_LOG:{
 
-			LOGS(save_controller_logs, central_controller_logger.file,
+			LOGS(save_controller_logs, central_controller_logger,
 				"%.15f;CC;%s;%s Central Controller info\n", SimTime(), LOG_C00, LOG_LVL3);
-			LOGS(save_controller_logs, central_controller_logger.file,
+			LOGS(save_controller_logs, central_controller_logger,
 				"%.15f;CC;%s;%s agents_number = %d\n", SimTime(), LOG_C00, LOG_LVL4, agents_number);
-			LOGS(save_controller_logs, central_controller_logger.file,
+			LOGS(save_controller_logs, central_controller_logger,
 				"%.15f;CC;%s;%s time_between_requests = %f\n", SimTime(), LOG_C00, LOG_LVL4, time_between_requests);
-			LOGS(save_controller_logs, central_controller_logger.file,
+			LOGS(save_controller_logs, central_controller_logger,
 				"%.15f;CC;%s;%s learning_mechanism = %d\n", SimTime(), LOG_C00, LOG_LVL4, learning_mechanism);
-			LOGS(save_controller_logs, central_controller_logger.file,
+			LOGS(save_controller_logs, central_controller_logger,
 				"%.15f;CC;%s;%s total_nodes_number = %d\n", SimTime(), LOG_C00, LOG_LVL4, total_nodes_number);
-			LOGS(save_controller_logs, central_controller_logger.file,
+			LOGS(save_controller_logs, central_controller_logger,
 				"%.15f;CC;%s;%s list of agents: ", SimTime(), LOG_C00, LOG_LVL4);
 			for (int i = 0; i < agents_number; ++ i) {
-				LOGS(save_controller_logs, central_controller_logger.file, "%d ", list_of_agents[i]);
+				LOGS(save_controller_logs, central_controller_logger, "%d ", list_of_agents[i]);
 			}
-			LOGS(save_controller_logs, central_controller_logger.file, "\n");
+			LOGS(save_controller_logs, central_controller_logger, "\n");
 			break;
 		}
 
@@ -462,7 +462,7 @@ void CentralController :: PrintOrWriteControllerStatistics(int print_or_write) {
 		}
 
 		case WRITE_LOG:{
-			LOGS(save_controller_logs, central_controller_logger.file,
+			LOGS(save_controller_logs, central_controller_logger,
 				"\n%.15f;CC;%s;%s STATISTICS CENTRAL CONTROLLER:\n", SimTime(), LOG_C00, LOG_LVL1);
 			break;
 		}
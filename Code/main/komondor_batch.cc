@@ -0,0 +1,432 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file runs a list of simulations on a pool of worker processes (one per core by default)
+ *   and appends the script output of every job to a single output file. Each job line holds the
+ *   arguments of komondor_main, the token OUTPUT standing for the script output file of the job.
+ *   Results are appended with a single write per job, prefixed by the key of the job (hash of its
+ *   line), so that an interrupted batch resumes by skipping the jobs already in the output file.
+ *   Failed jobs are retried. With --scenario_cache, the distinct scenarios are compiled before the
+ *   jobs start, and every worker maps the same compiled scenario.
+ *
+ * Usage: ./komondor_batch [options] <job_list> <output_file>
+ * e.g., job line: ../input/input_example/input_system_conf.csv ../input/input_example/input_nodes.csv
+ *                 OUTPUT sim_1 0 0 0 0 10 1992
+ * Options:
+ *   --jobs=<N>				worker processes (default: one per core)
+ *   --retries=<N>			retries of a failed job (default 2)
+ *   --simulator=<path>		simulator binary (default ./komondor_main)
+ *   --scenario_cache=<dir>	compiled scenarios shared by the workers
+ *   --logs=<dir>			console output of every job (default: discarded)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+
+#include "../list_of_macros.h"
+
+/*
+ * BatchJob: simulation of the job list
+ */
+struct BatchJob
+{
+	int line;							// Line in the job list
+	std::string key;					// Hash of the line (identifies the job in the output file)
+	std::vector<std::string> arguments;	// Arguments of the simulator
+	int attempts;						// Runs so far
+};
+
+/*
+ * JobKey(): 64-bit FNV-1a hash of a job line, in hexadecimal
+ */
+std::string JobKey(const std::string &line){
+	unsigned long long hash (14695981039346656037ULL);
+	for(size_t c = 0; c < line.size(); ++c){
+		hash ^= (unsigned char) line[c];
+		hash *= 1099511628211ULL;
+	}
+	char key[17];
+	snprintf(key, sizeof(key), "%016llx", hash);
+	return key;
+}
+
+/*
+ * ReadJobs(): reads the job list (blank lines and lines starting with '#' are ignored)
+ */
+void ReadJobs(const char *filename, std::vector<BatchJob> &jobs){
+
+	FILE *file = fopen(filename, "r");
+	if(file == NULL){
+		printf("ERROR: job list %s could not be opened\n", filename);
+		exit(-1);
+	}
+	std::set<std::string> keys;
+	char buffer[CHAR_BUFFER_SIZE];
+	std::string line;
+	int line_number (0);
+	while(fgets(buffer, sizeof(buffer), file) != NULL){
+		line.append(buffer);
+		if(line[line.size() - 1] != '\n' && !feof(file)) continue;	// Line longer than the buffer
+		++line_number;
+		line.erase(line.find_last_not_of(" \t\r\n") + 1);
+		line.erase(0, line.find_first_not_of(" \t"));
+		if(!line.empty() && line[0] != '#'){
+			BatchJob job;
+			job.line = line_number;
+			job.key = JobKey(line);
+			job.attempts = 0;
+			int has_token (FALSE);
+			size_t from (0);
+			while(from < line.size()){
+				size_t to (line.find_first_of(" \t", from));
+				if(to == std::string::npos) to = line.size();
+				if(to > from) job.arguments.push_back(line.substr(from, to - from));
+				if(line.compare(from, to - from, BATCH_OUTPUT_TOKEN) == 0) has_token = TRUE;
+				from = to + 1;
+			}
+			if(!has_token){
+				printf("ERROR: %s:%d: the job has no %s argument (script output file)\n", filename, line_number,
+					BATCH_OUTPUT_TOKEN);
+				exit(-1);
+			}
+			if(keys.insert(job.key).second) jobs.push_back(job);
+			else printf("%s WARNING: %s:%d: duplicated job skipped\n", LOG_LVL2, filename, line_number);
+		}
+		line.clear();
+	}
+	fclose(file);
+}
+
+/*
+ * ReadDoneJobs(): keys of the jobs already in the output file. A last line without end of line
+ * (interrupted write) is removed.
+ */
+void ReadDoneJobs(const char *filename, std::set<std::string> &done_keys){
+
+	FILE *file = fopen(filename, "r");
+	if(file == NULL) return;
+	std::string content;
+	char buffer[1 << 16];
+	size_t bytes_read;
+	while((bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0) content.append(buffer, bytes_read);
+	fclose(file);
+
+	size_t complete_size (content.rfind('\n') == std::string::npos ? 0 : content.rfind('\n') + 1);
+	if(complete_size < content.size()){
+		printf("%s WARNING: incomplete last record removed from %s\n", LOG_LVL2, filename);
+		if(truncate(filename, complete_size) != 0){
+			printf("ERROR: output file %s could not be repaired\n", filename);
+			exit(-1);
+		}
+	}
+	size_t from (0);
+	while(from < complete_size){
+		size_t separator (content.find(';', from));
+		size_t end (content.find('\n', from));
+		if(separator != std::string::npos && separator < end) done_keys.insert(content.substr(from, separator - from));
+		from = end + 1;
+	}
+}
+
+/*
+ * Now(): monotonic time [s]
+ */
+double Now(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/*
+ * BatchRunner: pool of worker processes
+ */
+struct BatchRunner
+{
+	std::string simulator;
+	std::string output_filename;
+	std::string scenario_cache;
+	std::string logs_directory;
+	int num_workers;
+	int max_retries;
+
+	/*
+	 * TemporaryOutput(): script output file of a job while it runs
+	 */
+	std::string TemporaryOutput(const BatchJob &job) const {
+		return output_filename + "." + job.key + ".tmp";
+	}
+
+	/*
+	 * Launch(): starts a job in a worker process
+	 * Input arguments:
+	 * - job: job to run
+	 * - extra_argument: argument appended to those of the job (empty: none)
+	 */
+	pid_t Launch(const BatchJob &job, const char *extra_argument) const {
+
+		std::string temporary_output (TemporaryOutput(job));
+		remove(temporary_output.c_str());
+		std::vector<std::string> arguments (1, simulator);
+		for(size_t a = 0; a < job.arguments.size(); ++a){
+			arguments.push_back(job.arguments[a] == BATCH_OUTPUT_TOKEN ? temporary_output : job.arguments[a]);
+		}
+		if(!scenario_cache.empty()) arguments.push_back("--scenario_cache=" + scenario_cache);
+		if(extra_argument[0] != '\0') arguments.push_back(extra_argument);
+		std::vector<char*> argv;
+		for(size_t a = 0; a < arguments.size(); ++a) argv.push_back(&arguments[a][0]);
+		argv.push_back(NULL);
+
+		std::string log_filename (logs_directory.empty() ? "/dev/null" : logs_directory + "/job_" + job.key + ".txt");
+		fflush(stdout);
+		pid_t pid = fork();
+		if(pid < 0){
+			printf("ERROR: job %s could not be launched\n", job.key.c_str());
+			exit(-1);
+		}
+		if(pid == 0){
+			int log_fd (open(log_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+			if(log_fd >= 0){
+				dup2(log_fd, STDOUT_FILENO);
+				dup2(log_fd, STDERR_FILENO);
+				close(log_fd);
+			}
+			execvp(argv[0], &argv[0]);
+			printf("ERROR: %s could not be executed\n", argv[0]);
+			_exit(127);
+		}
+		return pid;
+	}
+
+	/*
+	 * Record(): appends the script output of a finished job to the output file (single write)
+	 * Output:
+	 * - TRUE if the job wrote its script output, FALSE otherwise
+	 */
+	int Record(const BatchJob &job) const {
+
+		std::string temporary_output (TemporaryOutput(job));
+		FILE *file = fopen(temporary_output.c_str(), "r");
+		if(file == NULL) return FALSE;
+		std::string record (job.key + ";");
+		char buffer[1 << 16];
+		size_t bytes_read;
+		while((bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0) record.append(buffer, bytes_read);
+		fclose(file);
+		remove(temporary_output.c_str());
+		record.erase(record.find_last_not_of(" \r\n") + 1);
+		if(record.size() <= job.key.size() + 1) return FALSE;
+		for(size_t c = 0; c < record.size(); ++c) if(record[c] == '\n') record[c] = ' ';	// One record per line
+		record.push_back('\n');
+
+		int fd (open(output_filename.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644));
+		if(fd < 0 || write(fd, record.data(), record.size()) != (ssize_t) record.size() || fsync(fd) != 0){
+			printf("ERROR: output file %s could not be written\n", output_filename.c_str());
+			exit(-1);
+		}
+		close(fd);
+		return TRUE;
+	}
+
+	/*
+	 * CompileScenarios(): compiles the distinct scenarios (system and nodes files, the first two
+	 * arguments of every job) before the jobs start, so that workers do not compile them concurrently
+	 */
+	void CompileScenarios(const std::vector<BatchJob> &jobs) const {
+
+		std::vector<BatchJob> compile_jobs;
+		std::set<std::pair<std::string, std::string> > scenarios;
+		for(size_t j = 0; j < jobs.size(); ++j){
+			if(jobs[j].arguments.size() < 2) continue;
+			if(scenarios.insert(std::make_pair(jobs[j].arguments[0], jobs[j].arguments[1])).second) {
+				compile_jobs.push_back(jobs[j]);
+			}
+		}
+		printf("%s Compiling %d scenarios to '%s'...\n", LOG_LVL1, (int) compile_jobs.size(), scenario_cache.c_str());
+		std::map<pid_t, size_t> running;
+		for(size_t c = 0; c < compile_jobs.size() || !running.empty(); ){
+			if(c < compile_jobs.size() && (int) running.size() < num_workers){
+				running[Launch(compile_jobs[c], "--compile_only")] = c;
+				++c;
+				continue;
+			}
+			int status;
+			pid_t pid (wait(&status));
+			if(pid < 0) break;
+			const BatchJob &job = compile_jobs[running[pid]];
+			remove(TemporaryOutput(job).c_str());
+			if(!WIFEXITED(status) || WEXITSTATUS(status) != 0){
+				printf("%s WARNING: scenario of line %d could not be compiled (its jobs will compile it)\n",
+					LOG_LVL2, job.line);
+			}
+			running.erase(pid);
+		}
+	}
+
+	/*
+	 * Run(): runs the jobs, keeping every worker busy
+	 * Output:
+	 * - number of jobs failed after every retry
+	 */
+	int Run(std::vector<BatchJob> &jobs, int num_resumed){
+
+		std::deque<size_t> pending;
+		for(size_t j = 0; j < jobs.size(); ++j) pending.push_back(j);
+		std::map<pid_t, size_t> running;
+		int num_total (jobs.size() + num_resumed);
+		int num_done (0);
+		int num_failed (0);
+		double start (Now());
+
+		while(!pending.empty() || !running.empty()){
+
+			if(!pending.empty() && (int) running.size() < num_workers){
+				size_t j (pending.front());
+				pending.pop_front();
+				++jobs[j].attempts;
+				running[Launch(jobs[j], "")] = j;
+				continue;
+			}
+
+			int status;
+			pid_t pid (wait(&status));
+			if(pid < 0) break;
+			std::map<pid_t, size_t>::iterator worker (running.find(pid));
+			if(worker == running.end()) continue;
+			BatchJob &job = jobs[worker->second];
+			running.erase(worker);
+
+			int succeeded (WIFEXITED(status) && WEXITSTATUS(status) == 0 && Record(job));
+			if(succeeded){
+				++num_done;
+			} else if(job.attempts <= max_retries){
+				printf("%s WARNING: job of line %d failed (attempt %d), retrying\n", LOG_LVL2, job.line, job.attempts);
+				pending.push_back(&job - &jobs[0]);
+				continue;
+			} else {
+				++num_failed;
+				remove(TemporaryOutput(job).c_str());
+				printf("%s ERROR: job of line %d failed %d times\n", LOG_LVL2, job.line, job.attempts);
+			}
+
+			double elapsed (Now() - start);
+			double jobs_per_hour (elapsed > 0 ? 3600.0 * num_done / elapsed : 0);
+			int num_left (jobs.size() - num_done - num_failed);
+			printf("%s [%d/%d] line %d %s | %.1f jobs/h | ETA %.1f min\n", LOG_LVL1, num_resumed + num_done + num_failed,
+				num_total, job.line, succeeded ? "done" : "FAILED", jobs_per_hour,
+				jobs_per_hour > 0 ? 60.0 * num_left / jobs_per_hour : 0.0);
+		}
+
+		double elapsed (Now() - start);
+		printf("%s BATCH FINISHED: %d jobs done, %d resumed, %d failed in %.1f s (%.1f jobs/h)\n", LOG_LVL1,
+			num_done, num_resumed, num_failed, elapsed, elapsed > 0 ? 3600.0 * num_done / elapsed : 0.0);
+		return num_failed;
+	}
+};
+
+int main(int argc, char *argv[]){
+
+	BatchRunner runner;
+	runner.simulator = BATCH_DEFAULT_SIMULATOR;
+	runner.num_workers = 0;
+	runner.max_retries = BATCH_DEFAULT_RETRIES;
+
+	// Options (before the job list)
+	int arg_ix (1);
+	for(; arg_ix < argc && strncmp(argv[arg_ix], "--", 2) == 0; ++arg_ix){
+		const char *argument (argv[arg_ix]);
+		if(strncmp(argument, "--jobs=", 7) == 0) runner.num_workers = atoi(argument + 7);
+		else if(strncmp(argument, "--retries=", 10) == 0) runner.max_retries = atoi(argument + 10);
+		else if(strncmp(argument, "--simulator=", 12) == 0) runner.simulator = argument + 12;
+		else if(strncmp(argument, "--scenario_cache=", 17) == 0) runner.scenario_cache = argument + 17;
+		else if(strncmp(argument, "--logs=", 7) == 0) runner.logs_directory = argument + 7;
+		else {
+			printf("ERROR: unknown option %s\n", argument);
+			return -1;
+		}
+	}
+
+	if(argc - arg_ix != 2){
+		printf("ERROR: Console arguments were not set properly!\n"
+			" + Usage: ./komondor_batch [--jobs=<N>] [--retries=<N>] [--simulator=<path>] [--scenario_cache=<dir>]"
+			" [--logs=<dir>] <job_list> <output_file>\n"
+			"   Each job line holds the arguments of the simulator, %s standing for its script output file\n",
+			BATCH_OUTPUT_TOKEN);
+		return -1;
+	}
+	runner.output_filename = argv[arg_ix + 1];
+	if(runner.num_workers <= 0) runner.num_workers = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	if(runner.num_workers <= 0) runner.num_workers = 1;
+	if(!runner.logs_directory.empty()) mkdir(runner.logs_directory.c_str(), 0755);
+	if(!runner.scenario_cache.empty()) mkdir(runner.scenario_cache.c_str(), 0755);
+
+	std::vector<BatchJob> all_jobs;
+	ReadJobs(argv[arg_ix], all_jobs);
+
+	// Resume: skip the jobs already in the output file
+	std::set<std::string> done_keys;
+	ReadDoneJobs(runner.output_filename.c_str(), done_keys);
+	std::vector<BatchJob> jobs;
+	for(size_t j = 0; j < all_jobs.size(); ++j) if(done_keys.find(all_jobs[j].key) == done_keys.end()) jobs.push_back(all_jobs[j]);
+	int num_resumed (all_jobs.size() - jobs.size());
+
+	printf("%s BATCH '%s': %d jobs (%d already done), %d workers\n", LOG_LVL1, argv[arg_ix], (int) all_jobs.size(),
+		num_resumed, runner.num_workers);
+
+	if(!runner.scenario_cache.empty() && !jobs.empty()) runner.CompileScenarios(jobs);
+
+	int num_failed (runner.Run(jobs, num_resumed));
+	return num_failed == 0 ? 0 : -1;
+}
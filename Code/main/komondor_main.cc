@@ -53,6 +53,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
 #include <vector>
 #include <map>
 #include <string>     // std::string, std::to_string
@@ -62,16 +65,26 @@
 #include "../structures/logical_nack.h"
 #include "../structures/notification.h"
 #include "../structures/wlan.h"
+#include "../structures/csv_file.h"
+#include "../structures/scenario_file.h"
+#include "../structures/scenario_generator.h"
+#include "../structures/sweep.h"
+#include "../structures/result_cache.h"
+#include "../structures/mobility.h"
+#include "../structures/node_order.h"
+#include "../structures/analytical_model.h"
 
 #include "../methods/output_generation_methods.h"
+#include "../methods/analytical_methods.h"
 
 #include "node.h"
 #include "traffic_generator.h"
 #include "agent.h"
 #include "central_controller.h"
+#include "metrics_sampler.h"
+#include "mobility_manager.h"
 
 int total_nodes_number;			// Total number of nodes
-char* tmp_nodes;
 
 /* Sequential simulation engine from where the system to be simulated is derived. */
 component Komondor : public CostSimEng {
@@ -88,14 +101,25 @@ component Komondor : public CostSimEng {
 		void InputChecker();
 
 		void SetupEnvironmentByReadingInputFile(const char *system_filename);
+		void SetupEnvironment(const SystemRecord &system_record);
 		void GenerateNodesByReadingInputFile(const char *nodes_filename);
+		void GenerateNodes(const NodeRecord *node_records);
+		void RenumberNodes();
+		Wlan *RestoreOriginalNodeIds(Configuration *configuration_per_node);
+		void ComputePathGains();
+		void SetupScenario(const char *system_filename, const char *nodes_filename);
+		void OpenComponentLogs();
+		void CloseOutputFiles();
+		void CloseScriptOutput();
+
+		int RunSweep();
+		int ApplySweepPoint(int point);
+		void UpdateReceivedPowerFrom(int node_ix);
+		void RunAnalyticalModel();
 
 		void GenerateAgents(const char *agents_filename);
 		void GenerateCentralController(const char *agents_filename);
 
-		int GetNumOfLines(const char *nodes_filename);
-		int GetNumOfNodes(const char *nodes_filename, int node_type, std::string wlan_code);
-
 		void PrintSystemInfo();
 		void PrintAllWlansInfo();
 		void PrintAllAgentsInfo();
@@ -124,6 +148,7 @@ component Komondor : public CostSimEng {
 		int save_agent_logs;				// Flag for activating the log writting of agents
 		int print_agent_logs;				// Flag for activating the printing of agent logs
 		double simulation_time_komondor;	// Simulation time [s]
+		ResultKey result_key;				// Key of the results in the result cache (if entered per console)
 
 		// Parameters entered via system file
 		int num_channels_komondor;		// Number of subchannels composing the whole channel
@@ -142,6 +167,10 @@ component Komondor : public CostSimEng {
 		int collisions_model;			// Collisions model
 		double constant_per;			// Constant PER for successful transmissions
 		int traffic_model;				// Traffic model (0: full buffer, 1: poisson, 2: deterministic)
+		int burst_size_model;			// Burst size distribution (only for TRAFFIC_POISSON_BURST)
+		double burst_size;				// Average number of packets per burst (only for TRAFFIC_POISSON_BURST)
+		std::string per_tables_filename;	// SINR-to-PER tables file (only for CE_LINK_ABSTRACTION, empty: analytical)
+		int log_writer_mode;			// Log writing (0: synchronous, 1: asynchronous blocking, 2: asynchronous dropping)
 		int backoff_type;				// Type of Backoff (0: Slotted 1: Continuous)
 		int cw_adaptation;				// CW adaptation (0: constant, 1: bineary exponential backoff)
 		int pifs_activated;				// PIFS mechanism activation
@@ -165,6 +194,11 @@ component Komondor : public CostSimEng {
 		// Central controller info
 		CentralController[] central_controller;
 
+		// Periodic metrics sampler (only generated if --metrics_interval is entered per console)
+		MetricsSampler[] metrics_sampler;
+		// Mobility manager (only generated if --mobility_interval is entered per console)
+		MobilityManager[] mobility_manager;
+
 	// Private items
 	private:
 
@@ -176,11 +210,19 @@ component Komondor : public CostSimEng {
 		const char *agents_input_filename;	// Filename of the agents input CSV
 		FILE *simulation_output_file;		// File for the output logs (including statistics)
 		FILE *script_output_file;			// File for the whole input files included in the script TODO
+		std::string script_output_path;		// Filename of the script output file
+		char *point_script_output;			// Script output of a sweep point (in memory until it is appended)
+		size_t point_script_output_length;
 		Logger logger_simulation;			// Logger for the simulation output file
 		Logger logger_script;				// Logger for the script file (containing 1+ simulations) Readable version
 
+		// Input records (kept to compile the scenario) and compiled scenario (if loaded)
+		SystemRecord system_record;
+		std::vector<NodeRecord> node_records;
+		ScenarioFile scenario_file;
+
 		// Auxiliar variables
-		int first_line_skiped_flag;		// Flag for skipping first informative line of input file
+		CsvFile agents_file;			// Agents input CSV (read by GenerateAgents, reused by GenerateCentralController)
 		int central_controller_flag; 	// In order to allow the generation of the central controller
 
 };
@@ -214,8 +256,7 @@ void Komondor :: Setup(double sim_time_console, int save_system_logs_console, in
 	print_agent_logs = print_agent_logs_console;
 	nodes_input_filename = nodes_input_filename_console;
 	agents_input_filename = agents_input_filename_console;
-	std::string simulation_code;
-	simulation_code.append(ToString(simulation_code_console));
+	simulation_code = ToString(simulation_code_console);
 	seed = seed_console;
 	agents_enabled = agents_enabled_console;
 	total_wlans_number = 0;
@@ -243,61 +284,21 @@ void Komondor :: Setup(double sim_time_console, int save_system_logs_console, in
 	logger_simulation.file = simulation_output_file;
 
 	// Script output (Readable)
+	script_output_path = script_output_filename;
+	point_script_output = NULL;
 	script_output_file = fopen(script_output_filename, "at");	// Script output is removed when script is executed
 	logger_script.save_logs = SAVE_LOG;
 	logger_script.file = script_output_file;
-	fprintf(logger_script.file, "%s KOMONDOR SIMULATION '%s' (seed %d)", LOG_LVL1, simulation_code.c_str(), seed);
-
-	// Read system (environment) file
-	SetupEnvironmentByReadingInputFile(system_input_filename);
-
-	// Generate nodes
-	GenerateNodesByReadingInputFile(nodes_input_filename);
-
-	// Compute distance of each pair of nodes
-	for(int i = 0; i < total_nodes_number; ++i) {
-		node_container[i].distances_array = new double[total_nodes_number];
-		node_container[i].received_power_array = new double[total_nodes_number];
-		for(int j = 0; j < total_nodes_number; ++j) {
-			// Compute and assign distances for each other node
-			node_container[i].distances_array[j] = ComputeDistance(node_container[i].x,node_container[i].y,
-				node_container[i].z,node_container[j].x,node_container[j].y,node_container[j].z);
-			// Compute and assign the received power from each other node
-			if(i == j) {
-				node_container[i].received_power_array[j] = 0;
-			} else {
-				node_container[i].received_power_array[j] = ComputePowerReceived(node_container[i].distances_array[j],
-					node_container[j].tx_power_default, node_container[j].tx_gain, node_container[i].rx_gain,
-					node_container[i].central_frequency, path_loss_model);
-			}
-		}
+	if (sweep_config.filename.empty() && !scenario_cache_config.compile_only) {
+		fprintf(logger_script.file, "%s KOMONDOR SIMULATION '%s' (seed %d)", LOG_LVL1, simulation_code.c_str(), seed);
 	}
 
-	// Compute the maximum power received from each WLAN
-	for(int i = 0; i < total_nodes_number; ++i) {
-		double max_power_received_per_wlan;
-		if (node_container[i].node_type == NODE_TYPE_AP) {
-			node_container[i].max_received_power_in_ap_per_wlan = new double[total_wlans_number];
-			for(int j = 0; j < total_wlans_number; ++j) {
-				if (strcmp(node_container[i].wlan_code.c_str(),wlan_container[j].wlan_code.c_str()) == 0) {
-					// Same WLAN
-					node_container[i].max_received_power_in_ap_per_wlan[j] = 0;
-				} else {
-					// Different WLAN
-					max_power_received_per_wlan = -1000;
-					for (int k = 0; k < total_nodes_number; ++k) {
-						// Check only nodes in WLAN "j"
-						if(strcmp(node_container[k].wlan_code.c_str(),wlan_container[j].wlan_code.c_str()) == 0) {
-							if (node_container[i].received_power_array[k] > max_power_received_per_wlan) {
-								max_power_received_per_wlan = node_container[i].received_power_array[k];
-							}
-						}
-					}
-					node_container[i].max_received_power_in_ap_per_wlan[j] = max_power_received_per_wlan;
-				}
-			}
-		}
-	}
+	// Sharded log sink receiving node, agent and central controller logs
+	if (!scenario_cache_config.compile_only && sweep_config.filename.empty()) OpenComponentLogs();
+
+	// Read the system and nodes files (or their compiled scenario) and generate the nodes
+	SetupScenario(system_input_filename, nodes_input_filename);
+	if (scenario_cache_config.compile_only) return;
 
 	// Generate agents
 	central_controller_flag = 0;
@@ -306,6 +307,40 @@ void Komondor :: Setup(double sim_time_console, int save_system_logs_console, in
 
 	if (agents_enabled && central_controller_flag) { GenerateCentralController(agents_input_filename); }
 
+	// Generate the metrics sampler
+	if (metrics_sampler_config.sampling_interval > 0) {
+		// Despite we only have a single sampler, it must be declared as an array,
+		// in order to properly perform inport & outport connections
+		metrics_sampler.SetSize(1);
+		metrics_sampler[0].sampling_interval = metrics_sampler_config.sampling_interval;
+		metrics_sampler[0].metrics_filename = metrics_sampler_config.filename.empty() ?
+			"../output/metrics_" + simulation_code + ".csv" : metrics_sampler_config.filename;
+		metrics_sampler[0].total_nodes_number = total_nodes_number;
+		metrics_sampler[0].total_agents_number = agents_enabled ? total_agents_number : 0;
+	}
+
+	// Generate the mobility manager
+	if (mobility_config.interval > 0) {
+		mobility_manager.SetSize(1);
+		MobilityManager &manager = mobility_manager[0];
+		manager.interval = mobility_config.interval;
+		manager.speed = mobility_config.speed;
+		manager.fraction = mobility_config.fraction;
+		manager.radius = mobility_config.radius;
+		manager.total_nodes_number = total_nodes_number;
+		manager.wlan_container = wlan_container;
+		for (int n = 0; n < total_nodes_number; ++n) {
+			const Node &node = node_container[n];
+			manager.x.push_back(node.x);
+			manager.y.push_back(node.y);
+			manager.z.push_back(node.z);
+			manager.tx_power.push_back(node.tx_power_default);
+			manager.tx_gain.push_back(node.tx_gain);
+			manager.wlan_ix.push_back(node.wlan.wlan_id);
+			manager.ap_id.push_back(node.node_type == NODE_TYPE_STA ? wlan_container[node.wlan.wlan_id].ap_id : NODE_ID_NONE);
+		}
+	}
+
 	if (print_system_logs) {
 		printf("%s System configuration: \n", LOG_LVL2);
 		PrintSystemInfo();
@@ -352,6 +387,14 @@ void Komondor :: Setup(double sim_time_console, int save_system_logs_console, in
 
 		connect traffic_generator_container[n].outportNewPacketGenerated,node_container[n].InportNewPacketGenerated;
 
+		if (metrics_sampler_config.sampling_interval > 0) {
+			connect metrics_sampler[0].outportRequestMetrics,node_container[n].InportMetricsRequested;
+		}
+
+		if (mobility_config.interval > 0) {
+			connect mobility_manager[0].outportNodesMoved,node_container[n].InportNodesMoved;
+		}
+
 		for(int m=0; m < total_nodes_number; ++m) {
 
 			connect node_container[n].outportSelfStartTX,node_container[m].InportSomeNodeStartTX;
@@ -391,6 +434,9 @@ void Komondor :: Setup(double sim_time_console, int save_system_logs_console, in
 	// Connect the agents to the central controller, if applicable
 	if (agents_enabled) {
 		for(int w = 0; w < total_agents_number; ++w){
+			if (metrics_sampler_config.sampling_interval > 0) {
+				connect metrics_sampler[0].outportRequestMetrics,agent_container[w].InportMetricsRequested;
+			}
 			if(agent_container[w].communication_level ==  PURE_CENTRALIZED ||
 				agent_container[w].communication_level == HYBRID_CENTRALIZED_DECENTRALIZED) {
 				connect central_controller[0].outportRequestInformationToAgent,agent_container[w].InportReceivingRequestFromController;
@@ -417,34 +463,142 @@ void Komondor :: Stop(){
 
 	printf("%s STOP KOMONDOR SIMULATION '%s' (seed %d)", LOG_LVL1, simulation_code.c_str(), seed);
 
-	// Display (in logs and files) statistics of the simulation
+	// Display (in logs and files) statistics of the simulation (renumbered nodes in the order of the nodes file)
 	Performance *performance_per_node = new Performance[total_nodes_number];
 	Configuration *configuration_per_node = new Configuration[total_nodes_number];
-	for (int i = 0; i < total_nodes_number; ++i) {
-		performance_per_node[i] = node_container[i].simulation_performance;
-		configuration_per_node[i] = node_container[i].configuration;
+	for (int k = 0; k < total_nodes_number; ++k) {
+		performance_per_node[k] = node_container[NodeIdInOriginalOrder(k)].simulation_performance;
+		configuration_per_node[k] = node_container[NodeIdInOriginalOrder(k)].configuration;
 	}
+	Wlan *wlan_results (wlan_container);
+	if (!original_node_ids.empty()) wlan_results = RestoreOriginalNodeIds(configuration_per_node);
 
-	// Print and write global statistics
-	PrintAndWriteSimulationStatistics(print_system_logs, save_system_logs, logger_simulation,
-		performance_per_node, configuration_per_node, total_nodes_number, total_wlans_number,
-		frame_length, max_num_packets_aggregated, simulation_time_komondor);
+	// Compute the global statistics of this simulation
+	SimulationResults simulation_results(performance_per_node, configuration_per_node, wlan_results,
+		total_nodes_number, total_wlans_number, frame_length, max_num_packets_aggregated, simulation_time_komondor);
 
-	// Generate the output for scripts
-	int simulation_index (13);	// Choose the simulation index (TODO: change the way the simulation index is introduced by the user)
-	GenerateScriptOutput(simulation_index, performance_per_node, configuration_per_node, logger_script,
-		total_wlans_number, total_nodes_number, frame_length, max_num_packets_aggregated,
-		wlan_container, simulation_time_komondor);
+	// Print and write global statistics
+	PrintAndWriteSimulationStatistics(print_system_logs, save_system_logs, logger_simulation, simulation_results);
+
+	// Generate the output for scripts (schema entered per console or legacy layout). With the result cache,
+	// the output is generated in memory first, in order to store it
+	CachedResult cached_result;
+	char *script_output_buffer (NULL);
+	size_t script_output_length (0);
+	Logger logger_script_output (logger_script);
+	if (!result_cache.directory.empty()) {
+		logger_script_output.file = open_memstream(&script_output_buffer, &script_output_length);
+	}
+	if (!output_schema.entries.empty()) {
+		output_schema.Write(logger_script_output.file, simulation_results);
+	} else {
+		GenerateScriptOutput(output_schema.script_output_index, simulation_results, logger_script_output);
+	}
+	if (!result_cache.directory.empty()) {
+		fclose(logger_script_output.file);
+		cached_result.script_output.assign(script_output_buffer, script_output_length);
+		free(script_output_buffer);
+		fwrite(cached_result.script_output.data(), 1, cached_result.script_output.size(), logger_script.file);
+	}
 
 	// End of logs
-	fclose(simulation_output_file);
-	fclose(script_output_file);
+	CloseOutputFiles();
+
+	if (!result_cache.directory.empty()) {
+		cached_result.console_log = ReadWholeFile("../output/logs_console_" + simulation_code + ".txt");
+		result_cache.Store(result_key, cached_result);
+	}
 
 	printf("%s SIMULATION '%s' FINISHED\n", LOG_LVL1, simulation_code.c_str());
 	printf("------------------------------------------\n");
 
 };
 
+/*
+ * CloseComponentLogsAtExit(): appends the logs still pending when exiting with the log sink open (e.g., exit(-1))
+ */
+void CloseComponentLogsAtExit() {
+	async_log_writer.Stop();
+	log_sink.Close();
+}
+
+/*
+ * OpenComponentLogs(): opens the sharded log sink of the current simulation code if node or agent logs are saved
+ */
+void Komondor :: OpenComponentLogs() {
+	static int exit_handler_registered (FALSE);
+	if (!(save_node_logs || (agents_enabled && save_agent_logs))) return;
+	if (!exit_handler_registered) {
+		atexit(CloseComponentLogsAtExit);
+		exit_handler_registered = TRUE;
+	}
+	log_sink.Open("../output/logs_output_" + simulation_code);
+}
+
+/*
+ * CloseOutputFiles(): flushes the logs still queued in the asynchronous writer, closes the log sink
+ * and the console and script output files
+ */
+void Komondor :: CloseOutputFiles() {
+	async_log_writer.Stop();
+	log_sink.Close();
+	fclose(simulation_output_file);
+	CloseScriptOutput();
+}
+
+/*
+ * CloseScriptOutput(): closes the script output. The output of a sweep point, built in memory, is
+ * appended to the script output file with a single write, so that concurrent points never interleave
+ */
+void Komondor :: CloseScriptOutput() {
+	fclose(script_output_file);
+	if (point_script_output == NULL) return;
+	int fd (open(script_output_path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644));
+	if (fd < 0 || write(fd, point_script_output, point_script_output_length) != (ssize_t) point_script_output_length) {
+		printf("%sERROR: script output file '%s' could not be written\n", LOG_LVL1, script_output_path.c_str());
+		exit(-1);
+	}
+	close(fd);
+	free(point_script_output);
+	point_script_output = NULL;
+}
+
+/*
+ * RestoreOriginalNodeIds(): writes the original ids of the renumbered nodes in the results. The power
+ * received by each node is reordered in place, as the simulation is over.
+ * Input arguments:
+ * - configuration_per_node: configuration of each node, in the order of the nodes file
+ * Output:
+ * - copy of the WLANs with the original ids of their nodes
+ */
+Wlan *Komondor :: RestoreOriginalNodeIds(Configuration *configuration_per_node) {
+
+	for (int k = 0; k < total_nodes_number; ++k) {
+		configuration_per_node[k].capabilities.node_id = k;
+		configuration_per_node[k].capabilities.destination_id =
+			OriginalNodeId(configuration_per_node[k].capabilities.destination_id);
+	}
+
+	std::vector<double> received_power (total_nodes_number);
+	for (int i = 0; i < total_nodes_number; ++i) {
+		double *received_power_array (node_container[i].simulation_performance.received_power_array);
+		if (received_power_array == NULL) continue;
+		for (int k = 0; k < total_nodes_number; ++k) received_power[k] = received_power_array[NodeIdInOriginalOrder(k)];
+		std::copy(received_power.begin(), received_power.end(), received_power_array);
+	}
+
+	Wlan *wlan_results = new Wlan[total_wlans_number];
+	for (int w = 0; w < total_wlans_number; ++w) {
+		wlan_results[w] = wlan_container[w];
+		wlan_results[w].ap_id = OriginalNodeId(wlan_container[w].ap_id);
+		wlan_results[w].SetSizeOfSTAsArray(wlan_container[w].num_stas);
+		for (int s = 0; s < wlan_container[w].num_stas; ++s) {
+			wlan_results[w].list_sta_id[s] = OriginalNodeId(wlan_container[w].list_sta_id[s]);
+		}
+	}
+	return wlan_results;
+}
+
 /*
  * InputChecker(): identifies critical issues regarding the introduced input
  */
@@ -464,6 +618,20 @@ void Komondor :: InputChecker(){
 
 	if (print_system_logs) printf("%s Validating input files...\n", LOG_LVL2);
 
+	// Check the burst size configuration (only used by TRAFFIC_POISSON_BURST)
+	if (traffic_model == TRAFFIC_POISSON_BURST && (burst_size < 1
+			|| burst_size_model < BURST_SIZE_DETERMINISTIC || burst_size_model > BURST_SIZE_UNIFORM)) {
+		printf("\nERROR: burst size is not properly configured (burst_size_model = %d, burst_size = %f)\n\n",
+				burst_size_model, burst_size);
+		exit(-1);
+	}
+
+	// Check the log writer mode
+	if (log_writer_mode < LOG_WRITER_SYNC || log_writer_mode > LOG_WRITER_ASYNC_DROP) {
+		printf("\nERROR: log_writer_mode = %d is not valid\n\n", log_writer_mode);
+		exit(-1);
+	}
+
 	for (int i = 0; i < total_nodes_number; ++i) {
 
 		nodes_ids[i] = node_container[i].node_id;
@@ -479,7 +647,7 @@ void Komondor :: InputChecker(){
 					"node_container[i].tx_power_min = %f\n"
 					"node_container[i].tx_power_default = %f\n"
 					"node_container[i].tx_power_max = %f\n\n",
-					i+2, node_container[i].tx_power_min, node_container[i].tx_power_default, node_container[i].tx_power_max);
+					OriginalNodeId(i)+2, node_container[i].tx_power_min, node_container[i].tx_power_default, node_container[i].tx_power_max);
 			exit(-1);
 		}
 
@@ -487,7 +655,7 @@ void Komondor :: InputChecker(){
 		if (node_container[i].sensitivity_min > node_container[i].sensitivity_max
 				|| node_container[i].sensitivity_default > node_container[i].sensitivity_max
 				|| node_container[i].sensitivity_default < node_container[i].sensitivity_min) {
-			printf("\nERROR: pd values are not properly configured at node in line %d\n\n",i+2);
+			printf("\nERROR: pd values are not properly configured at node in line %d\n\n",OriginalNodeId(i)+2);
 			exit(-1);
 		}
 
@@ -498,7 +666,7 @@ void Komondor :: InputChecker(){
 				|| node_container[i].current_primary_channel > num_channels_komondor
 				|| node_container[i].min_channel_allowed > (num_channels_komondor-1)
 				|| node_container[i].max_channel_allowed > (num_channels_komondor-1)) {
-			printf("\nERROR: Channels are not properly configured at node in line %d\n\n",i+2);
+			printf("\nERROR: Channels are not properly configured at node in line %d\n\n",OriginalNodeId(i)+2);
 			exit(-1);
 		}
 	}
@@ -507,12 +675,12 @@ void Komondor :: InputChecker(){
 		for (int j = 0; j < total_nodes_number; ++j) {
 			// Node IDs must be different
 			if(i!=j && nodes_ids[i] == nodes_ids[j] && i < j) {
-				printf("\nERROR: Nodes in lines %d and %d have the same ID\n\n",i+2,j+2);
+				printf("\nERROR: Nodes in lines %d and %d have the same ID\n\n",OriginalNodeId(i)+2,OriginalNodeId(j)+2);
 				exit(-1);
 			}
 			// The position of nodes must be different
 			if(i!=j && nodes_x[i] == nodes_x[j] && nodes_y[i] == nodes_y[j] && nodes_z[i] == nodes_z[j] && i < j) {
-				printf("%s nERROR: Nodes in lines %d and %d are exactly at the same position\n\n", LOG_LVL2, i+2,j+2);
+				printf("%s nERROR: Nodes in lines %d and %d are exactly at the same position\n\n", LOG_LVL2, OriginalNodeId(i)+2,OriginalNodeId(j)+2);
 				exit(-1);
 			}
 		}
@@ -523,127 +691,132 @@ void Komondor :: InputChecker(){
 }
 
 /*
- * SetupEnvironmentByReadingInputFile(): sets up the Komondor environment
+ * SetupScenario(): sets up the environment and generates the nodes, either from the input files or from
+ * their compiled scenario (if a cache directory is entered per console). Compiled scenarios also skip
+ * the computation of the path gains.
  * Input arguments:
  * - system_filename: system input filename
+ * - nodes_filename: nodes input filename
  */
-void Komondor :: SetupEnvironmentByReadingInputFile(const char *system_filename) {
+void Komondor :: SetupScenario(const char *system_filename, const char *nodes_filename) {
 
-	if (print_system_logs) printf("%s Reading system configuration file '%s'...\n", LOG_LVL1, system_filename);
 	fprintf(simulation_output_file, "%s KOMONDOR SIMULATION '%s' (seed %d)", LOG_LVL1, simulation_code.c_str(), seed);
 
-	FILE* stream_system = fopen(system_filename, "r");
-	if (!stream_system){
-		printf("%s Komondor system file '%s' not found!\n", LOG_LVL3, system_filename);
-		fprintf(simulation_output_file, "%s Komondor system file '%s' not found!\n", LOG_LVL3, system_filename);
-		exit(-1);
+	unsigned long long input_hash (0);
+	std::string scenario_path;
+	int scenario_loaded (FALSE);
+	if (!scenario_cache_config.directory.empty()) {
+		input_hash = ScenarioFile::InputHash(system_filename, nodes_filename, node_order_config.curve);
+		scenario_path = ScenarioFile::CachePath(scenario_cache_config.directory, input_hash);
+		scenario_loaded = scenario_file.Load(scenario_path.c_str(), input_hash);
+		if (print_system_logs) printf("%s Compiled scenario '%s' %s\n", LOG_LVL1, scenario_path.c_str(),
+			scenario_loaded ? "loaded" : "not found: reading the input files");
 	}
 
-	char line_system[CHAR_BUFFER_SIZE];
-	int first_line_skiped_flag (0);	// Flag for skipping first informative line of input file
+	// Read system (environment) file
+	if (scenario_loaded) SetupEnvironment(*scenario_file.system_record);
+	else SetupEnvironmentByReadingInputFile(system_filename);
+
+	// Build the SINR-to-PER tables shared by all the nodes
+	if (capture_effect_model == CE_LINK_ABSTRACTION) {
+		link_abstraction.Generate(frame_length);
+		if (!per_tables_filename.empty()) link_abstraction.LoadFromFile(per_tables_filename.c_str());
+		if (print_system_logs) printf("%s Link abstraction tables ready (%s)\n", LOG_LVL2,
+			per_tables_filename.empty() ? "analytical AWGN" : per_tables_filename.c_str());
+	}
 
-	while (fgets(line_system, CHAR_BUFFER_SIZE, stream_system)){
+	// Generate nodes
+	if (scenario_loaded) {
+		total_nodes_number = scenario_file.header->total_nodes_number;
+		GenerateNodes(scenario_file.node_records);
+	} else {
+		GenerateNodesByReadingInputFile(nodes_filename);
+	}
 
-		if(!first_line_skiped_flag){
+	if (scenario_loaded) {
+
+		// Path gains precomputed in the compiled scenario (APs are stored in node order)
+		int ap_ix (0);
+		for(int i = 0; i < total_nodes_number; ++i) {
+			node_container[i].distances_array = scenario_file.distances + (size_t) i * total_nodes_number;
+			node_container[i].received_power_array = scenario_file.received_power + (size_t) i * total_nodes_number;
+			if (node_container[i].node_type == NODE_TYPE_AP) {
+				node_container[i].max_received_power_in_ap_per_wlan =
+					scenario_file.max_received_power_per_wlan + (size_t) ap_ix * total_wlans_number;
+				++ap_ix;
+			}
+		}
 
-			first_line_skiped_flag = 1;
+	} else {
 
-		} else {
+		ComputePathGains();
 
-			char* tmp = strdup(line_system);
-
-			// Number of channels
-			tmp = strdup(line_system);
-			const char* num_channels_char (GetField(tmp, IX_NUM_CHANNELS));
-			num_channels_komondor = atoi(num_channels_char);
-
-			// Basic channel bandwidth
-			tmp = strdup(line_system);
-			const char* basic_channel_bandwidth_char (GetField(tmp, IX_BASIC_CH_BW));
-			basic_channel_bandwidth = atoi(basic_channel_bandwidth_char);
-
-			// Prob. distribution of backoff duration
-			tmp = strdup(line_system);
-			const char* pdf_backoff_char (GetField(tmp, IX_PDF_BACKOFF));
-			pdf_backoff = atoi(pdf_backoff_char);
-
-			// Prob. distribution of transmission duration
-			tmp = strdup(line_system);
-			const char* pdf_tx_time_char (GetField(tmp, IX_PDF_TX_TIME));
-			pdf_tx_time = atoi(pdf_tx_time_char);
-
-			// Data packet length
-			tmp = strdup(line_system);
-			const char* packet_length_char (GetField(tmp, IX_PACKET_LENGTH));
-			frame_length = atoi(packet_length_char);
-
-			// Number of packets aggregated in one transmission
-			tmp = strdup(line_system);
-			const char* num_packets_aggregated_char (GetField(tmp, IX_NUM_PACKETS_AGGREGATED));
-			max_num_packets_aggregated = atoi(num_packets_aggregated_char);
-
-			// Path loss model
-			tmp = strdup(line_system);
-			const char* path_loss_model_char (GetField(tmp, IX_PATH_LOSS));
-			path_loss_model = atoi(path_loss_model_char);
-
-			// capture_effect
-			tmp = strdup(line_system);
-			const char* capture_effect_char (GetField(tmp, IX_CAPTURE_EFFECT));
-			double capture_effect_db (atof(capture_effect_char));
-			capture_effect = ConvertPower(DB_TO_LINEAR, capture_effect_db);
-
-			// Noise level
-			tmp = strdup(line_system);
-			const char* noise_level_char (GetField(tmp, IX_NOISE_LEVEL));
-			double noise_level_dbm (atof(noise_level_char));
-			noise_level = ConvertPower(DBM_TO_PW, noise_level_dbm);
-
-			// Co-channel model
-			tmp = strdup(line_system);
-			const char* adjacent_channel_model_char (GetField(tmp, IX_COCHANNEL_MODEL));
-			adjacent_channel_model = atof(adjacent_channel_model_char);
-
-			// Collisions model
-			tmp = strdup(line_system);
-			const char* collisions_model_char (GetField(tmp, IX_COLLISIONS_MODEL));
-			collisions_model = atof(collisions_model_char);
-
-			// Constant PER for successful transmissions
-			tmp = strdup(line_system);
-			const char* constant_PER_char (GetField(tmp, IX_CONSTANT_PER));
-			constant_per = atof(constant_PER_char);
-
-			// Traffic model
-			tmp = strdup(line_system);
-			const char* traffic_model_char (GetField(tmp, IX_TRAFFIC_MODEL));
-			traffic_model = atoi(traffic_model_char);
-
-			// Backoff type
-			tmp = strdup(line_system);
-			const char* backoff_type_char (GetField(tmp, IX_BO_TYPE));
-			backoff_type = atoi(backoff_type_char);
-
-			// Contention window adaptation
-			tmp = strdup(line_system);
-			const char* cw_adaptation_char (GetField(tmp, IX_CW_ADAPTATION));
-			cw_adaptation = atoi(cw_adaptation_char);
-
-			// PIFS mechanism activation
-			tmp = strdup(line_system);
-			const char* pifs_activated_char (GetField(tmp, IX_PIFS_ACTIVATION));
-			pifs_activated = atoi(pifs_activated_char);
-
-			// PIFS mechanism activation
-			tmp = strdup(line_system);
-			const char* capture_effect_model_char (GetField(tmp, IX_CAPTURE_EFFECT_MODEL));
-			capture_effect_model = atoi(capture_effect_model_char);
-
-			free(tmp);
+		if (!scenario_path.empty()) {
+			std::vector<double*> distances (total_nodes_number), received_power (total_nodes_number),
+				max_received_power_per_wlan (total_nodes_number);
+			for(int i = 0; i < total_nodes_number; ++i) {
+				distances[i] = node_container[i].distances_array;
+				received_power[i] = node_container[i].received_power_array;
+				max_received_power_per_wlan[i] = (node_container[i].node_type == NODE_TYPE_AP) ?
+					node_container[i].max_received_power_in_ap_per_wlan : NULL;
+			}
+			ScenarioFile::Write(scenario_path.c_str(), input_hash, system_record, node_records, total_wlans_number,
+				distances.data(), received_power.data(), max_received_power_per_wlan.data());
+			if (print_system_logs) printf("%s Compiled scenario written to '%s'\n", LOG_LVL2, scenario_path.c_str());
 		}
 	}
+}
 
-	fclose(stream_system);
+/*
+ * SetupEnvironmentByReadingInputFile(): sets up the Komondor environment
+ * Input arguments:
+ * - system_filename: system input filename
+ */
+void Komondor :: SetupEnvironmentByReadingInputFile(const char *system_filename) {
+
+	if (print_system_logs) printf("%s Reading system configuration file '%s'...\n", LOG_LVL1, system_filename);
+
+	if (access(system_filename, R_OK) != 0){
+		printf("%s Komondor system file '%s' not found!\n", LOG_LVL3, system_filename);
+		fprintf(simulation_output_file, "%s Komondor system file '%s' not found!\n", LOG_LVL3, system_filename);
+		exit(-1);
+	}
+
+	CsvFile system_file;
+	system_file.Load(system_filename);
+	for (int row = 0; row < system_file.NumRows(); ++row) system_record.ReadFromCsv(system_file, row);
+
+	SetupEnvironment(system_record);
+}
+
+/*
+ * SetupEnvironment(): sets up the Komondor environment from the parameters of the system file
+ * Input arguments:
+ * - system_record: parameters of the system file
+ */
+void Komondor :: SetupEnvironment(const SystemRecord &system_record) {
+
+	num_channels_komondor = system_record.num_channels;
+	basic_channel_bandwidth = system_record.basic_channel_bandwidth;
+	pdf_backoff = system_record.pdf_backoff;
+	pdf_tx_time = system_record.pdf_tx_time;
+	frame_length = system_record.frame_length;
+	max_num_packets_aggregated = system_record.max_num_packets_aggregated;
+	path_loss_model = system_record.path_loss_model;
+	capture_effect = ConvertPower(DB_TO_LINEAR, system_record.capture_effect_db);
+	noise_level = ConvertPower(DBM_TO_PW, system_record.noise_level_dbm);
+	adjacent_channel_model = system_record.adjacent_channel_model;
+	collisions_model = system_record.collisions_model;
+	constant_per = system_record.constant_per;
+	traffic_model = system_record.traffic_model;
+	backoff_type = system_record.backoff_type;
+	cw_adaptation = system_record.cw_adaptation;
+	pifs_activated = system_record.pifs_activated;
+	capture_effect_model = system_record.capture_effect_model;
+	burst_size_model = system_record.burst_size_model;
+	burst_size = system_record.burst_size;
+	per_tables_filename = system_record.per_tables_filename;
+	log_writer_mode = system_record.log_writer_mode;
 }
 
 /* *******************
@@ -654,7 +827,7 @@ void Komondor :: SetupEnvironmentByReadingInputFile(const char *system_filename)
 /*
  * GenerateNodesByReadingInputFile(): generates the nodes deterministically, according to the input nodes file.
  * Input arguments:
- * - nodes_filename: input nodes filename
+ * - nodes_filename: input nodes filename, or a generator spec ("generate:...", see structures/scenario_generator.h)
  */
 void Komondor :: GenerateNodesByReadingInputFile(const char *nodes_filename) {
 
@@ -662,538 +835,699 @@ void Komondor :: GenerateNodesByReadingInputFile(const char *nodes_filename) {
 	if (save_system_logs) fprintf(simulation_output_file, "%s Generating nodes DETERMINISTICALLY...\n", LOG_LVL1);
 
 
-	if (print_system_logs) printf("%s Reading nodes input file '%s'...\n", LOG_LVL2, nodes_filename);
+	if (IsScenarioGeneratorSpec(nodes_filename)) {
+		// Procedurally generated scenario: no nodes file
+		if (print_system_logs) printf("%s Generating scenario '%s'...\n", LOG_LVL2, nodes_filename);
+		GenerateScenario(nodes_filename, node_records);
+		total_nodes_number = node_records.size();
+	} else {
+		if (print_system_logs) printf("%s Reading nodes input file '%s'...\n", LOG_LVL2, nodes_filename);
+		CsvFile nodes_file;
+		nodes_file.Load(nodes_filename);
+		total_nodes_number = nodes_file.NumRows();
+		node_records.resize(total_nodes_number);
+		for (int node_ix = 0; node_ix < total_nodes_number; ++node_ix) node_records[node_ix].ReadFromCsv(nodes_file, node_ix);
+	}
 
-		total_wlans_number = GetNumOfNodes(nodes_filename, NODE_TYPE_AP, ToString(""));
+	for (int node_ix = 0; node_ix < total_nodes_number; ++node_ix) node_records[node_ix].original_node_id = node_ix;
+	if (node_order_config.curve != NODE_ORDER_FILE) RenumberNodes();
 
-		if (print_system_logs) printf("%s Num. of WLANs detected: %d\n", LOG_LVL3, total_wlans_number);
+	GenerateNodes(node_records.data());
+}
 
-		wlan_container = new Wlan[total_wlans_number];
+/*
+ * RenumberNodes(): renumbers the nodes along a space-filling curve of the positions of their APs, so that
+ * nodes close in space are also close in the per-node arrays. The members of each WLAN are kept adjacent
+ * (AP first, then its STAs in the order of the nodes file), and the original id of each node is kept in its
+ * record to be reported in the outputs and logs (see structures/node_order.h).
+ */
+void Komondor :: RenumberNodes() {
+
+	// Bounding box of the nodes
+	double min_position[3] = {INFINITY, INFINITY, INFINITY};
+	double max_position[3] = {-INFINITY, -INFINITY, -INFINITY};
+	for (int n = 0; n < total_nodes_number; ++n) {
+		double position[3] = {node_records[n].x, node_records[n].y, node_records[n].z};
+		for (int i = 0; i < 3; ++i) {
+			min_position[i] = std::min(min_position[i], position[i]);
+			max_position[i] = std::max(max_position[i], position[i]);
+		}
+	}
 
-		FILE* stream_nodes = fopen(nodes_filename, "r");
-		char line_nodes[CHAR_BUFFER_SIZE];
-		first_line_skiped_flag = 0;	// Flag for skipping first informative line of input file
-		int wlan_ix (0);			// Auxiliar wlan index
+	// One block per WLAN, placed at the position of its AP (or of its first node if it has no AP)
+	std::map<std::string, int> block_per_wlan;
+	std::vector<std::vector<int> > blocks;
+	std::vector<uint64_t> block_keys;
+	for (int n = 0; n < total_nodes_number; ++n) {
+		const NodeRecord &record = node_records[n];
+		double position[3] = {record.x, record.y, record.z};
+		std::map<std::string, int>::iterator block (block_per_wlan.find(record.wlan_code));
+		if (block == block_per_wlan.end()) {
+			block = block_per_wlan.insert(std::make_pair(std::string(record.wlan_code), (int) blocks.size())).first;
+			blocks.push_back(std::vector<int>());
+			block_keys.push_back(node_order_config.CurveKey(position, min_position, max_position));
+		}
+		std::vector<int> &members = blocks[block->second];
+		if (record.node_type == NODE_TYPE_AP) {
+			members.insert(members.begin(), n);
+			block_keys[block->second] = node_order_config.CurveKey(position, min_position, max_position);
+		} else {
+			members.push_back(n);
+		}
+	}
+
+	std::vector<int> block_order (blocks.size());
+	for (size_t b = 0; b < blocks.size(); ++b) block_order[b] = b;
+	std::stable_sort(block_order.begin(), block_order.end(),
+		[&block_keys](int a, int b) { return block_keys[a] < block_keys[b]; });
+
+	// Renumber the records (destination ids refer to the new ids)
+	std::vector<NodeRecord> renumbered_records;
+	std::vector<int> new_id (total_nodes_number);
+	renumbered_records.reserve(total_nodes_number);
+	for (size_t b = 0; b < block_order.size(); ++b) {
+		const std::vector<int> &members = blocks[block_order[b]];
+		for (size_t m = 0; m < members.size(); ++m) {
+			new_id[members[m]] = renumbered_records.size();
+			renumbered_records.push_back(node_records[members[m]]);
+		}
+	}
+	for (int n = 0; n < total_nodes_number; ++n) {
+		int &destination_id = renumbered_records[n].destination_id;
+		if (destination_id >= 0 && destination_id < total_nodes_number) destination_id = new_id[destination_id];
+	}
+	node_records.swap(renumbered_records);
+
+	if (print_system_logs) printf("%s Nodes renumbered along the %s curve (%d WLANs)\n", LOG_LVL2,
+		node_order_config.curve == NODE_ORDER_HILBERT ? "Hilbert" : "Morton", (int) blocks.size());
+}
 
-		// Identify WLANs
-		while (fgets(line_nodes, CHAR_BUFFER_SIZE, stream_nodes)){
+/*
+ * GenerateNodes(): generates the nodes and the WLANs
+ * Input arguments:
+ * - node_records: parameters of each node ([total_nodes_number])
+ */
+void Komondor :: GenerateNodes(const NodeRecord *node_records) {
 
-			if(!first_line_skiped_flag){
+	// Generate nodes (without wlan item) and gather the members of each WLAN in the same sweep
+	if (print_system_logs) printf("%s Generating nodes...\n", LOG_LVL3);
+	node_container.SetSize(total_nodes_number);
+	traffic_generator_container.SetSize(total_nodes_number);
 
-				first_line_skiped_flag = 1;
+	// Original ids of the renumbered nodes (see RenumberNodes())
+	std::vector<int> original_ids (total_nodes_number);
+	for (int node_ix = 0; node_ix < total_nodes_number; ++node_ix) original_ids[node_ix] = node_records[node_ix].original_node_id;
+	SetOriginalNodeIds(original_ids);
 
-			} else{
+	std::vector<std::string> wlan_codes;				// WLAN codes, in order of appearance of their APs
+	std::map<std::string, int> ap_id_per_wlan;			// AP of each WLAN code
+	std::map<std::string, std::vector<int> > sta_ids_per_wlan;	// STAs of each WLAN code
 
-				// Node type
-				tmp_nodes = strdup(line_nodes);
-				int node_type (atoi(GetField(tmp_nodes, IX_NODE_TYPE)));
+	for (int node_ix = 0; node_ix < total_nodes_number; ++node_ix) {
 
-				if(node_type == NODE_TYPE_AP){	// If node is AP
+		const NodeRecord &record = node_records[node_ix];
 
-					// WLAN ID
-					wlan_container[wlan_ix].wlan_id = wlan_ix;
+		// Node ID (auto-assigned)
+		node_container[node_ix].node_id = node_ix;
 
-					// WLAN code
-					tmp_nodes = strdup(line_nodes);
-					std::string wlan_code_aux = ToString(GetField(tmp_nodes, IX_WLAN_CODE));
-					wlan_container[wlan_ix].wlan_code = wlan_code_aux;
+		// Node code
+		node_container[node_ix].node_code = record.node_code;
 
-					++wlan_ix;
-					free(tmp_nodes);
+		// Node type
+		node_container[node_ix].node_type = record.node_type;
 
-				}
-			}
+		// WLAN code: add AP or STA ID to corresponding WLAN
+		std::string wlan_code (record.wlan_code);
+		node_container[node_ix].wlan_code = wlan_code;
+		if (record.node_type == NODE_TYPE_AP) {
+			if (ap_id_per_wlan.find(wlan_code) == ap_id_per_wlan.end()) wlan_codes.push_back(wlan_code);
+			ap_id_per_wlan[wlan_code] = node_ix;
+		} else if (record.node_type == NODE_TYPE_STA) {
+			sta_ids_per_wlan[wlan_code].push_back(node_ix);
 		}
 
-		// Get number of STAs in each WLAN
-		for(int w = 0; w < total_wlans_number; ++w){
-			int num_stas_in_wlan (GetNumOfNodes(nodes_filename, NODE_TYPE_STA, wlan_container[w].wlan_code));
-			wlan_container[w].num_stas = num_stas_in_wlan;
-			wlan_container[w].SetSizeOfSTAsArray(num_stas_in_wlan);
+		// Destination ID
+		node_container[node_ix].destination_id = record.destination_id;
+
+		// Position
+		node_container[node_ix].x = record.x;
+		node_container[node_ix].y = record.y;
+		node_container[node_ix].z = record.z;
+
+		// CW min and max stage
+		node_container[node_ix].cw_min = record.cw_min;
+		node_container[node_ix].cw_stage_max = record.cw_stage_max;
+
+		// Primary channel and channels allowed
+		node_container[node_ix].current_primary_channel = record.primary_channel;
+		node_container[node_ix].min_channel_allowed = record.min_channel_allowed;
+		node_container[node_ix].max_channel_allowed = record.max_channel_allowed;
+
+		// Tx power (min, default and max)
+		node_container[node_ix].tx_power_min = ConvertPower(DBM_TO_PW, record.tx_power_min_dbm);
+		node_container[node_ix].tx_power_default = ConvertPower(DBM_TO_PW, record.tx_power_default_dbm);
+		node_container[node_ix].tx_power_max = ConvertPower(DBM_TO_PW, record.tx_power_max_dbm);
+
+		// PD (min, default and max)
+		node_container[node_ix].sensitivity_min = ConvertPower(DBM_TO_PW, record.sensitivity_min_dbm);
+		node_container[node_ix].sensitivity_default = ConvertPower(DBM_TO_PW, record.sensitivity_default_dbm);
+		node_container[node_ix].sensitivity_max = ConvertPower(DBM_TO_PW, record.sensitivity_max_dbm);
+
+		// TX and RX gains
+		node_container[node_ix].tx_gain = ConvertPower(DB_TO_LINEAR, record.tx_gain_db);
+		node_container[node_ix].rx_gain = ConvertPower(DB_TO_LINEAR, record.rx_gain_db);
+
+		// Channel bonding model
+		node_container[node_ix].current_dcb_policy = record.dcb_policy;
+
+		// Default modulation
+		node_container[node_ix].modulation_default = record.modulation_default;
+
+		// Central frequency in GHz (e.g. 2.4)
+		node_container[node_ix].central_frequency = record.central_frequency_ghz * pow(10,9);
+
+		// IEEE protocol type
+		node_container[node_ix].ieee_protocol = record.ieee_protocol;
+
+		// System
+		node_container[node_ix].simulation_time_komondor = simulation_time_komondor;
+		node_container[node_ix].total_nodes_number = total_nodes_number;
+		node_container[node_ix].collisions_model = collisions_model;
+		node_container[node_ix].capture_effect = capture_effect;
+		node_container[node_ix].save_node_logs =
+			log_filter.NodeSelected(OriginalNodeId(node_ix)) ? save_node_logs : SAVE_LOG_NONE;
+		node_container[node_ix].print_node_logs = print_node_logs;
+		node_container[node_ix].basic_channel_bandwidth = basic_channel_bandwidth;
+		node_container[node_ix].num_channels_komondor = num_channels_komondor;
+		node_container[node_ix].adjacent_channel_model = adjacent_channel_model;
+		node_container[node_ix].default_destination_id = NODE_ID_NONE;
+		node_container[node_ix].noise_level = noise_level;
+		node_container[node_ix].constant_per = constant_per;
+		node_container[node_ix].pdf_backoff = pdf_backoff;
+		node_container[node_ix].path_loss_model = path_loss_model;
+		node_container[node_ix].pdf_tx_time = pdf_tx_time;
+		node_container[node_ix].frame_length = frame_length;
+		node_container[node_ix].max_num_packets_aggregated = max_num_packets_aggregated;
+		node_container[node_ix].ack_length = ack_length;
+		node_container[node_ix].rts_length = rts_length;
+		node_container[node_ix].cts_length = cts_length;
+		node_container[node_ix].traffic_model = traffic_model;
+		node_container[node_ix].burst_size_model = burst_size_model;
+		node_container[node_ix].burst_size = burst_size;
+		node_container[node_ix].log_writer_mode = log_writer_mode;
+		node_container[node_ix].backoff_type = backoff_type;
+		node_container[node_ix].cw_adaptation = cw_adaptation;
+		node_container[node_ix].pifs_activated = pifs_activated;
+		node_container[node_ix].capture_effect_model = capture_effect_model;
+		node_container[node_ix].simulation_code = simulation_code;
+
+		// SPATIAL REUSE parameters (BSS color, SRG, non-SRG OBSS_PD and SRG OBSS_PD)
+		if (record.spatial_reuse_enabled) { // Check if the input file is compliant with SR
+			node_container[node_ix].bss_color = record.bss_color;
+			node_container[node_ix].srg = record.srg;
+			node_container[node_ix].non_srg_obss_pd = ConvertPower(DBM_TO_PW, record.non_srg_obss_pd_dbm);
+			node_container[node_ix].srg_obss_pd = ConvertPower(DBM_TO_PW, record.srg_obss_pd_dbm);
+		} else {
+			node_container[node_ix].bss_color = -1;
+			node_container[node_ix].srg = -1;
+			node_container[node_ix].non_srg_obss_pd = -1;
+			node_container[node_ix].srg_obss_pd = -1;
 		}
 
-		// Generate nodes (without wlan item), finsih WLAN with ID lists, and set the wlan item of each STA.
-		if (print_system_logs) printf("%s Generating nodes...\n", LOG_LVL3);
-		total_nodes_number = GetNumOfNodes(nodes_filename, NODE_TYPE_UNKWNOW, ToString(""));
-		node_container.SetSize(total_nodes_number);
-		traffic_generator_container.SetSize(total_nodes_number);
+		// Traffic generator
+		traffic_generator_container[node_ix].node_type = record.node_type;
+		traffic_generator_container[node_ix].node_id = node_ix;
+		traffic_generator_container[node_ix].traffic_model = traffic_model;
+		traffic_generator_container[node_ix].traffic_load = record.traffic_load;
+		traffic_generator_container[node_ix].lambda = record.lambda;
+		traffic_generator_container[node_ix].burst_size = burst_size;
+	}
 
-		stream_nodes = fopen(nodes_filename, "r");
-		int node_ix (0);	// Auxiliar index for nodes
-		wlan_ix = 0;		// Auxiliar index for WLANs
-		first_line_skiped_flag = 0;
+	// Identify WLANs (one per AP). WLANs of renumbered nodes keep the order of their APs in the nodes file
+	if (!original_node_ids.empty()) {
+		std::stable_sort(wlan_codes.begin(), wlan_codes.end(), [&ap_id_per_wlan](const std::string &a, const std::string &b) {
+			return OriginalNodeId(ap_id_per_wlan[a]) < OriginalNodeId(ap_id_per_wlan[b]); });
+	}
+	total_wlans_number = wlan_codes.size();
+	if (print_system_logs) printf("%s Num. of WLANs detected: %d\n", LOG_LVL3, total_wlans_number);
+	wlan_container = new Wlan[total_wlans_number];
+	std::map<std::string, int> wlan_ix_per_code;
+	for (int w = 0; w < total_wlans_number; ++w) {
+		const std::vector<int> &sta_ids = sta_ids_per_wlan[wlan_codes[w]];
+		wlan_container[w].wlan_id = w;
+		wlan_container[w].wlan_code = wlan_codes[w];
+		wlan_container[w].ap_id = ap_id_per_wlan[wlan_codes[w]];
+		wlan_container[w].num_stas = sta_ids.size();
+		wlan_container[w].SetSizeOfSTAsArray(sta_ids.size());
+		for (size_t s = 0; s < sta_ids.size(); ++s) wlan_container[w].list_sta_id[s] = sta_ids[s];
+		wlan_ix_per_code[wlan_codes[w]] = w;
+	}
 
-		while (fgets(line_nodes, CHAR_BUFFER_SIZE, stream_nodes)){	// For each WLAN
+	// Set corresponding WLAN to each node
+	for (int n = 0; n < total_nodes_number; ++n) {
+		node_container[n].total_wlans_number = total_wlans_number;
+		std::map<std::string, int>::const_iterator wlan (wlan_ix_per_code.find(node_container[n].wlan_code));
+		if (wlan != wlan_ix_per_code.end()) node_container[n].wlan = wlan_container[wlan->second];
+	}
 
-			if(!first_line_skiped_flag){
+	if (print_system_logs) printf("%s Nodes generated!\n", LOG_LVL3);
+}
 
-				first_line_skiped_flag = 1;
+/*
+ * ComputePathGains(): computes the distance and the power received between each pair of nodes, and the
+ * maximum power received by each AP from each WLAN
+ */
+void Komondor :: ComputePathGains() {
 
+	// Compute distance of each pair of nodes
+	for(int i = 0; i < total_nodes_number; ++i) {
+		node_container[i].distances_array = new double[total_nodes_number];
+		node_container[i].received_power_array = new double[total_nodes_number];
+		for(int j = 0; j < total_nodes_number; ++j) {
+			// Compute and assign distances for each other node
+			node_container[i].distances_array[j] = ComputeDistance(node_container[i].x,node_container[i].y,
+				node_container[i].z,node_container[j].x,node_container[j].y,node_container[j].z);
+			// Compute and assign the received power from each other node
+			if(i == j) {
+				node_container[i].received_power_array[j] = 0;
 			} else {
+				node_container[i].received_power_array[j] = ComputePowerReceived(node_container[i].distances_array[j],
+					node_container[j].tx_power_default, node_container[j].tx_gain, node_container[i].rx_gain,
+					node_container[i].central_frequency, path_loss_model);
+			}
+		}
+	}
 
-				// Node ID (auto-assigned)
-				node_container[node_ix].node_id = node_ix;
-
-				// Node code
-				tmp_nodes = strdup(line_nodes);
-				std::string node_code = ToString(GetField(tmp_nodes, IX_NODE_CODE));
-				node_container[node_ix].node_code = node_code;
-
-				// Node type
-				tmp_nodes = strdup(line_nodes);
-				int node_type (atoi(GetField(tmp_nodes, IX_NODE_TYPE)));
-				node_container[node_ix].node_type = node_type;
-
-				// WLAN code: add AP or STA ID to corresponding WLAN
-				tmp_nodes = strdup(line_nodes);
-				const char *wlan_code_aux (GetField(tmp_nodes, IX_WLAN_CODE));
-				std::string wlan_code;
-				wlan_code.append(ToString(wlan_code_aux));
-				node_container[node_ix].wlan_code = wlan_code;
-				for(int w = 0; w < total_wlans_number; ++w){
-					if(strcmp(wlan_code.c_str(), wlan_container[w].wlan_code.c_str()) == 0){	// If nodes belong to WLAN
-						if(node_container[node_ix].node_type == NODE_TYPE_AP){	// If node is AP
-							wlan_container[w].ap_id = node_container[node_ix].node_id;
-						} else if (node_container[node_ix].node_type == NODE_TYPE_STA){	// If node is STA
-							for(int s = 0; s < wlan_container[w].num_stas; ++s){
-								if(wlan_container[w].list_sta_id[s] == NODE_ID_NONE){
-									wlan_container[w].list_sta_id[s] = node_container[node_ix].node_id;
-									break;
-								}
+	// Compute the maximum power received from each WLAN
+	for(int i = 0; i < total_nodes_number; ++i) {
+		double max_power_received_per_wlan;
+		if (node_container[i].node_type == NODE_TYPE_AP) {
+			node_container[i].max_received_power_in_ap_per_wlan = new double[total_wlans_number];
+			for(int j = 0; j < total_wlans_number; ++j) {
+				if (strcmp(node_container[i].wlan_code.c_str(),wlan_container[j].wlan_code.c_str()) == 0) {
+					// Same WLAN
+					node_container[i].max_received_power_in_ap_per_wlan[j] = 0;
+				} else {
+					// Different WLAN
+					max_power_received_per_wlan = -1000;
+					for (int k = 0; k < total_nodes_number; ++k) {
+						// Check only nodes in WLAN "j"
+						if(strcmp(node_container[k].wlan_code.c_str(),wlan_container[j].wlan_code.c_str()) == 0) {
+							if (node_container[i].received_power_array[k] > max_power_received_per_wlan) {
+								max_power_received_per_wlan = node_container[i].received_power_array[k];
 							}
 						}
 					}
-				}
-
-				// Destination ID
-				tmp_nodes = strdup(line_nodes);
-				node_container[node_ix].destination_id = atoi(GetField(tmp_nodes, IX_DESTINATION_ID));
-
-				// Position
-				tmp_nodes = strdup(line_nodes);
-				node_container[node_ix].x = atof(GetField(tmp_nodes, IX_POSITION_X));
-				tmp_nodes = strdup(line_nodes);
-				node_container[node_ix].y = atof(GetField(tmp_nodes, IX_POSITION_Y));
-				tmp_nodes = strdup(line_nodes);
-				node_container[node_ix].z = atof(GetField(tmp_nodes, IX_POSITION_Z));
-
-				// CW min
-				tmp_nodes = strdup(line_nodes);
-				node_container[node_ix].cw_min = atoi(GetField(tmp_nodes, IX_CW_MIN));
-
-				// CW max
-				tmp_nodes = strdup(line_nodes);
-				node_container[node_ix].cw_stage_max = atoi(GetField(tmp_nodes, IX_CW_STAGE_MAX));
-
-				// Primary channel
-				tmp_nodes = strdup(line_nodes);
-				node_container[node_ix].current_primary_channel = atoi(GetField(tmp_nodes, IX_PRIMARY_CHANNEL));
-
-				// Min channel allowed
-				tmp_nodes = strdup(line_nodes);
-				node_container[node_ix].min_channel_allowed = atoi(GetField(tmp_nodes, IX_MIN_CH_ALLOWED));
-
-				// Max channel allowed
-				tmp_nodes = strdup(line_nodes);
-				node_container[node_ix].max_channel_allowed = atoi(GetField(tmp_nodes, IX_MAX_CH_ALLOWED));
-
-				// Min tx_power
-				tmp_nodes = strdup(line_nodes);
-				double tx_power_min_dbm (atof(GetField(tmp_nodes, IX_TX_POWER_MIN)));
-				node_container[node_ix].tx_power_min = ConvertPower(DBM_TO_PW, tx_power_min_dbm);
-
-				// Default tx_power
-				tmp_nodes = strdup(line_nodes);
-				double tx_power_default_dbm (atof(GetField(tmp_nodes, IX_TX_POWER_DEFAULT)));
-				node_container[node_ix].tx_power_default = ConvertPower(DBM_TO_PW, tx_power_default_dbm);
-
-				// Max tx_power
-				tmp_nodes = strdup(line_nodes);
-				double tx_power_max_dbm = atof(GetField(tmp_nodes, IX_TX_POWER_MAX));
-				node_container[node_ix].tx_power_max = ConvertPower(DBM_TO_PW, tx_power_max_dbm);
-
-				// Min pd
-				tmp_nodes = strdup(line_nodes);
-				double sensitivity_min_dbm (atoi(GetField(tmp_nodes, IX_PD_MIN)));
-				node_container[node_ix].sensitivity_min = ConvertPower(DBM_TO_PW, sensitivity_min_dbm);
-
-				// Default pd
-				tmp_nodes = strdup(line_nodes);
-				double sensitivity_default_dbm (atoi(GetField(tmp_nodes, IX_PD_DEFAULT)));
-				node_container[node_ix].sensitivity_default = ConvertPower(DBM_TO_PW, sensitivity_default_dbm);
-
-				// Max pd
-				tmp_nodes = strdup(line_nodes);
-				double sensitivity_max_dbm (atoi(GetField(tmp_nodes, IX_PD_MAX)));
-				node_container[node_ix].sensitivity_max = ConvertPower(DBM_TO_PW, sensitivity_max_dbm);
-
-				// TX gain
-				tmp_nodes = strdup(line_nodes);
-				double tx_gain_db (atoi(GetField(tmp_nodes, IX_TX_GAIN)));
-				node_container[node_ix].tx_gain = ConvertPower(DB_TO_LINEAR, tx_gain_db);
-
-				// RX gain
-				tmp_nodes = strdup(line_nodes);
-				double rx_gain_db (atoi(GetField(tmp_nodes, IX_RX_GAIN)));
-				node_container[node_ix].rx_gain = ConvertPower(DB_TO_LINEAR, rx_gain_db);
-
-				// Channel bonding model
-				tmp_nodes = strdup(line_nodes);
-				node_container[node_ix].current_dcb_policy = atoi(GetField(tmp_nodes, IX_CHANNEL_BONDING_MODEL));
-
-				// Default modulation
-				tmp_nodes = strdup(line_nodes);
-				node_container[node_ix].modulation_default = atoi(GetField(tmp_nodes, IX_MODULATION_DEFAULT));
-
-				// Central frequency in GHz (e.g. 2.4)
-				tmp_nodes = strdup(line_nodes);
-				const char* central_frequency_char (GetField(tmp_nodes, IX_CENTRAL_FREQ));
-				node_container[node_ix].central_frequency = atof(central_frequency_char) * pow(10,9);
-
-				// Lambda (BO generation rate)
-				tmp_nodes = strdup(line_nodes);
-				const char* lambda_char (GetField(tmp_nodes, IX_LAMBDA));
-
-				// IEEE protocol type
-				tmp_nodes = strdup(line_nodes);
-				const char* ieee_protocol_char (GetField(tmp_nodes, IX_IEEE_PROTOCOL_TYPE));
-				node_container[node_ix].ieee_protocol = atof(ieee_protocol_char);
-
-				// Traffic load (packet generation rate)
-				tmp_nodes = strdup(line_nodes);
-				const char* traffic_load_char (GetField(tmp_nodes, IX_TRAFFIC_LOAD));
-
-				// SPATIAL REUSE parameters
-				//  - BSS color
-				tmp_nodes = strdup(line_nodes);
-				const char* bss_color_char = GetField(tmp_nodes, IX_BSS_COLOR);
-				//  - Spatial Reuse Group (SRG)
-				tmp_nodes = strdup(line_nodes);
-				const char* srg_char = GetField(tmp_nodes, IX_SRG);
-				//  - non-SRG OBSS_PD
-				tmp_nodes = strdup(line_nodes);
-				const char* non_srg_obss_pd_char = GetField(tmp_nodes, IX_NON_SRG_OBSS_PD);
-				//  - SRG OBSS_PD
-				tmp_nodes = strdup(line_nodes);
-				const char* srg_obss_pd_char = GetField(tmp_nodes, IX_SRG_OBSS_PD);
-
-				// System
-				node_container[node_ix].simulation_time_komondor = simulation_time_komondor;
-				node_container[node_ix].total_wlans_number = total_wlans_number;
-				node_container[node_ix].total_nodes_number = total_nodes_number;
-				node_container[node_ix].collisions_model = collisions_model;
-				node_container[node_ix].capture_effect = capture_effect;
-				node_container[node_ix].save_node_logs = save_node_logs;
-				node_container[node_ix].print_node_logs = print_node_logs;
-				node_container[node_ix].basic_channel_bandwidth = basic_channel_bandwidth;
-				node_container[node_ix].num_channels_komondor = num_channels_komondor;
-				node_container[node_ix].adjacent_channel_model = adjacent_channel_model;
-				node_container[node_ix].default_destination_id = NODE_ID_NONE;
-				node_container[node_ix].noise_level = noise_level;
-				node_container[node_ix].constant_per = constant_per;
-				node_container[node_ix].pdf_backoff = pdf_backoff;
-				node_container[node_ix].path_loss_model = path_loss_model;
-				node_container[node_ix].pdf_tx_time = pdf_tx_time;
-				node_container[node_ix].frame_length = frame_length;
-				node_container[node_ix].max_num_packets_aggregated = max_num_packets_aggregated;
-				node_container[node_ix].ack_length = ack_length;
-				node_container[node_ix].rts_length = rts_length;
-				node_container[node_ix].cts_length = cts_length;
-				node_container[node_ix].traffic_model = traffic_model;
-				node_container[node_ix].backoff_type = backoff_type;
-				node_container[node_ix].cw_adaptation = cw_adaptation;
-				node_container[node_ix].pifs_activated = pifs_activated;
-				node_container[node_ix].capture_effect_model = capture_effect_model;
-				node_container[node_ix].simulation_code = simulation_code;
-
-				// SPATIAL REUSE
-				if (bss_color_char != NULL) { // Check if the input file is compliant with SR
-					node_container[node_ix].bss_color = atoi(bss_color_char);
-					node_container[node_ix].srg = atoi(srg_char);
-					double non_srg_obss_pd_dbm = atof(non_srg_obss_pd_char);
-					node_container[node_ix].non_srg_obss_pd = ConvertPower(DBM_TO_PW, non_srg_obss_pd_dbm);
-					double srg_obss_pd_dbm = atof(srg_obss_pd_char);
-					node_container[node_ix].srg_obss_pd = ConvertPower(DBM_TO_PW, srg_obss_pd_dbm);
-				} else {
-					node_container[node_ix].bss_color = -1;
-					node_container[node_ix].srg = -1;
-					node_container[node_ix].non_srg_obss_pd = -1;
-					node_container[node_ix].srg_obss_pd = -1;
-				}
-
-				// Traffic generator
-				traffic_generator_container[node_ix].node_type = node_type;
-				traffic_generator_container[node_ix].node_id = node_ix;
-				traffic_generator_container[node_ix].traffic_model = traffic_model;
-				traffic_generator_container[node_ix].traffic_load = atof(traffic_load_char);
-				traffic_generator_container[node_ix].lambda = atof(lambda_char);
-				traffic_generator_container[node_ix].burst_rate = atof(lambda_char);
-
-				++node_ix;
-				free(tmp_nodes);
-			}
-		}
-
-		// Set corresponding WLAN to each node
-		for(int n = 0; n < total_nodes_number; ++n){
-			for(int w = 0; w < total_wlans_number; ++w){
-				if (strcmp(node_container[n].wlan_code.c_str(), wlan_container[w].wlan_code.c_str()) == 0) {
-					node_container[n].wlan = wlan_container[w];
+					node_container[i].max_received_power_in_ap_per_wlan[j] = max_power_received_per_wlan;
 				}
 			}
 		}
-
-		if (print_system_logs) printf("%s Nodes generated!\n", LOG_LVL3);
+	}
 }
 
 /*
- * GenerateAgents(): generates the agents according to the information in the input file.
- * Input arguments:
- * - agents_filename: agents filename
+ * RunAnalyticalModel(): estimates the throughput, failure probability and channel occupancy of every WLAN
+ * with the analytical models (see methods/analytical_methods.h) instead of simulating. The script output
+ * contains ";throughput [Mbps];prob. failure;occupancy" per WLAN, followed by the total throughput [Mbps]
  */
-void Komondor :: GenerateAgents(const char *agents_filename) {
-
-	if (print_system_logs) printf("%s Generating agents...\n", LOG_LVL1);
-
-	if (print_system_logs) printf("%s Reading agents input file '%s'...\n", LOG_LVL2, agents_filename);
-
-	// STEP 1: set size of the agents container
-	total_agents_number = GetNumOfLines(agents_filename);
-	agent_container.SetSize(total_agents_number);
+void Komondor :: RunAnalyticalModel() {
+
+	clock_t start_clock (clock());
+
+	// Frame durations of the APs (full aggregation, as in saturation)
+	FrameDurationTable frame_duration_table;
+	frame_duration_table.Build(frame_length, max_num_packets_aggregated);
+	double rts_duration, cts_duration, data_duration, ack_duration;
+
+	AnalyticalScenario scenario;
+	scenario.num_channels = num_channels_komondor;
+	scenario.cw_adaptation = cw_adaptation;
+	scenario.collision_duration = frame_duration_table.rts_duration + SIFS + frame_duration_table.cts_duration + DIFS;
+	scenario.noise_level = noise_level;
+	scenario.capture_effect = capture_effect;
+	scenario.constant_per = constant_per;
+	scenario.wlans.resize(total_wlans_number);
+	scenario.power_between_aps.resize((size_t) total_wlans_number * total_wlans_number);
+
+	for (int w = 0; w < total_wlans_number; ++w) {
+		Node &ap (node_container[wlan_container[w].ap_id]);
+		AnalyticalWlan &wlan (scenario.wlans[w]);
+		wlan.primary_channel = ap.current_primary_channel;
+		wlan.min_channel_allowed = ap.min_channel_allowed;
+		wlan.max_channel_allowed = ap.max_channel_allowed;
+		wlan.dcb_policy = ap.current_dcb_policy;
+		wlan.cw_min = ap.cw_min;
+		wlan.cw_stage_max = ap.cw_stage_max;
+		wlan.pd = ap.sensitivity_default;
+		wlan.offered_load = (traffic_model == TRAFFIC_FULL_BUFFER || traffic_model == TRAFFIC_FULL_BUFFER_NO_DIFFERENTIATION) ?
+			-1 : traffic_generator_container[wlan_container[w].ap_id].traffic_load * frame_length;
+		for (int v = 0; v < total_wlans_number; ++v) {
+			scenario.power_between_aps[(size_t) w * total_wlans_number + v] =
+				(v == w) ? 0 : ap.received_power_array[wlan_container[v].ap_id];
+		}
 
-	if (print_system_logs) printf("%s Num. of agents (WLANs): %d/%d\n", LOG_LVL3, total_agents_number, total_wlans_number);
+		wlan.stas.resize(wlan_container[w].num_stas);
+		for (int k = 0; k < wlan_container[w].num_stas; ++k) {
+			Node &sta_node (node_container[wlan_container[w].list_sta_id[k]]);
+			AnalyticalSta &sta (wlan.stas[k]);
+			sta.power_from_ap = sta_node.received_power_array[wlan_container[w].ap_id];
+			sta.power_from_wlan.resize(total_wlans_number);
+			for (int v = 0; v < total_wlans_number; ++v) {
+				sta.power_from_wlan[v] = (v == w) ? 0 : sta_node.received_power_array[wlan_container[v].ap_id];
+			}
+			SelectMCSResponse(sta.mcs_response, sta.power_from_ap);
+			for (int ix = 0; ix < NUM_OPTIONS_CHANNEL_LENGTH; ++ix) {
+				sta.tx_duration[ix] = 0;
+				sta.bits[ix] = 0;
+				if (sta.mcs_response[ix] == MODULATION_FORBIDDEN) continue;
+				int num_packets_aggregated (frame_duration_table.GetMaximumPacketsAggregated(ix,
+					sta.mcs_response[ix], max_num_packets_aggregated));
+				frame_duration_table.GetFramesDuration(&rts_duration, &cts_duration, &data_duration, &ack_duration,
+					ix, sta.mcs_response[ix], num_packets_aggregated);
+				sta.tx_duration[ix] = rts_duration + SIFS + cts_duration + SIFS + data_duration + SIFS
+					+ ack_duration + DIFS;
+				sta.bits[ix] = (double) num_packets_aggregated * frame_length;
+			}
+		}
+	}
 
-	// STEP 2: read the input file to determine the action space
-	if (print_system_logs) printf("%s Setting action space...\n", LOG_LVL4);
-	FILE* stream_agents = fopen(agents_filename, "r");
-	char line_agents[CHAR_BUFFER_SIZE];
-	first_line_skiped_flag = 0;	// Flag for skipping first informative line of input file
+	std::vector<AnalyticalWlanResult> results;
+	EstimatePerformanceAnalytically(scenario, analytical_config.max_states, results);
+	double elapsed_ms ((double) (clock() - start_clock) * 1000 / CLOCKS_PER_SEC);
 
-	int agent_ix (0);	// Auxiliary index
+	printf("%s ANALYTICAL ESTIMATION '%s' (%.3f ms)\n", LOG_LVL1, simulation_code.c_str(), elapsed_ms);
+	double total_throughput (0);
+	for (int w = 0; w < total_wlans_number; ++w) {
+		if (results[w].model == ANALYTICAL_MODEL_BIANCHI) {
+			printf("%s WLAN %s (Bianchi):\n", LOG_LVL2, wlan_container[w].wlan_code.c_str());
+		} else {
+			printf("%s WLAN %s (CTMN, %d states):\n", LOG_LVL2, wlan_container[w].wlan_code.c_str(),
+				results[w].num_states);
+		}
+		printf("%s Throughput = %.2f Mbps - Prob. failure = %.4f - Occupancy = %.4f - Av. channels = %.2f\n",
+			LOG_LVL3, results[w].throughput * pow(10,-6), results[w].prob_failure, results[w].occupancy,
+			results[w].av_num_channels);
+		fprintf(logger_script.file, ";%.3f;%.5f;%.5f", results[w].throughput * pow(10,-6),
+			results[w].prob_failure, results[w].occupancy);
+		total_throughput += results[w].throughput;
+	}
+	printf("%s Total throughput = %.2f Mbps\n", LOG_LVL2, total_throughput * pow(10,-6));
+	fprintf(logger_script.file, ";%.3f\n", total_throughput * pow(10,-6));
 
-	while (fgets(line_agents, CHAR_BUFFER_SIZE, stream_agents)){
+	CloseOutputFiles();
+}
 
-		if(!first_line_skiped_flag){
+/*
+ * RunSweep(): simulates every point of the sweep entered per console. The scenario is set up once;
+ * each point is then forked from it (sharing the setup copy-on-write), applied as a delta and
+ * simulated, keeping up to num_jobs points running concurrently.
+ * Output:
+ * - TRUE in the forked process of a point (which must run the simulation), FALSE in the parent
+ *   process once all the points are done
+ */
+int Komondor :: RunSweep() {
+
+	int num_points (sweep_config.NumPoints());
+	int num_jobs (sweep_config.num_jobs > 0 ? sweep_config.num_jobs : (int) sysconf(_SC_NPROCESSORS_ONLN));
+	if (num_jobs < 1) num_jobs = 1;
+
+	std::string index_filename ("../output/sweep_" + simulation_code + ".csv");
+	sweep_config.WriteIndex(index_filename, simulation_code);
+	printf("%s SWEEP '%s': %d points (%d concurrently), index written to '%s'\n", LOG_LVL1,
+		simulation_code.c_str(), num_points, num_jobs, index_filename.c_str());
+
+	// Nothing may remain buffered, or every forked process would write it again
+	fflush(stdout);
+	fflush(simulation_output_file);
+	fflush(script_output_file);
+
+	int running (0);
+	int failed (0);
+	int status;
+	for (int point = 0; point < num_points; ++point) {
+		if (running == num_jobs) {
+			if (wait(&status) > 0 && !(WIFEXITED(status) && WEXITSTATUS(status) == 0)) ++failed;
+			--running;
+		}
+		pid_t pid (fork());
+		if (pid < 0) {
+			printf("%sERROR: sweep point %d could not be forked\n", LOG_LVL1, point);
+			exit(-1);
+		}
+		if (pid == 0) {
+			if (ApplySweepPoint(point)) return TRUE;
+			exit(0);	// Found in the result cache
+		}
+		++running;
+	}
+	while (running > 0) {
+		if (wait(&status) > 0 && !(WIFEXITED(status) && WEXITSTATUS(status) == 0)) ++failed;
+		--running;
+	}
 
-			first_line_skiped_flag = 1;
+	printf("%s SWEEP '%s' FINISHED: %d points, %d failed\n", LOG_LVL1, simulation_code.c_str(), num_points, failed);
+	return FALSE;
+}
 
-		} else{
+/*
+ * ApplySweepPoint(): applies the values of a sweep point (in its forked process) and sets up its outputs.
+ * Only the data derived from the changed parameters is recomputed (e.g., a change of transmission
+ * power updates the power received from that node).
+ * Input arguments:
+ * - point: sweep point
+ * Output:
+ * - TRUE if the point must be simulated, FALSE if its results were found in the result cache
+ */
+int Komondor :: ApplySweepPoint(int point) {
 
-			char* tmp_agents = strdup(line_agents);
+	simulation_code = simulation_code + "_p" + std::to_string(point);
 
-			// Find the length of the channel actions array
-			tmp_agents = strdup(line_agents);
-			const char *channel_values_aux (GetField(tmp_agents, IX_AGENT_CHANNEL_VALUES));
-			std::string channel_values_text;
-			channel_values_text.append(ToString(channel_values_aux));
-			const char *channel_aux;
-			channel_aux = strtok ((char*)channel_values_text.c_str(),",");
-			num_actions_channel = 0;
-			while (channel_aux != NULL) {
-				channel_aux = strtok (NULL, ",");
-				++ num_actions_channel;
-			}
-			// Set the length of channel actions to agent's field
-			agent_container[agent_ix].num_actions_channel = num_actions_channel;
-
-			// Find the length of the pd actions array
-			tmp_agents = strdup(line_agents);
-			const char *pd_values_aux (GetField(tmp_agents, IX_AGENT_PD_VALUES));
-			std::string pd_values_text;
-			pd_values_text.append(ToString(pd_values_aux));
-			const char *pd_aux;
-			pd_aux = strtok ((char*)pd_values_text.c_str(),",");
-			num_actions_sensitivity = 0;
-			while (pd_aux != NULL) {
-				pd_aux = strtok (NULL, ",");
-				++ num_actions_sensitivity;
-			}
+	// The script output of the point is built in memory and appended at once (see CloseScriptOutput())
+	fclose(script_output_file);
+	script_output_file = open_memstream(&point_script_output, &point_script_output_length);
+	logger_script.file = script_output_file;
 
-			// Set the length of sensitivity actions to agent's field
-			agent_container[agent_ix].num_actions_sensitivity = num_actions_sensitivity;
-
-			// Find the length of the Tx power actions array
-			tmp_agents = strdup(line_agents);
-			const char *tx_power_values_aux (GetField(tmp_agents, IX_AGENT_TX_POWER_VALUES));
-			std::string tx_power_values_text;
-			tx_power_values_text.append(ToString(tx_power_values_aux));
-			const char *tx_power_aux;
-			tx_power_aux = strtok ((char*)tx_power_values_text.c_str(),",");
-			num_actions_tx_power = 0;
-			while (tx_power_aux != NULL) {
-				tx_power_aux = strtok (NULL, ",");
-				++ num_actions_tx_power;
-			}
+	std::vector<double> values;
+	sweep_config.PointValues(point, values);
+	for (size_t p = 0; p < values.size(); ++p) {
+
+		const SweepParameter &parameter = sweep_config.parameters[p];
+		double value (values[p]);
+		if (parameter.parameter == SWEEP_PARAMETER_SEED) {
+			seed = (int) value;
+			Seed = seed;
+			srand(seed);
+			continue;
+		}
 
-			// Set the length of Tx power actions to agent's field
-			agent_container[agent_ix].num_actions_tx_power = num_actions_tx_power;
-
-			// Find the length of the DCB actions actions array
-			tmp_agents = strdup(line_agents);
-			const char *policy_values_aux (GetField(tmp_agents, IX_AGENT_DCB_POLICY));
-			std::string policy_values_text;
-			policy_values_text.append(ToString(policy_values_aux));
-			const char *policy_aux;
-			policy_aux = strtok ((char*)policy_values_text.c_str(),",");
-			num_actions_dcb_policy = 0;
-			while (policy_aux != NULL) {
-				policy_aux = strtok (NULL, ",");
-				++num_actions_dcb_policy;
+		int num_targets (0);
+		for (int i = 0; i < total_nodes_number; ++i) {
+			Node &node = node_container[i];
+			if (parameter.target != SWEEP_TARGET_ALL && parameter.target != node.node_code
+				&& parameter.target != node.wlan_code) continue;
+			++num_targets;
+
+			switch (parameter.parameter) {
+				case SWEEP_PARAMETER_TX_POWER: {
+					node.tx_power_default = ConvertPower(DBM_TO_PW, value);
+					if (node.tx_power_min > node.tx_power_default) node.tx_power_min = node.tx_power_default;
+					if (node.tx_power_max < node.tx_power_default) node.tx_power_max = node.tx_power_default;
+					UpdateReceivedPowerFrom(i);
+					break;
+				}
+				case SWEEP_PARAMETER_CCA: {
+					node.sensitivity_default = ConvertPower(DBM_TO_PW, value);
+					if (node.sensitivity_min > node.sensitivity_default) node.sensitivity_min = node.sensitivity_default;
+					if (node.sensitivity_max < node.sensitivity_default) node.sensitivity_max = node.sensitivity_default;
+					break;
+				}
+				case SWEEP_PARAMETER_TRAFFIC_LOAD: {
+					traffic_generator_container[i].traffic_load = value;
+					break;
+				}
+				case SWEEP_PARAMETER_PRIMARY_CHANNEL: {
+					int channel ((int) value);
+					if (channel < 0 || channel >= num_channels_komondor) {
+						printf("%sERROR: sweep point %d: primary channel %d is out of range\n", LOG_LVL1, point, channel);
+						exit(-1);
+					}
+					node.current_primary_channel = channel;
+					if (node.min_channel_allowed > channel) node.min_channel_allowed = channel;
+					if (node.max_channel_allowed < channel) node.max_channel_allowed = channel;
+					break;
+				}
+				case SWEEP_PARAMETER_CW: {
+					// The largest CW (cw_min doubled cw_stage_max times) must also be a valid backoff window
+					if (value < 1 || value != floor(value) || ldexp(value, node.cw_stage_max) > RAND_MAX) {
+						printf("%sERROR: sweep point %d: CW %f is not valid for %s (cw_stage_max = %d)\n",
+							LOG_LVL1, point, value, node.node_code.c_str(), node.cw_stage_max);
+						exit(-1);
+					}
+					node.cw_min = (int) value;
+					break;
+				}
 			}
-
-			// Set the length of DCB actions to agent's field
-			agent_container[agent_ix].num_actions_dcb_policy = num_actions_dcb_policy;
-
-			++agent_ix;
-			free(tmp_agents);
-
+		}
+		if (num_targets == 0) {
+			printf("%sERROR: sweep target '%s' matches no node\n", LOG_LVL1, parameter.target.c_str());
+			exit(-1);
 		}
 	}
 
-	if (print_system_logs) printf("%s Action space set!\n", LOG_LVL4);
-
-	// STEP 3: set agents parameters
-	if (print_system_logs) printf("%s Setting agents parameters...\n", LOG_LVL4);
-	stream_agents = fopen(agents_filename, "r");
-	first_line_skiped_flag = 0;		// Flag for skipping first informative line of input file
-
-	agent_ix = 0;	// Auxiliary index
-
-	while (fgets(line_agents, CHAR_BUFFER_SIZE, stream_agents)){
-
-		if(!first_line_skiped_flag){
+	// Results of the point already in the result cache
+	if (!result_cache.directory.empty()) {
+		for (size_t p = 0; p < values.size(); ++p) {
+			result_key.AddString(sweep_config.parameters[p].name + "@" + sweep_config.parameters[p].target);
+			result_key.AddNumber(values[p]);
+		}
+		CachedResult cached_result;
+		if (result_cache.Lookup(result_key, cached_result)) {
+			WriteCachedResult(logger_script.file, simulation_code, seed, cached_result);
+			CloseScriptOutput();
+			printf("%s SIMULATION '%s' FOUND IN THE RESULT CACHE\n", LOG_LVL1, simulation_code.c_str());
+			return FALSE;
+		}
+	}
 
-			first_line_skiped_flag = 1;
+	// Outputs of the point
+	std::string simulation_filename ("../output/logs_console_" + simulation_code + ".txt");
+	fclose(simulation_output_file);
+	simulation_output_file = fopen(simulation_filename.c_str(), "w");
+	logger_simulation.file = simulation_output_file;
+	fprintf(logger_script.file, "%s KOMONDOR SIMULATION '%s' (seed %d)", LOG_LVL1, simulation_code.c_str(), seed);
+	for (int i = 0; i < total_nodes_number; ++i) node_container[i].simulation_code = simulation_code;
+	OpenComponentLogs();
+	if (metrics_sampler_config.sampling_interval > 0 && metrics_sampler_config.filename.empty()) {
+		metrics_sampler[0].metrics_filename = "../output/metrics_" + simulation_code + ".csv";
+	}
+	return TRUE;
+}
 
-		} else{
+/*
+ * UpdateReceivedPowerFrom(): recomputes the power received from a node (after a change of its transmission
+ * power) by every other node, and the maximum power received by each AP from the WLAN of the node
+ * Input arguments:
+ * - node_ix: node whose transmission power changed
+ */
+void Komondor :: UpdateReceivedPowerFrom(int node_ix) {
 
-			// Initialize actions and arrays in agents
-			agent_container[agent_ix].InitializeAgent();
+	const Node &source = node_container[node_ix];
+	for (int i = 0; i < total_nodes_number; ++i) {
+		if (i == node_ix) continue;
+		node_container[i].received_power_array[node_ix] = ComputePowerReceived(node_container[i].distances_array[node_ix],
+			source.tx_power_default, source.tx_gain, node_container[i].rx_gain, node_container[i].central_frequency,
+			path_loss_model);
+	}
 
-			// Agent ID
-			agent_container[agent_ix].agent_id = agent_ix;
+	int w (source.wlan.wlan_id);
+	const Wlan &wlan = wlan_container[w];
+	for (int i = 0; i < total_nodes_number; ++i) {
+		if (node_container[i].node_type != NODE_TYPE_AP || node_container[i].wlan_code == source.wlan_code) continue;
+		double max_power_received (node_container[i].received_power_array[wlan.ap_id]);
+		for (int s = 0; s < wlan.num_stas; ++s) {
+			double power_received (node_container[i].received_power_array[wlan.list_sta_id[s]]);
+			if (power_received > max_power_received) max_power_received = power_received;
+		}
+		node_container[i].max_received_power_in_ap_per_wlan[w] = max_power_received;
+	}
 
-			// WLAN code
-			char* tmp_agents (strdup(line_agents));
-			const char *wlan_code_aux (GetField(tmp_agents, IX_AGENT_WLAN_CODE));
-			std::string wlan_code;
-			wlan_code.append(ToString(wlan_code_aux));
-			agent_container[agent_ix].wlan_code = wlan_code.c_str();
+	if (mobility_config.interval > 0) mobility_manager[0].tx_power[node_ix] = source.tx_power_default;
+}
 
-			//  Communication level
-			tmp_agents = strdup(line_agents);
-			int communication_level (atoi(GetField(tmp_agents, IX_COMMUNICATION_LEVEL)));
-			agent_container[agent_ix].communication_level = communication_level;
+/*
+ * GenerateAgents(): generates the agents according to the information in the input file.
+ * Input arguments:
+ * - agents_filename: agents filename
+ */
+void Komondor :: GenerateAgents(const char *agents_filename) {
 
-			// Check if the central controller has to be created or not
-			if(communication_level ==  PURE_CENTRALIZED || communication_level == HYBRID_CENTRALIZED_DECENTRALIZED) {
-				++total_controlled_agents_number;
-				central_controller_flag = 1;
-			}
+	if (print_system_logs) printf("%s Generating agents...\n", LOG_LVL1);
+	if (print_system_logs) printf("%s Reading agents input file '%s'...\n", LOG_LVL2, agents_filename);
 
-			// Time between requests (in seconds)
-			tmp_agents = strdup(line_agents);
-			double time_between_requests (atof(GetField(tmp_agents, IX_AGENT_TIME_BW_REQUESTS)));
-			agent_container[agent_ix].time_between_requests = time_between_requests;
-			// Channel values
-			tmp_agents = strdup(line_agents);
-			std::string channel_values_text = ToString(GetField(tmp_agents, IX_AGENT_CHANNEL_VALUES));
-
-			// Fill the channel actions array
-			char *channel_aux_2;
-			char *channel_values_text_char = new char[channel_values_text.length() + 1];
-			strcpy(channel_values_text_char, channel_values_text.c_str());
-			channel_aux_2 = strtok (channel_values_text_char,",");
-
-			int ix (0);
-			while (channel_aux_2 != NULL) {
-				int a (atoi(channel_aux_2));
-				agent_container[agent_ix].list_of_channels[ix] = a;
-				channel_aux_2 = strtok (NULL, ",");
-				++ix;
-			}
+	// Set size of the agents container (the file is kept for the central controller)
+	agents_file.Load(agents_filename);
+	total_agents_number = agents_file.NumRows();
+	agent_container.SetSize(total_agents_number);
 
-			// sensitivity values
-			tmp_agents = strdup(line_agents);
-			std::string pd_values_text = ToString(GetField(tmp_agents, IX_AGENT_PD_VALUES));
-
-			// Fill the sensitivity actions array
-			char *pd_aux_2;
-			char *pd_values_text_char = new char[pd_values_text.length() + 1];
-			strcpy(pd_values_text_char, pd_values_text.c_str());
-			pd_aux_2 = strtok (pd_values_text_char,",");
-
-			ix = 0;
-			while (pd_aux_2 != NULL) {
-				int a = atoi(pd_aux_2);
-				agent_container[agent_ix].list_of_pd_values[ix] = ConvertPower(DBM_TO_PW, a);
-				pd_aux_2 = strtok (NULL, ",");
-				++ix;
-			}
+	if (print_system_logs) printf("%s Num. of agents (WLANs): %d/%d\n", LOG_LVL3, total_agents_number, total_wlans_number);
 
-			// Tx Power values
-			tmp_agents = strdup(line_agents);
-			std::string tx_power_values_text = ToString(GetField(tmp_agents, IX_AGENT_TX_POWER_VALUES));
-
-			// Fill the TX power actions array
-			char *tx_power_aux_2;
-			char *tx_power_values_text_char = new char[tx_power_values_text.length() + 1];
-			strcpy(tx_power_values_text_char, tx_power_values_text.c_str());
-			tx_power_aux_2 = strtok (tx_power_values_text_char,",");
-
-			ix = 0;
-			while (tx_power_aux_2 != NULL) {
-				int a (atoi(tx_power_aux_2));
-				agent_container[agent_ix].list_of_tx_power_values[ix] = ConvertPower(DBM_TO_PW, a);
-				tx_power_aux_2 = strtok (NULL, ",");
-				++ix;
-			}
+	// Set the action space and the parameters of each agent in a single sweep
+	if (print_system_logs) printf("%s Setting agents parameters...\n", LOG_LVL4);
 
-			// DCB policy values
-			tmp_agents = strdup(line_agents);
-			std::string dcb_policy_values_text = ToString(GetField(tmp_agents, IX_AGENT_DCB_POLICY));
-
-			// Fill the DCB policy actions array
-			char *policy_aux_2;
-			char *dcb_policy_values_text_char = new char[dcb_policy_values_text.length() + 1];
-			strcpy(dcb_policy_values_text_char, dcb_policy_values_text.c_str());
-			policy_aux_2 = strtok (dcb_policy_values_text_char,",");
-
-			ix = 0;
-			while (policy_aux_2 != NULL) {
-				int a (atoi(policy_aux_2));
-				agent_container[agent_ix].list_of_dcb_policy[ix] = a;
-				policy_aux_2 = strtok (NULL, ",");
-				++ix;
-			}
+	std::vector<double> channel_values, pd_values, tx_power_values, dcb_policy_values;
+
+	for (int agent_ix = 0; agent_ix < total_agents_number; ++agent_ix) {
+
+		// Action space (the length of each actions array is needed to initialize the agent)
+		agents_file.GetList(agent_ix, IX_AGENT_CHANNEL_VALUES, "actions channels", channel_values);
+		agents_file.GetList(agent_ix, IX_AGENT_PD_VALUES, "actions cca", pd_values);
+		agents_file.GetList(agent_ix, IX_AGENT_TX_POWER_VALUES, "actions tx power", tx_power_values);
+		agents_file.GetList(agent_ix, IX_AGENT_DCB_POLICY, "actions dcb policy", dcb_policy_values);
+		num_actions_channel = channel_values.size();
+		num_actions_sensitivity = pd_values.size();
+		num_actions_tx_power = tx_power_values.size();
+		num_actions_dcb_policy = dcb_policy_values.size();
+		agent_container[agent_ix].num_actions_channel = num_actions_channel;
+		agent_container[agent_ix].num_actions_sensitivity = num_actions_sensitivity;
+		agent_container[agent_ix].num_actions_tx_power = num_actions_tx_power;
+		agent_container[agent_ix].num_actions_dcb_policy = num_actions_dcb_policy;
+
+		// Initialize actions and arrays in agents
+		agent_container[agent_ix].InitializeAgent();
+
+		// Agent ID
+		agent_container[agent_ix].agent_id = agent_ix;
+
+		// WLAN code
+		agent_container[agent_ix].wlan_code = agents_file.GetString(agent_ix, IX_AGENT_WLAN_CODE, "wlan_code");
+
+		//  Communication level
+		int communication_level (agents_file.GetInt(agent_ix, IX_COMMUNICATION_LEVEL, "centralized"));
+		agent_container[agent_ix].communication_level = communication_level;
+
+		// Check if the central controller has to be created or not
+		if(communication_level ==  PURE_CENTRALIZED || communication_level == HYBRID_CENTRALIZED_DECENTRALIZED) {
+			++total_controlled_agents_number;
+			central_controller_flag = 1;
+		}
 
-			// Type of reward
-			tmp_agents = strdup(line_agents);
-			int type_of_reward (atoi(GetField(tmp_agents, IX_AGENT_TYPE_OF_REWARD)));
-			agent_container[agent_ix].type_of_reward = type_of_reward;
+		// Time between requests (in seconds)
+		agent_container[agent_ix].time_between_requests =
+			agents_file.GetDouble(agent_ix, IX_AGENT_TIME_BW_REQUESTS, "time between requests");
 
-			// Learning mechanism
-			tmp_agents = strdup(line_agents);
-			int learning_mechanism (atoi(GetField(tmp_agents, IX_AGENT_LEARNING_MECHANISM)));
-			agent_container[agent_ix].learning_mechanism = learning_mechanism;
+		// Fill the actions arrays (sensitivity and power values in dBm, truncated as in former versions)
+		for (int ix = 0; ix < num_actions_channel; ++ix) {
+			agent_container[agent_ix].list_of_channels[ix] = (int) channel_values[ix];
+		}
+		for (int ix = 0; ix < num_actions_sensitivity; ++ix) {
+			agent_container[agent_ix].list_of_pd_values[ix] = ConvertPower(DBM_TO_PW, (int) pd_values[ix]);
+		}
+		for (int ix = 0; ix < num_actions_tx_power; ++ix) {
+			agent_container[agent_ix].list_of_tx_power_values[ix] = ConvertPower(DBM_TO_PW, (int) tx_power_values[ix]);
+		}
+		for (int ix = 0; ix < num_actions_dcb_policy; ++ix) {
+			agent_container[agent_ix].list_of_dcb_policy[ix] = (int) dcb_policy_values[ix];
+		}
 
-			// Selected strategy
-			tmp_agents = strdup(line_agents);
-			int action_selection_strategy (atoi(GetField(tmp_agents, IX_AGENT_SELECTED_STRATEGY)));
-			agent_container[agent_ix].action_selection_strategy = action_selection_strategy;
+		// Type of reward
+		agent_container[agent_ix].type_of_reward = agents_file.GetInt(agent_ix, IX_AGENT_TYPE_OF_REWARD, "reward_type");
 
-			// System
-			agent_container[agent_ix].save_agent_logs = save_agent_logs;
-			agent_container[agent_ix].print_agent_logs = print_agent_logs;
+		// Learning mechanism
+		agent_container[agent_ix].learning_mechanism =
+			agents_file.GetInt(agent_ix, IX_AGENT_LEARNING_MECHANISM, "learning_mechanism");
 
-			// Initialize learning algorithm in agent
-			//agent_container[agent_ix].InitializePreProcessor();
-			//agent_container[agent_ix].InitializeLearningAlgorithm();
+		// Selected strategy
+		agent_container[agent_ix].action_selection_strategy =
+			agents_file.GetInt(agent_ix, IX_AGENT_SELECTED_STRATEGY, "selected_strategy");
 
-			++agent_ix;
-			free(tmp_agents);
+		// System
+		agent_container[agent_ix].save_agent_logs = save_agent_logs;
+		agent_container[agent_ix].print_agent_logs = print_agent_logs;
+		agent_container[agent_ix].log_writer_mode = log_writer_mode;
 
-		}
+		// Initialize learning algorithm in agent
+		//agent_container[agent_ix].InitializePreProcessor();
+		//agent_container[agent_ix].InitializeLearningAlgorithm();
 	}
 
 	if (print_system_logs) printf("%s Agents parameters set!\n", LOG_LVL4);
@@ -1243,52 +1577,28 @@ void Komondor :: GenerateCentralController(const char *agents_filename) {
 		// The overall "time between requests" is set to the maximum among all the agents
 		central_controller[0].list_of_agents = agents_list;
 
-		// Initialize the CC with parameters from the agents input file
-		FILE* stream_cc = fopen(agents_filename, "r");
-		char line_agents[CHAR_BUFFER_SIZE];
-		char* tmp_agents (strdup(line_agents));
-		first_line_skiped_flag = 0;		// Flag for skipping first informative line of input file
-
-		while (fgets(line_agents, CHAR_BUFFER_SIZE, stream_cc)){
-			if(!first_line_skiped_flag){
-				first_line_skiped_flag = 1;
-			} else{
-
-				// Type OF reward
-				tmp_agents = strdup(line_agents);
-				int type_of_reward (atoi(GetField(tmp_agents, IX_AGENT_TYPE_OF_REWARD)));
-				central_controller[0].type_of_reward = type_of_reward;
-				// Learning mechanism
-				tmp_agents = strdup(line_agents);
-				int learning_mechanism (atoi(GetField(tmp_agents, IX_AGENT_LEARNING_MECHANISM)));
-				central_controller[0].learning_mechanism = learning_mechanism;
-				// Selected strategy
-				tmp_agents = strdup(line_agents);
-				int action_selection_strategy (atoi(GetField(tmp_agents, IX_AGENT_SELECTED_STRATEGY)));
-				central_controller[0].action_selection_strategy = action_selection_strategy;
-
-				// Find the length of the channel actions array
-				tmp_agents = strdup(line_agents);
-				const char *channel_values_aux (GetField(tmp_agents, IX_AGENT_CHANNEL_VALUES));
-				std::string channel_values_text;
-				channel_values_text.append(ToString(channel_values_aux));
-				const char *channels_aux;
-				channels_aux = strtok ((char*)channel_values_text.c_str(),",");
-				int num_actions_channels = 0;
-				while (channels_aux != NULL) {
-					channels_aux = strtok (NULL, ",");
-					++ num_actions_channels;
-				}
-				central_controller[0].num_channels = num_actions_channels;
+		// Initialize the CC with parameters from the agents input file (already loaded by GenerateAgents)
+		std::vector<double> channel_values;
+		for (int row = 0; row < agents_file.NumRows(); ++row) {
 
-				free(tmp_agents);
+			// Type OF reward
+			central_controller[0].type_of_reward = agents_file.GetInt(row, IX_AGENT_TYPE_OF_REWARD, "reward_type");
+			// Learning mechanism
+			central_controller[0].learning_mechanism =
+				agents_file.GetInt(row, IX_AGENT_LEARNING_MECHANISM, "learning_mechanism");
+			// Selected strategy
+			central_controller[0].action_selection_strategy =
+				agents_file.GetInt(row, IX_AGENT_SELECTED_STRATEGY, "selected_strategy");
 
-			}
+			// Find the length of the channel actions array
+			agents_file.GetList(row, IX_AGENT_CHANNEL_VALUES, "actions channels", channel_values);
+			central_controller[0].num_channels = channel_values.size();
 		}
 
 		// System logs
 		central_controller[0].save_controller_logs = save_agent_logs;
 		central_controller[0].print_controller_logs = print_agent_logs;
+		central_controller[0].log_writer_mode = log_writer_mode;
 
 		central_controller[0].total_nodes_number = total_nodes_number;
 
@@ -1318,11 +1628,19 @@ void Komondor :: PrintSystemInfo(){
 		printf("%s pdf_tx_time = %d\n", LOG_LVL3, pdf_tx_time);
 		printf("%s frame_length = %d bits\n", LOG_LVL3, frame_length);
 		printf("%s traffic_model = %d\n", LOG_LVL3, traffic_model);
+		if(traffic_model == TRAFFIC_POISSON_BURST) {
+			printf("%s burst_size_model = %d\n", LOG_LVL3, burst_size_model);
+			printf("%s burst_size = %f packets\n", LOG_LVL3, burst_size);
+		}
 		printf("%s backoff_type = %d\n", LOG_LVL3, backoff_type);
 		printf("%s cw_adaptation = %d\n", LOG_LVL3, cw_adaptation);
 		printf("%s pifs_activated = %d\n", LOG_LVL3, pifs_activated);
 		printf("%s capture_effect_model = %d\n", LOG_LVL3, capture_effect_model);
+		if(capture_effect_model == CE_LINK_ABSTRACTION && !per_tables_filename.empty()) {
+			printf("%s per_tables_filename = %s\n", LOG_LVL3, per_tables_filename.c_str());
+		}
 		printf("%s max_num_packets_aggregated = %d\n", LOG_LVL3, max_num_packets_aggregated);
+		printf("%s log_writer_mode = %d\n", LOG_LVL3, log_writer_mode);
 		printf("%s path_loss_model = %d\n", LOG_LVL3, path_loss_model);
 		printf("%s capture_effect = %f [linear] (%f dB)\n", LOG_LVL3, capture_effect, ConvertPower(LINEAR_TO_DB, capture_effect));
 		printf("%s noise_level = %f pW (%f dBm)\n",
@@ -1412,106 +1730,6 @@ void Komondor :: WriteAllNodesInfo(Logger logger, int info_detail_level, std::st
 /* FILES FUNCTIONS */
 /*******************/
 
-/*
- * GetField(): returns a field corresponding to a given index from a CSV file
- * Input arguments:
- * - line: line of the CSV
- * - num: field number (index)
- */
-const char* GetField(char* line, int num){
-    const char* tok;
-    for (tok = strtok(line, ";");
-            tok && *tok;
-            tok = strtok(NULL, ";\n"))
-    {
-        if (!--num)
-            return tok;
-    }
-    return NULL;
-}
-
-/*
- * GetNumOfLines(): returns the number of lines of a csv file
- * Input arguments:
- * - filename: CSV filename
- */
-int Komondor :: GetNumOfLines(const char *filename){
-	int num_lines (0);
-	// Nodes file
-	FILE* stream = fopen(filename, "r");
-	if (!stream){
-		printf("Nodes configuration file %s not found!\n", filename);
-		exit(-1);
-	}
-	char line[CHAR_BUFFER_SIZE];
-	while (fgets(line, CHAR_BUFFER_SIZE, stream))
-	{
-		++num_lines;
-	}
-	num_lines--;
-	fclose(stream);
-	return num_lines;
-}
-
-/*
- * GetNumOfNodes(): returns the number of nodes of a given type (0: AP, 1: STA, 2: Free Node)
- * Input arguments:
- * - nodes_filename: nodes configuration filename
- * - node_type: type of node to consider in the counting
- * - wlan_id: wlan to consider in the counting
- */
-int Komondor :: GetNumOfNodes(const char *nodes_filename, int node_type, std::string wlan_code){
-
-	int num_nodes(0);
-	char line_nodes[CHAR_BUFFER_SIZE];
-	first_line_skiped_flag = 0;
-	int type_found;
-	std::string wlan_code_found;
-
-	FILE* stream_nodes = fopen(nodes_filename, "r");
-
-	if (!stream_nodes){
-		printf("[MAIN] ERROR: Nodes configuration file %s not found!\n", nodes_filename);
-		exit(-1);
-	}
-
-	if(node_type == NODE_TYPE_UNKWNOW){	// Count all type of nodes
-
-		num_nodes = GetNumOfLines(nodes_filename);
-
-	} else {	// Count specific nodes
-
-		while (fgets(line_nodes, CHAR_BUFFER_SIZE, stream_nodes)){
-
-			if(!first_line_skiped_flag){
-
-				first_line_skiped_flag = 1;
-
-			} else{
-
-				// Node type
-				tmp_nodes = strdup(line_nodes);
-				type_found = atof(GetField(tmp_nodes, IX_NODE_TYPE));
-				free(tmp_nodes);
-
-				// WLAN code
-				tmp_nodes = strdup(line_nodes);
-				wlan_code_found = ToString(GetField(tmp_nodes, IX_WLAN_CODE));
-				free(tmp_nodes);
-
-				if(wlan_code.compare(ToString("")) > 0){
-					if(type_found == node_type && strcmp(wlan_code_found.c_str(), wlan_code.c_str()) == 0) ++num_nodes;
-				} else {
-					if(type_found == node_type) ++num_nodes;
-				}
-			}
-		}
-	}
-
-	fclose(stream_nodes);
-	return num_nodes;
-}
-
 /*
  * ReadSystemConfigurationFile():  READ CONFIG FILE (MS-DOS type) WITH SPECIFIC INFORMATION (SUCH AS THE SIMULATION_INDEX)
  */
@@ -1548,6 +1766,45 @@ void Komondor :: ReadSystemConfigurationFile() {
 /**********/
 /* main() */
 /**********/
+/*
+ * ComputeResultKey(): key of the results of a simulation in the result cache
+ * Input arguments:
+ * - system_filename, nodes_filename, agents_filename: input files (or generator spec for the nodes)
+ * - agents_enabled: flag indicating if the agents file is used
+ * - sim_time: simulation time [s]
+ * - seed: simulation seed
+ */
+ResultKey ComputeResultKey(const char *system_filename, const char *nodes_filename, int agents_enabled,
+	const char *agents_filename, double sim_time, int seed) {
+
+	ResultKey key;
+	key.AddString(RESULT_CACHE_MAGIC);
+	key.AddString(KOMONDOR_BUILD_VERSION);
+	key.AddFile(system_filename);
+	if (IsScenarioGeneratorSpec(nodes_filename)) key.AddString(nodes_filename);
+	else key.AddFile(nodes_filename);
+	key.AddNumber(agents_enabled);
+	if (agents_enabled) key.AddFile(agents_filename);
+	key.AddNumber(sim_time);
+	key.AddNumber(seed);
+	// Node order and mobility
+	key.AddNumber(node_order_config.curve);
+	key.AddNumber(mobility_config.interval);
+	if (mobility_config.interval > 0) {
+		key.AddNumber(mobility_config.speed);
+		key.AddNumber(mobility_config.fraction);
+		key.AddNumber(mobility_config.radius);
+	}
+	// Layout of the script output
+	key.AddNumber(output_schema.script_output_index);
+	for (size_t e = 0; e < output_schema.entries.size(); ++e) {
+		key.AddString(output_schema.entries[e].metric->name);
+		key.AddNumber(output_schema.entries[e].scope);
+		key.AddString(output_schema.entries[e].format);
+	}
+	return key;
+}
+
 int main(int argc, char *argv[]){
 
 	printf("\n");
@@ -1576,6 +1833,37 @@ int main(int argc, char *argv[]){
 
 	total_nodes_number = 0;
 
+	// Remove the log filter, log sink, flight recorder, metrics sampler, output schema and compiled scenario options
+	// (--log_xxx=..., --flight_recorder_xxx=..., --metrics_xxx=..., --output_schema=..., --script_output_index=...,
+	// --scenario_cache=..., --compile_only, --sweep_xxx=..., --result_cache_xxx, --mobility_xxx=..., --node_order=...,
+	// --analytical[_max_states=...])
+	// so that the remaining arguments keep their positions
+	int num_arguments (1);
+	for(int i = 1; i < argc; ++i) {
+		if(!log_filter.ParseArgument(argv[i]) && !flight_recorder_config.ParseArgument(argv[i])
+			&& !log_sink.ParseArgument(argv[i]) && !metrics_sampler_config.ParseArgument(argv[i])
+			&& !output_schema.ParseArgument(argv[i]) && !scenario_cache_config.ParseArgument(argv[i])
+			&& !sweep_config.ParseArgument(argv[i]) && !result_cache.ParseArgument(argv[i])
+			&& !mobility_config.ParseArgument(argv[i]) && !node_order_config.ParseArgument(argv[i])
+			&& !analytical_config.ParseArgument(argv[i])) {
+			argv[num_arguments++] = argv[i];
+		}
+	}
+	argc = num_arguments;
+	if (scenario_cache_config.compile_only && scenario_cache_config.directory.empty()) {
+		printf("%sERROR: --compile_only requires --scenario_cache=<dir>\n", LOG_LVL1);
+		return(-1);
+	}
+	if (!sweep_config.filename.empty()) sweep_config.Load();
+	if (result_cache.print_statistics) {
+		if (result_cache.directory.empty()) {
+			printf("%sERROR: --result_cache_stats requires --result_cache=<dir>\n", LOG_LVL1);
+			return(-1);
+		}
+		result_cache.PrintStatistics();
+		return(0);
+	}
+
 	// Get input variables per console
 	if(argc == NUM_FULL_ARGUMENTS_CONSOLE){	// Full configuration entered per console
 
@@ -1663,7 +1951,32 @@ int main(int argc, char *argv[]){
 				"-simulation_code -save_system_logs -save_node_logs -print_node_logs -print_system_logs "
 				"- sim_time -seed\n"
 				" + For PARTIAL configuration setting execute\n"
-				"    ./KomondorSimulation -system_input_filename -nodes_input_filename - sim_time - seed\n", LOG_LVL1);
+				"    ./KomondorSimulation -system_input_filename -nodes_input_filename - sim_time - seed\n"
+				" + Node/agent logs can be filtered with --log_level=<1-5> --log_categories=<letters> "
+				"--log_nodes=<ids> --log_time=<from>:<until>, and written to <N> segment files with --log_shards=<N>\n"
+				" + With -save_node_logs = 3 (flight recorder) use --flight_recorder_events=<N> "
+				"--flight_recorder_triggers=<bo_collision,ack_timeout,cts_timeout,nack,abort> "
+				"--flight_recorder_max_dumps=<N> (if the process aborts, the last events of every node are "
+				"written to logs_output_<code>_flight_recorder_abort.trc: decode it with ./trace_decoder)\n"
+				" + Counters are sampled every <s> seconds with --metrics_interval=<s> [--metrics_file=<path>]\n"
+				" + The script output line is set with --output_schema=<metric@node|wlan|global[:format],...> "
+				"or --output_schema_file=<path> (default: --script_output_index=<N>)\n"
+				" + Scenarios are compiled to (and loaded from) a cache with --scenario_cache=<dir>, "
+				"--compile_only exits once compiled\n"
+				" + Large scenarios can be generated by entering a spec instead of the nodes input file, e.g. "
+				"generate:topology=<grid|random|enterprise|stadium>,aps=<N>,stas=<M>,num_channels=<n>,"
+				"channels=<single|round_robin|random|reuse>,power=<fixed|random> (see ./scenario_generator)\n"
+				" + Parameter sweeps are run on the loaded scenario with --sweep=<file> "
+				"[--sweep_design=<cartesian|listed>] [--sweep_jobs=<N>] (see structures/sweep.h)\n"
+				" + Results are looked up in (and stored to) a cache with --result_cache=<dir> "
+				"[--result_cache_max_mb=<N>], --result_cache_stats prints its statistics (runs saving node or agent logs, "
+				"traces or metrics are always simulated)\n"
+				" + STAs move around their AP every <s> seconds with --mobility_interval=<s> "
+				"[--mobility_speed=<m/s>] [--mobility_fraction=<0-1>] [--mobility_radius=<m>]\n"
+				" + Nodes are renumbered along a space-filling curve with --node_order=<morton|hilbert> "
+				"(outputs and logs keep the ids of the nodes file)\n"
+				" + The performance is estimated analytically (Bianchi/CTMN, no simulation) with --analytical "
+				"[--analytical_max_states=<N>]\n", LOG_LVL1);
 		return(-1);
 	}
 
@@ -1681,10 +1994,34 @@ int main(int argc, char *argv[]){
 		printf("%s print_node_logs: %d\n", LOG_LVL2, print_node_logs);
 		printf("%s sim_time: %f s\n", LOG_LVL2, sim_time);
 		printf("%s seed: %d\n", LOG_LVL2, seed);
+		log_filter.PrintFilter();
+	}
+
+	// Results already in the result cache (sweep points are looked up once applied). A hit only restores the
+	// script output and the console log, so runs writing node or agent logs, traces or metrics are always simulated
+	ResultKey result_key;
+	if (save_node_logs != SAVE_LOG_NONE || (agents_enabled && save_agent_logs)
+		|| metrics_sampler_config.sampling_interval > 0) {
+		result_cache.lookups_enabled = FALSE;
+	}
+	if (!result_cache.directory.empty() && !scenario_cache_config.compile_only && !analytical_config.enabled) {
+		result_key = ComputeResultKey(system_input_filename, nodes_input_filename, agents_enabled,
+			agents_input_filename, sim_time, seed);
+		CachedResult cached_result;
+		if (sweep_config.filename.empty() && result_cache.Lookup(result_key, cached_result)) {
+			FILE *script_file = fopen(script_output_filename.c_str(), "at");
+			if (script_file != NULL) {
+				WriteCachedResult(script_file, simulation_code, seed, cached_result);
+				fclose(script_file);
+			}
+			printf("%s SIMULATION '%s' FOUND IN THE RESULT CACHE\n", LOG_LVL1, simulation_code.c_str());
+			return(0);
+		}
 	}
 
 	// Generate Komondor component
 	Komondor test;
+	test.result_key = result_key;
 	test.Seed = seed;
 	srand(seed); // Needed for ensuring randomness dependency on seed
 	test.StopTime(sim_time);
@@ -1692,6 +2029,22 @@ int main(int argc, char *argv[]){
 		system_input_filename, nodes_input_filename, script_output_filename.c_str(), simulation_code.c_str(), seed,
 		agents_enabled, agents_input_filename);
 
+	if (scenario_cache_config.compile_only) {
+		printf("%s SCENARIO '%s' COMPILED\n", LOG_LVL1, simulation_code.c_str());
+		return(0);
+	}
+
+	// Sweep: the parent process returns once every point (forked from here) is simulated
+	if (!sweep_config.filename.empty()) {
+		if (!test.RunSweep()) return(0);
+	}
+
+	// Analytical estimation instead of the simulation (of each sweep point, if any)
+	if (analytical_config.enabled) {
+		test.RunAnalyticalModel();
+		return(0);
+	}
+
 	printf("------------------------------------------\n");
 	printf("%s SIMULATION '%s' STARTED\n", LOG_LVL1, simulation_code.c_str());
 
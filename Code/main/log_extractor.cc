@@ -0,0 +1,218 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file regenerates the per-node (and per-agent) log files from the sharded log sink
+ *   (see structures/log_sink.h). Only the chunks listed in the index for the requested
+ *   owner are read. The index is written incrementally, so the logs of a simulation that did not
+ *   finish are extracted up to its last appended chunk.
+ *
+ * Usage: ./log_extractor <index_file> [<log file name>] (all the log files by default)
+ * The log files are written in the directory of the index file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "../list_of_macros.h"
+
+struct ExtractorChunk
+{
+	int shard;
+	unsigned long long offset;
+	unsigned long long length;
+};
+
+struct ExtractorOwner
+{
+	int shard;
+	std::string filename;
+	std::vector<ExtractorChunk> chunks;
+};
+
+/*
+ * ExtractOwner(): writes the records of one owner to its log file
+ * Input arguments:
+ * - owner_id: owner to extract
+ * - owner: owner information read from the index
+ * - shard_files: open segment files
+ * - directory: directory of the output file
+ */
+void ExtractOwner(int owner_id, const ExtractorOwner &owner, std::vector<FILE*> &shard_files,
+	const std::string &directory){
+
+	std::string path = directory + owner.filename;
+	FILE *output_file = fopen(path.c_str(), "wb");
+	if(output_file == NULL){
+		printf("ERROR: log file %s could not be created\n", path.c_str());
+		exit(-1);
+	}
+
+	std::vector<char> chunk;
+	for(size_t c = 0; c < owner.chunks.size(); ++c){
+		const ExtractorChunk &info = owner.chunks[c];
+		chunk.resize(info.length);
+		FILE *shard_file = shard_files[info.shard];
+		if(fseek(shard_file, (long) info.offset, SEEK_SET) != 0
+			|| fread(&chunk[0], 1, info.length, shard_file) != info.length){
+			printf("ERROR: chunk at offset %llu of shard %d is truncated\n", info.offset, info.shard);
+			exit(-1);
+		}
+		size_t position = 0;
+		while(position + LOG_SINK_RECORD_HEADER_SIZE <= chunk.size()){
+			uint32_t header[2];
+			memcpy(header, &chunk[position], LOG_SINK_RECORD_HEADER_SIZE);
+			position += LOG_SINK_RECORD_HEADER_SIZE;
+			if((int) header[0] == owner_id) fwrite(&chunk[position], 1, header[1], output_file);
+			position += header[1];
+		}
+	}
+	fclose(output_file);
+}
+
+int main(int argc, char *argv[]){
+
+	if(argc != 2 && argc != 3){
+		printf("ERROR: Console arguments were not set properly!\n"
+			" + Usage: ./log_extractor <index_file> [<log file name>]\n");
+		return -1;
+	}
+
+	std::string index_path(argv[1]);
+	size_t slash = index_path.find_last_of('/');
+	std::string directory = (slash == std::string::npos) ? "" : index_path.substr(0, slash + 1);
+
+	FILE *index_file = fopen(argv[1], "r");
+	if(index_file == NULL){
+		printf("ERROR: index file %s could not be opened\n", argv[1]);
+		return -1;
+	}
+
+	// Read the index
+	std::vector<std::string> shard_filenames;
+	std::vector<ExtractorOwner> owners;
+	char line[CHAR_BUFFER_SIZE];
+	int line_number (0);
+	int index_valid (TRUE);
+	while(fgets(line, sizeof(line), index_file)){
+		++line_number;
+		if(strchr(line, '\n') == NULL && feof(index_file)){
+			// Line cut by a crash while the index was being written: its chunk is not listed
+			printf("WARNING: last line of index file %s is incomplete and was ignored\n", argv[1]);
+			break;
+		}
+		line[strcspn(line, "\r\n")] = '\0';
+		int id, shard;
+		unsigned long long offset, length;
+		char name[CHAR_BUFFER_SIZE];
+		if(sscanf(line, "shard;%d;%1023[^\n]", &shard, name) == 2){
+			if(shard != (int) shard_filenames.size()){
+				index_valid = FALSE;
+				break;
+			}
+			shard_filenames.push_back(name);
+		} else if(sscanf(line, "owner;%d;%d;%1023[^\n]", &id, &shard, name) == 3){
+			if(id != (int) owners.size()){
+				index_valid = FALSE;
+				break;
+			}
+			ExtractorOwner owner;
+			owner.shard = shard;
+			owner.filename = name;
+			owners.push_back(owner);
+		} else if(sscanf(line, "chunk;%d;%d;%llu;%llu", &id, &shard, &offset, &length) == 4){
+			if(id < 0 || id >= (int) owners.size() || shard != owners[id].shard){
+				index_valid = FALSE;
+				break;
+			}
+			ExtractorChunk chunk = {shard, offset, length};
+			owners[id].chunks.push_back(chunk);
+		} else {
+			index_valid = FALSE;
+			break;
+		}
+	}
+	if(!index_valid){
+		printf("ERROR: index file %s is not valid (line %d)\n", argv[1], line_number);
+		return -1;
+	}
+	fclose(index_file);
+
+	std::vector<FILE*> shard_files;
+	for(size_t k = 0; k < shard_filenames.size(); ++k){
+		std::string path = directory + shard_filenames[k];
+		FILE *shard_file = fopen(path.c_str(), "rb");
+		if(shard_file == NULL){
+			printf("ERROR: log segment %s could not be opened\n", path.c_str());
+			return -1;
+		}
+		shard_files.push_back(shard_file);
+	}
+
+	// Extract the requested owner (or all of them)
+	int num_extracted (0);
+	for(size_t o = 0; o < owners.size(); ++o){
+		if(argc == 3 && owners[o].filename != argv[2]) continue;
+		if(owners[o].shard < 0 || owners[o].shard >= (int) shard_files.size()){
+			printf("ERROR: owner %s refers to unknown shard %d\n", owners[o].filename.c_str(), owners[o].shard);
+			return -1;
+		}
+		ExtractOwner((int) o, owners[o], shard_files, directory);
+		++num_extracted;
+	}
+
+	for(size_t k = 0; k < shard_files.size(); ++k) fclose(shard_files[k]);
+
+	if(argc == 3 && num_extracted == 0){
+		printf("ERROR: log file %s not found in the index\n", argv[2]);
+		return -1;
+	}
+	printf("%d log files extracted\n", num_extracted);
+
+	return 0;
+}
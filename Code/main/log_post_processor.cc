@@ -0,0 +1,667 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file post-processes the logs of batches of simulations:
+ *   + Script outputs (one line per simulation, e.g., " KOMONDOR SIMULATION
+ *     'sim_input_nodes_n20_s10_p0_cb4_load050.csv' (seed 1992);num_packets_generated;
+ *     average_num_packets_generated;throughput;rho;delay;utilization;drop_ratio"), from which the
+ *     statistics previously computed by Apps/CentralNodePostProcessing (Java + MySQL) are generated.
+ *   + Node logs, as text (save_node_logs == SAVE_LOG, or extracted with ./log_extractor) or as binary
+ *     traces (save_node_logs == SAVE_LOG_BINARY_TRACE, decoded on the fly), from which the lines per
+ *     LOG category and the time spent in every state are computed per node.
+ *   Files are processed in parallel, each of them in a single streaming pass: only the running
+ *   statistics of every (load, primary, policy) group, the AM/PU pairs not yet matched and the
+ *   counters of every node log are kept. The type of each line (and of each file) is detected.
+ *
+ * Usage: ./log_post_processor [options] <log_file> [<log_file> ...]
+ * Options:
+ *   --output_dir=<dir>				directory of the generated CSV files (default .)
+ *   --sim_time=<s>					simulation time of the runs (default 25)
+ *   --throughput_delta=<f>			load achieved if |throughput - generation rate| < f * load (default 0.05)
+ *   --delay_delta=<ms>				delay difference to declare a winner between AM and PU (default 1)
+ *   --threads=<N>					worker threads (default: number of cores)
+ * Generated files: generated_info.csv, delay_comparison.csv, probability_throughput_load_similar.csv,
+ * delay_load_similar.csv, delay_comparison_sim.csv, if the simulation codes contain the primary
+ * channel ('p<N>'), primary_study.csv and, if node logs are found, node_log_statistics.csv.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <atomic>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "../list_of_macros.h"
+#include "../structures/streaming_statistics.h"
+#include "../structures/trace.h"
+
+// Metrics of each simulation line
+#define LOG_METRIC_PKTS_GENERATED		0
+#define LOG_METRIC_AV_PKTS_GENERATED	1
+#define LOG_METRIC_THROUGHPUT			2
+#define LOG_METRIC_RHO					3
+#define LOG_METRIC_DELAY				4
+#define LOG_METRIC_UTILIZATION			5
+#define LOG_METRIC_DROP_RATIO			6
+#define NUM_LOG_METRICS					7
+
+// Sides of the delay comparison
+#define PAIR_AM		0	// CB_ALWAYS_MAX_LOG2
+#define PAIR_PU		1	// CB_PROB_UNIFORM_LOG2
+
+/*
+ * PostProcessorOptions: options entered per console
+ */
+struct PostProcessorOptions
+{
+	std::string output_dir;
+	double sim_time;
+	double throughput_delta;
+	double delay_delta;
+	int num_threads;
+};
+
+/*
+ * SimulationLog: line of a simulation in the script output
+ */
+struct SimulationLog
+{
+	int num_nodes;
+	int scenario_id;
+	int primary_channel;		// -1 if the simulation code does not contain it
+	int policy;					// Channel bonding model
+	int traffic_load;
+	double metrics[NUM_LOG_METRICS];
+};
+
+/*
+ * GroupStatistics: running statistics of the simulations of a (load, primary, policy) group
+ */
+struct GroupStatistics
+{
+	RunningStatistics metrics[NUM_LOG_METRICS];	// Every simulation of the group
+	RunningStatistics delay_nonzero;			// Delays > 0
+	RunningStatistics delay_load_achieved;		// Delays of the simulations where the load was achieved
+
+	void Merge(const GroupStatistics &other){
+		for(int m = 0; m < NUM_LOG_METRICS; ++m) metrics[m].Merge(other.metrics[m]);
+		delay_nonzero.Merge(other.delay_nonzero);
+		delay_load_achieved.Merge(other.delay_load_achieved);
+	}
+};
+
+/*
+ * PairedDelays: AM and PU simulations of the same scenario and load (matched as they are read)
+ */
+struct PairedDelays
+{
+	int has[2];
+	double delay[2];
+	int load_achieved[2];
+
+	PairedDelays() : has{FALSE, FALSE}, delay{0, 0}, load_achieved{FALSE, FALSE} {}
+};
+
+/*
+ * DelayComparison: AM vs. PU delay comparison of a traffic load
+ */
+struct DelayComparison
+{
+	long num_pairs;
+	long am_wins;
+	long pu_wins;
+	long sim_am_wins;	// Considering only the simulations where the load was achieved
+	long sim_pu_wins;
+	long sim_draws;
+
+	DelayComparison() : num_pairs(0), am_wins(0), pu_wins(0), sim_am_wins(0), sim_pu_wins(0), sim_draws(0) {}
+
+	void Merge(const DelayComparison &other){
+		num_pairs += other.num_pairs;
+		am_wins += other.am_wins;
+		pu_wins += other.pu_wins;
+		sim_am_wins += other.sim_am_wins;
+		sim_pu_wins += other.sim_pu_wins;
+		sim_draws += other.sim_draws;
+	}
+};
+
+/*
+ * NodeLogLine: line of a node log ("<time>;N<node>;S<state>;<LOG code>;<level> <message>")
+ */
+struct NodeLogLine
+{
+	double timestamp;
+	int node_id;
+	int state;
+	char category;			// First letter of the LOG code (e.g., 'D' for LOG_D08)
+};
+
+/*
+ * NodeLogStatistics: counters of the log of a node. The time between two consecutive lines is
+ * accounted to the state of the first one (the state logged at every event of the node).
+ */
+struct NodeLogStatistics
+{
+	long num_lines;
+	double first_time;
+	double last_time;
+	int last_state;
+	long lines_per_category[26];
+	std::map<int, double> time_per_state;
+
+	NodeLogStatistics() : num_lines(0), first_time(0), last_time(0), last_state(STATE_UNKNOWN),
+		lines_per_category() {}
+
+	void Add(const NodeLogLine &line){
+		if(num_lines == 0) first_time = line.timestamp;
+		else time_per_state[last_state] += line.timestamp - last_time;
+		last_time = line.timestamp;
+		last_state = line.state;
+		++lines_per_category[line.category - 'A'];
+		++num_lines;
+	}
+};
+
+typedef std::tuple<int, int, int> GroupKey;			// Load, primary, policy
+typedef std::tuple<int, int, int, int> PairKey;		// Number of nodes, scenario, primary, load
+typedef std::pair<std::string, int> NodeLogKey;		// Log file, node
+
+/*
+ * PostProcessorState: everything kept while streaming through the files
+ */
+struct PostProcessorState
+{
+	const PostProcessorOptions *options;
+	std::map<GroupKey, GroupStatistics> groups;
+	std::map<PairKey, PairedDelays> pending_pairs;
+	std::map<int, DelayComparison> comparisons;
+	std::map<NodeLogKey, NodeLogStatistics> node_logs;
+	long num_logs;
+	long num_node_log_lines;
+	long num_skipped_lines;
+
+	PostProcessorState() : options(NULL), num_logs(0), num_node_log_lines(0), num_skipped_lines(0) {}
+
+	/*
+	 * AddLog(): adds a simulation
+	 */
+	void AddLog(const SimulationLog &log){
+
+		const double *metrics (log.metrics);
+		int load_achieved (fabs(metrics[LOG_METRIC_THROUGHPUT] - metrics[LOG_METRIC_PKTS_GENERATED] / options->sim_time)
+			< options->throughput_delta * log.traffic_load);
+
+		GroupStatistics &group = groups[GroupKey(log.traffic_load, log.primary_channel, log.policy)];
+		for(int m = 0; m < NUM_LOG_METRICS; ++m) group.metrics[m].Add(metrics[m]);
+		if(metrics[LOG_METRIC_DELAY] > 0) group.delay_nonzero.Add(metrics[LOG_METRIC_DELAY]);
+		if(load_achieved) group.delay_load_achieved.Add(metrics[LOG_METRIC_DELAY]);
+
+		if(log.policy == CB_ALWAYS_MAX_LOG2 || log.policy == CB_PROB_UNIFORM_LOG2){
+			PairedDelays half;
+			int side (log.policy == CB_ALWAYS_MAX_LOG2 ? PAIR_AM : PAIR_PU);
+			half.has[side] = TRUE;
+			half.delay[side] = metrics[LOG_METRIC_DELAY];
+			half.load_achieved[side] = load_achieved;
+			AddPairHalf(PairKey(log.num_nodes, log.scenario_id, log.primary_channel, log.traffic_load), half);
+		}
+		++num_logs;
+	}
+
+	/*
+	 * AddNodeLogLine(): adds a line of the log of a node
+	 */
+	void AddNodeLogLine(const char *filename, const NodeLogLine &line){
+		node_logs[NodeLogKey(filename, line.node_id)].Add(line);
+		++num_node_log_lines;
+	}
+
+	/*
+	 * AddPairHalf(): matches one or both sides of a pair, comparing the delays once both are known
+	 */
+	void AddPairHalf(const PairKey &key, const PairedDelays &half){
+		PairedDelays &pair = pending_pairs[key];
+		for(int side = 0; side < 2; ++side){
+			if(!half.has[side]) continue;
+			pair.has[side] = TRUE;
+			pair.delay[side] = half.delay[side];
+			pair.load_achieved[side] = half.load_achieved[side];
+		}
+		if(pair.has[PAIR_AM] && pair.has[PAIR_PU]){
+			CompareDelays(std::get<3>(key), pair);
+			pending_pairs.erase(key);
+		}
+	}
+
+	/*
+	 * CompareDelays(): AM vs. PU delay comparison (same criteria as Post_processer.java)
+	 */
+	void CompareDelays(int traffic_load, const PairedDelays &pair){
+
+		DelayComparison &comparison = comparisons[traffic_load];
+		double delay_dif (pair.delay[PAIR_PU] - pair.delay[PAIR_AM]);
+
+		++comparison.num_pairs;
+		if(delay_dif > options->delay_delta) ++comparison.am_wins;
+		else if(delay_dif < -options->delay_delta) ++comparison.pu_wins;
+
+		if(pair.load_achieved[PAIR_AM] && pair.load_achieved[PAIR_PU]){
+			if(delay_dif > options->delay_delta) ++comparison.sim_am_wins;
+			else if(delay_dif < -options->delay_delta) ++comparison.sim_pu_wins;
+			else ++comparison.sim_draws;
+		} else if(pair.load_achieved[PAIR_AM]){
+			++comparison.sim_am_wins;
+		} else if(pair.load_achieved[PAIR_PU]){
+			++comparison.sim_pu_wins;
+		}
+	}
+
+	/*
+	 * Merge(): adds the state of another worker
+	 */
+	void Merge(const PostProcessorState &other){
+		for(std::map<GroupKey, GroupStatistics>::const_iterator it = other.groups.begin(); it != other.groups.end(); ++it){
+			groups[it->first].Merge(it->second);
+		}
+		for(std::map<int, DelayComparison>::const_iterator it = other.comparisons.begin();
+			it != other.comparisons.end(); ++it){
+			comparisons[it->first].Merge(it->second);
+		}
+		for(std::map<PairKey, PairedDelays>::const_iterator it = other.pending_pairs.begin();
+			it != other.pending_pairs.end(); ++it){
+			AddPairHalf(it->first, it->second);
+		}
+		node_logs.insert(other.node_logs.begin(), other.node_logs.end());	// Each file is read by a single worker
+		num_logs += other.num_logs;
+		num_node_log_lines += other.num_node_log_lines;
+		num_skipped_lines += other.num_skipped_lines;
+	}
+};
+
+/*
+ * ParseTaggedNumber(): parses a token made of a tag followed by digits (e.g., "cb4")
+ */
+int ParseTaggedNumber(const std::string &token, const char *tag, int *value){
+	size_t tag_length (strlen(tag));
+	if(token.size() <= tag_length || token.compare(0, tag_length, tag) != 0) return FALSE;
+	for(size_t c = tag_length; c < token.size(); ++c){
+		if(token[c] < '0' || token[c] > '9') return FALSE;
+	}
+	*value = atoi(token.c_str() + tag_length);
+	return TRUE;
+}
+
+/*
+ * ParseSimulationLog(): parses a simulation line of the script output
+ * Output:
+ * - TRUE if the line is a simulation whose code identifies scenario, policy and load
+ */
+int ParseSimulationLog(const char *line, SimulationLog &log){
+
+	const char *header = "KOMONDOR SIMULATION '";
+	const char *start (strstr(line, header));
+	if(start == NULL) return FALSE;
+	start += strlen(header);
+	const char *end (strchr(start, '\''));
+	if(end == NULL) return FALSE;
+
+	// Simulation code: sim_input_nodes_n<nodes>_s<scenario>[_p<primary>]_cb<policy>_load<load>.csv
+	std::string code (start, end - start);
+	size_t extension (code.find_last_of('.'));
+	if(extension != std::string::npos) code.erase(extension);
+	log.num_nodes = -1;
+	log.scenario_id = -1;
+	log.primary_channel = -1;
+	log.policy = -1;
+	log.traffic_load = -1;
+	size_t from (0);
+	while(from <= code.size()){
+		size_t to (code.find('_', from));
+		if(to == std::string::npos) to = code.size();
+		std::string token (code.substr(from, to - from));
+		if(!ParseTaggedNumber(token, "cb", &log.policy) && !ParseTaggedNumber(token, "load", &log.traffic_load)
+			&& !ParseTaggedNumber(token, "n", &log.num_nodes) && !ParseTaggedNumber(token, "s", &log.scenario_id)) {
+			ParseTaggedNumber(token, "p", &log.primary_channel);
+		}
+		from = to + 1;
+	}
+	if(log.scenario_id < 0 || log.policy < 0 || log.traffic_load < 0) return FALSE;
+
+	// Metrics
+	const char *field (strchr(end, ';'));
+	for(int m = 0; m < NUM_LOG_METRICS; ++m){
+		if(field == NULL) return FALSE;
+		char *field_end;
+		log.metrics[m] = strtod(field + 1, &field_end);
+		if(field_end == field + 1) return FALSE;
+		field = strchr(field_end, ';');
+	}
+	return TRUE;
+}
+
+/*
+ * ParseNodeLogLine(): parses a line of a node log
+ * Output:
+ * - TRUE if the line starts with the header of the node log lines (TRACE_LOG_HEADER)
+ */
+int ParseNodeLogLine(const char *line, NodeLogLine &log_line){
+
+	char code[4];
+	int length (0);
+	if(sscanf(line, "%lf;N%d;S%d;%3[A-Z0-9];%n", &log_line.timestamp, &log_line.node_id, &log_line.state, code,
+		&length) != 4 || length == 0 || strlen(code) != 3 || code[0] < 'A' || code[0] > 'Z') return FALSE;
+	log_line.category = code[0];
+	return TRUE;
+}
+
+/*
+ * ProcessFile(): streams through a log file (script output, node log or binary trace)
+ */
+void ProcessFile(const char *filename, PostProcessorState &state){
+
+	FILE *file = fopen(filename, "rb");
+	if(file == NULL){
+		printf("ERROR: log file %s could not be opened\n", filename);
+		exit(-1);
+	}
+
+	// Binary traces are decoded into a temporary file, which is then read as a text log
+	char magic[TRACE_MAGIC_SIZE];
+	if(fread(magic, 1, TRACE_MAGIC_SIZE, file) == TRACE_MAGIC_SIZE && memcmp(magic, TRACE_MAGIC, TRACE_MAGIC_SIZE) == 0){
+		FILE *decoded_file = tmpfile();
+		if(decoded_file == NULL){
+			printf("ERROR: trace file %s could not be decoded (no temporary file)\n", filename);
+			exit(-1);
+		}
+		rewind(file);
+		DecodeTraceFile(file, filename, decoded_file);
+		fclose(file);
+		file = decoded_file;
+	}
+	rewind(file);
+
+	char *line (NULL);
+	size_t line_capacity (0);
+	SimulationLog log;
+	NodeLogLine log_line;
+	while(getline(&line, &line_capacity, file) != -1){
+		if(ParseNodeLogLine(line, log_line)) state.AddNodeLogLine(filename, log_line);
+		else if(ParseSimulationLog(line, log)) state.AddLog(log);
+		else ++state.num_skipped_lines;
+	}
+	free(line);
+	fclose(file);
+}
+
+/*
+ * PolicyName(): column name of a channel bonding policy in the generated files
+ */
+std::string PolicyName(int policy){
+	switch(policy){
+		case CB_ONLY_PRIMARY: return "OP";
+		case CB_SCB_LOG2: return "SCB";
+		case CB_ALWAYS_MAX_LOG2: return "AM";
+		case CB_PROB_UNIFORM_LOG2: return "PU";
+		default: return "cb" + std::to_string(policy);
+	}
+}
+
+/*
+ * OpenOutputFile(): creates one of the generated files
+ */
+FILE *OpenOutputFile(const PostProcessorOptions &options, const char *name){
+	std::string path (options.output_dir + "/" + name);
+	FILE *file = fopen(path.c_str(), "w");
+	if(file == NULL){
+		printf("ERROR: output file %s could not be created\n", path.c_str());
+		exit(-1);
+	}
+	printf("%s File saved in %s\n", LOG_LVL2, path.c_str());
+	return file;
+}
+
+/*
+ * WriteOutputFiles(): writes the statistics (same files as Post_processer.java and Post_processer_primary.java)
+ */
+void WriteOutputFiles(const PostProcessorOptions &options, const PostProcessorState &state){
+
+	// Groups without primary distinction: (policy, load)
+	std::map<std::pair<int,int>, GroupStatistics> policy_load_groups;
+	std::set<int> policies, loads;
+	int primary_found (FALSE);
+	for(std::map<GroupKey, GroupStatistics>::const_iterator it = state.groups.begin(); it != state.groups.end(); ++it){
+		int load (std::get<0>(it->first)), primary (std::get<1>(it->first)), policy (std::get<2>(it->first));
+		policy_load_groups[std::make_pair(policy, load)].Merge(it->second);
+		policies.insert(policy);
+		loads.insert(load);
+		if(primary >= 0) primary_found = TRUE;
+	}
+
+	// Average metrics per policy and load
+	FILE *file (OpenOutputFile(options, "generated_info.csv"));
+	fprintf(file, "cb_type;load;num_pkt_gen;through;rho;delay;util;drop;std_delay;\n");
+	for(std::map<std::pair<int,int>, GroupStatistics>::const_iterator it = policy_load_groups.begin();
+		it != policy_load_groups.end(); ++it){
+		const GroupStatistics &group = it->second;
+		fprintf(file, "%d;%d;%f;%f;%f;%f;%f;%f;%f\n", it->first.first, it->first.second,
+			group.metrics[LOG_METRIC_PKTS_GENERATED].mean, group.metrics[LOG_METRIC_THROUGHPUT].mean,
+			group.metrics[LOG_METRIC_RHO].mean, group.delay_nonzero.mean, group.metrics[LOG_METRIC_UTILIZATION].mean,
+			group.metrics[LOG_METRIC_DROP_RATIO].mean, sqrt(group.delay_nonzero.Variance()));
+	}
+	fclose(file);
+
+	// Delay comparison AM vs. PU (percentage of scenarios)
+	file = OpenOutputFile(options, "delay_comparison.csv");
+	fprintf(file, "load (delta_delay = %g);AM;PU;Draw;\n", options.delay_delta);
+	for(std::map<int, DelayComparison>::const_iterator it = state.comparisons.begin(); it != state.comparisons.end(); ++it){
+		const DelayComparison &comparison = it->second;
+		fprintf(file, "%d;%ld;%ld;%ld\n", it->first, comparison.am_wins * 100 / comparison.num_pairs,
+			comparison.pu_wins * 100 / comparison.num_pairs,
+			(comparison.num_pairs - comparison.am_wins - comparison.pu_wins) * 100 / comparison.num_pairs);
+	}
+	fclose(file);
+
+	// Percentage of simulations where the load is achieved, and their delay
+	FILE *probability_file (OpenOutputFile(options, "probability_throughput_load_similar.csv"));
+	FILE *delay_file (OpenOutputFile(options, "delay_load_similar.csv"));
+	fprintf(probability_file, "load (THROUGHPUT_DELTA_FACTOR = %g);", options.throughput_delta);
+	fprintf(delay_file, "load (THROUGHPUT_DELTA_FACTOR = %g);", options.throughput_delta);
+	for(std::set<int>::const_iterator p = policies.begin(); p != policies.end(); ++p){
+		fprintf(probability_file, "%s;", PolicyName(*p).c_str());
+		fprintf(delay_file, "%s;", PolicyName(*p).c_str());
+	}
+	for(std::set<int>::const_iterator p = policies.begin(); p != policies.end(); ++p){
+		fprintf(delay_file, "std_%s;", PolicyName(*p).c_str());
+	}
+	fprintf(probability_file, "\n");
+	fprintf(delay_file, "\n");
+	for(std::set<int>::const_iterator l = loads.begin(); l != loads.end(); ++l){
+		fprintf(probability_file, "%d;", *l);
+		fprintf(delay_file, "%d;", *l);
+		for(std::set<int>::const_iterator p = policies.begin(); p != policies.end(); ++p){
+			std::map<std::pair<int,int>, GroupStatistics>::const_iterator group (policy_load_groups.find(std::make_pair(*p, *l)));
+			if(group == policy_load_groups.end()){
+				fprintf(probability_file, ";");
+				fprintf(delay_file, ";");
+				continue;
+			}
+			fprintf(probability_file, "%f;", (double) group->second.delay_load_achieved.num_samples * 100
+				/ group->second.metrics[LOG_METRIC_DELAY].num_samples);
+			fprintf(delay_file, "%f;", group->second.delay_load_achieved.num_samples > 0 ?
+				group->second.delay_load_achieved.mean : NAN);
+		}
+		for(std::set<int>::const_iterator p = policies.begin(); p != policies.end(); ++p){
+			std::map<std::pair<int,int>, GroupStatistics>::const_iterator group (policy_load_groups.find(std::make_pair(*p, *l)));
+			if(group == policy_load_groups.end() || group->second.delay_load_achieved.num_samples == 0){
+				fprintf(delay_file, "%f;", NAN);
+			} else {
+				fprintf(delay_file, "%f;", sqrt(group->second.delay_load_achieved.PopulationVariance()));
+			}
+		}
+		fprintf(probability_file, "\n");
+		fprintf(delay_file, "\n");
+	}
+	fclose(probability_file);
+	fclose(delay_file);
+
+	// Delay comparison AM vs. PU considering whether the load is achieved (number of scenarios)
+	file = OpenOutputFile(options, "delay_comparison_sim.csv");
+	fprintf(file, "load (delta_delay = %g);AM;PU;DRAW\n", options.delay_delta);
+	for(std::map<int, DelayComparison>::const_iterator it = state.comparisons.begin(); it != state.comparisons.end(); ++it){
+		fprintf(file, "%d;%ld;%ld;%ld\n", it->first, it->second.sim_am_wins, it->second.sim_pu_wins, it->second.sim_draws);
+	}
+	fclose(file);
+
+	// Average metrics per load, primary and policy
+	if(primary_found){
+		file = OpenOutputFile(options, "primary_study.csv");
+		fprintf(file, "traffic_load;primary;policy;num_pkts_generated;av_num_pkts_generated;throughput;rho;delay;"
+			"utilization;drop_ratio;\n");
+		for(std::map<GroupKey, GroupStatistics>::const_iterator it = state.groups.begin(); it != state.groups.end(); ++it){
+			fprintf(file, "%d;%d;%d", std::get<0>(it->first), std::get<1>(it->first), std::get<2>(it->first));
+			for(int m = 0; m < NUM_LOG_METRICS; ++m) fprintf(file, ";%f", it->second.metrics[m].mean);
+			fprintf(file, ";\n");
+		}
+		fclose(file);
+	}
+
+	// Lines per LOG category and time per state of every node log (only the categories and states found)
+	if(!state.node_logs.empty()){
+		std::set<int> categories, states;
+		for(std::map<NodeLogKey, NodeLogStatistics>::const_iterator it = state.node_logs.begin();
+			it != state.node_logs.end(); ++it){
+			for(int c = 0; c < 26; ++c) if(it->second.lines_per_category[c] > 0) categories.insert(c);
+			for(std::map<int, double>::const_iterator s = it->second.time_per_state.begin();
+				s != it->second.time_per_state.end(); ++s){
+				states.insert(s->first);
+			}
+		}
+		file = OpenOutputFile(options, "node_log_statistics.csv");
+		fprintf(file, "log_file;node;lines;first_time;last_time");
+		for(std::set<int>::const_iterator c = categories.begin(); c != categories.end(); ++c){
+			fprintf(file, ";lines_%c", 'A' + *c);
+		}
+		for(std::set<int>::const_iterator s = states.begin(); s != states.end(); ++s) fprintf(file, ";time_S%d", *s);
+		fprintf(file, "\n");
+		for(std::map<NodeLogKey, NodeLogStatistics>::const_iterator it = state.node_logs.begin();
+			it != state.node_logs.end(); ++it){
+			const NodeLogStatistics &node_log = it->second;
+			fprintf(file, "%s;%d;%ld;%.15f;%.15f", it->first.first.c_str(), it->first.second, node_log.num_lines,
+				node_log.first_time, node_log.last_time);
+			for(std::set<int>::const_iterator c = categories.begin(); c != categories.end(); ++c){
+				fprintf(file, ";%ld", node_log.lines_per_category[*c]);
+			}
+			for(std::set<int>::const_iterator s = states.begin(); s != states.end(); ++s){
+				std::map<int, double>::const_iterator time (node_log.time_per_state.find(*s));
+				fprintf(file, ";%.15f", time == node_log.time_per_state.end() ? 0 : time->second);
+			}
+			fprintf(file, "\n");
+		}
+		fclose(file);
+	}
+}
+
+int main(int argc, char *argv[]){
+
+	PostProcessorOptions options;
+	options.output_dir = ".";
+	options.sim_time = POST_PROCESSOR_DEFAULT_SIM_TIME;
+	options.throughput_delta = POST_PROCESSOR_DEFAULT_THROUGHPUT_DELTA;
+	options.delay_delta = POST_PROCESSOR_DEFAULT_DELAY_DELTA;
+	options.num_threads = std::thread::hardware_concurrency();
+
+	int arg_ix (1);
+	for(; arg_ix < argc && strncmp(argv[arg_ix], "--", 2) == 0; ++arg_ix){
+		const char *argument (argv[arg_ix]);
+		if(strncmp(argument, "--output_dir=", 13) == 0) options.output_dir = argument + 13;
+		else if(strncmp(argument, "--sim_time=", 11) == 0) options.sim_time = atof(argument + 11);
+		else if(strncmp(argument, "--throughput_delta=", 19) == 0) options.throughput_delta = atof(argument + 19);
+		else if(strncmp(argument, "--delay_delta=", 14) == 0) options.delay_delta = atof(argument + 14);
+		else if(strncmp(argument, "--threads=", 10) == 0) options.num_threads = atoi(argument + 10);
+		else {
+			printf("ERROR: unknown option %s\n", argument);
+			return -1;
+		}
+	}
+
+	if(arg_ix >= argc){
+		printf("ERROR: Console arguments were not set properly!\n"
+			" + Usage: ./log_post_processor [--output_dir=<dir>] [--sim_time=<s>] [--throughput_delta=<f>]"
+			" [--delay_delta=<ms>] [--threads=<N>] <log_file> [<log_file> ...]\n");
+		return -1;
+	}
+
+	// Process the files in parallel (each worker takes the next file not processed yet)
+	int num_files (argc - arg_ix);
+	int num_workers (options.num_threads < 1 ? 1 : (options.num_threads > num_files ? num_files : options.num_threads));
+	std::vector<PostProcessorState> states (num_workers);
+	std::vector<std::thread> workers;
+	std::atomic<int> next_file (arg_ix);
+	for(int w = 0; w < num_workers; ++w){
+		states[w].options = &options;
+		workers.push_back(std::thread([&, w]() {
+			int file_ix;
+			while((file_ix = next_file++) < argc) ProcessFile(argv[file_ix], states[w]);
+		}));
+	}
+	for(int w = 0; w < num_workers; ++w) workers[w].join();
+	for(int w = 1; w < num_workers; ++w) states[0].Merge(states[w]);
+
+	printf("%s %ld simulations and %ld node log lines (%d node logs) processed from %d files (%d threads, "
+		"%ld lines skipped, %d AM/PU pairs unmatched)\n", LOG_LVL1, states[0].num_logs, states[0].num_node_log_lines,
+		(int) states[0].node_logs.size(), num_files, num_workers, states[0].num_skipped_lines,
+		(int) states[0].pending_pairs.size());
+
+	WriteOutputFiles(options, states[0]);
+
+	return 0;
+}
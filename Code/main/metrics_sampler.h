@@ -0,0 +1,222 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: defines the metrics sampler component
+ *
+ * - This file contains the periodic sampler of node and agent counters. Every sampling interval
+ * the sampler requests a snapshot from all the nodes and agents and appends one line to a
+ * columnar CSV file, so that nothing is done per event and the logs can stay disabled.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../list_of_macros.h"
+#include "../structures/metrics.h"
+#include "../structures/node_order.h"
+#include "../methods/auxiliary_methods.h"
+
+// Metrics sampler component: "TypeII" represents components that are aware of the existence of the simulated time.
+component MetricsSampler : public TypeII{
+
+	// Methods
+	public:
+
+		// COST
+		void Setup();
+		void Start();
+		void Stop();
+
+		// Output file
+		void WriteHeader();
+		void WriteSample();
+
+	// Public items (entered by Komondor)
+	public:
+
+		double sampling_interval;		// Time between samples [s]
+		std::string metrics_filename;	// Output CSV file
+		int total_nodes_number;			// Number of nodes in the system
+		int total_agents_number;		// Number of agents in the system (0 if agents are not enabled)
+
+	// Private items
+	private:
+
+		FILE *metrics_file;						// Output CSV file
+		MetricsSnapshot snapshot;				// Counters filled by nodes and agents at each sample
+		std::vector<std::string> wlan_codes;	// WLANs in order of appearance (one throughput column each)
+		std::vector<int> node_wlan_ix;			// Index in 'wlan_codes' of the WLAN of each node
+		std::vector<double> last_bits_acked;	// Bits acked per node at the previous sample [bits]
+		std::vector<double> last_time_in_nav;	// Time in NAV per node at the previous sample [s]
+		std::vector<double> wlan_throughput;	// Throughput of each WLAN during the last interval [Mbps]
+		double last_sample_time;				// Time of the previous sample [s]
+
+	// Connections and timers
+	public:
+
+		// OUTPORT connections for requesting the counters of nodes and agents
+		outport void outportRequestMetrics(MetricsSnapshot &snapshot);
+
+		// Triggers
+		Timer <trigger_t> trigger_sample;	// Timer for taking the next sample
+
+		// Every time the timer expires execute this
+		inport inline void Sample(trigger_t& t1);
+
+		// Connect timers to methods
+		MetricsSampler () {
+			connect trigger_sample.to_component,Sample;
+		}
+
+};
+
+/*
+ * Setup()
+ */
+void MetricsSampler :: Setup(){
+	// Do nothing
+};
+
+/*
+ * Start()
+ */
+void MetricsSampler :: Start(){
+
+	metrics_file = fopen(metrics_filename.c_str(), "w");
+	if(metrics_file == NULL){
+		printf("ERROR: metrics file '%s' could not be created\n", metrics_filename.c_str());
+		exit(-1);
+	}
+
+	snapshot.nodes.resize(total_nodes_number);
+	snapshot.agents.resize(total_agents_number);
+	last_bits_acked.assign(total_nodes_number, 0);
+	last_time_in_nav.assign(total_nodes_number, 0);
+	last_sample_time = SimTime();
+
+	trigger_sample.Set(fix_time_offset(SimTime() + sampling_interval, 13, 12));
+
+};
+
+/*
+ * Stop()
+ */
+void MetricsSampler :: Stop(){
+
+	if(metrics_file != NULL) fclose(metrics_file);
+
+};
+
+/*
+ * Sample(): requests the counters of every node and agent and appends them to the metrics file
+ */
+void MetricsSampler :: Sample(trigger_t &){
+
+	outportRequestMetrics(snapshot);
+
+	// The WLAN columns are known once the nodes have answered for the first time
+	if(wlan_codes.empty()) WriteHeader();
+
+	WriteSample();
+
+	last_sample_time = SimTime();
+	trigger_sample.Set(fix_time_offset(SimTime() + sampling_interval, 13, 12));
+
+};
+
+/*
+ * WriteHeader(): writes the column names. Columns: time, throughput of each WLAN, then buffer size,
+ * primary channel power, CW stage and NAV fraction of each node, and the arm selected by each agent.
+ */
+void MetricsSampler :: WriteHeader(){
+
+	// Nodes (and WLANs) are written in the order of the nodes file, even if they were renumbered
+	node_wlan_ix.resize(total_nodes_number);
+	for(int k = 0; k < total_nodes_number; ++k){
+		int n (NodeIdInOriginalOrder(k));
+		size_t w (0);
+		while(w < wlan_codes.size() && wlan_codes[w] != snapshot.nodes[n].wlan_code) ++w;
+		if(w == wlan_codes.size()) wlan_codes.push_back(snapshot.nodes[n].wlan_code);
+		node_wlan_ix[n] = w;
+	}
+	wlan_throughput.resize(wlan_codes.size());
+
+	fprintf(metrics_file, "time");
+	for(size_t w = 0; w < wlan_codes.size(); ++w) fprintf(metrics_file, ";throughput_%s", wlan_codes[w].c_str());
+	for(int k = 0; k < total_nodes_number; ++k){
+		fprintf(metrics_file, ";buffer_N%d;power_N%d;cw_stage_N%d;nav_N%d", k, k, k, k);
+	}
+	for(int a = 0; a < total_agents_number; ++a) fprintf(metrics_file, ";arm_A%d", a);
+	fprintf(metrics_file, "\n");
+
+}
+
+/*
+ * WriteSample(): appends the line of the current sample (rates are computed over the last interval)
+ */
+void MetricsSampler :: WriteSample(){
+
+	double interval (SimTime() - last_sample_time);
+
+	std::fill(wlan_throughput.begin(), wlan_throughput.end(), 0);
+	for(int n = 0; n < total_nodes_number; ++n){
+		wlan_throughput[node_wlan_ix[n]] += (snapshot.nodes[n].bits_acked - last_bits_acked[n]) / interval;
+	}
+
+	fprintf(metrics_file, "%.6f", SimTime());
+	for(size_t w = 0; w < wlan_codes.size(); ++w) fprintf(metrics_file, ";%.3f", wlan_throughput[w] * pow(10,-6));
+	for(int k = 0; k < total_nodes_number; ++k){
+		int n (NodeIdInOriginalOrder(k));
+		const NodeMetrics &metrics = snapshot.nodes[n];
+		fprintf(metrics_file, ";%d;%.2f;%d;%.4f", metrics.buffer_size, metrics.primary_power, metrics.cw_stage,
+			(metrics.time_in_nav - last_time_in_nav[n]) / interval);
+		last_bits_acked[n] = metrics.bits_acked;
+		last_time_in_nav[n] = metrics.time_in_nav;
+	}
+	for(int a = 0; a < total_agents_number; ++a) fprintf(metrics_file, ";%d", snapshot.agents[a].selected_arm);
+	fprintf(metrics_file, "\n");
+
+}
@@ -0,0 +1,201 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: defines the mobility manager component
+ *
+ * - This file contains the manager of node positions. Every mobility interval a random subset of
+ * the STAs takes one step of a random walk around its AP, and the moved nodes are broadcast to all
+ * the nodes, which only recompute the distances and received powers related to them.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+#include "../list_of_macros.h"
+#include "../structures/wlan.h"
+#include "../structures/mobility.h"
+#include "../methods/auxiliary_methods.h"
+
+// Mobility manager component: "TypeII" represents components that are aware of the existence of the simulated time.
+component MobilityManager : public TypeII{
+
+	// Methods
+	public:
+
+		// COST
+		void Setup();
+		void Start();
+		void Stop();
+
+		// Random walk
+		void Step(int s);
+
+	// Public items (entered by Komondor)
+	public:
+
+		double interval;					// Time between position updates [s]
+		double speed;						// Speed of the mobile STAs [m/s]
+		double fraction;					// Fraction of STAs that move
+		double radius;						// Maximum distance between a STA and its AP [m] (0: initial distance)
+		int total_nodes_number;				// Number of nodes in the system
+		const Wlan *wlan_container;			// WLANs of the system
+		std::vector<double> x;				// X position of every node [m]
+		std::vector<double> y;				// Y position of every node [m]
+		std::vector<double> z;				// Z position of every node [m]
+		std::vector<double> tx_power;		// Default transmission power of every node [pW]
+		std::vector<double> tx_gain;		// Transmission gain of every node [linear]
+		std::vector<int> wlan_ix;			// Index of the WLAN of every node in 'wlan_container'
+		std::vector<int> ap_id;				// AP of every STA (NODE_ID_NONE for the APs)
+
+	// Private items
+	private:
+
+		MobilityUpdate update;				// Moved nodes broadcast at each interval
+		std::vector<int> mobile_stas;		// STAs that take part in the random walk
+		std::vector<double> max_distance;	// Maximum distance to its AP of every mobile STA [m]
+		int num_updates;					// Position updates done so far
+
+	// Connections and timers
+	public:
+
+		// OUTPORT connections for notifying the nodes about the new positions
+		outport void outportNodesMoved(MobilityUpdate &update);
+
+		// Triggers
+		Timer <trigger_t> trigger_move;		// Timer for the next position update
+
+		// Every time the timer expires execute this
+		inport inline void Move(trigger_t& t1);
+
+		// Connect timers to methods
+		MobilityManager () {
+			connect trigger_move.to_component,Move;
+		}
+
+};
+
+/*
+ * Setup()
+ */
+void MobilityManager :: Setup(){
+	// Do nothing
+};
+
+/*
+ * Start(): selects the mobile STAs and schedules the first position update
+ */
+void MobilityManager :: Start(){
+
+	for(int n = 0; n < total_nodes_number; ++n){
+		if(ap_id[n] == NODE_ID_NONE || Random() >= fraction) continue;
+		int ap (ap_id[n]);
+		double initial_distance (sqrt(pow(x[n] - x[ap], 2) + pow(y[n] - y[ap], 2)));
+		mobile_stas.push_back(n);
+		max_distance.push_back(radius > 0 ? radius : std::max(initial_distance, (double) MOBILITY_MIN_RADIUS));
+	}
+
+	update.moved_nodes = mobile_stas;
+	update.x = x.data();
+	update.y = y.data();
+	update.z = z.data();
+	update.tx_power = tx_power.data();
+	update.tx_gain = tx_gain.data();
+	update.wlan_ix = wlan_ix.data();
+	update.wlan_container = wlan_container;
+	update.total_nodes_number = total_nodes_number;
+	num_updates = 0;
+
+	if(!mobile_stas.empty() && speed > 0) trigger_move.Set(fix_time_offset(SimTime() + interval, 13, 12));
+
+};
+
+/*
+ * Stop()
+ */
+void MobilityManager :: Stop(){
+
+	printf("%s Mobility: %d STAs moved %d times (every %.3f s at %.2f m/s)\n", LOG_LVL2,
+		(int) mobile_stas.size(), num_updates, interval, speed);
+
+};
+
+/*
+ * Move(): moves every mobile STA one step and notifies the nodes
+ */
+void MobilityManager :: Move(trigger_t &){
+
+	for(size_t s = 0; s < mobile_stas.size(); ++s) Step(s);
+	++num_updates;
+
+	outportNodesMoved(update);
+
+	trigger_move.Set(fix_time_offset(SimTime() + interval, 13, 12));
+
+};
+
+/*
+ * Step(): moves a mobile STA in a random direction (the height is kept). A STA leaving the
+ * circle around its AP is brought back to its edge.
+ * Input arguments:
+ * - s: index of the STA in 'mobile_stas'
+ */
+void MobilityManager :: Step(int s){
+
+	int n (mobile_stas[s]);
+	int ap (ap_id[n]);
+	double heading (Random(2 * M_PI));
+	double new_x (x[n] + speed * interval * cos(heading));
+	double new_y (y[n] + speed * interval * sin(heading));
+
+	double distance (sqrt(pow(new_x - x[ap], 2) + pow(new_y - y[ap], 2)));
+	if(distance > max_distance[s]){
+		new_x = x[ap] + (new_x - x[ap]) * max_distance[s] / distance;
+		new_y = y[ap] + (new_y - y[ap]) * max_distance[s] / distance;
+	}
+
+	x[n] = new_x;
+	y[n] = new_y;
+
+}
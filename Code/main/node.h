@@ -52,6 +52,7 @@
 #include <stddef.h>
 #include <iostream>
 #include <stdlib.h>
+#include <type_traits>
 
 #include "../list_of_macros.h"
 #include "../methods/auxiliary_methods.h"
@@ -61,20 +62,34 @@
 #include "../methods/notification_methods.h"
 #include "../methods/time_methods.h"
 #include "../methods/spatial_reuse_methods.h"
+#include "../methods/agent_methods.h"
 #include "../structures/notification.h"
 #include "../structures/logical_nack.h"
 #include "../structures/wlan.h"
 #include "../structures/logger.h"
+#include "../structures/log_filter.h"
 #include "../structures/FIFO.h"
 #include "../structures/node_configuration.h"
 #include "../structures/performance_metrics.h"
+#include "../structures/metrics.h"
+#include "../structures/mobility.h"
+#include "../structures/delay_histogram.h"
 
 #define __SAVELOGS__
 
+// Level and category of each line are compile-time constants taken from its arguments (see log_filter.h).
+// With logging off only the flag is tested; the arguments are only evaluated if the line is written.
+// The format string of each line is parsed once, when its LogSite is built (see trace.h).
 #ifdef __SAVELOGS__
-    #define    LOGS(flag,file,...)    if(flag){fprintf(file, ##__VA_ARGS__);}
+    #define    LOG_SITE_FORMAT(format,...)    format
+    #define    LOGS(flag,logger,...)    if((flag) && log_filter.Passes( \
+        std::integral_constant<int, LogLevelOf(#__VA_ARGS__)>::value, \
+        std::integral_constant<int, LogCategoryOf(#__VA_ARGS__)>::value, SimTime())){ \
+        static const LogSite log_site(LOG_SITE_FORMAT(__VA_ARGS__, 0)); \
+        (void) sizeof(LogFormatCheck(__VA_ARGS__)); \
+        LogPrintf(logger, log_site, ##__VA_ARGS__);}
 #else
-    #define    LOGS(flag,file,...)
+    #define    LOGS(flag,logger,...)
 #endif
 
 // Node component: "TypeII" represents components that are aware of the existence of the simulated time.
@@ -100,6 +115,8 @@ component Node : public TypeII{
 		void WriteReceivedConfiguration(Logger node_logger, std::string header_str, Configuration new_configuration);
 		void PrintOrWriteNodeStatistics(int write_or_print);
 		void HandleSlottedBackoffCollision();
+		void TriggerFlightRecorder(int trigger, const char *reason, int involved_node_id);
+		void WriteFlightRecorderState(FILE *file);
 		void StartSavingLogs();
 		void RecoverFromCtsTimeout();
 		void MeasureRho();
@@ -134,6 +151,10 @@ component Node : public TypeII{
 		// Spatial Reuse
 		void SpatialReuseOpportunityEnds();
 
+		// Mobility
+		void UpdatePathGainTo(int node_ix, const MobilityUpdate &update);
+		void UpdateMaxPowerReceivedFromWlan(int wlan_ix, const MobilityUpdate &update);
+
 	// Public items (entered by nodes constructor in komondor_main)
 	public:
 
@@ -183,6 +204,7 @@ component Node : public TypeII{
 		double constant_per;				// Constant PER for correct transmissions
 		int save_node_logs;					// Flag for activating the log writting of nodes
 		int print_node_logs;				// Flag for activating the printing of node logs
+		int log_writer_mode;				// Synchronous or asynchronous (blocking or dropping) log writing
 		std::string simulation_code;		// Simulation code
 		int capture_effect_model;			// Capture Effect model
 		int nack_activated;					// Flag for activating the utilization of NACKs
@@ -190,7 +212,7 @@ component Node : public TypeII{
 		// Channel
 		int basic_channel_bandwidth;		// Channel unit bandwidth [Hz]
 		int num_channels_komondor;			// Number of subchannels composing the whole channel
-		int adjacent_channel_model;			// Adjacent channel interference model (definition of models in function UpdateChannelsPower())
+		int adjacent_channel_model;			// Adjacent channel interference model (definition of models in function SelectAdjacentChannelInterferenceModel())
 		int pifs_activated;					// PIFS mechanism activation
 
 		// Transmissions
@@ -217,6 +239,8 @@ component Node : public TypeII{
 		int rts_length;						// RTS length [bits]
 		int cts_length;						// CTS length [bits]
 		int traffic_model;					// Traffic model (0: full buffer, 1: poisson, 2: deterministic)
+		int burst_size_model;				// Burst size distribution (only for TRAFFIC_POISSON_BURST)
+		double burst_size;					// Average number of packets per burst (only for TRAFFIC_POISSON_BURST)
 		int backoff_type;					// Type of Backoff (0: Slotted 1: Continuous)
 		int cw_adaptation;					// CW adaptation (0: constant, 1: bineary exponential backoff)
 
@@ -259,6 +283,7 @@ component Node : public TypeII{
 		int num_delay_measurements;							// Number of delay measurements for averaging
 		double sum_delays;									// Sum of delays for averaging
 		double average_delay;								// Average delay from packet generation to ACK
+		DelayHistogram delay_histogram;						// Distribution of the delays (percentiles)
 		double average_rho;									// Average rho metric (prob. of having packets in buffer and channel free)
 		double average_utilization;							// Average buffer utilization
 		double generation_drop_ratio;						// Probability of dropping a packet
@@ -282,6 +307,7 @@ component Node : public TypeII{
 		int *rts_cts_lost_per_sta;
 		int *data_packets_acked_per_sta;
 		int *data_frames_acked_per_sta;
+		DelayHistogram *delay_histogram_per_sta;
 
 		// Store the simulation performance
 		Performance simulation_performance;
@@ -304,10 +330,19 @@ component Node : public TypeII{
 		int *channels_free;					// Channels that are found free for the beginning TX (i.e. power sensed < pd)
 		int *channels_for_tx;				// Channels that are used in the beginning TX (depend on the channel bonding model)
 
-		// File for writting node logs
-		FILE *output_log_file;				// File for logs in which the node is involved
-		char own_file_path[32];				// Name of the file for node logs
+		// Model handlers (selected once in InitializeVariables() according to the configured models)
+		ComputeBackoffFunction compute_backoff;						// Backoff per pdf_backoff and backoff_type
+		ComputeRemainingBackoffFunction compute_remaining_backoff;	// Remaining backoff per backoff_type
+		AdjacentChannelModelFunction apply_adjacent_channel_model;	// Adjacent channel interference model
+		IsPacketLostFunction is_packet_lost;						// Packet loss per capture effect model
+		CaptureOutcomeFunction capture_as_destination;				// Capture outcome when receiving a frame addressed to the node
+		CaptureOutcomeFunction capture_as_interferer;				// Capture outcome when the ongoing reception is lost
+		HandleContentionWindowFunction handle_contention_window;	// Contention window update per cw_adaptation
+
+		// Node logs
 		Logger node_logger;					// struct containing the attributes needed for writting logs in a file
+		TraceWriter node_trace;				// Binary trace writer (used when save_node_logs == SAVE_LOG_BINARY_TRACE)
+		FlightRecorder node_flight_recorder;	// Last log events (used when save_node_logs == SAVE_LOG_FLIGHT_RECORDER)
 		std::string header_str;				// Header string for the logger
 
 		// State and timers
@@ -320,7 +355,7 @@ component Node : public TypeII{
 		int current_left_channel;			// Left channel used in current TX
 		int current_right_channel;			// Right channel used in current TX
 		double current_tx_power;					// Transmission power used in current TX [dBm]
-		double current_pd;					// Current pd (variable "sensitivity")	[dBm]
+		double current_pd;					// Current pd (variable "sensitivity")	[pW]
 		int current_destination_id;			// Current destination node ID
 		double current_tx_duration;			// Duration of the TX being done [s]
 		double current_nav_time;			// Current NAV duration
@@ -349,6 +384,7 @@ component Node : public TypeII{
 
 		int default_modulation;				// Default MCS identifier
 		double bits_ofdm_sym;					// Number of bits per OFDM symbol in the data packet according to MCS [bits]
+		FrameDurationTable frame_duration_table;	// Frame durations and bits per OFDM symbol per MCS, channels and aggregation
 
 		int cw_current;						// Contention Window being used currently
 		int cw_stage_current;				// Current CW stage
@@ -368,6 +404,7 @@ component Node : public TypeII{
 		int channel_max_interference;		// Channel of maximum interference detected in range of interest [pW]
 		int *nodes_transmitting;			// IDs of the nodes which are transmitting to any destination
 		std::map<int, double> power_received_per_node;
+		std::map<int, double> deferred_received_power;	// Power received from moved nodes, applied once their TX finishes [pW]
 		double power_rx_interest;			// Power received from a TX destined to the node [pW]
 		int receiving_from_node_id;			// ID of the node that is transmitting to the node (-1 if node is not receiing)
 		int receiving_packet_id;			// ID of the notification that is being transmitted to me
@@ -390,7 +427,6 @@ component Node : public TypeII{
 		int num_measures_buffer_with_packets;	// Number of measures where the buffer had packets
 
 		// Burst traffic
-		double burst_rate;				// Average time between two packet generation bursts [bursts/s]
 		int num_bursts;					// Total number of bursts occurred in the simulation
 
 		// Flag to determine if there is any new configuration to be applied when doing "RestartNode()"
@@ -444,6 +480,12 @@ component Node : public TypeII{
 		inport void inline InportRequestSpatialReuseConfiguration();
 		inport void inline InportNewSpatialReuseConfiguration(Configuration &new_configuration);
 
+		// Metrics sampler
+		inport void inline InportMetricsRequested(MetricsSnapshot &snapshot);
+
+		// Mobility manager
+		inport void inline InportNodesMoved(MobilityUpdate &update);
+
 		// OUTPORT connections for sending notifications
 		outport void outportSelfStartTX(Notification &notification);
 		outport void outportSelfFinishTX(Notification &notification);
@@ -535,19 +577,40 @@ void Node :: Start(){
 
 	// if(print_node_logs) printf("%s(N%d) Start\n", node_code, node_id);
 
-	// Create node logs file if required
+	// Create node logs if required
 	if(save_node_logs) {
 		// Name node log file accordingly to the node_id
 		// Sergio on 16 Jan: changed path to adapt to new directory hierarchy
-		sprintf(own_file_path,"%s_%s_N%d_%s.txt","../output/logs_output", simulation_code.c_str(), node_id, node_code.c_str());
-		remove(own_file_path);
-		output_log_file = fopen(own_file_path, "at");
+		// Logs are appended to the sharded log sink: 'log_extractor' regenerates this per-node file
+		char log_filename[CHAR_BUFFER_SIZE];
+		snprintf(log_filename, sizeof(log_filename), "%s_%s_N%d_%s%s", "../output/logs_output",
+			simulation_code.c_str(), OriginalNodeId(node_id), node_code.c_str(),
+			(save_node_logs == SAVE_LOG_BINARY_TRACE) ? ".trc" :
+			(save_node_logs == SAVE_LOG_FLIGHT_RECORDER) ? "_flight_recorder.txt" : ".txt");
 		node_logger.save_logs = save_node_logs;
-		node_logger.file = output_log_file;
 		node_logger.SetVoidHeadString();
+		if(save_node_logs == SAVE_LOG_FLIGHT_RECORDER) {
+			// Flight recorder: events are only kept in memory and dumped when a trigger fires
+			remove(log_filename);
+			char abort_filename[CHAR_BUFFER_SIZE];
+			snprintf(abort_filename, sizeof(abort_filename), "%s_%s_flight_recorder_abort.trc",
+				"../output/logs_output", simulation_code.c_str());
+			node_flight_recorder.Open(flight_recorder_config.num_events, node_id, log_filename, abort_filename,
+				[this](FILE *file){ WriteFlightRecorderState(file); });
+			node_logger.recorder = &node_flight_recorder;
+		} else {
+			node_logger.sink_owner = log_sink.RegisterOwner(log_filename);
+			if(save_node_logs == SAVE_LOG_BINARY_TRACE) {
+				// Binary event trace: decode it with 'trace_decoder' to obtain the text logs
+				node_trace.Open(node_logger.sink_owner);
+				node_logger.trace = &node_trace;
+			} else if(log_writer_mode != LOG_WRITER_SYNC) {
+				node_logger.ring = async_log_writer.OpenRing(node_logger.sink_owner, log_writer_mode);
+			}
+		}
 	}
 
-	LOGS(save_node_logs, node_logger.file,"%.18f;N%d;S%d;%s;%s Start()\n",
+	LOGS(save_node_logs, node_logger,"%.18f;N%d;S%d;%s;%s Start()\n",
 		SimTime(), node_id, STATE_UNKNOWN, LOG_B00, LOG_LVL1);
 
 	// Write node info and conf.
@@ -595,9 +658,9 @@ void Node :: Start(){
 	//    trigger_start_saving_logs.Set(SimTime() + 3628);
 	// ----------------------------------------
 
-	LOGS(save_node_logs, node_logger.file,"\nXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX\n");
+	LOGS(save_node_logs, node_logger,"\nXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX\n");
 
-	// LOGS(save_node_logs, node_logger.file, "%f;N%d;S%d;%s;%s Start() END\n", SimTime(), node_id, node_state, LOG_B01, LOG_LVL1);
+	// LOGS(save_node_logs, node_logger, "%f;N%d;S%d;%s;%s Start() END\n", SimTime(), node_id, node_state, LOG_B01, LOG_LVL1);
 };
 
 /*
@@ -606,7 +669,7 @@ void Node :: Start(){
 void Node :: Stop(){
 
 
-	LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s Node Stop()\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Node Stop()\n",
 		SimTime(), node_id, node_state, LOG_C00, LOG_LVL1);
 
 	// Print and write node statistics if required
@@ -614,7 +677,13 @@ void Node :: Stop(){
 	if (save_node_logs) PrintOrWriteNodeStatistics(WRITE_LOG);
 
 	// Close node logs file
-	if(save_node_logs) fclose(node_logger.file);
+	if(save_node_logs == SAVE_LOG_FLIGHT_RECORDER) {
+		node_flight_recorder.Close();
+	} else if(save_node_logs == SAVE_LOG_BINARY_TRACE) {
+		node_trace.Close();
+	} else if(save_node_logs) {
+		CloseLogRing(node_logger);
+	}
 
 	// Save performance into the simulation_performance object
 	SaveSimulationPerformance();
@@ -622,7 +691,7 @@ void Node :: Stop(){
 	// Save the configuration currently being used by the node
 	GenerateConfiguration();
 
-	// LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s Node info:\n", SimTime(), node_id, node_state, LOG_C01, LOG_LVL1);
+	// LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Node info:\n", SimTime(), node_id, node_state, LOG_C01, LOG_LVL1);
 };
 
 /*
@@ -632,13 +701,13 @@ void Node :: Stop(){
  */
 void Node :: InportSomeNodeStartTX(Notification &notification){
 
-	LOGS(save_node_logs,node_logger.file,
+	LOGS(save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s InportSomeNodeStartTX(): N%d to N%d sends packet type %d in range %d-%d\n",
 			SimTime(), node_id, node_state, LOG_D00, LOG_LVL1,
 			notification.source_id, notification.destination_id, notification.packet_type,
 			notification.left_channel, notification.right_channel);
 
-	LOGS(save_node_logs,node_logger.file,
+	LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s Nodes transmitting: ",
 				SimTime(), node_id, node_state, LOG_D00, LOG_LVL3);
 
@@ -649,7 +718,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 	if(notification.source_id == node_id){ // If OWN NODE IS THE TRANSMITTER, do nothing
 
-		LOGS(save_node_logs,node_logger.file,
+		LOGS(save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s I have started a TX of packet #%d (type %d) to N%d in channels %d - %d of duration %.9f us\n",
 			SimTime(), node_id, node_state, LOG_D02, LOG_LVL2, notification.packet_id,
 			notification.packet_type, notification.destination_id,
@@ -658,13 +727,13 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 	} else {	// If OTHER NODE IS THE TRANSMITTER
 
-		LOGS(save_node_logs,node_logger.file,
+		LOGS(save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s N%d has started a TX of packet #%d (type %d) to N%d in channels %d - %d\n",
 			SimTime(), node_id, node_state, LOG_D02, LOG_LVL2, notification.source_id,
 			notification.packet_id,	notification.packet_type, notification.destination_id,
 			notification.left_channel, notification.right_channel);
 
-		LOGS(save_node_logs,node_logger.file,
+		LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s START Channel before updating: ",
 				SimTime(), node_id, node_state, LOG_E18, LOG_LVL3);
 
@@ -679,11 +748,10 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 		}
 
 		// Update the power sensed at each channel
-		UpdateChannelsPower(&channel_power, notification, TX_INITIATED,
-			central_frequency, num_channels_komondor, path_loss_model, rx_gain,
-			adjacent_channel_model, received_power_array[notification.source_id], node_id);
+		UpdateChannelsPower(&channel_power, notification, TX_INITIATED, num_channels_komondor,
+			apply_adjacent_channel_model, received_power_array[notification.source_id]);
 
-		LOGS(save_node_logs,node_logger.file,
+		LOGS(save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s Power sensed per channel: ",
 			SimTime(), node_id, node_state, LOG_E18, LOG_LVL3);
 
@@ -699,18 +767,18 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 			current_pd, num_channels_komondor, SimTime());
 
 		if(save_node_logs) {
-			LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s timestampt_channel_becomes_frees: ",
+			LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s timestampt_channel_becomes_frees: ",
 				SimTime(), node_id, node_state, LOG_F02, LOG_LVL3);
 			for(int i = 0; i < num_channels_komondor; ++i){
-				fprintf(node_logger.file, "%.9f  ", timestampt_channel_becomes_free[i]);
+				LogPrintf(node_logger, "%.9f  ", timestampt_channel_becomes_free[i]);
 			}
-			fprintf(node_logger.file, "\n");
-			LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s difference times: ",
+			LogPrintf(node_logger, "\n");
+			LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s difference times: ",
 				SimTime(), node_id, node_state, LOG_F02, LOG_LVL3);
 			for(int i = 0; i < num_channels_komondor; ++i){
-				fprintf(node_logger.file, "%.9f  ", SimTime() - timestampt_channel_becomes_free[i]);
+				LogPrintf(node_logger, "%.9f  ", SimTime() - timestampt_channel_becomes_free[i]);
 			}
-			fprintf(node_logger.file, "\n");
+			LogPrintf(node_logger, "\n");
 		}
 
 		/* ****************************************
@@ -729,15 +797,15 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 				srg_obss_pd, non_srg_obss_pd, current_pd, power_received_per_node[notification.source_id]);
 			// In case of detecting an inter-BSS frame, print the information
 			if (type_last_sensed_packet != INTRA_BSS_FRAME) {
-				LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s SPATIAL REUSE OPERATION: \n",
+				LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s SPATIAL REUSE OPERATION: \n",
 					SimTime(), node_id, node_state, LOG_F02, LOG_LVL3);
-				LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s type_last_sensed_packet = %d\n",
+				LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s type_last_sensed_packet = %d\n",
 					SimTime(), node_id, node_state, LOG_F02, LOG_LVL4, type_last_sensed_packet);
-				LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s Previous current_obss_pd_threshold = %f\n",
+				LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Previous current_obss_pd_threshold = %f\n",
 					SimTime(), node_id, node_state, LOG_F02, LOG_LVL4, ConvertPower(PW_TO_DBM, current_obss_pd_threshold));
-				LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s previous txop_sr_identified = %d\n",
+				LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s previous txop_sr_identified = %d\n",
 					SimTime(), node_id, node_state, LOG_F02, LOG_LVL4, txop_sr_identified);
-				LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s New potential_obss_pd_threshold = %f\n",
+				LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s New potential_obss_pd_threshold = %f\n",
 					SimTime(), node_id, node_state, LOG_F02, LOG_LVL4, ConvertPower(PW_TO_DBM, potential_obss_pd_threshold));
 			}
 		}
@@ -764,7 +832,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 					current_left_channel = notification.left_channel;
 					current_right_channel = notification.right_channel;
 
-					LOGS(save_node_logs,node_logger.file,
+					LOGS(save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d). Checking if notification can be received.\n",
 						SimTime(), node_id, node_state, LOG_D07, LOG_LVL3,
 						notification.destination_id);
@@ -773,7 +841,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 					ComputeMaxInterference(&max_pw_interference, &channel_max_intereference,
 						notification, node_state, power_received_per_node, &channel_power);
 
-					LOGS(save_node_logs,node_logger.file,
+					LOGS(save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s P[%d] = %f dBm - P_st = %f dBm - P_if = %f dBm\n",
 						SimTime(), node_id, node_state, LOG_D08, LOG_LVL5,
 						channel_max_intereference,
@@ -785,14 +853,14 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 						current_sinr = UpdateSINR(power_rx_interest, noise_level, max_pw_interference);
 
-						LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s SINR = %.2f dBm\n",
+						LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s SINR = %.2f dBm\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL5,
 							ConvertPower(LINEAR_TO_DB, current_sinr));
 
 						// Check if notification has been lost due to interferences or weak signal strength
-						loss_reason = IsPacketLost(current_primary_channel, notification, notification,
+						loss_reason = is_packet_lost(current_primary_channel, notification, notification,
 								current_sinr, capture_effect, current_pd,
-								power_rx_interest, constant_per, node_id, capture_effect_model);
+								power_rx_interest, constant_per, node_id);
 
 						if(loss_reason != PACKET_NOT_LOST) {	// If RTS IS LOST, send logical Nack
 
@@ -804,7 +872,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 								}
 							}
 
-							LOGS(save_node_logs,node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Reception of notification %d from N%d CANNOT be started because of reason %d\n",
 								SimTime(), node_id, node_state, LOG_D15, LOG_LVL4, notification.packet_id,
 								notification.source_id, loss_reason);
@@ -827,7 +895,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 						} else {	// Data packet IS NOT LOST (it can be properly received)
 
-							LOGS(save_node_logs,node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Reception of RTS #%d from N%d CAN be started (SINR = %f dB)\n",
 								SimTime(), node_id, node_state, LOG_D16, LOG_LVL4, notification.packet_id,
 								notification.source_id, ConvertPower(LINEAR_TO_DB, current_sinr));
@@ -857,7 +925,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 						}
 
 					} else {	//	Notification does NOT CONTAIN an RTS
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Unexpected packet type (%d) received!\n",
 								SimTime(), node_id, node_state, LOG_D08, LOG_LVL4, notification.packet_type);
 					}
@@ -870,7 +938,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 						|| notification.packet_type == PACKET_TYPE_DATA
 						|| notification.packet_type == PACKET_TYPE_ACK) {
 
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s I am not the TX destination (N%d to N%d). Checking if Frame can be decoded.\n",
 							SimTime(), node_id, node_state, LOG_D07, LOG_LVL2,
 							notification.source_id, notification.destination_id);
@@ -884,10 +952,10 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 						// 3 - Compute the SINR
 						current_sinr = UpdateSINR(power_rx_interest, noise_level, max_pw_interference);
 						// 4 - Check if the packet is lost or not
-						loss_reason = IsPacketLost(current_primary_channel, notification, notification, current_sinr,
-							capture_effect, current_pd, power_rx_interest, constant_per, node_id, capture_effect_model);
+						loss_reason = is_packet_lost(current_primary_channel, notification, notification, current_sinr,
+							capture_effect, current_pd, power_rx_interest, constant_per, node_id);
 
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s Pmax_intf[%d] = %f dBm - P_st = %f dBm - P_if = %f dBm, sinr = %f dB\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL5,
 							channel_max_intereference, ConvertPower(PW_TO_DBM, channel_power[channel_max_intereference]),
@@ -901,7 +969,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 						// If the packet is not lost, check if we can ignore it by applying another pd
 						if (spatial_reuse_enabled && loss_reason == PACKET_NOT_LOST) {
 							// The incoming packet can be decoded by the default pd
-							LOGS(save_node_logs, node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s The packet could be decoded with the default pd (%f dBm)...\n",
 								SimTime(), node_id, node_state, LOG_D08, LOG_LVL3, ConvertPower(PW_TO_DBM, current_pd));
 							// Check if a new SR-based opportunity can be identified to ignore the incoming tranmission
@@ -909,7 +977,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 							// Two cases:
 							// (1) An SR-based opportunity was already identified and needs to be overwritten
 							// (2) None SR opportunites were previously detected
-							LOGS(save_node_logs, node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s txop_sr_identified = %d / new_txop_sr_identified = %d\n",
 								SimTime(), node_id, node_state, LOG_D08, LOG_LVL4, txop_sr_identified, new_txop_sr_identified);
 							if ( (txop_sr_identified && new_txop_sr_identified &&
@@ -926,7 +994,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 								// Start (update) the trigger that indicates the end of the SR-based opportunity
 								time_to_trigger = SimTime() + notification.tx_info.nav_time;
 								txop_sr_end.Set(fix_time_offset(time_to_trigger,13,12));
-								LOGS(save_node_logs, node_logger.file,
+								LOGS(save_node_logs, node_logger,
 									"%.15f;N%d;S%d;%s;%s An SR TXOP was detected for OBSS_PD = %f dBm "
 									"(received RTS/CTS while being in SENSING state.)\n",
 									SimTime(), node_id, node_state, LOG_D08, LOG_LVL3,
@@ -937,7 +1005,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 						if(loss_reason == PACKET_NOT_LOST) { // RTS/CTS can be decoded
 
-							LOGS(save_node_logs,node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Packet type %d can be decoded\n",
 								SimTime(), node_id, node_state, LOG_D07, LOG_LVL3, notification.packet_type);
 
@@ -967,12 +1035,12 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 								trigger_NAV_timeout.Set(fix_time_offset(time_to_trigger,13,12));
 							}
 
-							LOGS(save_node_logs,node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Entering in NAV during %.12f and setting NAV timeout to %.12f\n",
 								SimTime(), node_id, node_state, LOG_D08, LOG_LVL3,
 								current_nav_time, trigger_NAV_timeout.GetTime());
 
-							LOGS(save_node_logs,node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s current_nav_time = %.12f\n",
 								SimTime(), node_id, node_state, LOG_D08, LOG_LVL4,
 								current_nav_time);
@@ -983,7 +1051,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 						} else { // Frame cannot be decoded.
 
-							LOGS(save_node_logs,node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Frame sent by N%d could not be decoded for reason %d\n",
 								SimTime(), node_id, node_state, LOG_D08, LOG_LVL3,
 								notification.source_id, loss_reason);
@@ -994,7 +1062,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 							// Check if DIFS or BO must be stopped
 							if(node_is_transmitter){
 
-								LOGS(save_node_logs,node_logger.file,
+								LOGS(save_node_logs, node_logger,
 									"%.15f;N%d;S%d;%s;%s Checking if BO must be paused...\n",
 									SimTime(), node_id, node_state, LOG_D08, LOG_LVL4);
 
@@ -1015,7 +1083,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 								} else {
 
-									LOGS(save_node_logs,node_logger.file,
+									LOGS(save_node_logs, node_logger,
 										"%.15f;N%d;S%d;%s;%s BO must not be paused (%f remaining slots).\n",
 										SimTime(), node_id, node_state, LOG_D08, LOG_LVL5, remaining_backoff/SLOT_TIME);
 								}
@@ -1028,7 +1096,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 //					else if (notification.packet_type == PACKET_TYPE_DATA ||
 //							   notification.packet_type == PACKET_TYPE_ACK){
 //						if(node_is_transmitter){
-//							LOGS(save_node_logs,node_logger.file,
+//							LOGS(save_node_logs, node_logger,
 //									"%.15f;N%d;S%d;%s;%s Checking if BO must be paused...\n",
 //									SimTime(), node_id, node_state, LOG_D08, LOG_LVL4);
 //							int pause = HandleBackoff(PAUSE_TIMER, &channel_power, current_primary_channel, current_pd,
@@ -1037,7 +1105,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 //							if (pause) {
 //								PauseBackoff();
 //							} else {
-//								LOGS(save_node_logs,node_logger.file,
+//								LOGS(save_node_logs, node_logger,
 //									"%.15f;N%d;S%d;%s;%s BO must not be paused.\n",
 //									SimTime(), node_id, node_state, LOG_D08, LOG_LVL5);
 //							}
@@ -1077,7 +1145,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 						if(notification.packet_type == PACKET_TYPE_RTS) {	// Notification CONTAINS an RTS PACKET
 
-							LOGS(save_node_logs,node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s RTS from my AP N%d sent simultaneously\n",
 								SimTime(), node_id, node_state, LOG_D16, LOG_LVL4,
 								notification.source_id);
@@ -1091,7 +1159,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 							current_sinr = UpdateSINR(power_rx_interest, noise_level, max_pw_interference);
 
-							LOGS(save_node_logs,node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s P[%d] = %f dBm - P_st = %f dBm - P_if = %f dBm\n",
 								SimTime(), node_id, node_state, LOG_D08, LOG_LVL5, channel_max_intereference,
 								ConvertPower(PW_TO_DBM, channel_power[channel_max_intereference]),
@@ -1099,9 +1167,9 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 								ConvertPower(PW_TO_DBM, max_pw_interference));
 
 							// Check if notification has been lost due to interferences or weak signal strength
-							loss_reason = IsPacketLost(current_primary_channel, notification, notification,
+							loss_reason = is_packet_lost(current_primary_channel, notification, notification,
 								current_sinr, capture_effect, current_pd,
-								power_rx_interest, constant_per, node_id, capture_effect_model);
+								power_rx_interest, constant_per, node_id);
 
 							if(loss_reason != PACKET_NOT_LOST) {	// If RTS IS LOST, send logical Nack
 
@@ -1115,7 +1183,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 									// Trigger the restart then.
 
 									// Sergio on 27/09/2017. Review this case
-									LOGS(save_node_logs,node_logger.file,
+									LOGS(save_node_logs, node_logger,
 										"%.15f;N%d;S%d;%s;%s RTS from my AP CANNOT be decoded\n",
 										SimTime(), node_id, node_state, LOG_D08, LOG_LVL5);
 
@@ -1133,7 +1201,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 								// EOF HandleSlottedBackoffCollision();
 
 								if(nack_activated) {
-									LOGS(save_node_logs,node_logger.file,
+									LOGS(save_node_logs, node_logger,
 										"%.15f;N%d;S%d;%s;%s RTS cannot be decoded (SINR = %f dB) -> Sending NACK corresponding to BO collision to N%d\n",
 										SimTime(), node_id, node_state, LOG_D16, LOG_LVL5,
 										ConvertPower(LINEAR_TO_DB, current_sinr), notification.source_id);
@@ -1145,7 +1213,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 							} else {	// Data packet IS NOT LOST (it can be properly received)
 
-								LOGS(save_node_logs,node_logger.file,
+								LOGS(save_node_logs, node_logger,
 									"%.15f;N%d;S%d;%s;%s Reception of RTS #%d from N%d CAN be started (SINR = %f dB)\n",
 									SimTime(), node_id, node_state, LOG_D16, LOG_LVL4, notification.packet_id,
 									notification.source_id, ConvertPower(LINEAR_TO_DB, current_sinr));
@@ -1153,12 +1221,12 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 								// Cancel the previous NAV
 								if ( spatial_reuse_enabled ) {
 									trigger_inter_bss_NAV_timeout.Cancel(); // Cancel inter-BSS NAV
-									LOGS(save_node_logs,node_logger.file,
+									LOGS(save_node_logs, node_logger,
 										"%.15f;N%d;S%d;%s;%s INTER-BSS NAV CANCELLED!\n",
 										SimTime(), node_id, node_state, LOG_D16, LOG_LVL4);
 								} else {
 									trigger_NAV_timeout.Cancel();			// Cancel intra-BSS NAV (legacy)
-									LOGS(save_node_logs,node_logger.file,
+									LOGS(save_node_logs, node_logger,
 										"%.15f;N%d;S%d;%s;%s DEFAULT NAV CANCELLED!\n",
 										SimTime(), node_id, node_state, LOG_D16, LOG_LVL4);
 								}
@@ -1172,6 +1240,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 								current_left_channel = notification.left_channel;
 								current_right_channel = notification.right_channel;
 
+								time_in_nav = time_in_nav + (SimTime() - last_time_not_in_nav);	// The NAV ends here
 								node_state = STATE_RX_RTS;
 								receiving_from_node_id = notification.source_id;
 								receiving_packet_id = notification.packet_id;
@@ -1184,7 +1253,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 							}
 
 						} else {	//	Notification does NOT CONTAIN an RTS
-							LOGS(save_node_logs,node_logger.file,
+							LOGS(save_node_logs, node_logger,
 									"%.15f;N%d;S%d;%s;%s Unexpected packet type (%d) received!\n",
 									SimTime(), node_id, node_state, LOG_D08, LOG_LVL4, notification.packet_type);
 						}
@@ -1217,21 +1286,21 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 							notification, node_state, power_received_per_node, &channel_power);
 						// Update the current_sinr
 						current_sinr = UpdateSINR(power_rx_interest, noise_level, max_pw_interference);
-						LOGS(save_node_logs, node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s P[%d] = %f dBm - P_st = %f dBm - P_if = %f dBm\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL5, channel_max_intereference,
 							ConvertPower(PW_TO_DBM, channel_power[channel_max_intereference]),
 							ConvertPower(PW_TO_DBM, power_rx_interest),
 							ConvertPower(PW_TO_DBM, max_pw_interference));
 						// Check if notification can be decoded
-						int loss_reason (IsPacketLost(current_primary_channel, notification, notification,
+						int loss_reason (is_packet_lost(current_primary_channel, notification, notification,
 							current_sinr, capture_effect, current_pd, power_rx_interest, constant_per,
-							node_id, capture_effect_model));
+							node_id));
 
 						// NAV collision detected
 						if((nav_collision || inter_bss_nav_collision) && loss_reason == PACKET_NOT_LOST)  {
 
-							LOGS(save_node_logs, node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Updating the NAV according to the last sensed transmission\n",
 								SimTime(), node_id, node_state, LOG_D07, LOG_LVL2);
 
@@ -1242,13 +1311,13 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 								if (spatial_reuse_enabled && inter_bss_nav_collision) {
 									trigger_inter_bss_NAV_timeout.Cancel(); // Cancel inter-BSS NAV
 									trigger_inter_bss_NAV_timeout.Set(fix_time_offset(time_to_trigger,13,12));
-									LOGS(save_node_logs, node_logger.file,
+									LOGS(save_node_logs, node_logger,
 										"%.15f;N%d;S%d;%s;%s (workaround) setting inter-BSS NAV trigger to %.12f\n",
 										SimTime(), node_id, node_state, LOG_D07, LOG_LVL3, time_to_trigger);
 								} else {
 									trigger_NAV_timeout.Cancel();			// Cancel intra-BSS NAV (legacy)
 									trigger_NAV_timeout.Set(fix_time_offset(time_to_trigger,13,12));
-									LOGS(save_node_logs, node_logger.file,
+									LOGS(save_node_logs, node_logger,
 										"%.15f;N%d;S%d;%s;%s (workaround) setting NAV trigger to %.12f\n",
 										SimTime(), node_id, node_state, LOG_D07, LOG_LVL3, time_to_trigger);
 								}
@@ -1258,7 +1327,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 								if ( (nav_collision && nav_notification.packet_type == notification.packet_type)
 									|| (inter_bss_nav_collision && nav_notification.packet_type == notification.packet_type) ) {
 
-									// if(save_node_logs) fprintf(node_logger.file,
+									// if(save_node_logs) LogPrintf(node_logger, 
 									//	"%.15f;N%d;S%d;%s;%s Waiting just in case of more collisions.\n",
 									//	SimTime(), node_id, node_state, LOG_D07, LOG_LVL4);
 
@@ -1280,7 +1349,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 									trigger_wait_collisions.Set(fix_time_offset(time_to_trigger,13,12));
 
-									LOGS(save_node_logs, node_logger.file,
+									LOGS(save_node_logs, node_logger,
 										"%.15f;N%d;S%d;%s;%s Recovering from EIFS at %.12f (preoc. = %.12f)\n",
 										SimTime(), node_id, node_state, LOG_D07, LOG_LVL4,
 										trigger_wait_collisions.GetTime(),
@@ -1293,7 +1362,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 						} else { // No collision
 
-							LOGS(save_node_logs, node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s I am not the TX destination (N%d to N%d). Checking if new RTS/CTS can be decoded.\n",
 								SimTime(), node_id, node_state, LOG_D07, LOG_LVL2,
 								notification.source_id, notification.destination_id);
@@ -1308,7 +1377,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 							current_sinr = UpdateSINR(power_rx_interest, noise_level, max_pw_interference);
 
-							LOGS(save_node_logs, node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Pmax_intf[%d] = %f dBm - P_st = %f dBm - P_if = %f dBm, sinr = %f dB\n",
 								SimTime(), node_id, node_state, LOG_D08, LOG_LVL5,
 								channel_max_intereference, ConvertPower(PW_TO_DBM, channel_power[channel_max_intereference]),
@@ -1316,9 +1385,9 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 								ConvertPower(PW_TO_DBM, max_pw_interference),
 								ConvertPower(LINEAR_TO_DB,current_sinr));
 
-							loss_reason = IsPacketLost(current_primary_channel, notification, notification,
+							loss_reason = is_packet_lost(current_primary_channel, notification, notification,
 								current_sinr, capture_effect, current_pd, power_rx_interest, constant_per,
-								node_id, capture_effect_model);
+								node_id);
 
 							int power_condition (ConvertPower(PW_TO_DBM, channel_power[current_primary_channel]) > sensitivity_default);
 
@@ -1333,15 +1402,15 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 								int power_condition_sr (1);
 								if (spatial_reuse_enabled && type_last_sensed_packet != INTRA_BSS_FRAME && node_is_transmitter) { 	// Check for TXOP
 									double power_interference (power_received_per_node[notification.source_id]);
-									loss_reason_sr = IsPacketLost(current_primary_channel, notification, notification,
+									loss_reason_sr = is_packet_lost(current_primary_channel, notification, notification,
 										current_sinr, capture_effect, potential_obss_pd_threshold, power_interference, constant_per,
-										node_id, capture_effect_model);
+										node_id);
 									power_condition_sr = ConvertPower(PW_TO_DBM, channel_power[current_primary_channel]) > potential_obss_pd_threshold;
 								}
 								if (loss_reason_sr != PACKET_NOT_LOST && power_condition_sr) {
 									txop_sr_identified = TRUE;	// TXOP identified!
 									next_pd_spatial_reuse = potential_obss_pd_threshold;	// Update the pd
-									LOGS(save_node_logs, node_logger.file,
+									LOGS(save_node_logs, node_logger,
 										"%.15f;N%d;S%d;%s;%s TXOP detected while being in NAV state\n",
 										SimTime(), node_id, node_state, LOG_D08, LOG_LVL3);
 								} else {
@@ -1352,7 +1421,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 										if(trigger_inter_bss_NAV_timeout.GetTime() < notification.tx_info.nav_time) {
 											time_to_trigger = SimTime() +  notification.tx_info.nav_time + TIME_OUT_EXTRA_TIME;
 											trigger_inter_bss_NAV_timeout.Set(fix_time_offset(time_to_trigger,13,12));
-											LOGS(save_node_logs, node_logger.file,
+											LOGS(save_node_logs, node_logger,
 												"%.15f;N%d;S%d;%s;%s Updating inter-BSS NAV timeout to the more restrictive one: From %.12f to %.12f\n",
 												SimTime(), node_id, node_state, LOG_D07, LOG_LVL4,
 												trigger_inter_bss_NAV_timeout.GetTime(), time_to_trigger);
@@ -1362,20 +1431,20 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 										if(trigger_NAV_timeout.GetTime() < notification.tx_info.nav_time) {
 											time_to_trigger = SimTime() +  notification.tx_info.nav_time + TIME_OUT_EXTRA_TIME;
 											trigger_NAV_timeout.Set(fix_time_offset(time_to_trigger,13,12));
-											LOGS(save_node_logs, node_logger.file,
+											LOGS(save_node_logs, node_logger,
 												"%.15f;N%d;S%d;%s;%s Updating NAV timeout to the more restrictive one: From %.12f to %.12f\n",
 												SimTime(), node_id, node_state, LOG_D07, LOG_LVL4,
 												trigger_NAV_timeout.GetTime(), time_to_trigger);
 										}
 									}
-									LOGS(save_node_logs, node_logger.file,
+									LOGS(save_node_logs, node_logger,
 										"%.15f;N%d;S%d;%s;%s New RTS/CTS arrived from (N%d). Setting NAV to new value %.18f\n",
 										SimTime(), node_id, node_state, LOG_D07, LOG_LVL3,
 										notification.source_id, trigger_NAV_timeout.GetTime());
 								}
 
 							} else {			// Packet IS LOST
-								LOGS(save_node_logs, node_logger.file,
+								LOGS(save_node_logs, node_logger,
 									"%.15f;N%d;S%d;%s;%s RTS/CTS sent from N%d could not be decoded for reason %d\n",
 									SimTime(), node_id, node_state, LOG_D08, LOG_LVL3,
 									notification.source_id, loss_reason);
@@ -1398,12 +1467,12 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 				if(notification.destination_id == node_id){ // Node IS THE DESTINATION
 
-					LOGS(save_node_logs, node_logger.file,
+					LOGS(save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d)\n",
 						SimTime(), node_id, node_state, LOG_D07, LOG_LVL3,
 						notification.destination_id);
 
-					LOGS(save_node_logs, node_logger.file,
+					LOGS(save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s I am transmitting, packet cannot be received\n",
 						SimTime(), node_id, node_state, LOG_D18, LOG_LVL3);
 
@@ -1417,7 +1486,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 				} else {	// Node IS NOT THE DESTINATION, do nothing
 
-//					LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
+//					LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
 //						SimTime(), node_id, node_state, LOG_D08, LOG_LVL3, notification.destination_id);
 
 				}
@@ -1449,22 +1518,22 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 						double sinr_interference (UpdateSINR(power_interference, noise_level, max_pw_interference));
 
 						// Is packet lost with the default pd?
-						int loss_reason_legacy (IsPacketLost(current_primary_channel, notification, notification,
+						int loss_reason_legacy (is_packet_lost(current_primary_channel, notification, notification,
 							sinr_interference, capture_effect, sensitivity_default, power_interference, constant_per,
-							node_id, capture_effect_model));
+							node_id));
 						// Is packet lost with the SR pd?
-						int loss_reason_sr (IsPacketLost(current_primary_channel, notification, notification,
+						int loss_reason_sr (is_packet_lost(current_primary_channel, notification, notification,
 							sinr_interference, capture_effect, potential_obss_pd_threshold, power_interference, constant_per,
-							node_id, capture_effect_model));
+							node_id));
 
-						if(save_node_logs && node_id == 0) LOGS(save_node_logs, node_logger.file,
+						if(save_node_logs && node_id == 0) LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s sinr_interference = %f - capture_effect = %f - pd_spatial_reuse = %f"
 							" - power_interference = %f)\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL3,
 							ConvertPower(LINEAR_TO_DB, sinr_interference), capture_effect,
 							ConvertPower(PW_TO_DBM,pd_spatial_reuse),ConvertPower(PW_TO_DBM,power_interference));
 
-						if(save_node_logs && node_id == 0) fprintf(node_logger.file,
+						if(save_node_logs && node_id == 0) LogPrintf(node_logger, 
 							"%.15f;N%d;S%d;%s;%s CHECKING TXOP in TX state (pd_sr = %f - lost = %d)\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL3,
 							ConvertPower(PW_TO_DBM,pd_spatial_reuse), loss_reason_sr);
@@ -1478,13 +1547,13 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 							// Start (update) the trigger that indicates the end of the SR-based opportunity
 							time_to_trigger = SimTime() + notification.tx_info.nav_time;
 							txop_sr_end.Set(fix_time_offset(time_to_trigger,13,12));
-							LOGS(save_node_logs, node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s TXOP detected while being in TX state\n",
 								SimTime(), node_id, node_state, LOG_D08, LOG_LVL3);
 						} else if (loss_reason_legacy == PACKET_NOT_LOST && txop_sr_identified) {
 							// Cancel SR TXOP
 							txop_sr_identified = FALSE;
-							LOGS(save_node_logs, node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Cancelling SR TXOP while being in TX state\n",
 								SimTime(), node_id, node_state, LOG_D08, LOG_LVL3);
 						}
@@ -1508,122 +1577,81 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 				if(notification.destination_id == node_id){	// Node IS THE DESTINATION
 
-//					LOGS(save_node_logs, node_logger.file,
+//					LOGS(save_node_logs, node_logger,
 //							"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d)\n",
 //							SimTime(), node_id, node_state, LOG_D07, LOG_LVL3, notification.destination_id);
 
 					// Check if ongoing notification has been lost due to interferences caused by new transmission
 					current_sinr = UpdateSINR(power_rx_interest, noise_level, max_pw_interference);
 
-					loss_reason = IsPacketLost(current_primary_channel, incoming_notification, notification,
+					loss_reason = is_packet_lost(current_primary_channel, incoming_notification, notification,
 						current_sinr, capture_effect, current_pd,
-						power_rx_interest, constant_per, node_id, capture_effect_model);
-
-					switch(capture_effect_model){
-
-						case CE_DEFAULT:{
-							if(loss_reason != PACKET_NOT_LOST
-								&& loss_reason != PACKET_LOST_OUTSIDE_CH_RANGE)  {	// If ongoing data packet IS LOST
-									// Pure collision (two nodes transmitting to me with enough power)
-									LOGS(save_node_logs, node_logger.file,
-										"%.15f;N%d;S%d;%s;%s Pure collision! Already receiving from N%d\n",
-										SimTime(), node_id, node_state, LOG_D19, LOG_LVL4, receiving_from_node_id);
-									loss_reason = PACKET_LOST_PURE_COLLISION;
-									// If two or more packets sent at the same time
-									if(fabs(notification.timestamp - incoming_notification.timestamp) < MAX_DIFFERENCE_SAME_TIME){
-										// SERGIO HandleSlottedBackoffCollision();
-										loss_reason = PACKET_LOST_BO_COLLISION;
-										if(!node_is_transmitter) {
-											time_to_trigger = SimTime() + MAX_DIFFERENCE_SAME_TIME;
-											trigger_NAV_timeout.Set(fix_time_offset(time_to_trigger,13,12));
-										} else {
-											printf("ALARM! Should not happen in downlink traffic\n");
-										}
-									}
-									if(nack_activated) {
-										// Send NACK to both ongoing transmitter and incoming interferer nodes
-										logical_nack = GenerateLogicalNack(notification.packet_type, nav_notification.packet_id,
-												node_id, nav_notification.source_id, notification.source_id, loss_reason, BER, current_sinr);
-										SendLogicalNack(logical_nack);
-									}
+						power_rx_interest, constant_per, node_id);
 
-							} else {	// If ongoing data packet IS NOT LOST (incoming transmission does not affect ongoing reception)
+					switch(capture_as_destination(loss_reason, notification.packet_type, power_received_per_node,
+						notification.source_id, receiving_from_node_id, capture_effect)){
 
-								if (nack_activated) {
-									LOGS(save_node_logs, node_logger.file,
-											"%.15f;N%d;S%d;%s;%s Low strength signal received while already receiving from N%d\n",
-										SimTime(), node_id, node_state, LOG_D20, LOG_LVL4, receiving_from_node_id);
-
-									// Send logical NACK to incoming transmitter indicating that node is already receiving
-									logical_nack = GenerateLogicalNack(notification.packet_type, receiving_from_node_id,
-											node_id, notification.source_id, NODE_ID_NONE, PACKET_LOST_LOW_SIGNAL_AND_RX, BER, current_sinr);
+						case CAPTURE_SWITCH:{	// The new RTS captures the receiver
+							// Start decoding the new packet
+							incoming_notification = notification;
+							// Change state and update receiving info
+							data_duration = notification.tx_info.data_duration;
+							ack_duration = notification.tx_info.ack_duration;
+							rts_duration = notification.tx_info.rts_duration;
+							cts_duration = notification.tx_info.cts_duration;
+							current_left_channel = notification.left_channel;
+							current_right_channel = notification.right_channel;
+							node_state = STATE_RX_RTS;
+							receiving_from_node_id = notification.source_id;
+							receiving_packet_id = notification.packet_id;
+							// Pause backoff as node has began a reception
+							if(node_is_transmitter) PauseBackoff();
+							if (nack_activated) {
+								// Send NACK to both ongoing transmitter and incoming interferer nodes
+								logical_nack = GenerateLogicalNack(notification.packet_type, nav_notification.packet_id,
+										node_id, NODE_ID_NONE, notification.source_id, PACKET_LOST_CAPTURE_EFFECT, BER, current_sinr);
+								SendLogicalNack(logical_nack);
+							}
+							break;
+						}
 
-									SendLogicalNack(logical_nack);
+						case CAPTURE_COLLISION:{	// If ongoing data packet IS LOST
+							// Pure collision (two nodes transmitting to me with enough power)
+							LOGS(save_node_logs, node_logger,
+								"%.15f;N%d;S%d;%s;%s Pure collision! Already receiving from N%d\n",
+								SimTime(), node_id, node_state, LOG_D19, LOG_LVL4, receiving_from_node_id);
+							loss_reason = PACKET_LOST_PURE_COLLISION;
+							// If two or more packets sent at the same time
+							if(fabs(notification.timestamp - incoming_notification.timestamp) < MAX_DIFFERENCE_SAME_TIME){
+								// SERGIO HandleSlottedBackoffCollision();
+								loss_reason = PACKET_LOST_BO_COLLISION;
+								if(!node_is_transmitter) {
+									time_to_trigger = SimTime() + MAX_DIFFERENCE_SAME_TIME;
+									trigger_NAV_timeout.Set(fix_time_offset(time_to_trigger,13,12));
+								} else {
+									printf("ALARM! Should not happen in downlink traffic\n");
 								}
-
+							}
+							if(nack_activated) {
+								// Send NACK to both ongoing transmitter and incoming interferer nodes
+								logical_nack = GenerateLogicalNack(notification.packet_type, nav_notification.packet_id,
+										node_id, nav_notification.source_id, notification.source_id, loss_reason, BER, current_sinr);
+								SendLogicalNack(logical_nack);
 							}
 							break;
 						}
 
-						case CE_IEEE_802_11:{
-							int capture_effect_condition (power_received_per_node[notification.source_id] >
-								power_received_per_node[receiving_from_node_id] + capture_effect);
-
-							if (loss_reason == PACKET_NOT_LOST && capture_effect_condition) {
-								if (notification.packet_type == PACKET_TYPE_RTS) {
-									// Start decoding the new packet
-									incoming_notification = notification;
-									// Change state and update receiving info
-									data_duration = notification.tx_info.data_duration;
-									ack_duration = notification.tx_info.ack_duration;
-									rts_duration = notification.tx_info.rts_duration;
-									cts_duration = notification.tx_info.cts_duration;
-									current_left_channel = notification.left_channel;
-									current_right_channel = notification.right_channel;
-									node_state = STATE_RX_RTS;
-									receiving_from_node_id = notification.source_id;
-									receiving_packet_id = notification.packet_id;
-									// Pause backoff as node has began a reception
-									if(node_is_transmitter) PauseBackoff();
-									if (nack_activated) {
-										// Send NACK to both ongoing transmitter and incoming interferer nodes
-										logical_nack = GenerateLogicalNack(notification.packet_type, nav_notification.packet_id,
-												node_id, NODE_ID_NONE, notification.source_id, PACKET_LOST_CAPTURE_EFFECT, BER, current_sinr);
-										SendLogicalNack(logical_nack);
-									}
-								}  else {
-									// Pure collision (two nodes transmitting to me with enough power)
-									LOGS(save_node_logs, node_logger.file,
-										"%.15f;N%d;S%d;%s;%s Pure collision! Already receiving from N%d\n",
-										SimTime(), node_id, node_state, LOG_D19, LOG_LVL4, receiving_from_node_id);
-									loss_reason = PACKET_LOST_PURE_COLLISION;
-									// If two or more packets sent at the same time
-									if(fabs(notification.timestamp - incoming_notification.timestamp) < MAX_DIFFERENCE_SAME_TIME) {
-										loss_reason = PACKET_LOST_BO_COLLISION;
-										if(!node_is_transmitter) {
-											time_to_trigger = SimTime() + MAX_DIFFERENCE_SAME_TIME;
-											trigger_NAV_timeout.Set(fix_time_offset(time_to_trigger,13,12));
-										} else {
-											printf("ALARM! Should not happen in downlink traffic\n");
-										}
-									}
-									if(nack_activated){
-										// Send NACK to both ongoing transmitter and incoming interferer nodes
-										logical_nack = GenerateLogicalNack(notification.packet_type, nav_notification.packet_id,
-												node_id, nav_notification.source_id, notification.source_id, loss_reason, BER, current_sinr);
-										SendLogicalNack(logical_nack);
-									}
-								}
-							} else { // If ongoing data packet IS NOT LOST (incoming transmission does not affect ongoing reception)
-								if(nack_activated){
-									LOGS(save_node_logs, node_logger.file,
-											"%.15f;N%d;S%d;%s;%s Low strength signal received while already receiving from N%d\n",
-										SimTime(), node_id, node_state, LOG_D20, LOG_LVL4, receiving_from_node_id);
-									// Send logical NACK to incoming transmitter indicating that node is already receiving
-									logical_nack = GenerateLogicalNack(notification.packet_type, receiving_from_node_id,
-											node_id, notification.source_id, NODE_ID_NONE, PACKET_LOST_LOW_SIGNAL_AND_RX, BER, current_sinr);
-									SendLogicalNack(logical_nack);
-								}
+						default:{	// If ongoing data packet IS NOT LOST (incoming transmission does not affect ongoing reception)
+							if (nack_activated) {
+								LOGS(save_node_logs, node_logger,
+										"%.15f;N%d;S%d;%s;%s Low strength signal received while already receiving from N%d\n",
+									SimTime(), node_id, node_state, LOG_D20, LOG_LVL4, receiving_from_node_id);
+
+								// Send logical NACK to incoming transmitter indicating that node is already receiving
+								logical_nack = GenerateLogicalNack(notification.packet_type, receiving_from_node_id,
+										node_id, notification.source_id, NODE_ID_NONE, PACKET_LOST_LOW_SIGNAL_AND_RX, BER, current_sinr);
+
+								SendLogicalNack(logical_nack);
 							}
 							break;
 						}
@@ -1631,7 +1659,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 				} else {	// Node is NOT THE DESTINATION
 
-//					LOGS(save_node_logs, node_logger.file,
+//					LOGS(save_node_logs, node_logger,
 //						"%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
 //						SimTime(), node_id, node_state, LOG_D08, LOG_LVL3, notification.destination_id);
 
@@ -1642,7 +1670,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 					// Check if the ongoing reception is affected
 					current_sinr = UpdateSINR(power_rx_interest, noise_level, max_pw_interference);
 
-					LOGS(save_node_logs, node_logger.file,
+					LOGS(save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s P[%d] = %f dBm - P_st = %f dBm - P_if = %f dBm - current_sinr = %.2f dBm\n",
 						SimTime(), node_id, node_state, LOG_D08, LOG_LVL5, channel_max_intereference,
 						ConvertPower(PW_TO_DBM, channel_power[channel_max_intereference]),
@@ -1652,25 +1680,26 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 					// Check if the notification that was already being received is lost due to new notification
 					if (spatial_reuse_enabled && txop_sr_identified) {
-						loss_reason = IsPacketLost(current_primary_channel, incoming_notification, notification,
+						loss_reason = is_packet_lost(current_primary_channel, incoming_notification, notification,
 							current_sinr, capture_effect, current_obss_pd_threshold,
-							power_rx_interest, constant_per, node_id, capture_effect_model);
+							power_rx_interest, constant_per, node_id);
 					} else {
-						loss_reason = IsPacketLost(current_primary_channel, incoming_notification, notification,
+						loss_reason = is_packet_lost(current_primary_channel, incoming_notification, notification,
 							current_sinr, capture_effect, current_pd,
-							power_rx_interest, constant_per, node_id, capture_effect_model);
+							power_rx_interest, constant_per, node_id);
 					}
 
-					LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s loss_reason = %d\n",
+					LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s loss_reason = %d\n",
 						SimTime(), node_id, node_state, LOG_D19, LOG_LVL4, loss_reason);
 
 					if(loss_reason != PACKET_NOT_LOST) { 	// If ongoing packet reception IS LOST
 
-						switch(capture_effect_model) {
+						switch(capture_as_interferer(loss_reason, notification.packet_type, power_received_per_node,
+							notification.source_id, receiving_from_node_id, capture_effect)) {
 
-							case CE_DEFAULT:{
+							case CAPTURE_LOST_INTERFERENCE:{
 								// Collision by hidden node
-								LOGS(save_node_logs, node_logger.file,
+								LOGS(save_node_logs, node_logger,
 									"%.15f;N%d;S%d;%s;%s Collision by interferences!\n",
 									SimTime(), node_id, node_state, LOG_D19, LOG_LVL4);
 
@@ -1691,24 +1720,24 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 								break;
 							}
 
-							case CE_IEEE_802_11:{
-								int capture_effect_condition = power_received_per_node[notification.source_id] >
-									power_received_per_node[receiving_from_node_id] + capture_effect;
-								if (capture_effect_condition) {
-									loss_reason = PACKET_LOST_CAPTURE_EFFECT;
-									printf("Node %d was in state RX (from %d), and a new notification arrived from %d:\n", node_id, receiving_from_node_id, notification.source_id);
-									printf("	* New RSSI: %f\n", power_received_per_node[notification.source_id]);
-									printf("	* Old RSSI: %f:\n", power_received_per_node[receiving_from_node_id]);
-									printf("	* CE: %f:\n", capture_effect);
-									printf("	* loss_reason: %d:\n", loss_reason);
-									if(nack_activated){
+							case CAPTURE_LOST_CAPTURE_EFFECT:{
+								loss_reason = PACKET_LOST_CAPTURE_EFFECT;
+								printf("Node %d was in state RX (from %d), and a new notification arrived from %d:\n", OriginalNodeId(node_id), OriginalNodeId(receiving_from_node_id), OriginalNodeId(notification.source_id));
+								printf("	* New RSSI: %f\n", power_received_per_node[notification.source_id]);
+								printf("	* Old RSSI: %f:\n", power_received_per_node[receiving_from_node_id]);
+								printf("	* CE: %f:\n", capture_effect);
+								printf("	* loss_reason: %d:\n", loss_reason);
+								if(nack_activated){
 									// Send NACK to both ongoing transmitter and incoming interferer nodes
 									logical_nack = GenerateLogicalNack(notification.packet_type, nav_notification.packet_id,
 										node_id, nav_notification.source_id, notification.source_id, loss_reason, BER, current_sinr);
 									SendLogicalNack(logical_nack);
-									}
-									RestartNode(FALSE);
 								}
+								RestartNode(FALSE);
+								break;
+							}
+
+							default:{	// The ongoing reception keeps going
 								break;
 							}
 						}
@@ -1725,24 +1754,24 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 //					double sinr_interference (UpdateSINR(power_interference, noise_level, max_pw_interference));
 //
 //					// Is packet lost with the default pd?
-//					int loss_reason_legacy (IsPacketLost(current_primary_channel, notification, notification,
+//					int loss_reason_legacy (is_packet_lost(current_primary_channel, notification, notification,
 //						sinr_interference, capture_effect, sensitivity_default, power_interference, constant_per,
-//						node_id, capture_effect_model));
+//						node_id));
 //					// Is packet lost with the SR pd?
-//					int loss_reason_sr (IsPacketLost(current_primary_channel, notification, notification,
+//					int loss_reason_sr (is_packet_lost(current_primary_channel, notification, notification,
 //						sinr_interference, capture_effect, pd_spatial_reuse, power_interference, constant_per,
-//						node_id, capture_effect_model));
+//						node_id));
 //					// If the packet has been ignored due to the OBSS_PD, then detect a TXOP
 //					if (loss_reason_legacy == PACKET_NOT_LOST && loss_reason_sr != PACKET_NOT_LOST) {
 //						txop_sr_identified = TRUE;	// TXOP identified!
 //						next_pd_spatial_reuse = pd_spatial_reuse;
-//						LOGS(save_node_logs, node_logger.file,
+//						LOGS(save_node_logs, node_logger,
 //							"%.15f;N%d;S%d;%s;%s TXOP detected while being in RX state\n",
 //							SimTime(), node_id, node_state, LOG_D08, LOG_LVL3);
 //					} else if (loss_reason_legacy == PACKET_NOT_LOST && txop_sr_identified) {
 //						// Cancel SR TXOP
 //						txop_sr_identified = FALSE;
-//						LOGS(save_node_logs, node_logger.file,
+//						LOGS(save_node_logs, node_logger,
 //							"%.15f;N%d;S%d;%s;%s Cancelling SR TXOP while being in RX state\n",
 //							SimTime(), node_id, node_state, LOG_D08, LOG_LVL3);
 //					}
@@ -1767,7 +1796,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 					incoming_notification = notification;
 
-//					LOGS(save_node_logs, node_logger.file,
+//					LOGS(save_node_logs, node_logger,
 //							"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d). Checking if notification can be received.\n",
 //							SimTime(), node_id, node_state, LOG_D07, LOG_LVL3, notification.destination_id);
 
@@ -1780,14 +1809,14 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 						// Check if notification has been lost due to interferences or weak signal strength
 						current_sinr = UpdateSINR(power_rx_interest, noise_level, max_pw_interference);
 
-						loss_reason = IsPacketLost(current_primary_channel, incoming_notification, notification,
+						loss_reason = is_packet_lost(current_primary_channel, incoming_notification, notification,
 								current_sinr, capture_effect, current_pd,
-								power_rx_interest, constant_per, node_id, capture_effect_model);
+								power_rx_interest, constant_per, node_id);
 
 						if(loss_reason != PACKET_NOT_LOST
 								&& loss_reason != PACKET_LOST_OUTSIDE_CH_RANGE) {	// If ACK packet IS LOST, send logical Nack
 
-							LOGS(save_node_logs, node_logger.file,
+							LOGS(save_node_logs, node_logger,
 									"%.15f;N%d;S%d;%s;%s Reception of notification %d from N%d CANNOT be started because of reason %d\n",
 									SimTime(), node_id, node_state, LOG_D15, LOG_LVL4, notification.packet_id,
 									notification.source_id, loss_reason);
@@ -1803,7 +1832,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 						} else {	// If ACK packet IS NOT LOST (it can be properly received)
 
-							LOGS(save_node_logs, node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Reception of ACK %d from N%d CAN be started\n",
 								SimTime(), node_id, node_state, LOG_D16, LOG_LVL4, notification.packet_id, notification.source_id);
 
@@ -1813,11 +1842,11 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 							receiving_from_node_id = notification.source_id;
 							receiving_packet_id = notification.packet_id;
 
-//							LOGS(save_node_logs, node_logger.file,
+//							LOGS(save_node_logs, node_logger,
 //									"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d)\n",
 //									SimTime(), node_id, node_state, LOG_D16, LOG_LVL4, notification.destination_id);
 
-//							LOGS(save_node_logs, node_logger.file,
+//							LOGS(save_node_logs, node_logger,
 //									"%.15f;N%d;S%d;%s;%s current_sinr = %f dB\n",
 //									SimTime(), node_id, node_state, LOG_D16, LOG_LVL5,
 //									ConvertPower(LINEAR_TO_DB,current_sinr));
@@ -1825,14 +1854,14 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 						}
 
 					}  else {	//	Some packet type received that is not ACK
-						LOGS(save_node_logs, node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s Unexpected packet type received!\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL4);
 					}
 
 				} else {	// Node IS NOT THE DESTINATION, do nothing
 //
-//					LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
+//					LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
 //								SimTime(), node_id, node_state, LOG_D08, LOG_LVL3, notification.destination_id);
 //
 //					/* ****************************************
@@ -1842,24 +1871,24 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 //					if (spatial_reuse_enabled && type_last_sensed_packet != INTRA_BSS_FRAME && node_is_transmitter) {
 //						double sinr_interference (UpdateSINR(power_rx_interest, noise_level, max_pw_interference));
 //						// Is packet lost with the default pd?
-//						int loss_reason_legacy (IsPacketLost(current_primary_channel, notification, notification,
+//						int loss_reason_legacy (is_packet_lost(current_primary_channel, notification, notification,
 //							sinr_interference, capture_effect, sensitivity_default, power_rx_interest, constant_per,
-//							node_id, capture_effect_model));
+//							node_id));
 //						// Is packet lost with the SR pd?
-//						int loss_reason_sr (IsPacketLost(current_primary_channel, notification, notification,
+//						int loss_reason_sr (is_packet_lost(current_primary_channel, notification, notification,
 //							sinr_interference, capture_effect, pd_spatial_reuse, power_rx_interest, constant_per,
-//							node_id, capture_effect_model));
+//							node_id));
 //						// If the packet has been ignored due to the OBSS_PD, then detect a TXOP
 //						if (loss_reason_legacy == PACKET_NOT_LOST && loss_reason_sr != PACKET_NOT_LOST) {
 //							txop_sr_identified = TRUE;	// TXOP identified!
 //							next_pd_spatial_reuse = pd_spatial_reuse;
-//							LOGS(save_node_logs, node_logger.file,
+//							LOGS(save_node_logs, node_logger,
 //								"%.15f;N%d;S%d;%s;%s TXOP detected while being in WAIT ACK state\n",
 //								SimTime(), node_id, node_state, LOG_D08, LOG_LVL3);
 //						} else if (loss_reason_legacy == PACKET_NOT_LOST && txop_sr_identified) {
 //							// Cancel SR TXOP
 //							txop_sr_identified = FALSE;
-//							LOGS(save_node_logs, node_logger.file,
+//							LOGS(save_node_logs, node_logger,
 //								"%.15f;N%d;S%d;%s;%s Cancelling SR TXOP while being in WAIT ACK state\n",
 //								SimTime(), node_id, node_state, LOG_D08, LOG_LVL3);
 //						}
@@ -1881,7 +1910,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 					incoming_notification = notification;
 
-//					LOGS(save_node_logs, node_logger.file,
+//					LOGS(save_node_logs, node_logger,
 //							"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d). Checking if notification can be received.\n",
 //							SimTime(), node_id, node_state, LOG_D07, LOG_LVL3, notification.destination_id);
 
@@ -1896,7 +1925,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 						// Check if notification has been lost due to interferences or weak signal strength
 						current_sinr = UpdateSINR(power_rx_interest, noise_level, max_pw_interference);
 
-//						LOGS(save_node_logs, node_logger.file,
+//						LOGS(save_node_logs, node_logger,
 //							"%.15f;N%d;S%d;%s;%s P_sn = %f dBm (%f pW) - P_st= %f dBm (%f pW)"
 //							"- P_if = %f dBm (%f pW)\n",
 //							SimTime(), node_id, node_state, LOG_D08, LOG_LVL5,
@@ -1904,14 +1933,14 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 //							ConvertPower(PW_TO_DBM, power_rx_interest), power_rx_interest, ConvertPower(PW_TO_DBM, max_pw_interference),
 //							max_pw_interference);
 
-						loss_reason = IsPacketLost(current_primary_channel, incoming_notification, notification,
+						loss_reason = is_packet_lost(current_primary_channel, incoming_notification, notification,
 							current_sinr, capture_effect, current_pd,
-							power_rx_interest, constant_per, node_id, capture_effect_model);
+							power_rx_interest, constant_per, node_id);
 
 						if(loss_reason != PACKET_NOT_LOST
 								&& loss_reason != PACKET_LOST_OUTSIDE_CH_RANGE)  {	// If CTS packet IS LOST, send logical Nack
 
-							LOGS(save_node_logs, node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Reception of notification %d from N%d CANNOT be started because of reason %d\n",
 								SimTime(), node_id, node_state, LOG_D15, LOG_LVL4, notification.packet_id,
 								notification.source_id, loss_reason);
@@ -1928,7 +1957,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 						} else {	// If CTS packet IS NOT LOST (it can be properly received)
 
-							LOGS(save_node_logs, node_logger.file,
+							LOGS(save_node_logs, node_logger,
 									"%.15f;N%d;S%d;%s;%s Reception of CTS #%d from N%d CAN be started\n",
 									SimTime(), node_id, node_state, LOG_D16, LOG_LVL4,
 									notification.packet_id, notification.source_id);
@@ -1944,24 +1973,24 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 							ack_duration = notification.tx_info.ack_duration;
 							cts_duration = notification.tx_info.cts_duration;
 
-//							LOGS(save_node_logs, node_logger.file,
+//							LOGS(save_node_logs, node_logger,
 //									"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d)\n",
 //									SimTime(), node_id, node_state, LOG_D16, LOG_LVL4, notification.destination_id);
 
-//							LOGS(save_node_logs, node_logger.file,
+//							LOGS(save_node_logs, node_logger,
 //									"%.15f;N%d;S%d;%s;%s current_sinr = %f dB\n",
 //									SimTime(), node_id, node_state, LOG_D16, LOG_LVL5, ConvertPower(LINEAR_TO_DB,current_sinr));
 
 						}
 
 					}  else {	//	Some packet type received that is not CTS
-						LOGS(save_node_logs, node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s Unexpected packet type received!\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL4);
 					}
 
 				} else {	// Node IS NOT THE DESTINATION, do nothing
-////					LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
+////					LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
 ////						SimTime(), node_id, node_state, LOG_D08, LOG_LVL3, notification.destination_id);
 //					/* ****************************************
 //					/* SPATIAL REUSE OPERATION
@@ -1971,24 +2000,24 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 //
 //						double sinr_interference (UpdateSINR(power_rx_interest, noise_level, max_pw_interference));
 //						// Is packet lost with the default pd?
-//						int loss_reason_legacy (IsPacketLost(current_primary_channel, notification, notification,
+//						int loss_reason_legacy (is_packet_lost(current_primary_channel, notification, notification,
 //							sinr_interference, capture_effect, sensitivity_default, power_rx_interest, constant_per,
-//							node_id, capture_effect_model));
+//							node_id));
 //						// Is packet lost with the SR pd?
-//						int loss_reason_sr (IsPacketLost(current_primary_channel, notification, notification,
+//						int loss_reason_sr (is_packet_lost(current_primary_channel, notification, notification,
 //							sinr_interference, capture_effect, pd_spatial_reuse, power_rx_interest, constant_per,
-//							node_id, capture_effect_model));
+//							node_id));
 //						// If the packet has been ignored due to the OBSS_PD, then detect a TXOP
 //						if (loss_reason_legacy == PACKET_NOT_LOST && loss_reason_sr != PACKET_NOT_LOST) {
 //							txop_sr_identified = TRUE;	// TXOP identified!
 //							next_pd_spatial_reuse = pd_spatial_reuse;
-//							LOGS(save_node_logs, node_logger.file,
+//							LOGS(save_node_logs, node_logger,
 //								"%.15f;N%d;S%d;%s;%s TXOP detected while being in WAIT CTS state\n",
 //								SimTime(), node_id, node_state, LOG_D08, LOG_LVL3);
 //						} else if (loss_reason_legacy == PACKET_NOT_LOST && txop_sr_identified) {
 //							// Cancel SR TXOP
 //							txop_sr_identified = FALSE;
-//							LOGS(save_node_logs, node_logger.file,
+//							LOGS(save_node_logs, node_logger,
 //								"%.15f;N%d;S%d;%s;%s Cancelling SR TXOP while being in WAIT CTS state\n",
 //								SimTime(), node_id, node_state, LOG_D08, LOG_LVL3);
 //						}
@@ -2012,7 +2041,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 					power_rx_interest = power_received_per_node[notification.source_id];
 					incoming_notification = notification;
 
-//					LOGS(save_node_logs, node_logger.file,
+//					LOGS(save_node_logs, node_logger,
 //							"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d). Checking if notification can be received.\n",
 //							SimTime(), node_id, node_state, LOG_D07, LOG_LVL3, notification.destination_id);
 
@@ -2025,7 +2054,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 						// Check if notification has been lost due to interferences or weak signal strength
 						current_sinr = UpdateSINR(power_rx_interest, noise_level, max_pw_interference);
 
-						LOGS(save_node_logs, node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s P[%d] = %f dBm - P_st = %f dBm - P_if = %f dBm - current_sinr = %.2f dBm\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL5, channel_max_intereference,
 							ConvertPower(PW_TO_DBM, channel_power[channel_max_intereference]),
@@ -2033,14 +2062,14 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 							ConvertPower(PW_TO_DBM, max_pw_interference),
 							ConvertPower(LINEAR_TO_DB, current_sinr));
 
-						loss_reason = IsPacketLost(current_primary_channel, incoming_notification, notification,
+						loss_reason = is_packet_lost(current_primary_channel, incoming_notification, notification,
 							current_sinr, capture_effect, current_pd,
-							power_rx_interest, constant_per, node_id, capture_effect_model);
+							power_rx_interest, constant_per, node_id);
 
 						if(loss_reason != PACKET_NOT_LOST
 							&& loss_reason != PACKET_LOST_OUTSIDE_CH_RANGE)  {	// If DATA packet IS LOST, send logical Nack
 
-							LOGS(save_node_logs, node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Reception of notification %d from N%d CANNOT be started because of reason %d\n",
 								SimTime(), node_id, node_state, LOG_D15, LOG_LVL4, notification.packet_id,
 								notification.source_id, loss_reason);
@@ -2055,7 +2084,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 						} else {	// If DATA packet IS NOT LOST (it can be properly received)
 
-							LOGS(save_node_logs, node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Reception of DATA %d from N%d CAN be started\n",
 								SimTime(), node_id, node_state, LOG_D16, LOG_LVL4, notification.packet_id, notification.source_id);
 
@@ -2072,14 +2101,14 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 						}
 
 					}  else {	//	Some packet type received that is not ACK
-						LOGS(save_node_logs, node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s Unexpected packet type received!\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL4);
 					}
 
 				} else {	// Node IS NOT THE DESTINATION, do nothing
 
-//					LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
+//					LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
 //								SimTime(), node_id, node_state, LOG_D08, LOG_LVL3, notification.destination_id);
 
 				}
@@ -2091,24 +2120,24 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 //				if (spatial_reuse_enabled && type_last_sensed_packet != INTRA_BSS_FRAME && node_is_transmitter) {
 //					double sinr_interference (UpdateSINR(power_rx_interest, noise_level, max_pw_interference));
 //					// Is packet lost with the default pd?
-//					int loss_reason_legacy (IsPacketLost(current_primary_channel, notification, notification,
+//					int loss_reason_legacy (is_packet_lost(current_primary_channel, notification, notification,
 //						sinr_interference, capture_effect, sensitivity_default, power_rx_interest, constant_per,
-//						node_id, capture_effect_model));
+//						node_id));
 //					// Is packet lost with the SR pd?
-//					int loss_reason_sr (IsPacketLost(current_primary_channel, notification, notification,
+//					int loss_reason_sr (is_packet_lost(current_primary_channel, notification, notification,
 //						sinr_interference, capture_effect, pd_spatial_reuse, power_rx_interest, constant_per,
-//						node_id, capture_effect_model));
+//						node_id));
 //					// If the packet has been ignored due to the OBSS_PD, then detect a TXOP
 //					if (loss_reason_legacy == PACKET_NOT_LOST && loss_reason_sr != PACKET_NOT_LOST) {
 //						txop_sr_identified = TRUE;	// TXOP identified!
 //						next_pd_spatial_reuse = pd_spatial_reuse;
-//						LOGS(save_node_logs, node_logger.file,
+//						LOGS(save_node_logs, node_logger,
 //							"%.15f;N%d;S%d;%s;%s TXOP detected while being in WAIT DATA state\n",
 //							SimTime(), node_id, node_state, LOG_D08, LOG_LVL3);
 //					} else if (loss_reason_legacy == PACKET_NOT_LOST && txop_sr_identified) {
 //						// Cancel SR TXOP
 //						txop_sr_identified = FALSE;
-//						LOGS(save_node_logs, node_logger.file,
+//						LOGS(save_node_logs, node_logger,
 //							"%.15f;N%d;S%d;%s;%s Cancelling SR TXOP while being in WAIT DATA state (SHOULD NOT HAPPEN!)\n",
 //							SimTime(), node_id, node_state, LOG_D08, LOG_LVL3);
 //					}
@@ -2137,7 +2166,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 		channel_idle = false;
 	}
 
-	// LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s InportSomeNodeStartTX() END\n", SimTime(), node_id, node_state, LOG_D01, LOG_LVL1);
+	// LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s InportSomeNodeStartTX() END\n", SimTime(), node_id, node_state, LOG_D01, LOG_LVL1);
 };
 
 /*
@@ -2147,7 +2176,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
  */
 void Node :: InportSomeNodeFinishTX(Notification &notification){
 
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s InportSomeNodeFinishTX(): N%d to N%d (type %d)"
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s InportSomeNodeFinishTX(): N%d to N%d (type %d)"
 			" at range %d-%d "
 			"- nodes transmitting: ",
 		SimTime(), node_id, node_state, LOG_E00, LOG_LVL1,
@@ -2161,21 +2190,21 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 	if(notification.source_id == node_id){	// Node is the TX source: do nothing
 
-//		LOGS(save_node_logs,node_logger.file,
+//		LOGS(save_node_logs, node_logger,
 //				"%.15f;N%d;S%d;%s;%s I have finished the TX of packet #%d (type %d) in channel range: %d - %d\n",
 //				SimTime(), node_id, node_state, LOG_E18, LOG_LVL2, notification.packet_id,
 //				notification.packet_type, notification.left_channel, notification.right_channel);
 
 	} else {	// Node is not the TX source
 
-//		LOGS(save_node_logs,node_logger.file,
+//		LOGS(save_node_logs, node_logger,
 //				"%.15f;N%d;S%d;%s;%s N%d has finished the TX of packet #%d (type %d) in channel range: %d - %d\n",
 //				SimTime(), node_id, node_state, LOG_E18, LOG_LVL2, notification.source_id,
 //				notification.packet_id, notification.packet_type, notification.left_channel,
 //				notification.right_channel);
 
 
-//		LOGS(save_node_logs,node_logger.file,
+//		LOGS(save_node_logs, node_logger,
 //			"%.15f;N%d;S%d;%s;%s Channel before updating: ",
 //			SimTime(), node_id, node_state, LOG_E18, LOG_LVL3);
 //
@@ -2183,9 +2212,8 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 //				channel_power, num_channels_komondor);
 
 		// Update the power sensed at each channel
-		UpdateChannelsPower(&channel_power, notification, TX_FINISHED,
-			central_frequency, num_channels_komondor, path_loss_model, rx_gain,
-			adjacent_channel_model, received_power_array[notification.source_id], node_id);
+		UpdateChannelsPower(&channel_power, notification, TX_FINISHED, num_channels_komondor,
+			apply_adjacent_channel_model, received_power_array[notification.source_id]);
 
 		// -------------------------
 		// Safety condtion. Empty the channel when no node is transmitting
@@ -2213,7 +2241,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 		}
 		/* **************************************** */
 
-		LOGS(save_node_logs,node_logger.file,
+		LOGS(save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s Power sensed per channel: ",
 			SimTime(), node_id, node_state, LOG_E18, LOG_LVL3);
 
@@ -2224,22 +2252,29 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 		UpdatePowerSensedPerNode(current_primary_channel, power_received_per_node, notification,
 			rx_gain, central_frequency, path_loss_model, received_power_array[notification.source_id], TX_FINISHED);
 
+		// The power of a node that moved during its TX is updated once the TX power has been removed
+		std::map<int, double>::iterator deferred (deferred_received_power.find(notification.source_id));
+		if (deferred != deferred_received_power.end()) {
+			received_power_array[notification.source_id] = deferred->second;
+			deferred_received_power.erase(deferred);
+		}
+
 		UpdateTimestamptChannelFreeAgain(timestampt_channel_becomes_free, &channel_power,
 			current_pd, num_channels_komondor, SimTime());
 
 		if(save_node_logs) {
-			LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s timestampt_channel_becomes_free: ",
+			LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s timestampt_channel_becomes_free: ",
 				SimTime(), node_id, node_state, LOG_F02, LOG_LVL3);
 			for(int i = 0; i < num_channels_komondor; ++i){
-				fprintf(node_logger.file, "%.9f  ", timestampt_channel_becomes_free[i]);
+				LogPrintf(node_logger, "%.9f  ", timestampt_channel_becomes_free[i]);
 			}
-			fprintf(node_logger.file, "\n");
-			LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s difference times: ",
+			LogPrintf(node_logger, "\n");
+			LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s difference times: ",
 				SimTime(), node_id, node_state, LOG_F02, LOG_LVL3);
 			for(int i = 0; i < num_channels_komondor; ++i){
-				fprintf(node_logger.file, "%.9f  ", SimTime() - timestampt_channel_becomes_free[i]);
+				LogPrintf(node_logger, "%.9f  ", SimTime() - timestampt_channel_becomes_free[i]);
 			}
-			fprintf(node_logger.file, "\n");
+			LogPrintf(node_logger, "\n");
 		}
 
 		switch(node_state){
@@ -2253,14 +2288,14 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 					if(!trigger_start_backoff.Active()
 						&& !trigger_end_backoff.Active()){	// BO was paused and DIFS not initiated
 
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s UNEXPECTED ERROR IN THE BACKOFF!\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL5);
 
 						int resume (HandleBackoff(RESUME_TIMER, &channel_power, current_primary_channel, current_pd,
 								buffer.QueueSize()));
 
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s P[%d] = %f dBm (%f)\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL5,
 							current_primary_channel, ConvertPower(PW_TO_DBM, channel_power[current_primary_channel]), channel_power[current_primary_channel]);
@@ -2272,17 +2307,17 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 							time_to_trigger = SimTime() + DIFS;
 							// time_to_trigger = SimTime() + SIFS + notification.tx_info.cts_duration + DIFS;
 							trigger_start_backoff.Set(fix_time_offset(time_to_trigger,13,12));
-							LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s BO will be resumed after DIFS at %.12f.\n",
+							LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s BO will be resumed after DIFS at %.12f.\n",
 								SimTime(), node_id, node_state, LOG_E11, LOG_LVL4,
 								trigger_start_backoff.GetTime());
-//							LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s EIFS started.\n",
+//							LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s EIFS started.\n",
 //														SimTime(), node_id, node_state, LOG_E11, LOG_LVL4);
 						} else {	// BO cannot be resumed
-							LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s EIFS cannot be started.\n",
+							LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s EIFS cannot be started.\n",
 								SimTime(), node_id, node_state, LOG_E11, LOG_LVL4);
 						}
 					} else {	// BO was already active
-						LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s BO was already active.\n",
+						LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s BO was already active.\n",
 								SimTime(), node_id, node_state, LOG_E11, LOG_LVL4);
 					}
 				}
@@ -2301,7 +2336,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 					if(notification.packet_type == PACKET_TYPE_DATA){	// Data packet transmission finished
 
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s Packet #%d reception from N%d is finished successfully.\n",
 							SimTime(), node_id, node_state, LOG_E14, LOG_LVL3, notification.packet_id,
 							notification.source_id);
@@ -2344,20 +2379,20 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 						time_to_trigger = SimTime() + SIFS;
 						trigger_SIFS.Set(fix_time_offset(time_to_trigger,13,12));
 
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s SIFS will be triggered in %.12f\n",
 							SimTime(), node_id, node_state, LOG_E14, LOG_LVL3,
 							trigger_SIFS.GetTime());
 
 					} else {	// Other packet type transmission finished
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s Unexpected packet type transmission finished!\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL4);
 					}
 
 				} else {	// Node IS NOT THE DESTINATION, do nothing
 
-					LOGS(save_node_logs,node_logger.file,
+					LOGS(save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s Still noticing a packet transmission (#%d) from N%d.\n",
 						SimTime(), node_id, node_state, LOG_E15, LOG_LVL3, notification.packet_id,
 						notification.source_id);
@@ -2379,7 +2414,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 					if(notification.packet_type == PACKET_TYPE_ACK){	// ACK packet transmission finished
 
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s ACK #%d reception from N%d is finished successfully.\n",
 							SimTime(), node_id, node_state, LOG_E14, LOG_LVL3, notification.packet_id,
 							notification.source_id);
@@ -2399,7 +2434,10 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 							++data_frames_acked_per_sta[current_destination_id-node_id-1];
 							++num_delay_measurements;
 							sum_delays = sum_delays + (SimTime() - buffer.GetFirstPacket().timestamp_generated);
-							LOGS(save_node_logs,node_logger.file,
+							delay_histogram.Add(SimTime() - buffer.GetFirstPacket().timestamp_generated);
+							delay_histogram_per_sta[current_destination_id-node_id-1].Add(
+								SimTime() - buffer.GetFirstPacket().timestamp_generated);
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Packet delay: %f us (generated at %f).\n",
 								SimTime(), node_id, node_state, LOG_E14, LOG_LVL4,
 								(SimTime() - buffer.GetFirstPacket().timestamp_generated) * pow(10,6),
@@ -2422,23 +2460,23 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 							}
 						}
 
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s Data packet/s removed from buffer (queue: %d/%d).\n",
 							SimTime(), node_id, node_state, LOG_E14, LOG_LVL3,
 							buffer.QueueSize(), PACKET_BUFFER_SIZE);
 
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s Handling contention window\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL4);
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 									"%.15f;N%d;S%d;%s;%s From CW = %d, b = %d, m = %d\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL5,
 							cw_current, cw_stage_current, cw_stage_max);
 						// Sergio on 20/09/2017:
 						// - Transmission succeeded ---> reset CW if binary exponential backoff is implemented
-						HandleContentionWindow(
-								cw_adaptation, RESET_CW, &cw_current, cw_min, &cw_stage_current, cw_stage_max);
-						LOGS(save_node_logs,node_logger.file,
+						handle_contention_window(
+								RESET_CW, &cw_current, cw_min, &cw_stage_current, cw_stage_max);
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s To CW = %d, b = %d, m = %d\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL5,
 							cw_current, cw_stage_current, cw_stage_max);
@@ -2448,14 +2486,14 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 						RestartNode(FALSE);
 
 					} else {	// Other packet type transmission finished
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s Unexpected packet type transmission finished!\n",
 							SimTime(), node_id, node_state, LOG_D08, LOG_LVL4);
 					}
 
 				} else {	// Node IS NOT THE DESTINATION
 
-					LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Still receiving packet #%d reception from N%d.\n",
+					LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Still receiving packet #%d reception from N%d.\n",
 						SimTime(), node_id, node_state, LOG_E15, LOG_LVL3, incoming_notification.packet_id,
 						incoming_notification.source_id);
 				}
@@ -2486,13 +2524,13 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 					if(notification.packet_type == PACKET_TYPE_RTS){	// RTS packet transmission finished
 
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s RTS #%d reception from N%d is finished successfully.\n",
 							SimTime(), node_id, node_state, LOG_E14, LOG_LVL3, notification.packet_id,
 							notification.source_id);
 
 						// Check channel availability in order to send the CTS
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s Checking if CTS can be sent: P_sen = %f dBm, pd = %f dBm.\n",
 							SimTime(), node_id, node_state, LOG_E14, LOG_LVL3,
 							ConvertPower(PW_TO_DBM, channel_power[current_primary_channel]),
@@ -2500,7 +2538,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 						if(ConvertPower(PW_TO_DBM, channel_power[current_primary_channel]) < current_pd) {
 
-							LOGS(save_node_logs,node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Channel(s) is (are) clear! Sending CTS to N%d (STATE = %d) ...\n",
 								SimTime(), node_id, node_state, LOG_E14, LOG_LVL3, current_destination_id, node_state);
 
@@ -2524,7 +2562,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 							time_to_trigger = SimTime() + SIFS;
 							trigger_SIFS.Set(fix_time_offset(time_to_trigger,13,12)); // triggers the SendResponsePacket() function after SIFS
 
-							LOGS(save_node_logs,node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s SIFS will be triggered in %.12f\n",
 								SimTime(), node_id, node_state, LOG_E14, LOG_LVL3,
 								trigger_SIFS.GetTime());
@@ -2553,7 +2591,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 						} else {
 							// CANNOT START PACKET TX
 
-							LOGS(save_node_logs,node_logger.file,
+							LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s NO PUEDE PASAR!\n",
 								SimTime(), node_id, node_state, LOG_D08, LOG_LVL4);
 
@@ -2574,14 +2612,14 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 						}
 
 					} else {	// Other packet type transmission finished
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Unexpected packet type transmission finished!\n",
 								SimTime(), node_id, node_state, LOG_D08, LOG_LVL4);
 					}
 
 				} else {	// Node IS NOT THE DESTINATION
 
-					LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Still receiving packet #%d reception from N%d.\n",
+					LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Still receiving packet #%d reception from N%d.\n",
 							SimTime(), node_id, node_state, LOG_E15, LOG_LVL3, incoming_notification.packet_id,
 							incoming_notification.source_id);
 				}
@@ -2599,7 +2637,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 					if(notification.packet_type == PACKET_TYPE_CTS){	// CTS packet transmission finished
 
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s CTS #%d reception from N%d is finished successfully.\n",
 								SimTime(), node_id, node_state, LOG_E14, LOG_LVL3,
 								notification.packet_id, notification.source_id);
@@ -2625,7 +2663,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 						trigger_SIFS.Set(fix_time_offset(time_to_trigger,13,12));
 
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s SIFS will be triggered in %.12f\n",
 							SimTime(), node_id, node_state, LOG_E14, LOG_LVL3,
 							trigger_SIFS.GetTime());
@@ -2650,14 +2688,14 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 
 					} else {	// Other packet type transmission finished
-						LOGS(save_node_logs,node_logger.file,
+						LOGS(save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Unexpected packet type transmission finished!\n",
 								SimTime(), node_id, node_state, LOG_D08, LOG_LVL4);
 					}
 
 				} else {	// Node IS NOT THE DESTINATION
 
-					LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Still receiving packet #%d reception from N%d.\n",
+					LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Still receiving packet #%d reception from N%d.\n",
 						SimTime(), node_id, node_state, LOG_E15, LOG_LVL3, incoming_notification.packet_id,
 						incoming_notification.source_id);
 				}
@@ -2694,7 +2732,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 		}
 	}
 
-	// LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s InportSomeNodeFinishTX() END",	SimTime(), node_id, node_state, LOG_E01, LOG_LVL1);
+	// LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s InportSomeNodeFinishTX() END",	SimTime(), node_id, node_state, LOG_E01, LOG_LVL1);
 };
 
 /*
@@ -2706,7 +2744,7 @@ void Node :: InportNackReceived(LogicalNack &logical_nack){
 
 	int nack_reason;
 
-//	LOGS(save_node_logs,node_logger.file,
+//	LOGS(save_node_logs, node_logger,
 //			"%.15f;N%d;S%d;%s;%s InportNackReceived(): N%d to N%d (A) and N%d (B)\n",
 //			SimTime(), node_id, node_state, LOG_H00, LOG_LVL1, logical_nack.source_id,
 //			logical_nack.node_id_a, logical_nack.node_id_b);
@@ -2715,7 +2753,7 @@ void Node :: InportNackReceived(LogicalNack &logical_nack){
 	if(logical_nack.source_id != node_id &&
 			(node_id == logical_nack.node_id_a || node_id == logical_nack.node_id_b)){
 
-		LOGS(save_node_logs,node_logger.file,
+		LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s NACK of packet #%d received from N%d sent to a:N%d (and b:N%d) with reason %d\n",
 				SimTime(), node_id, node_state, LOG_H00, LOG_LVL2, logical_nack.packet_id, logical_nack.source_id,
 				logical_nack.node_id_a, logical_nack.node_id_b, logical_nack.loss_reason);
@@ -2724,32 +2762,37 @@ void Node :: InportNackReceived(LogicalNack &logical_nack){
 		nack_reason = ProcessNack(logical_nack, node_id, node_logger, node_state, save_node_logs,
 			SimTime(), nacks_received, total_nodes_number, nodes_transmitting);
 
+		TriggerFlightRecorder((nack_reason == PACKET_LOST_BO_COLLISION) ?
+			FLIGHT_RECORDER_TRIGGER_BO_COLLISION : FLIGHT_RECORDER_TRIGGER_NACK,
+			(nack_reason == PACKET_LOST_BO_COLLISION) ? "slotted BO collision" : "NACK received",
+			logical_nack.source_id);
+
 		if(nack_reason == PACKET_LOST_BO_COLLISION){
 			++ rts_lost_slotted_bo;
 
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s ++++++++++++++++++++++++++++++++\n",
 				SimTime(), node_id, node_state, LOG_H00, LOG_LVL2);
 
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s rts_lost_slotted_bo ++\n",
 				SimTime(), node_id, node_state, LOG_H00, LOG_LVL2);
 
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s ++++++++++++++++++++++++++++++++\n",
 				SimTime(), node_id, node_state, LOG_H00, LOG_LVL2);
 		}
 
 	} else {	// Node is the NACK transmitter, do nothing
 
-//		LOGS(save_node_logs,node_logger.file,
+//		LOGS(save_node_logs, node_logger,
 //				"%.15f;N%d;S%d;%s;%s NACK of packet #%d sent to a) N%d and b) N%d with reason %d\n",
 //				SimTime(), node_id, node_state, LOG_H00, LOG_LVL2, logical_nack.packet_id,
 //				logical_nack.node_id_a, logical_nack.node_id_b, logical_nack.loss_reason);
 
 	}
 
-	// LOGS(save_node_logs,node_logger.file, "%.15f;N%d;G01;%s InportNackReceived() END\n", SimTime(), node_id, LOG_LVL1);
+	// LOGS(save_node_logs, node_logger, "%.15f;N%d;G01;%s InportNackReceived() END\n", SimTime(), node_id, LOG_LVL1);
 }
 
 /*
@@ -2761,7 +2804,7 @@ void Node :: InportMCSRequestReceived(Notification &notification){
 
 	if(notification.destination_id == node_id) {	// If node IS THE DESTINATION
 
-		LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s MCS request received from N%d\n",
+		LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s MCS request received from N%d\n",
 			SimTime(), node_id, node_state, LOG_F00, LOG_LVL1, notification.source_id);
 
 //		// Compute distance and power received from transmitter
@@ -2779,7 +2822,7 @@ void Node :: InportMCSRequestReceived(Notification &notification){
 				notification.tx_info.tx_power, tx_gain, rx_gain, central_frequency, path_loss_model);
 		}
 
-		LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s I am at distance: %.2f m (sensing P_rx = %.2f dBm)\n",
+		LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s I am at distance: %.2f m (sensing P_rx = %.2f dBm)\n",
 			SimTime(), node_id, node_state, LOG_F00, LOG_LVL2,
 			distances_array[notification.source_id], ConvertPower(PW_TO_DBM,
 			received_power_array[notification.source_id]));
@@ -2787,7 +2830,7 @@ void Node :: InportMCSRequestReceived(Notification &notification){
 		// Select the modulation according to the SINR perceived corresponding to incoming transmitter
 		SelectMCSResponse(mcs_response, received_power_array[notification.source_id]);
 
-		LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s mcs_response for 1, 2, 4 and 8 channels: ",
+		LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s mcs_response for 1, 2, 4 and 8 channels: ",
 			SimTime(), node_id, node_state, LOG_F00, LOG_LVL3);
 
 		PrintOrWriteArrayInt(mcs_response, 4, WRITE_LOG, save_node_logs,
@@ -2813,12 +2856,12 @@ void Node :: InportMCSResponseReceived(Notification &notification){
 
 	if(notification.destination_id == node_id) {	// If node IS THE DESTINATION
 
-		LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s InportMCSResponseReceived()\n",
+		LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s InportMCSResponseReceived()\n",
 				SimTime(), node_id, node_state, LOG_F00, LOG_LVL1);
 
 		int ix_aux (current_destination_id - wlan.list_sta_id[0]);	// Auxiliary index for correcting the node id offset
 
-		LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s MCS per number of channels: ",
+		LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s MCS per number of channels: ",
 			SimTime(), node_id, node_state, LOG_F00, LOG_LVL2);
 
 		// Set receiver modulation to the received one
@@ -2830,7 +2873,7 @@ void Node :: InportMCSResponseReceived(Notification &notification){
 			} else {
 				mcs_per_node[ix_aux][i] = notification.tx_info.modulation_schemes[i];
 			}
-			LOGS(save_node_logs,node_logger.file, "%d ", mcs_per_node[ix_aux][i]);
+			LOGS(save_node_logs, node_logger, "%d ", mcs_per_node[ix_aux][i]);
 		}
 
 		double max_achievable_bits_ofdm_sym (getNumberSubcarriers(max_channel_allowed - min_channel_allowed + 1) *
@@ -2843,9 +2886,9 @@ void Node :: InportMCSResponseReceived(Notification &notification){
 		// Update performance measurements
 		performance_report.max_bound_throughput = max_achievable_throughput;
 
-		LOGS(save_node_logs,node_logger.file, "\n");
+		LOGS(save_node_logs, node_logger, "\n");
 
-		LOGS(save_node_logs,node_logger.file,
+		LOGS(save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s max_achievable_throughput (%d - %d) = %.1f Mbps "
 			"(%d channel/s: Y_sc = %d, MCS %d: Y_m = %d, Y_c = %.2f)\n",
 			SimTime(), node_id, node_state, LOG_F00, LOG_LVL3,
@@ -2865,7 +2908,7 @@ void Node :: InportMCSResponseReceived(Notification &notification){
 //				change_modulation_flag[ix_aux] = TRUE;
 			} else {
 				// NODE UNREACHABLE
-				LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Unreachable node: transmissions to N%d are cancelled\n",
+				LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Unreachable node: transmissions to N%d are cancelled\n",
 					SimTime(), node_id, node_state, LOG_G00, LOG_LVL3, current_destination_id);
 				// TODO: unreachable_nodes[current_destination_id] = TRUE;
 			}
@@ -2901,7 +2944,7 @@ void Node :: InportNewPacketGenerated(){
 				new_packet.packet_id = last_packet_generated_id;
 				buffer.PutPacket(new_packet);
 
-				LOGS(save_node_logs,node_logger.file,
+				LOGS(save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s A new packet (id: %d) has been generated (queue: %d/%d)\n",
 						SimTime(), node_id, node_state, LOG_F00, LOG_LVL4,
 						new_packet.packet_id, buffer.QueueSize(), PACKET_BUFFER_SIZE);
@@ -2910,7 +2953,7 @@ void Node :: InportNewPacketGenerated(){
 				if(node_state == STATE_SENSING && buffer.QueueSize() == 1) {
 
 					if(trigger_end_backoff.Active()) remaining_backoff =
-							ComputeRemainingBackoff(backoff_type, trigger_end_backoff.GetTime() - SimTime());
+							compute_remaining_backoff(trigger_end_backoff.GetTime() - SimTime());
 
 					int resume (HandleBackoff(RESUME_TIMER, &channel_power, current_primary_channel, current_pd,
 							buffer.QueueSize()));
@@ -2924,7 +2967,7 @@ void Node :: InportNewPacketGenerated(){
 
 			} else {
 				// Buffer overflow - new packet is lost
-				LOGS(save_node_logs,node_logger.file,
+				LOGS(save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s A new packet (id: %d) has been dropped! (queue: %d/%d)\n",
 					SimTime(), node_id, node_state, LOG_F00, LOG_LVL4,
 					last_packet_generated_id, buffer.QueueSize(), PACKET_BUFFER_SIZE);
@@ -2941,56 +2984,51 @@ void Node :: InportNewPacketGenerated(){
 
 			++ num_bursts;
 
-			int num_packets_generated_in_burst (burst_rate);
+			int num_packets_generated_in_burst (DrawBurstSize(burst_size_model, burst_size));
+			int queue_size_before_burst (buffer.QueueSize());
 
-			LOGS(save_node_logs,node_logger.file,
-				"%.15f;N%d;S%d;%s;%s New traffic burst (#%d) generated %d packets\n",
-				SimTime(), node_id, node_state, LOG_F00, LOG_LVL4,
-				num_bursts,
-				num_packets_generated_in_burst);
+			// Packets fitting in the buffer are enqueued at once and the rest are dropped
+			int num_packets_enqueued_in_burst (std::max(0, std::min(num_packets_generated_in_burst,
+				PACKET_BUFFER_SIZE - queue_size_before_burst)));
+			int num_packets_dropped_in_burst (num_packets_generated_in_burst - num_packets_enqueued_in_burst);
 
 			num_packets_generated = num_packets_generated + num_packets_generated_in_burst;
+			num_packets_dropped = num_packets_dropped + num_packets_dropped_in_burst;
+			// Update performance measurements
+			performance_report.num_packets_generated += num_packets_generated_in_burst;
+			performance_report.num_packets_dropped += num_packets_dropped_in_burst;
 
-			for(int i = 0; i < num_packets_generated_in_burst; ++i){
-
-				if (buffer.QueueSize() < PACKET_BUFFER_SIZE) {
-
-					// Include new packet
-					Notification new_packet;
-					new_packet.timestamp_generated = SimTime();
-					new_packet.packet_id = last_packet_generated_id;
-					buffer.PutPacket(new_packet);
-
-					LOGS(save_node_logs,node_logger.file,
-							"%.15f;N%d;S%d;%s;%s A new packet (id: %d) has been generated from burst %d (buffer queue: %d/%d)\n",
-							SimTime(), node_id, node_state, LOG_F00, LOG_LVL4,
-							new_packet.packet_id,
-							num_bursts,
-							buffer.QueueSize(),
-							PACKET_BUFFER_SIZE);
+			if(num_packets_enqueued_in_burst > 0) {
+				new_packet = null_notification;
+				new_packet.timestamp_generated = SimTime();
+				new_packet.packet_id = last_packet_generated_id;
+				buffer.PutPackets(new_packet, num_packets_enqueued_in_burst);
+			}
 
-					// Attempt to restart BO only if node didn't have any packet before a new packet was generated
-					if(node_state == STATE_SENSING && buffer.QueueSize() == 1) {
+			LOGS(save_node_logs, node_logger,
+				"%.15f;N%d;S%d;%s;%s New traffic burst (#%d) generated %d packets (ids: %d to %d): %d enqueued, %d dropped (queue: %d/%d)\n",
+				SimTime(), node_id, node_state, LOG_F00, LOG_LVL4,
+				num_bursts, num_packets_generated_in_burst,
+				last_packet_generated_id, last_packet_generated_id + num_packets_generated_in_burst - 1,
+				num_packets_enqueued_in_burst, num_packets_dropped_in_burst,
+				buffer.QueueSize(), PACKET_BUFFER_SIZE);
 
-						if(trigger_end_backoff.Active()) remaining_backoff =
-								ComputeRemainingBackoff(backoff_type, trigger_end_backoff.GetTime() - SimTime());
+			last_packet_generated_id = last_packet_generated_id + num_packets_generated_in_burst;
 
-						int resume (HandleBackoff(RESUME_TIMER, &channel_power, current_primary_channel,
-							current_pd, buffer.QueueSize()));
+			// Attempt to restart BO only if node didn't have any packet before the burst was generated
+			if(node_state == STATE_SENSING && queue_size_before_burst == 0 && num_packets_enqueued_in_burst > 0) {
 
-						if (resume) {
-							time_to_trigger = SimTime() + DIFS;
-							trigger_start_backoff.Set(fix_time_offset(time_to_trigger,13,12));
-						}
+				if(trigger_end_backoff.Active()) remaining_backoff =
+						compute_remaining_backoff(trigger_end_backoff.GetTime() - SimTime());
 
-					}
+				int resume (HandleBackoff(RESUME_TIMER, &channel_power, current_primary_channel,
+					current_pd, buffer.QueueSize()));
 
-				} else {  // Buffer overflow - new packet is lost
-					++num_packets_dropped;
+				if (resume) {
+					time_to_trigger = SimTime() + DIFS;
+					trigger_start_backoff.Set(fix_time_offset(time_to_trigger,13,12));
 				}
 
-				++last_packet_generated_id;
-
 			}
 
 		} // End of BURST TRAFFIC
@@ -3014,8 +3052,8 @@ void Node :: StartTransmission(trigger_t &){
  */
 void Node :: EndBackoff(trigger_t &){
 
-	LOGS(save_node_logs,node_logger.file, "\n----------------------------------------------------------\n");
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s EndBackoff()\n",
+	LOGS(save_node_logs, node_logger, "\n----------------------------------------------------------\n");
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s EndBackoff()\n",
 			SimTime(), node_id, node_state, LOG_F00, LOG_LVL1);
 
 	/* ****************************************
@@ -3025,7 +3063,7 @@ void Node :: EndBackoff(trigger_t &){
 	 *  to the SR operation (in case of having detected a TXOP).
 	 *
 	 * *****************************************/
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s txop_sr_identified = %d\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s txop_sr_identified = %d\n",
 		SimTime(), node_id, node_state, LOG_F00, LOG_LVL1, txop_sr_identified);
 	if (spatial_reuse_enabled) {
 		flag_change_in_tx_power = TRUE;
@@ -3039,7 +3077,7 @@ void Node :: EndBackoff(trigger_t &){
 	} else {
 		// Use default values
 	}
-	if(save_node_logs) fprintf(node_logger.file, "%.15f;N%d;S%d;%s;%s Intended values for the next TX: "
+	if(save_node_logs) LogPrintf(node_logger, "%.15f;N%d;S%d;%s;%s Intended values for the next TX: "
 		"pd = %f dBm, Tx Power = %f dBm\n", SimTime(), node_id, node_state, LOG_F02, LOG_LVL3,
 		ConvertPower(PW_TO_DBM, current_obss_pd_threshold), ConvertPower(PW_TO_DBM, current_tx_power_sr));
 	}
@@ -3060,19 +3098,19 @@ void Node :: EndBackoff(trigger_t &){
 		current_destination_id = wlan.list_sta_id[n];
 		// Receive the possible MCS to be used for each number of channels
 		if (change_modulation_flag[n]) {
-			LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Requesting MCS to N%d\n",
+			LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Requesting MCS to N%d\n",
 				SimTime(), node_id, node_state, LOG_F02, LOG_LVL2, current_destination_id);
 			RequestMCS();
 		}
 	}
 
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Allowed LEFT/RIGHT: %d - %d\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Allowed LEFT/RIGHT: %d - %d\n",
 		SimTime(), node_id, node_state, LOG_F02, LOG_LVL2, min_channel_allowed, max_channel_allowed);
 
 	// Pick one receiver from the pool of potential receivers
 	SelectDestination();
 
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Trying to start TX to STA N%d\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Trying to start TX to STA N%d\n",
 		SimTime(), node_id, node_state, LOG_F02, LOG_LVL2, current_destination_id);
 
 	// Identify free channels
@@ -3086,7 +3124,7 @@ void Node :: EndBackoff(trigger_t &){
 			max_channel_allowed, &channel_power, current_pd, timestampt_channel_becomes_free, SimTime(), PIFS);
 	}
 
-	LOGS(save_node_logs,node_logger.file,
+	LOGS(save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s Power sensed per channel: ",
 		SimTime(), node_id, node_state, LOG_E18, LOG_LVL3);
 
@@ -3094,21 +3132,21 @@ void Node :: EndBackoff(trigger_t &){
 		&channel_power, num_channels_komondor);
 
 	if(save_node_logs) {
-		LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s timestampt_channel_becomes_frees: ",
+		LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s timestampt_channel_becomes_frees: ",
 			SimTime(), node_id, node_state, LOG_F02, LOG_LVL3);
 		for(int i = 0; i < num_channels_komondor; ++i){
-			fprintf(node_logger.file, "%.9f  ", timestampt_channel_becomes_free[i]);
+			LogPrintf(node_logger, "%.9f  ", timestampt_channel_becomes_free[i]);
 		}
-		fprintf(node_logger.file, "\n");
-		LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s difference times: ",
+		LogPrintf(node_logger, "\n");
+		LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s difference times: ",
 			SimTime(), node_id, node_state, LOG_F02, LOG_LVL3);
 		for(int i = 0; i < num_channels_komondor; ++i){
-			fprintf(node_logger.file, "%.9f  ", SimTime() - timestampt_channel_becomes_free[i]);
+			LogPrintf(node_logger, "%.9f  ", SimTime() - timestampt_channel_becomes_free[i]);
 		}
-		fprintf(node_logger.file, "\n");
+		LogPrintf(node_logger, "\n");
 	}
 
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Channels founds free (mind PIFS if activated): ",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Channels founds free (mind PIFS if activated): ",
 		SimTime(), node_id, node_state, LOG_F02, LOG_LVL3);
 
 	PrintOrWriteChannelsFree(WRITE_LOG, save_node_logs, print_node_logs, node_logger,
@@ -3121,7 +3159,7 @@ void Node :: EndBackoff(trigger_t &){
 		min_channel_allowed, max_channel_allowed, current_primary_channel,
 		mcs_per_node, ix_mcs_per_node, num_channels_komondor);
 
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Channels for transmitting: ",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Channels for transmitting: ",
 		SimTime(), node_id, node_state, LOG_F02, LOG_LVL2);
 
 	PrintOrWriteChannelForTx(WRITE_LOG, save_node_logs, print_node_logs, node_logger,
@@ -3139,7 +3177,7 @@ void Node :: EndBackoff(trigger_t &){
 			channels_for_tx, num_channels_komondor);
 		current_right_channel = GetFirstOrLastTrueElemOfArray(LAST_TRUE_IN_ARRAY,
 			channels_for_tx, num_channels_komondor);
-		LOGS(save_node_logs,node_logger.file,
+		LOGS(save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s Transmission is possible in range: %d - %d\n",
 			SimTime(), node_id, node_state, LOG_F04, LOG_LVL3, current_left_channel, current_right_channel);
 
@@ -3159,28 +3197,24 @@ void Node :: EndBackoff(trigger_t &){
 			current_num_packets_aggregated = buffer.QueueSize();
 		}
 
-		// data rate depending on CB and streams: Nsc * ym * yc * SUSS
-		bits_ofdm_sym =  getNumberSubcarriers(num_channels_tx) *
-			Mcs_array::modulation_bits[current_modulation-1] *
-			Mcs_array::coding_rates[current_modulation-1] *
-			IEEE_AX_SU_SPATIAL_STREAMS;
+		// data rate depending on CB and streams: Nsc * ym * yc * SUSS (precomputed at InitializeVariables())
+		bits_ofdm_sym = frame_duration_table.bits_ofdm_sym[ix_num_channels_used][current_modulation-1];
 
 		// Update the number of packets aggregate (just in case that the max PPDU is exceeded with the current MCS)
-		limited_num_packets_aggregated = findMaximumPacketsAggregated(
-			current_num_packets_aggregated, frame_length, bits_ofdm_sym);
+		limited_num_packets_aggregated = frame_duration_table.GetMaximumPacketsAggregated(
+			ix_num_channels_used, current_modulation, current_num_packets_aggregated);
 
 		//printf("data transmitted: %d\n", limited_num_packets_aggregated*frame_length);
 
-		LOGS(save_node_logs,node_logger.file,
+		LOGS(save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s Num. of packets to aggregate: %d/%d\n",
 			SimTime(), node_id, node_state, LOG_F04, LOG_LVL4,
 			limited_num_packets_aggregated, max_num_packets_aggregated);
 		// ********************************************************
 
 		// Compute all packets durations (RTS, CTS, DATA and ACK) and NAV time
-		ComputeFramesDuration(&rts_duration, &cts_duration, &data_duration, &ack_duration,
-			ieee_protocol, num_channels_tx, current_modulation, limited_num_packets_aggregated,
-			frame_length, bits_ofdm_sym);
+		frame_duration_table.GetFramesDuration(&rts_duration, &cts_duration, &data_duration, &ack_duration,
+			ix_num_channels_used, current_modulation, limited_num_packets_aggregated);
 
 //		if(node_id == 0) {
 //			printf("----------------\n");
@@ -3192,19 +3226,19 @@ void Node :: EndBackoff(trigger_t &){
 //			printf("ack_duration = %f\n", ack_duration * pow(10,6));
 //		}
 
-		LOGS(save_node_logs,node_logger.file,
+		LOGS(save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s Transmitting (N_agg = %d) in %d channels using modulation %d (%.0f bits per OFDM symbol ---> %.2f Mbps) \n",
 			SimTime(), node_id, node_state, LOG_F04, LOG_LVL4, limited_num_packets_aggregated,
 			(int) pow(2, ix_num_channels_used), current_modulation, bits_ofdm_sym,
 			bits_ofdm_sym/IEEE_AX_OFDM_SYMBOL_GI32_DURATION * pow(10,-6));
 
 		if(spatial_reuse_enabled && txop_sr_identified) {
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s Using tx power = %f dBm \n",
 				SimTime(), node_id, node_state, LOG_F04, LOG_LVL4,
 				ConvertPower(PW_TO_DBM, current_tx_power_sr));
 		} else {
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s Using tx power = %f dBm \n",
 				SimTime(), node_id, node_state, LOG_F04, LOG_LVL4,
 				ConvertPower(PW_TO_DBM, current_tx_power));
@@ -3216,7 +3250,7 @@ void Node :: EndBackoff(trigger_t &){
 		current_nav_time = ComputeNavTime(node_state, rts_duration, cts_duration, data_duration, ack_duration, SIFS);
 		current_nav_time = fix_time_offset(current_nav_time,13,12); // Update the NAV time according to the time offsets
 
-		LOGS(save_node_logs,node_logger.file,
+		LOGS(save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s RTS duration: %.12f s - NAV duration = %.12f s\n",
 			SimTime(), node_id, node_state, LOG_F04, LOG_LVL5,
 			rts_duration, current_nav_time);
@@ -3238,7 +3272,7 @@ void Node :: EndBackoff(trigger_t &){
 			// time_rand_value = round_to_digits(time_rand_value, 15);
 			time_rand_value = fix_time_offset(time_rand_value,13,12);
 			current_nav_time = current_nav_time - time_rand_value;
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s time_rand_value = %.12f s - corrected NAV time = %.12f s\n",
 				SimTime(), node_id, node_state, LOG_F04, LOG_LVL5,
 				time_rand_value, current_nav_time);
@@ -3251,7 +3285,7 @@ void Node :: EndBackoff(trigger_t &){
 			first_packet_buffer.packet_id, limited_num_packets_aggregated,
 			first_packet_buffer.timestamp_generated, current_tx_duration);
 
-		LOGS(save_node_logs,node_logger.file,
+		LOGS(save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s Transmission of RTS #%d started\n",
 			SimTime(), node_id, node_state, LOG_F04, LOG_LVL3, rts_notification.packet_id);
 
@@ -3273,7 +3307,7 @@ void Node :: EndBackoff(trigger_t &){
 
 		time_to_trigger = SimTime() + current_tx_duration;
 
-		LOGS(save_node_logs,node_logger.file,
+		LOGS(save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s time_to_trigger = %.12f s - fix_time_offset = %.12f s\n",
 			SimTime(), node_id, node_state, LOG_F04, LOG_LVL5,
 			time_to_trigger, fix_time_offset(time_to_trigger,13,12));
@@ -3288,7 +3322,7 @@ void Node :: EndBackoff(trigger_t &){
 		AbortRtsTransmission();
 
 	}
-	// LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s EndBackoff() END\n", SimTime(), node_id, node_state, LOG_F01, LOG_LVL1);
+	// LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s EndBackoff() END\n", SimTime(), node_id, node_state, LOG_F01, LOG_LVL1);
 };
 
 /*
@@ -3298,7 +3332,7 @@ void Node :: EndBackoff(trigger_t &){
  */
 void Node :: MyTxFinished(trigger_t &){
 
-//	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s MyTxFinished()\n",
+//	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s MyTxFinished()\n",
 //			SimTime(), node_id, node_state, LOG_G00, LOG_LVL1);
 
 	switch(node_state){
@@ -3322,7 +3356,7 @@ void Node :: MyTxFinished(trigger_t &){
 
 			node_state = STATE_WAIT_CTS;
 
-			LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s RTS #%d tx finished. Waiting for CTS until %.12f\n",
+			LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s RTS #%d tx finished. Waiting for CTS until %.12f\n",
 				SimTime(), node_id, node_state, LOG_G00, LOG_LVL2,
 				notification.packet_id, trigger_CTS_timeout.GetTime());
 
@@ -3342,7 +3376,7 @@ void Node :: MyTxFinished(trigger_t &){
 			trigger_DATA_timeout.Set(fix_time_offset(time_to_trigger,13,12));
 			node_state = STATE_WAIT_DATA;
 
-			LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s CTS %d tx finished. Waiting for DATA...\n",
+			LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s CTS %d tx finished. Waiting for DATA...\n",
 				SimTime(), node_id, node_state, LOG_G00, LOG_LVL2, notification.packet_id);
 
 			break;
@@ -3361,7 +3395,7 @@ void Node :: MyTxFinished(trigger_t &){
 			trigger_ACK_timeout.Set(fix_time_offset(time_to_trigger,13,12));
 			node_state = STATE_WAIT_ACK;
 
-			LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s DATA %d tx finished. Waiting for ACK...\n",
+			LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s DATA %d tx finished. Waiting for ACK...\n",
 				SimTime(), node_id, node_state, LOG_G00, LOG_LVL2, notification.packet_id);
 
 			break;
@@ -3375,7 +3409,7 @@ void Node :: MyTxFinished(trigger_t &){
 
 			outportSelfFinishTX(notification);
 
-			LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s ACK %d tx finished. Restarting node...\n",
+			LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s ACK %d tx finished. Restarting node...\n",
 				SimTime(), node_id, node_state, LOG_G00, LOG_LVL2, notification.packet_id);
 
 			RestartNode(FALSE);
@@ -3389,7 +3423,7 @@ void Node :: MyTxFinished(trigger_t &){
 			break;
 	}
 
-	// LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;  MyTxFinished()\n", SimTime(), node_id, node_state, LOG_G01, LOG_LVL1);
+	// LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;  MyTxFinished()\n", SimTime(), node_id, node_state, LOG_G01, LOG_LVL1);
 };
 
 /*
@@ -3397,7 +3431,7 @@ void Node :: MyTxFinished(trigger_t &){
  */
 void Node :: RequestMCS(){
 
-//	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s RequestMCS() to N%d\n",
+//	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s RequestMCS() to N%d\n",
 //				SimTime(), node_id, node_state, LOG_G00, LOG_LVL1, current_destination_id);
 
 	// Only one channel required (logically!)
@@ -3430,7 +3464,7 @@ void Node :: RequestMCS(){
 	if(first_time_requesting_mcs) {
 		first_time_requesting_mcs = FALSE;
 	}
-	// LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s RequestMCS() END\n", SimTime(), node_id, node_state, LOG_G00, LOG_LVL1);
+	// LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s RequestMCS() END\n", SimTime(), node_id, node_state, LOG_G00, LOG_LVL1);
 }
 
 /*
@@ -3438,7 +3472,7 @@ void Node :: RequestMCS(){
  */
 void Node :: SelectDestination(){
 
-//	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s SelectDestination()\n",
+//	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s SelectDestination()\n",
 //			SimTime(), node_id, node_state, LOG_G00, LOG_LVL1);
 
 	if(node_type == NODE_TYPE_OTHER) {
@@ -3446,7 +3480,7 @@ void Node :: SelectDestination(){
 	}
 
 	current_destination_id = PickRandomElementFromArray(wlan.list_sta_id, wlan.num_stas);
-	// LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s SelectDestination() END\n", SimTime(), node_id, node_state, LOG_G00, LOG_LVL1);
+	// LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s SelectDestination() END\n", SimTime(), node_id, node_state, LOG_G00, LOG_LVL1);
 }
 
 /*********************/
@@ -3508,6 +3542,7 @@ Notification Node :: GenerateNotification(int packet_type, int destination_id, i
 
 		case PACKET_TYPE_DATA:{
 			notification.frame_length = frame_length;
+			notification.modulation_id = current_modulation;
 			notification.tx_info.nav_time = current_nav_time;
 			break;
 		}
@@ -3559,7 +3594,7 @@ void Node :: SendLogicalNack(LogicalNack logical_nack){
 
 	outportSendLogicalNack(logical_nack);
 
-	LOGS(save_node_logs,node_logger.file,
+	LOGS(save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s NACK of packet type %d sent to a:N%d (and b:N%d) with reason %d\n",
 		SimTime(), node_id, node_state, LOG_I00, LOG_LVL4, logical_nack.packet_type,
 		logical_nack.node_id_a, logical_nack.node_id_b, logical_nack.loss_reason);
@@ -3575,7 +3610,7 @@ void Node :: SendResponsePacket(trigger_t &){
 
 		case STATE_TX_ACK:{
 
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s SIFS completed after receiving DATA, sending ACK...\n",
 				SimTime(), node_id, node_state, LOG_I00, LOG_LVL3);
 
@@ -3586,7 +3621,7 @@ void Node :: SendResponsePacket(trigger_t &){
 			time_to_trigger = SimTime() + current_tx_duration;
 			trigger_toFinishTX.Set(fix_time_offset(time_to_trigger,13,12));
 
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s truncate_Sergio = %.12f - current_tx_duration = %.12f - trigger_toFinishTX = %.12f\n",
 				SimTime(), node_id, node_state, LOG_I00, LOG_LVL3,
 				truncate_Sergio(SimTime() + FEMTO_VALUE,12), current_tx_duration, trigger_toFinishTX.GetTime());
@@ -3595,7 +3630,7 @@ void Node :: SendResponsePacket(trigger_t &){
 		}
 
 		case STATE_TX_CTS:{
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s SIFS completed after receiving RTS, sending CTS (duration = %f)\n",
 				SimTime(), node_id, node_state, LOG_I00, LOG_LVL3, current_tx_duration);
 			outportSelfStartTX(cts_notification);
@@ -3606,7 +3641,7 @@ void Node :: SendResponsePacket(trigger_t &){
 		}
 
 		case STATE_TX_DATA:{
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s SIFS completed after receiving CTS, sending DATA...\n",
 				SimTime(), node_id, node_state, LOG_I00, LOG_LVL3);
 			outportSelfStartTX(data_notification);
@@ -3616,7 +3651,7 @@ void Node :: SendResponsePacket(trigger_t &){
 			++data_packets_sent_per_sta[current_destination_id-node_id-1];
 			// Update performance measurements
 			++performance_report.data_packets_sent;
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s Data TX will be finished at %.15f\n",
 				SimTime(), node_id, node_state, LOG_I00, LOG_LVL3,
 				trigger_toFinishTX.GetTime());
@@ -3632,12 +3667,12 @@ void Node :: AbortRtsTransmission(){
 
 	num_tx_init_not_possible ++;
 	// Compute a new backoff and trigger a new DIFS
-	remaining_backoff = ComputeBackoff(pdf_backoff, cw_current, backoff_type);
+	remaining_backoff = compute_backoff(cw_current);
 	expected_backoff += remaining_backoff;
 	num_new_backoff_computations++;
 	node_state = STATE_SENSING;
 
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Transmission is NOT possible\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Transmission is NOT possible\n",
 		SimTime(), node_id, node_state, LOG_F03, LOG_LVL3);
 
 }
@@ -3667,22 +3702,24 @@ void Node :: AckTimeout(trigger_t &){
 	// Update performance measurements
 	performance_report.data_packets_lost++;
 
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s  ACK TIMEOUT! Data packet %d lost\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s  ACK TIMEOUT! Data packet %d lost\n",
 		SimTime(), node_id, node_state, LOG_D17, LOG_LVL4,
 		packet_id);
 
-	LOGS(save_node_logs,node_logger.file,
+	TriggerFlightRecorder(FLIGHT_RECORDER_TRIGGER_ACK_TIMEOUT, "ACK timeout", current_destination_id);
+
+	LOGS(save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s Handling contention window\n",
 		SimTime(), node_id, node_state, LOG_D08, LOG_LVL4);
-	LOGS(save_node_logs,node_logger.file,
+	LOGS(save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s From CW = %d, b = %d, m = %d\n",
 		SimTime(), node_id, node_state, LOG_D08, LOG_LVL5,
 		cw_current, cw_stage_current, cw_stage_max);
 	// Sergio on 20/09/2017. CW only must be changed when ACK received or loss detected.
-	HandleContentionWindow(
-		cw_adaptation, INCREASE_CW, &cw_current, cw_min, &cw_stage_current, cw_stage_max);
+	handle_contention_window(
+		INCREASE_CW, &cw_current, cw_min, &cw_stage_current, cw_stage_max);
 
-	LOGS(save_node_logs,node_logger.file,
+	LOGS(save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s To CW = %d, b = %d, m = %d\n",
 		SimTime(), node_id, node_state, LOG_D08, LOG_LVL5,
 		cw_current, cw_stage_current, cw_stage_max);
@@ -3699,23 +3736,25 @@ void Node :: CtsTimeout(trigger_t &){
 		data_packets_lost, rts_cts_lost, &data_packets_lost_per_sta, &rts_cts_lost_per_sta, current_right_channel,
 		current_left_channel,current_tx_duration, node_id, current_destination_id);
 
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s ---------------------------------------------\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s ---------------------------------------------\n",
 		SimTime(), node_id, node_state, LOG_D17, LOG_LVL1);
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s CTS TIMEOUT! RTS-CTS packet lost\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s CTS TIMEOUT! RTS-CTS packet lost\n",
 		SimTime(), node_id, node_state, LOG_D17, LOG_LVL2);
 
-	LOGS(save_node_logs,node_logger.file,
+	TriggerFlightRecorder(FLIGHT_RECORDER_TRIGGER_CTS_TIMEOUT, "CTS timeout", current_destination_id);
+
+	LOGS(save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s Handling contention window\n",
 		SimTime(), node_id, node_state, LOG_D08, LOG_LVL4);
-	LOGS(save_node_logs,node_logger.file,
+	LOGS(save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s From CW = %d, b = %d, m = %d\n",
 		SimTime(), node_id, node_state, LOG_D08, LOG_LVL5,
 		cw_current, cw_stage_current, cw_stage_max);
 	// Sergio on 20/09/2017. CW only must be changed when ACK received or loss detected.
-	HandleContentionWindow(
-		cw_adaptation, INCREASE_CW, &cw_current, cw_min, &cw_stage_current, cw_stage_max);
+	handle_contention_window(
+		INCREASE_CW, &cw_current, cw_min, &cw_stage_current, cw_stage_max);
 
-	LOGS(save_node_logs,node_logger.file,
+	LOGS(save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s To CW = %d, b = %d, m = %d\n",
 		SimTime(), node_id, node_state, LOG_D08, LOG_LVL5,
 		cw_current, cw_stage_current, cw_stage_max);
@@ -3739,7 +3778,7 @@ void Node :: DataTimeout(trigger_t &){
 		data_packets_lost, rts_cts_lost, &data_packets_lost_per_sta, &rts_cts_lost_per_sta, current_right_channel,
 		current_left_channel,current_tx_duration, node_id, current_destination_id);
 
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s DATA TIMEOUT! RTS-CTS packet lost\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s DATA TIMEOUT! RTS-CTS packet lost\n",
 		SimTime(), node_id, node_state, LOG_D17, LOG_LVL4);
 
 	// Sergio on 20/09/2017. CW only must be changed when ACK received or loss detected.
@@ -3752,16 +3791,16 @@ void Node :: DataTimeout(trigger_t &){
  */
 void Node :: NavTimeout(trigger_t &){
 
-	LOGS(save_node_logs,node_logger.file, "\n **********************************************************************\n");
+	LOGS(save_node_logs, node_logger, "\n **********************************************************************\n");
 
-	LOGS(save_node_logs,node_logger.file,
+	LOGS(save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s NAV TIMEOUT!\n",
 		SimTime(), node_id, node_state, LOG_D17, LOG_LVL1);
 
-	time_in_nav = time_in_nav + (SimTime() - last_time_not_in_nav);
-
 	if(node_is_transmitter){
 
+		// The timer is also used to wait after a slotted BO collision while receiving, which is not time in NAV
+		if(node_state == STATE_NAV) time_in_nav = time_in_nav + (SimTime() - last_time_not_in_nav);
 		node_state = STATE_SENSING;
 
 		int resume (HandleBackoff(RESUME_TIMER, &channel_power, current_primary_channel,
@@ -3774,20 +3813,20 @@ void Node :: NavTimeout(trigger_t &){
 
 			trigger_start_backoff.Set(fix_time_offset(time_to_trigger,13,12));
 
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s Starting new DIFS to finsih in %.12f\n",
 				SimTime(), node_id, node_state, LOG_D17, LOG_LVL3,
 				trigger_start_backoff.GetTime());
 
 		} else {
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s New DIFS cannot be started\n",
 				SimTime(), node_id, node_state, LOG_D17, LOG_LVL3);
 		}
 
 	} else {
 
-		RestartNode(TRUE);
+		RestartNode(TRUE);	// Accounts the time in NAV
 
 	}
 
@@ -3805,7 +3844,7 @@ void Node :: NavTimeout(trigger_t &){
 void Node :: PauseBackoff(){
 
 	if(trigger_start_backoff.Active()){
-		LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Cancelling DIFS. BO still frozen at %.9f (%.2f slots)\n",
+		LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Cancelling DIFS. BO still frozen at %.9f (%.2f slots)\n",
 			SimTime(), node_id, node_state, LOG_F00, LOG_LVL3,
 			remaining_backoff * pow(10,6), remaining_backoff / SLOT_TIME);
 
@@ -3814,24 +3853,24 @@ void Node :: PauseBackoff(){
 
 		if(trigger_end_backoff.Active()){	// If backoff trigger is active, freeze it
 
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s BO is active. Freezing it from %.9f (%.2f slots)...\n",
 				SimTime(), node_id, node_state, LOG_F00, LOG_LVL3,
 				(trigger_end_backoff.GetTime() - SimTime()) * pow(10,6), (trigger_end_backoff.GetTime() - SimTime())/SLOT_TIME);
 
-			remaining_backoff = ComputeRemainingBackoff(backoff_type, trigger_end_backoff.GetTime() - SimTime());
+			remaining_backoff = compute_remaining_backoff(trigger_end_backoff.GetTime() - SimTime());
 
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s ... to %.9f (%.2f slots)\n",
 				SimTime(), node_id, node_state, LOG_F00, LOG_LVL3,
 				remaining_backoff * pow(10,6), remaining_backoff/SLOT_TIME);
 
-//			LOGS(save_node_logs,node_logger.file,
+//			LOGS(save_node_logs, node_logger,
 //								"%.15f;N%d;S%d;%s;%s Original remaining BO: %.9f us\n",
 //								SimTime(), node_id, node_state, LOG_F00, LOG_LVL3,
 //								(trigger_end_backoff.GetTime() - SimTime())*pow(10,6));
 
-//			LOGS(save_node_logs,node_logger.file,
+//			LOGS(save_node_logs, node_logger,
 //					"%.15f;N%d;S%d;%s;%s Backoff is active --> freeze it at %.9f us (%.2f slots)\n",
 //					SimTime(), node_id, node_state, LOG_F00, LOG_LVL3,
 //					remaining_backoff * pow(10,6), remaining_backoff/SLOT_TIME);
@@ -3840,7 +3879,7 @@ void Node :: PauseBackoff(){
 
 		} else {	// If backoff trigger is frozen
 
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s Backoff is NOT active - it is already frozen at %.9f us (%.2f slots)\n",
 				SimTime(), node_id, node_state, LOG_F00, LOG_LVL3,
 				remaining_backoff * pow(10,6), remaining_backoff / SLOT_TIME);
@@ -3857,18 +3896,18 @@ void Node :: PauseBackoff(){
  * */
 void Node :: ResumeBackoff(trigger_t &){
 
-//	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s DIFS finished\n",
+//	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s DIFS finished\n",
 //					SimTime(), node_id, node_state, LOG_F00, LOG_LVL2);
 
 	time_to_trigger = SimTime() + remaining_backoff;
 
 	trigger_end_backoff.Set(fix_time_offset(time_to_trigger,13,12));
 
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Resuming backoff in %.9f us (%.2f slots)\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Resuming backoff in %.9f us (%.2f slots)\n",
 		SimTime(), node_id, node_state, LOG_F00, LOG_LVL3,
 		(remaining_backoff * pow(10,6)), (remaining_backoff / (double) SLOT_TIME));
 
-//	LOGS(save_node_logs,node_logger.file,
+//	LOGS(save_node_logs, node_logger,
 //				"%.15f;N%d;S%d;%s;%s DIFS: active = %d, t_DIFS = %f - backoff: active = %d - t_back = %f\n",
 //				SimTime(), node_id, node_state, LOG_D02, LOG_LVL3,
 //				trigger_start_backoff.Active(), trigger_start_backoff.GetTime() - SimTime(),
@@ -3888,7 +3927,7 @@ void Node :: ResumeBackoff(trigger_t &){
  * -
  */
 void Node :: SpatialReuseOpportunityEnds(trigger_t &){
-	LOGS(save_node_logs,node_logger.file,
+	LOGS(save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s SpatialReuseOpportunityEnds()\n",
 		SimTime(), node_id, node_state, LOG_F00, LOG_LVL2);
 	// Set the SR parameters to the default values (disable mechanism to activate SR opportunities)
@@ -3901,11 +3940,11 @@ void Node :: SpatialReuseOpportunityEnds(trigger_t &){
 		change_modulation_flag[n] = true;
 	}
 
-	LOGS(save_node_logs,node_logger.file,
+	LOGS(save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s current_obss_pd_threshold = %f\n",
 		SimTime(), node_id, node_state, LOG_F00, LOG_LVL3,
 		ConvertPower(PW_TO_DBM,current_obss_pd_threshold));
-	LOGS(save_node_logs,node_logger.file,
+	LOGS(save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s current_tx_power_sr = %f\n",
 		SimTime(), node_id, node_state, LOG_F00, LOG_LVL3,
 		ConvertPower(PW_TO_DBM,current_tx_power_sr));
@@ -4027,8 +4066,8 @@ void Node :: InportReceivingRequestFromAgent() {
 
 //	printf("%s Node #%d: New information request received from the Agent\n", LOG_LVL1, node_id);
 
-	LOGS(save_node_logs, node_logger.file, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
-	LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s New information request received from the Agent\n",
+	LOGS(save_node_logs, node_logger, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s New information request received from the Agent\n",
 		SimTime(), node_id, node_state, LOG_F02, LOG_LVL2);
 
 	// Generate the configuration to be sent to the agent
@@ -4038,7 +4077,7 @@ void Node :: InportReceivingRequestFromAgent() {
 	UpdatePerformanceMeasurements();
 
 	// Answer to the agent
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Sending information to the Agent\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Sending information to the Agent\n",
 		SimTime(), node_id, node_state, LOG_F02, LOG_LVL2);
 
 	outportAnswerToAgent(configuration, performance_report);
@@ -4046,7 +4085,117 @@ void Node :: InportReceivingRequestFromAgent() {
 	// Restart performance metrics for future requests
 	RestartPerformanceMetrics(&performance_report, SimTime());
 
-	LOGS(save_node_logs,node_logger.file, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
+	LOGS(save_node_logs, node_logger, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
+
+}
+
+/*
+ * InportMetricsRequested(): called when the metrics sampler takes a sample
+ * Input arguments:
+ * - snapshot: counters of all the nodes, where the entry of this node is filled
+ */
+void Node :: InportMetricsRequested(MetricsSnapshot &snapshot) {
+
+	NodeMetrics &metrics = snapshot.nodes[node_id];
+	metrics.node_id = node_id;
+	metrics.node_type = node_type;
+	metrics.wlan_code = wlan_code;
+	metrics.bits_acked = (double) data_frames_acked * frame_length;
+	metrics.buffer_size = buffer.QueueSize();
+	metrics.primary_power = ConvertPower(PW_TO_DBM, channel_power[current_primary_channel]);
+	metrics.cw_stage = cw_stage_current;
+	// time_in_nav is only accumulated when the NAV ends, so the elapsed part of an ongoing NAV is added
+	metrics.time_in_nav = time_in_nav;
+	if(node_state == STATE_NAV) metrics.time_in_nav += SimTime() - last_time_not_in_nav;
+
+}
+
+/*
+ * InportNodesMoved(): called when the mobility manager updates the node positions. Only the distances
+ * and powers related to the moved nodes are recomputed (the whole row if this node moved).
+ * Input arguments:
+ * - update: moved nodes and current position of every node
+ */
+void Node :: InportNodesMoved(MobilityUpdate &update) {
+
+	int self_moved (FALSE);
+	for (size_t m = 0; m < update.moved_nodes.size(); ++m) {
+		if (update.moved_nodes[m] == node_id) self_moved = TRUE;
+	}
+
+	if (self_moved) {
+		x = update.x[node_id];
+		y = update.y[node_id];
+		z = update.z[node_id];
+		for (int n = 0; n < update.total_nodes_number; ++n) UpdatePathGainTo(n, update);
+	} else {
+		for (size_t m = 0; m < update.moved_nodes.size(); ++m) UpdatePathGainTo(update.moved_nodes[m], update);
+	}
+
+	// Request a new MCS to the STAs of the WLAN whose link changed
+	for (int s = 0; s < wlan.num_stas; ++s) {
+		if (self_moved || std::find(update.moved_nodes.begin(), update.moved_nodes.end(),
+			wlan.list_sta_id[s]) != update.moved_nodes.end()) {
+			change_modulation_flag[s] = TRUE;
+		}
+	}
+
+	if (node_type == NODE_TYPE_AP) {
+		if (self_moved) {
+			for (int w = 0; w < total_wlans_number; ++w) UpdateMaxPowerReceivedFromWlan(w, update);
+		} else {
+			for (size_t m = 0; m < update.moved_nodes.size(); ++m) {
+				UpdateMaxPowerReceivedFromWlan(update.wlan_ix[update.moved_nodes[m]], update);
+			}
+		}
+	}
+
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s %d nodes moved (self moved: %d)\n",
+		SimTime(), node_id, node_state, LOG_F02, LOG_LVL2, (int) update.moved_nodes.size(), self_moved);
+
+}
+
+/*
+ * UpdatePathGainTo(): recomputes the distance to a node and the power received from it. The power of a
+ * node that is transmitting is deferred until its TX finishes, so that the power removed from the
+ * channel is the same that was added when it started.
+ * Input arguments:
+ * - node_ix: other node
+ * - update: current position, transmission power and gain of every node
+ */
+void Node :: UpdatePathGainTo(int node_ix, const MobilityUpdate &update) {
+
+	if (node_ix == node_id) return;
+
+	distances_array[node_ix] = ComputeDistance(x, y, z, update.x[node_ix], update.y[node_ix], update.z[node_ix]);
+	double power_received (ComputePowerReceived(distances_array[node_ix], update.tx_power[node_ix],
+		update.tx_gain[node_ix], rx_gain, central_frequency, path_loss_model));
+
+	if (nodes_transmitting[node_ix]) {
+		deferred_received_power[node_ix] = power_received;
+	} else {
+		received_power_array[node_ix] = power_received;
+	}
+
+}
+
+/*
+ * UpdateMaxPowerReceivedFromWlan(): recomputes the maximum power received from the nodes of a WLAN (APs only)
+ * Input arguments:
+ * - wlan_ix: index of the WLAN
+ * - update: WLANs of the system
+ */
+void Node :: UpdateMaxPowerReceivedFromWlan(int wlan_ix, const MobilityUpdate &update) {
+
+	const Wlan &other_wlan = update.wlan_container[wlan_ix];
+	if (other_wlan.wlan_code == wlan_code) return;
+
+	double max_power_received (received_power_array[other_wlan.ap_id]);
+	for (int s = 0; s < other_wlan.num_stas; ++s) {
+		double power_received (received_power_array[other_wlan.list_sta_id[s]]);
+		if (power_received > max_power_received) max_power_received = power_received;
+	}
+	max_received_power_in_ap_per_wlan[wlan_ix] = max_power_received;
 
 }
 
@@ -4058,7 +4207,7 @@ void Node :: InportReceivingRequestFromAgent() {
 void Node :: InportReceiveConfigurationFromAgent(Configuration &received_configuration) {
 
 //	printf("%s Node #%d: New configuration received from the Agent\n", LOG_LVL1, node_id);
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s New configuration received from the Agent\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s New configuration received from the Agent\n",
 		SimTime(), node_id, node_state, LOG_F02, LOG_LVL2);
 
 	if(!flag_apply_new_configuration) {
@@ -4092,7 +4241,7 @@ void Node :: InportReceiveConfigurationFromAgent(Configuration &received_configu
 void Node :: ApplyNewConfiguration(Configuration &new_configuration) {
 
 	// TODO: think about recommendation levels done by agents (e.g., Critical, Recommended ...)
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Applying the new received configuration\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Applying the new received configuration\n",
 		SimTime(), node_id, node_state, LOG_F02, LOG_LVL2);
 
 	// Set new configuration according to received instructions
@@ -4126,7 +4275,7 @@ void Node :: ApplyNewConfiguration(Configuration &new_configuration) {
 void Node :: BroadcastNewConfigurationToStas(Configuration &new_configuration) {
 
 	// ONLY APs connected to agents
-	LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Broadcasting the new configuration to STAs\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Broadcasting the new configuration to STAs\n",
 		SimTime(), node_id, node_state, LOG_F02, LOG_LVL2);
 
 	// Send the new configuration to the associated STAs
@@ -4143,9 +4292,9 @@ void Node :: InportNewWlanConfigurationReceived(Configuration &received_configur
 
 	if (node_type == NODE_TYPE_STA) {
 
-		LOGS(save_node_logs, node_logger.file, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
+		LOGS(save_node_logs, node_logger, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
 
-		LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s New configuration received from the AP\n",
+		LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s New configuration received from the AP\n",
 			SimTime(), node_id, node_state, LOG_F02, LOG_LVL2);
 
 		// Set new configuration
@@ -4156,7 +4305,7 @@ void Node :: InportNewWlanConfigurationReceived(Configuration &received_configur
 		// Set flag to true in order to apply the new configuration next time the node restarts
 		flag_apply_new_configuration = TRUE;
 
-		LOGS(save_node_logs,node_logger.file, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
+		LOGS(save_node_logs, node_logger, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
 
 //		if(node_state == STATE_SENSING) RestartNode(FALSE);
 		// Force restart
@@ -4195,8 +4344,8 @@ void Node :: CallRestartSta(trigger_t &){
  */
 void Node :: RestartNode(int called_by_time_out){
 
-	LOGS(save_node_logs, node_logger.file, "\n **********************************************************************\n");
-	LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s Node Restarted (%d)\n",
+	LOGS(save_node_logs, node_logger, "\n **********************************************************************\n");
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Node Restarted (%d)\n",
 		SimTime(), node_id, node_state, LOG_Z00, LOG_LVL1,
 		called_by_time_out);
 
@@ -4214,6 +4363,7 @@ void Node :: RestartNode(int called_by_time_out){
 	//PrintNodeInfo(INFO_DETAIL_LEVEL_2);
 
 	// Reinitialize parameters
+	if(node_state == STATE_NAV) time_in_nav = time_in_nav + (SimTime() - last_time_not_in_nav);
 	node_state = STATE_SENSING;
 	current_tx_duration = 0;
 	power_rx_interest = 0;
@@ -4240,22 +4390,22 @@ void Node :: RestartNode(int called_by_time_out){
 		++packet_id;
 
 		// In case of being an AP
-		remaining_backoff = ComputeBackoff(pdf_backoff, cw_current, backoff_type);
+		remaining_backoff = compute_backoff(cw_current);
 		expected_backoff = expected_backoff + remaining_backoff;
 		++num_new_backoff_computations;
 
-		LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s New backoff computed: %f (%.0f slots).\n",
+		LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s New backoff computed: %f (%.0f slots).\n",
 			SimTime(), node_id, node_state, LOG_Z00, LOG_LVL3,
 			remaining_backoff, remaining_backoff/SLOT_TIME);
 
 		// Add extra slot since node has txed
 		remaining_backoff = remaining_backoff + SLOT_TIME;
 
-		LOGS(save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Extra slot added --> remaining BO %f slots\n",
+		LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Extra slot added --> remaining BO %f slots\n",
 			SimTime(), node_id, node_state, LOG_Z00, LOG_LVL4,
 			remaining_backoff / SLOT_TIME);
 
-		LOGS(save_node_logs,node_logger.file,
+		LOGS(save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s Checking if BO can be resumed. Pow(primary #%d) =  %.2f dBm\n",
 			SimTime(), node_id, node_state, LOG_Z00, LOG_LVL4,
 			current_primary_channel, ConvertPower(PW_TO_DBM, channel_power[current_primary_channel]));
@@ -4272,14 +4422,14 @@ void Node :: RestartNode(int called_by_time_out){
 
 		// Check if node has to freeze the BO (if it is not already frozen)
 		if (resume) {
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s BO can be resumed! Starting DIFS...\n",
 				SimTime(), node_id, node_state, LOG_Z00, LOG_LVL5);
 			// time_to_trigger = SimTime() + DIFS - TIME_OUT_EXTRA_TIME;
 			time_to_trigger = SimTime() + DIFS;
 			trigger_start_backoff.Set(fix_time_offset(time_to_trigger,13,12));
 		} else {
-			LOGS(save_node_logs,node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s BO cannot be resumed!\n",
 				SimTime(), node_id, node_state, LOG_Z00, LOG_LVL5);
 		}
@@ -4317,6 +4467,7 @@ void Node:: HandleSlottedBackoffCollision() {
 	 */
 	// Slotted BO collision (case where STA is receiving)
 	loss_reason = PACKET_LOST_BO_COLLISION;
+	TriggerFlightRecorder(FLIGHT_RECORDER_TRIGGER_BO_COLLISION, "slotted BO collision", -1);
 	if(!node_is_transmitter) {
 		node_state = STATE_SLEEP; // avoid listening to notifications until restart
 		time_to_trigger = SimTime() + MAX_DIFFERENCE_SAME_TIME;
@@ -4333,7 +4484,7 @@ void Node:: HandleSlottedBackoffCollision() {
 void Node:: RecoverFromCtsTimeout(trigger_t &) {
 	// Sergio on 25 Oct 2017
 	// - Just restart the node to start the DIFS
-	LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s RecoverFromCtsTimeout\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s RecoverFromCtsTimeout\n",
 		SimTime(), node_id, node_state, LOG_Z00, LOG_LVL3);
 	// Cancel trigger for safety
 	trigger_recover_cts_timeout.Cancel();
@@ -4346,21 +4497,21 @@ void Node:: RecoverFromCtsTimeout(trigger_t &) {
 void Node:: MeasureRho(trigger_t &){
 	// if ( (buffer.QueueSize() > 0) && (channel_power[current_primary_channel] < current_pd)){
 	if (node_state == STATE_SENSING && channel_power[current_primary_channel] < current_pd){
-		LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s RHO: Sensing + free\n",
+		LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s RHO: Sensing + free\n",
 			SimTime(), node_id, node_state, LOG_Z00, LOG_LVL3);
 		++num_measures_rho;
 		// DIFS condition: !trigger_start_backoff.Active()
 		if (buffer.QueueSize() > 0){
-			LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s RHO: Packet in buffer\n",
+			LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s RHO: Packet in buffer\n",
 				SimTime(), node_id, node_state, LOG_Z00, LOG_LVL4);
 			num_measures_rho_accomplished ++;
 		} else {
-			LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s RHO: Not packet in buffer\n",
+			LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s RHO: Not packet in buffer\n",
 				SimTime(), node_id, node_state, LOG_Z00, LOG_LVL4);
 		}
 	} else {
 
-//		LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s No RHO!\n",
+//		LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s No RHO!\n",
 //						SimTime(), node_id, node_state, LOG_Z00, LOG_LVL3);
 	}
 	// Utilization
@@ -4375,9 +4526,10 @@ void Node:: MeasureRho(trigger_t &){
 void Node:: CallSensing(trigger_t &){
 
 
-	LOGS(save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s State changed to sensing due to NAV collision\n",
+	LOGS(save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s State changed to sensing due to NAV collision\n",
 		SimTime(), node_id, node_state, LOG_Z00, LOG_LVL3);
 
+	if(node_state == STATE_NAV) time_in_nav = time_in_nav + (SimTime() - last_time_not_in_nav);
 	node_state = STATE_SENSING;
 
 	int resume (HandleBackoff(RESUME_TIMER, &channel_power,
@@ -4385,7 +4537,7 @@ void Node:: CallSensing(trigger_t &){
 
 	// Check if node has to freeze the BO (if it is not already frozen)
 	if (resume) {
-		LOGS(save_node_logs, node_logger.file,
+		LOGS(save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s BO can be resumed! Starting DIFS...\n",
 			SimTime(), node_id, node_state, LOG_Z00, LOG_LVL5);
 		// time_to_trigger = SimTime() + DIFS - TIME_OUT_EXTRA_TIME;
@@ -4398,18 +4550,18 @@ void Node:: CallSensing(trigger_t &){
 		int loss_reason_sr = 1;	// lost by default
 		// Check if the packet can be decoded with the CST indicated by the SR operation
 		if (loss_reason == PACKET_NOT_LOST && spatial_reuse_enabled) {
-			loss_reason_sr = IsPacketLost(current_primary_channel, nav_notification, nav_notification,
-				current_sinr, capture_effect, potential_obss_pd_threshold, power_rx_interest, constant_per, node_id, capture_effect_model);
+			loss_reason_sr = is_packet_lost(current_primary_channel, nav_notification, nav_notification,
+				current_sinr, capture_effect, potential_obss_pd_threshold, power_rx_interest, constant_per, node_id);
 			if (loss_reason_sr != PACKET_NOT_LOST && node_is_transmitter) {
 				txop_sr_identified = TRUE;	// TXOP identified!
 				current_obss_pd_threshold = potential_obss_pd_threshold;	// Update the pd
-				if(save_node_logs) fprintf(node_logger.file,
+				if(save_node_logs) LogPrintf(node_logger, 
 					"%.15f;N%d;S%d;%s;%s TXOP detected for OBSS_PD = %f dBm (in CallSensing())\n",
 					SimTime(), node_id, node_state, LOG_D08, LOG_LVL3, ConvertPower(PW_TO_DBM, current_obss_pd_threshold));
 			}
 		/* **************************************** */
 		} else {
-			LOGS(save_node_logs, node_logger.file,
+			LOGS(save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s BO canot be resumed!\n",
 				SimTime(), node_id, node_state, LOG_Z00, LOG_LVL5);
 		}
@@ -4431,7 +4583,7 @@ void Node:: CallSensing(trigger_t &){
 void Node :: PrintNodeInfo(int info_detail_level){
 
 	printf("%s Node %s info:\n", LOG_LVL3, node_code.c_str());
-	printf("%s node_id = %d\n", LOG_LVL4, node_id);
+	printf("%s node_id = %d\n", LOG_LVL4, OriginalNodeId(node_id));
 	printf("%s node_type = %d\n", LOG_LVL4, node_type);
 	printf("%s position = (%.2f, %.2f, %.2f)\n", LOG_LVL4, x, y, z);
 	printf("%s current_primary_channel = %d\n", LOG_LVL4, current_primary_channel);
@@ -4451,7 +4603,7 @@ void Node :: PrintNodeInfo(int info_detail_level){
 		printf("%s wlan:\n", LOG_LVL4);
 		printf("%s wlan code = %s\n", LOG_LVL5, wlan.wlan_code.c_str());
 		printf("%s wlan id = %d\n", LOG_LVL5, wlan.wlan_id);
-		printf("%s wlan AP id = %d\n", LOG_LVL5, wlan.ap_id);
+		printf("%s wlan AP id = %d\n", LOG_LVL5, OriginalNodeId(wlan.ap_id));
 		printf("%s STAs in WLAN (%d): ", LOG_LVL5, wlan.num_stas);
 		wlan.PrintStaIds();
 	}
@@ -4459,7 +4611,7 @@ void Node :: PrintNodeInfo(int info_detail_level){
 	if(info_detail_level > INFO_DETAIL_LEVEL_1){
 		printf("%s cw_min = %d\n", LOG_LVL4, cw_min);
 		printf("%s cw_stage_max = %d\n", LOG_LVL4, cw_stage_max);
-		printf("%s destination_id = %d\n", LOG_LVL4, destination_id);
+		printf("%s destination_id = %d\n", LOG_LVL4, OriginalNodeId(destination_id));
 		printf("%s tx_power_min = %f pW (%f dBm)\n", LOG_LVL4, tx_power_min, ConvertPower(PW_TO_DBM, tx_power_min));
 		printf("%s tx_power_default = %f pW (%f dBm)\n", LOG_LVL4, tx_power_default, ConvertPower(PW_TO_DBM, tx_power_default));
 		printf("%s tx_power_max = %f pW (%f dBm)\n", LOG_LVL4, tx_power_max, ConvertPower(PW_TO_DBM, tx_power_max));
@@ -4479,20 +4631,20 @@ void Node :: PrintNodeInfo(int info_detail_level){
  */
 void Node :: WriteNodeInfo(Logger node_logger, int info_detail_level, std::string header_str){
 
-	fprintf(node_logger.file, "%s Node %s info:\n", header_str.c_str(), node_code.c_str());
-	fprintf(node_logger.file, "%s - node_id = %d\n", header_str.c_str(), node_id);
-	fprintf(node_logger.file, "%s - node_type = %d\n", header_str.c_str(), node_type);
-	fprintf(node_logger.file, "%s - position = (%.2f, %.2f, %.2f)\n", header_str.c_str(), x, y, z);
-	fprintf(node_logger.file, "%s - current_primary_channel = %d\n", header_str.c_str(), current_primary_channel);
-	fprintf(node_logger.file, "%s - min_channel_allowed = %d\n", header_str.c_str(), min_channel_allowed);
-	fprintf(node_logger.file, "%s - max_channel_allowed = %d\n", header_str.c_str(), max_channel_allowed);
-	fprintf(node_logger.file, "%s - current_dcb_policy = %d\n", header_str.c_str(), current_dcb_policy);
-	fprintf(node_logger.file, "%s - spatial_reuse_enabled = %d\n", header_str.c_str(), (bss_color>=0));
+	LogPrintf(node_logger, "%s Node %s info:\n", header_str.c_str(), node_code.c_str());
+	LogPrintf(node_logger, "%s - node_id = %d\n", header_str.c_str(), OriginalNodeId(node_id));
+	LogPrintf(node_logger, "%s - node_type = %d\n", header_str.c_str(), node_type);
+	LogPrintf(node_logger, "%s - position = (%.2f, %.2f, %.2f)\n", header_str.c_str(), x, y, z);
+	LogPrintf(node_logger, "%s - current_primary_channel = %d\n", header_str.c_str(), current_primary_channel);
+	LogPrintf(node_logger, "%s - min_channel_allowed = %d\n", header_str.c_str(), min_channel_allowed);
+	LogPrintf(node_logger, "%s - max_channel_allowed = %d\n", header_str.c_str(), max_channel_allowed);
+	LogPrintf(node_logger, "%s - current_dcb_policy = %d\n", header_str.c_str(), current_dcb_policy);
+	LogPrintf(node_logger, "%s - spatial_reuse_enabled = %d\n", header_str.c_str(), (bss_color>=0));
 	if(bss_color>=0) {
-		fprintf(node_logger.file, "%s bss_color = %d\n", header_str.c_str(), bss_color);
-		fprintf(node_logger.file, "%s srg = %d\n", header_str.c_str(), srg);
-		fprintf(node_logger.file, "%s non_srg_obss_pd = %f dBm\n", header_str.c_str(), ConvertPower(PW_TO_DBM,non_srg_obss_pd));
-		fprintf(node_logger.file, "%s srg_obss_pd = %f dBm\n", header_str.c_str(), ConvertPower(PW_TO_DBM,srg_obss_pd));
+		LogPrintf(node_logger, "%s bss_color = %d\n", header_str.c_str(), bss_color);
+		LogPrintf(node_logger, "%s srg = %d\n", header_str.c_str(), srg);
+		LogPrintf(node_logger, "%s non_srg_obss_pd = %f dBm\n", header_str.c_str(), ConvertPower(PW_TO_DBM,non_srg_obss_pd));
+		LogPrintf(node_logger, "%s srg_obss_pd = %f dBm\n", header_str.c_str(), ConvertPower(PW_TO_DBM,srg_obss_pd));
 	}
 
 	if(info_detail_level > INFO_DETAIL_LEVEL_0){
@@ -4500,11 +4652,11 @@ void Node :: WriteNodeInfo(Logger node_logger, int info_detail_level, std::strin
 	}
 
 	if(info_detail_level > INFO_DETAIL_LEVEL_1){
-		fprintf(node_logger.file, "%s - cw_min = %d\n", header_str.c_str(), cw_min);
-		fprintf(node_logger.file, "%s - cw_stage_max = %d\n", header_str.c_str(), cw_stage_max);
-		fprintf(node_logger.file, "%s - destination_id = %d\n", header_str.c_str(), destination_id);
-		fprintf(node_logger.file, "%s - tx_power_default = %f pW\n", header_str.c_str(), tx_power_default);
-		fprintf(node_logger.file, "%s - sensitivity_default = %f pW\n", header_str.c_str(), sensitivity_default);
+		LogPrintf(node_logger, "%s - cw_min = %d\n", header_str.c_str(), cw_min);
+		LogPrintf(node_logger, "%s - cw_stage_max = %d\n", header_str.c_str(), cw_stage_max);
+		LogPrintf(node_logger, "%s - destination_id = %d\n", header_str.c_str(), OriginalNodeId(destination_id));
+		LogPrintf(node_logger, "%s - tx_power_default = %f pW\n", header_str.c_str(), tx_power_default);
+		LogPrintf(node_logger, "%s - sensitivity_default = %f pW\n", header_str.c_str(), sensitivity_default);
 	}
 
 }
@@ -4513,28 +4665,28 @@ void Node :: WriteNodeInfo(Logger node_logger, int info_detail_level, std::strin
  * WriteNodeConfiguration(): writes Node conf.
  */
 void Node :: WriteNodeConfiguration(Logger node_logger, std::string header_str){
-	fprintf(node_logger.file, "%s Configuration %s info:\n", header_str.c_str(), node_code.c_str());
-	fprintf(node_logger.file, "%s - current_primary = %d\n", header_str.c_str(), current_primary_channel);
-	fprintf(node_logger.file, "%s - current_pd = %f (%f dBm)\n", header_str.c_str(), current_pd, ConvertPower(PW_TO_DBM,current_pd));
-	fprintf(node_logger.file, "%s - current_tx_power = %f (%f dBm)\n", header_str.c_str(), current_tx_power, ConvertPower(PW_TO_DBM,current_tx_power));
-	fprintf(node_logger.file, "%s - current_dcb_policy = %d\n", header_str.c_str(), current_dcb_policy);
+	LogPrintf(node_logger, "%s Configuration %s info:\n", header_str.c_str(), node_code.c_str());
+	LogPrintf(node_logger, "%s - current_primary = %d\n", header_str.c_str(), current_primary_channel);
+	LogPrintf(node_logger, "%s - current_pd = %f (%f dBm)\n", header_str.c_str(), current_pd, ConvertPower(PW_TO_DBM,current_pd));
+	LogPrintf(node_logger, "%s - current_tx_power = %f (%f dBm)\n", header_str.c_str(), current_tx_power, ConvertPower(PW_TO_DBM,current_tx_power));
+	LogPrintf(node_logger, "%s - current_dcb_policy = %d\n", header_str.c_str(), current_dcb_policy);
 }
 
 /*
  * WriteReceivedConfiguration(): writes received conf.
  */
 void Node :: WriteReceivedConfiguration(Logger node_logger, std::string header_str, Configuration new_configuration) {
-	fprintf(node_logger.file, "%s Received Configuration:\n", header_str.c_str());
-	fprintf(node_logger.file, "%s - selected_primary_channel = %d\n", header_str.c_str(), new_configuration.selected_primary_channel);
-	fprintf(node_logger.file, "%s - selected_pd = %f (%f dBm)\n", header_str.c_str(), new_configuration.selected_pd, ConvertPower(PW_TO_DBM,new_configuration.selected_pd));
-	fprintf(node_logger.file, "%s - current_tx_power = %f (%f dBm)\n", header_str.c_str(), new_configuration.selected_tx_power, ConvertPower(PW_TO_DBM,new_configuration.selected_tx_power));
-	fprintf(node_logger.file, "%s - selected_dcb_policy = %d\n", header_str.c_str(), new_configuration.selected_dcb_policy);
+	LogPrintf(node_logger, "%s Received Configuration:\n", header_str.c_str());
+	LogPrintf(node_logger, "%s - selected_primary_channel = %d\n", header_str.c_str(), new_configuration.selected_primary_channel);
+	LogPrintf(node_logger, "%s - selected_pd = %f (%f dBm)\n", header_str.c_str(), new_configuration.selected_pd, ConvertPower(PW_TO_DBM,new_configuration.selected_pd));
+	LogPrintf(node_logger, "%s - current_tx_power = %f (%f dBm)\n", header_str.c_str(), new_configuration.selected_tx_power, ConvertPower(PW_TO_DBM,new_configuration.selected_tx_power));
+	LogPrintf(node_logger, "%s - selected_dcb_policy = %d\n", header_str.c_str(), new_configuration.selected_dcb_policy);
 }
 /*
  * WriteNodeConfiguration(): writes Node conf.
  */
 void Node :: PrintNodeConfiguration(){
-	printf("Node%d - Configuration info:\n", node_id);
+	printf("Node%d - Configuration info:\n", OriginalNodeId(node_id));
 	printf(" - current_pd = %f (%f dBm)\n", current_pd, ConvertPower(PW_TO_DBM,current_pd));
 	printf(" - current_tx_power = %f (%f dBm)\n", current_tx_power, ConvertPower(PW_TO_DBM,current_tx_power));
 }
@@ -4555,6 +4707,40 @@ void Node :: PrintProgressBar(trigger_t &){
 	++progress_bar_counter;
 }
 
+/*
+ * TriggerFlightRecorder(): dumps the flight recorder of the node (and of the other node involved, if any)
+ * when the trigger is enabled
+ * Input arguments:
+ * - trigger: FLIGHT_RECORDER_TRIGGER_XXX
+ * - reason: description of the event that fired the trigger
+ * - involved_node_id: other node involved in the event (-1 if none)
+ */
+void Node :: TriggerFlightRecorder(int trigger, const char *reason, int involved_node_id){
+	if(node_logger.recorder == NULL || !(flight_recorder_config.triggers & trigger)) return;
+	node_flight_recorder.Dump(reason, SimTime());
+	FlightRecorder *involved_recorder (FindFlightRecorder(involved_node_id));
+	if(involved_node_id != node_id && involved_recorder != NULL) involved_recorder->Dump(reason, SimTime());
+}
+
+/*
+ * WriteFlightRecorderState(): writes the MAC state of the node in a flight recorder dump
+ * Input arguments:
+ * - file: dump file
+ */
+void Node :: WriteFlightRecorderState(FILE *file){
+	fprintf(file, "%s node_code = %s, node_state = %d, primary = %d, tx channels = [%d, %d]\n",
+		LOG_LVL2, node_code.c_str(), node_state, current_primary_channel, current_left_channel, current_right_channel);
+	fprintf(file, "%s cw = %d (stage %d), remaining_backoff = %.9f s, queue = %d packets\n",
+		LOG_LVL2, cw_current, cw_stage_current, remaining_backoff, buffer.QueueSize());
+	fprintf(file, "%s destination = N%d, packet_id = %d, nav_time = %.9f s, sinr = %f\n",
+		LOG_LVL2, OriginalNodeId(current_destination_id), packet_id, current_nav_time, current_sinr);
+	fprintf(file, "%s channel_power [dBm] = ", LOG_LVL2);
+	for(int c = 0; c < num_channels_komondor; ++c){
+		fprintf(file, "%.2f ", ConvertPower(PW_TO_DBM, channel_power[c]));
+	}
+	fprintf(file, "\n");
+}
+
 /*
  * PrintOrWriteNodeStatistics(): prints (or writes) final statistics at the given node
  */
@@ -4595,7 +4781,7 @@ void Node :: PrintOrWriteNodeStatistics(int write_or_print){
 		case PRINT_LOG:{
 
 			if (node_is_transmitter && print_node_logs) {
-				printf("------- %s (N%d) ------\n", node_code.c_str(), node_id);
+				printf("------- %s (N%d) ------\n", node_code.c_str(), OriginalNodeId(node_id));
 				// Throughput
 				printf("%s Throughput = %f Mbps (%.2f pkt/s)\n", LOG_LVL2,
 					throughput * pow(10,-6),
@@ -4755,71 +4941,71 @@ void Node :: PrintOrWriteNodeStatistics(int write_or_print){
 
 				if (node_is_transmitter) {
 					// Throughput
-					fprintf(node_logger.file, "%.15f;N%d;S%d;%s;%s Throughput = %f Mbps\n",
+					LogPrintf(node_logger, "%.15f;N%d;S%d;%s;%s Throughput = %f Mbps\n",
 						SimTime(), node_id, node_state, LOG_C02, LOG_LVL2, throughput * pow(10,-6));
 
 					// Data packets sent and lost
-					fprintf(node_logger.file,
+					LogPrintf(node_logger, 
 						"%.15f;N%d;S%d;%s;%s Data packets sent: %d\n",
 						SimTime(), node_id, node_state, LOG_C03, LOG_LVL2, data_packets_sent);
-					fprintf(node_logger.file,
+					LogPrintf(node_logger, 
 						"%.15f;N%d;S%d;%s;%s Data packets lost: %d\n",
 						SimTime(), node_id, node_state, LOG_C04, LOG_LVL2, data_packets_lost);
-					fprintf(node_logger.file,
+					LogPrintf(node_logger, 
 						"%.15f;N%d;S%d;%s;%s Loss ratio: %f\n",
 						SimTime(), node_id, node_state, LOG_C05, LOG_LVL2, data_packets_lost_percentage);
 
 					// Time EFFECTIVELY transmitting in a given number of channels (no losses)
-					fprintf(node_logger.file, "%.15f;N%d;S%d;%s;%s Time EFFECTIVELY transmitting in N channels: ",
+					LogPrintf(node_logger, "%.15f;N%d;S%d;%s;%s Time EFFECTIVELY transmitting in N channels: ",
 						SimTime(), node_id, node_state, LOG_C06, LOG_LVL2);
 					for(int n = 0; n < num_channels_allowed; ++n){
-						fprintf(node_logger.file, "(%d) %f  ",
+						LogPrintf(node_logger, "(%d) %f  ",
 							n+1, total_time_transmitting_in_num_channels[n] - total_time_lost_in_num_channels[n]);
 					}
-					fprintf(node_logger.file, "\n");
+					LogPrintf(node_logger, "\n");
 
 					// Time EFFECTIVELY transmitting in each of the channels (no losses)
-					fprintf(node_logger.file,
+					LogPrintf(node_logger, 
 						"%.15f;N%d;S%d;%s;%s Time EFFECTIVELY transmitting in each channel: ",
 						SimTime(), node_id, node_state, LOG_C07, LOG_LVL2);
 					for(int c = 0; c < num_channels_komondor; ++c){
-						fprintf(node_logger.file, "(#%d) %f ",
+						LogPrintf(node_logger, "(#%d) %f ",
 							c, total_time_transmitting_per_channel[c] - total_time_lost_per_channel[c]);
 					}
-					fprintf(node_logger.file, "\n");
+					LogPrintf(node_logger, "\n");
 
 					// Time LOST transmitting in a given number of channels
-					fprintf(node_logger.file, "%.15f;N%d;S%d;%s;%s Time LOST transmitting in N channels: ",
+					LogPrintf(node_logger, "%.15f;N%d;S%d;%s;%s Time LOST transmitting in N channels: ",
 						SimTime(), node_id, node_state, LOG_C08, LOG_LVL2);
 					for(int n = 0; n < num_channels_allowed; ++n){
-						fprintf(node_logger.file, "(%d) %f  ", n+1, total_time_lost_in_num_channels[n]);
+						LogPrintf(node_logger, "(%d) %f  ", n+1, total_time_lost_in_num_channels[n]);
 					}
-					fprintf(node_logger.file, "\n");
+					LogPrintf(node_logger, "\n");
 
 					// Time LOST transmitting in each of the channels
-					fprintf(node_logger.file, "%.15f;N%d;S%d;%s;%s Time LOST transmitting in each channel: ",
+					LogPrintf(node_logger, "%.15f;N%d;S%d;%s;%s Time LOST transmitting in each channel: ",
 						SimTime(), node_id, node_state, LOG_C09, LOG_LVL2);
 					for(int c = 0; c < num_channels_komondor; ++c){
-						fprintf(node_logger.file, "(#%d) %f ", c, total_time_lost_per_channel[c]);
+						LogPrintf(node_logger, "(#%d) %f ", c, total_time_lost_per_channel[c]);
 					}
-					fprintf(node_logger.file, "\n");
+					LogPrintf(node_logger, "\n");
 
 					// Number of TX initiations that have been not possible due to channel state and DCB model
-					fprintf(node_logger.file, "%.15f;N%d;S%d;%s;%s num_tx_init_not_possible = %d\n",
+					LogPrintf(node_logger, "%.15f;N%d;S%d;%s;%s num_tx_init_not_possible = %d\n",
 						SimTime(), node_id, node_state, LOG_C09, LOG_LVL2, num_tx_init_not_possible);
 
 					// Spectrum utilization
-					fprintf(node_logger.file,"%s Time occupying the spectrum in each channel:", LOG_LVL3);
+					LogPrintf(node_logger, "%s Time occupying the spectrum in each channel:", LOG_LVL3);
 					for(int c = 0; c < num_channels_komondor; ++c){
-						fprintf(node_logger.file,"\n%s - %d = %.2f s (%.2f %%)",
+						LogPrintf(node_logger, "\n%s - %d = %.2f s (%.2f %%)",
 							LOG_LVL3, c, total_time_spectrum_per_channel[c],
 							(total_time_spectrum_per_channel[c] * 100 /SimTime()));
 					}
 
-					fprintf(node_logger.file,"\n%s - Average bandwidth used for transmitting = %.2f MHz / %d MHz (%.2f %%)\n",
+					LogPrintf(node_logger, "\n%s - Average bandwidth used for transmitting = %.2f MHz / %d MHz (%.2f %%)\n",
 						LOG_LVL4, bandwidth_used_txing, num_channels_allowed * 20, bandwidth_used_txing * 100 / (num_channels_allowed * 20));
 
-					fprintf(node_logger.file,"\n");
+					LogPrintf(node_logger, "\n");
 
 				}
 
@@ -4828,13 +5014,13 @@ void Node :: PrintOrWriteNodeStatistics(int write_or_print){
 //				for(int n = 0; n < total_nodes_number; ++n){
 //					if(hidden_nodes_list[n]) hidden_nodes_number++;
 //				}
-//				fprintf(node_logger.file, "%.15f;N%d;S%d;%s;%s Total hidden nodes: %d\n",
+//				LogPrintf(node_logger, "%.15f;N%d;S%d;%s;%s Total hidden nodes: %d\n",
 //						SimTime(), node_id, node_state, LOG_C10, LOG_LVL2, hidden_nodes_number);
 //
-//				fprintf(node_logger.file, "%.15f;N%d;S%d;%s;%s Hidden nodes list: ",
+//				LogPrintf(node_logger, "%.15f;N%d;S%d;%s;%s Hidden nodes list: ",
 //						SimTime(), node_id, node_state, LOG_C11, LOG_LVL2);
 //				for(int i = 0; i < total_nodes_number; ++i){
-//					fprintf(node_logger.file, "%d  ", hidden_nodes_list[i]);
+//					LogPrintf(node_logger, "%d  ", hidden_nodes_list[i]);
 //				}
 			}
 			break;
@@ -4865,6 +5051,7 @@ void Node :: SaveSimulationPerformance() {
 	simulation_performance.num_delay_measurements = num_delay_measurements;
 	simulation_performance.sum_delays = sum_delays;
 	simulation_performance.average_delay = average_delay;
+	simulation_performance.delay_histogram = &delay_histogram;
 	simulation_performance.average_rho = average_rho;
 	simulation_performance.average_utilization = average_utilization;
 	simulation_performance.generation_drop_ratio = generation_drop_ratio;
@@ -4891,6 +5078,7 @@ void Node :: SaveSimulationPerformance() {
 		simulation_performance.rts_cts_lost_per_sta = rts_cts_lost_per_sta;
 		simulation_performance.data_packets_acked_per_sta = data_packets_acked_per_sta;
 		simulation_performance.data_frames_acked_per_sta = data_frames_acked_per_sta;
+		simulation_performance.delay_histogram_per_sta = delay_histogram_per_sta;
 	}
 	simulation_performance.received_power_array = received_power_array;
 
@@ -4917,7 +5105,6 @@ void Node :: InitializeVariables() {
 	 * - These variables are initialized in the code itself
 	 * - Despite this is not the most efficient approach, it allows us testing new features
 	 */
-	burst_rate = 10;
 	num_bursts = 0;
 	// NACK system not activated - to be further extended in future
 	nack_activated = FALSE;
@@ -4939,6 +5126,7 @@ void Node :: InitializeVariables() {
 	num_delay_measurements = 0;
 	sum_delays = 0;
 	average_delay = 0;
+	delay_histogram.Reset();
 	num_packets_generated = 0;
 	num_packets_dropped = 0;
 
@@ -4957,6 +5145,13 @@ void Node :: InitializeVariables() {
 	num_measures_buffer_with_packets = 0;
 	generation_drop_ratio = 0;
 
+	// Select the model handlers once, so that no model switch is evaluated per notification
+	compute_backoff = SelectComputeBackoff(pdf_backoff, backoff_type);
+	compute_remaining_backoff = SelectComputeRemainingBackoff(backoff_type);
+	apply_adjacent_channel_model = SelectAdjacentChannelInterferenceModel(adjacent_channel_model);
+	is_packet_lost = SelectCaptureEffectModel(capture_effect_model, &capture_as_destination, &capture_as_interferer);
+	handle_contention_window = SelectContentionWindowHandler(cw_adaptation);
+
 	// Output file - logger
 	node_logger.save_logs = save_node_logs;
 	node_logger.file = node_logger.file;
@@ -5032,7 +5227,8 @@ void Node :: InitializeVariables() {
 
 	if(node_type == NODE_TYPE_AP) {
 		node_is_transmitter = TRUE;
-		remaining_backoff = ComputeBackoff(pdf_backoff, cw_current, backoff_type);
+		frame_duration_table.Build(frame_length, max_num_packets_aggregated);
+		remaining_backoff = compute_backoff(cw_current);
 		expected_backoff += remaining_backoff;
 		num_new_backoff_computations++;
 	} else {
@@ -5122,6 +5318,7 @@ void Node :: InitializeVariables() {
 	rts_cts_lost_per_sta = new int[wlan.num_stas];
 	data_packets_acked_per_sta = new int[wlan.num_stas];
 	data_frames_acked_per_sta = new int[wlan.num_stas];
+	delay_histogram_per_sta = new DelayHistogram[wlan.num_stas];
 
 	for(int i = 0; i < wlan.num_stas; ++i){
 		throughput_per_sta[i] = 0;
@@ -0,0 +1,95 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file writes procedurally generated scenarios (see structures/scenario_generator.h) as
+ *   nodes input files. The same spec can be entered to komondor_main instead of the nodes input
+ *   file, generating the scenario in-process.
+ *
+ * Usage: ./scenario_generator [generate:]<key>=<value>,... <output_nodes_file.csv>
+ * e.g.,  ./scenario_generator topology=stadium,aps=500,stas=20,num_channels=8,channels=reuse nodes.csv
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "../list_of_macros.h"
+#include "../structures/csv_file.h"
+#include "../structures/scenario_file.h"
+#include "../structures/scenario_generator.h"
+
+int main(int argc, char *argv[]){
+
+	if(argc != 3){
+		printf("ERROR: Console arguments were not set properly!\n"
+			" + Usage: ./scenario_generator [generate:]<key>=<value>,... <output_nodes_file.csv>\n"
+			"   Keys: topology=<grid|random|enterprise|stadium>, aps, stas, seed, ap_distance, min_ap_distance,"
+			" width, sta_distance, floors, floor_height, pitch_radius, tiers, tier_height, num_channels,"
+			" channels=<single|round_robin|random|reuse>, reuse_distance, power=<fixed|random>, tx_power,"
+			" tx_power_min, tx_power_max, cca, cw, cw_stage, dcb_policy, ieee_protocol, traffic_load,"
+			" spatial_reuse, obss_pd\n");
+		return -1;
+	}
+
+	std::string spec (argv[1]);
+	if(!IsScenarioGeneratorSpec(spec.c_str())) spec = SCENARIO_GENERATOR_PREFIX + spec;
+
+	std::vector<NodeRecord> node_records;
+	GenerateScenario(spec.c_str(), node_records);
+
+	if(!WriteNodesFile(argv[2], node_records)){
+		printf("ERROR: output file %s could not be written\n", argv[2]);
+		return -1;
+	}
+
+	int num_aps (0);
+	for(size_t n = 0; n < node_records.size(); ++n) if(node_records[n].node_type == NODE_TYPE_AP) ++num_aps;
+	printf("%s Scenario '%s' written to %s (%d nodes, %d WLANs)\n", LOG_LVL1, spec.c_str(), argv[2],
+		(int) node_records.size(), num_aps);
+
+	return 0;
+}
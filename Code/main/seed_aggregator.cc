@@ -0,0 +1,279 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file runs the same simulation with consecutive seeds and aggregates the script output
+ *   of every run with streaming (Welford) statistics. New seeds are launched until the confidence
+ *   interval of every column is narrower than the target (relative half-width) or the maximum
+ *   number of seeds is reached.
+ *
+ * Usage: ./seed_aggregator [options] <simulator> <arguments>
+ * The token SEED in the arguments is replaced by the seed of each run (e.g., the seed argument
+ * itself, or the simulation code 'sim_SEED'). Every run must append a single line of values to the
+ * script output file, as done by --output_schema (see structures/output_schema.h).
+ * Options:
+ *   --ci_target=<r>		relative half-width of the intervals (default 0.05)
+ *   --confidence=<c>		confidence level (default 0.95)
+ *   --min_seeds=<N>		seeds run before checking the intervals (default 3)
+ *   --max_seeds=<N>		maximum number of seeds (default 30)
+ *   --first_seed=<N>		seed of the first run (default 1)
+ *   --script_output=<path>	script output file of the runs (default ./output/script_output.txt)
+ *   --summary=<path>		file where the aggregated line is appended
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <string>
+#include <vector>
+
+#include "../list_of_macros.h"
+#include "../structures/streaming_statistics.h"
+
+/*
+ * FileSize(): size of a file (0 if it does not exist)
+ */
+long FileSize(const char *filename){
+	FILE *file = fopen(filename, "r");
+	if(file == NULL) return 0;
+	fseek(file, 0, SEEK_END);
+	long size (ftell(file));
+	fclose(file);
+	return size;
+}
+
+/*
+ * RunSimulation(): runs the simulator with a given seed and waits for it
+ * Input arguments:
+ * - arguments: simulator and its arguments (AGGREGATOR_SEED_TOKEN is replaced by the seed)
+ * - seed: seed of the run
+ * Output:
+ * - exit status of the simulator
+ */
+int RunSimulation(const std::vector<std::string> &arguments, int seed){
+
+	std::vector<std::string> run_arguments (arguments);
+	std::string seed_string (std::to_string(seed));
+	for(size_t a = 0; a < run_arguments.size(); ++a){
+		size_t position;
+		while((position = run_arguments[a].find(AGGREGATOR_SEED_TOKEN)) != std::string::npos){
+			run_arguments[a].replace(position, strlen(AGGREGATOR_SEED_TOKEN), seed_string);
+		}
+	}
+	std::vector<char*> argv;
+	for(size_t a = 0; a < run_arguments.size(); ++a) argv.push_back(&run_arguments[a][0]);
+	argv.push_back(NULL);
+
+	fflush(stdout);
+	pid_t pid = fork();
+	if(pid < 0){
+		printf("ERROR: the simulation could not be launched\n");
+		exit(-1);
+	}
+	if(pid == 0){
+		execvp(argv[0], &argv[0]);
+		printf("ERROR: %s could not be executed\n", argv[0]);
+		_exit(127);
+	}
+	int status;
+	waitpid(pid, &status, 0);
+	return (WIFEXITED(status)) ? WEXITSTATUS(status) : -1;
+}
+
+/*
+ * ReadRunValues(): reads the values appended by a run to the script output file
+ * Input arguments:
+ * - filename: script output file
+ * - offset: size of the file before the run
+ * Output:
+ * - values after the simulation header (';'-separated, non-numeric fields are NaN)
+ */
+std::vector<double> ReadRunValues(const char *filename, long offset){
+
+	std::vector<double> values;
+	FILE *file = fopen(filename, "r");
+	if(file == NULL){
+		printf("ERROR: script output file %s could not be opened\n", filename);
+		exit(-1);
+	}
+	fseek(file, offset, SEEK_SET);
+	std::string text;
+	char buffer[CHAR_BUFFER_SIZE];
+	size_t num_read;
+	while((num_read = fread(buffer, 1, sizeof(buffer), file)) > 0) text.append(buffer, num_read);
+	fclose(file);
+
+	// Skip the header of the simulation (" KOMONDOR SIMULATION 'code' (seed N)")
+	size_t from (text.find(';'));
+	if(from == std::string::npos) return values;
+	++from;
+	while(from < text.size()){
+		size_t to (text.find_first_of(";\n", from));
+		if(to == std::string::npos) to = text.size();
+		std::string field (text.substr(from, to - from));
+		if(!field.empty()){
+			char *end;
+			double value (strtod(field.c_str(), &end));
+			values.push_back((*end == '\0' || *end == '\r') ? value : NAN);
+		}
+		from = to + 1;
+	}
+	return values;
+}
+
+int main(int argc, char *argv[]){
+
+	double ci_target (AGGREGATOR_DEFAULT_CI_TARGET);
+	double confidence (AGGREGATOR_DEFAULT_CONFIDENCE);
+	int min_seeds (AGGREGATOR_DEFAULT_MIN_SEEDS);
+	int max_seeds (AGGREGATOR_DEFAULT_MAX_SEEDS);
+	int first_seed (1);
+	std::string script_output (DEFAULT_SCRIPT_FILENAME);
+	std::string summary_filename;
+
+	// Options (before the simulator)
+	int arg_ix (1);
+	for(; arg_ix < argc && strncmp(argv[arg_ix], "--", 2) == 0; ++arg_ix){
+		const char *argument (argv[arg_ix]);
+		if(strncmp(argument, "--ci_target=", 12) == 0) ci_target = atof(argument + 12);
+		else if(strncmp(argument, "--confidence=", 13) == 0) confidence = atof(argument + 13);
+		else if(strncmp(argument, "--min_seeds=", 12) == 0) min_seeds = atoi(argument + 12);
+		else if(strncmp(argument, "--max_seeds=", 12) == 0) max_seeds = atoi(argument + 12);
+		else if(strncmp(argument, "--first_seed=", 13) == 0) first_seed = atoi(argument + 13);
+		else if(strncmp(argument, "--script_output=", 16) == 0) script_output = argument + 16;
+		else if(strncmp(argument, "--summary=", 10) == 0) summary_filename = argument + 10;
+		else {
+			printf("ERROR: unknown option %s\n", argument);
+			return -1;
+		}
+	}
+
+	if(arg_ix >= argc){
+		printf("ERROR: Console arguments were not set properly!\n"
+			" + Usage: ./seed_aggregator [--ci_target=<r>] [--confidence=<c>] [--min_seeds=<N>] [--max_seeds=<N>]"
+			" [--first_seed=<N>] [--script_output=<path>] [--summary=<path>] <simulator> <arguments with %s>\n",
+			AGGREGATOR_SEED_TOKEN);
+		return -1;
+	}
+	if(min_seeds < 2 || max_seeds < min_seeds || confidence <= 0 || confidence >= 1 || ci_target <= 0){
+		printf("ERROR: invalid options (2 <= min_seeds <= max_seeds, 0 < confidence < 1, ci_target > 0)\n");
+		return -1;
+	}
+
+	std::vector<std::string> arguments (argv + arg_ix, argv + argc);
+	std::vector<RunningStatistics> statistics;
+
+	int num_seeds (0);
+	int converged (FALSE);
+	while(num_seeds < max_seeds && !converged){
+
+		int seed (first_seed + num_seeds);
+		long offset (FileSize(script_output.c_str()));
+		int status (RunSimulation(arguments, seed));
+		if(status != 0){
+			printf("ERROR: simulation with seed %d exited with status %d\n", seed, status);
+			return -1;
+		}
+
+		std::vector<double> values (ReadRunValues(script_output.c_str(), offset));
+		if(num_seeds == 0) {
+			if(values.empty()){
+				printf("ERROR: the simulation did not append any value to %s\n", script_output.c_str());
+				return -1;
+			}
+			statistics.resize(values.size());
+		} else if(values.size() != statistics.size()){
+			printf("ERROR: seed %d wrote %d values (%d expected)\n", seed, (int) values.size(), (int) statistics.size());
+			return -1;
+		}
+		for(size_t c = 0; c < values.size(); ++c) statistics[c].Add(values[c]);
+		++num_seeds;
+
+		// Find the least precise column
+		double worst_relative_half_width (0);
+		int worst_column (0);
+		converged = (num_seeds >= min_seeds);
+		for(size_t c = 0; c < statistics.size(); ++c){
+			if(statistics[c].num_samples == 0) continue;	// Non-numeric column
+			double relative_half_width (statistics[c].mean == 0 ? 0 :
+				statistics[c].HalfWidth(confidence) / fabs(statistics[c].mean));
+			if(relative_half_width > worst_relative_half_width){
+				worst_relative_half_width = relative_half_width;
+				worst_column = c;
+			}
+			if(!statistics[c].IsPrecise(confidence, ci_target)) converged = FALSE;
+		}
+		printf("%s Seed %d done (%d seeds): worst relative half-width = %.4f (column %d)\n",
+			LOG_LVL1, seed, num_seeds, worst_relative_half_width, worst_column + 1);
+	}
+
+	// Summary
+	printf("%s %s after %d seeds (%.0f%% confidence, target relative half-width %.4f)\n", LOG_LVL1,
+		converged ? "Converged" : "Maximum number of seeds reached", num_seeds, confidence * 100, ci_target);
+	printf("%s column;samples;mean;std;half_width\n", LOG_LVL2);
+	for(size_t c = 0; c < statistics.size(); ++c){
+		printf("%s %d;%ld;%f;%f;%f\n", LOG_LVL2, (int) c + 1, statistics[c].num_samples, statistics[c].mean,
+			sqrt(statistics[c].Variance()), statistics[c].HalfWidth(confidence));
+	}
+
+	if(!summary_filename.empty()){
+		FILE *summary_file = fopen(summary_filename.c_str(), "at");
+		if(summary_file == NULL){
+			printf("ERROR: summary file %s could not be opened\n", summary_filename.c_str());
+			return -1;
+		}
+		// Line: seeds;converged;mean_1;half_width_1;mean_2;half_width_2;...
+		fprintf(summary_file, "%d;%d", num_seeds, converged);
+		for(size_t c = 0; c < statistics.size(); ++c){
+			fprintf(summary_file, ";%f;%f", statistics[c].mean, statistics[c].HalfWidth(confidence));
+		}
+		fprintf(summary_file, "\n");
+		fclose(summary_file);
+	}
+
+	return 0;
+}
@@ -79,7 +79,7 @@ component TrafficGenerator : public TypeII{
 		double traffic_load;	// Average traffic load of the AP [packets/s]
 		double lambda;			// Average notification generation rate (related to exponential BO) [notification/s]
 		// Burst traffic
-		double burst_rate;				// Average time between two packet generation bursts [bursts/s]
+		double burst_size;				// Average number of packets per burst (sets the time between bursts)
 		int num_bursts;					// Total number of bursts occurred in the simulation
 
 	// Private items (just for node operation)
@@ -181,8 +181,8 @@ void TrafficGenerator :: GenerateTraffic() {
 		// 3
 		case TRAFFIC_POISSON_BURST:{
 			// Sergio on 2nd February 2018
-			// - Input: traffic load and average time between bursts
-			time_for_next_packet = Exponential(burst_rate/traffic_load);
+			// - Input: traffic load and average burst size (the burst size itself is drawn by the node)
+			time_for_next_packet = Exponential(burst_size/traffic_load);
 			time_to_trigger = SimTime() + time_for_next_packet;
 //			if(save_node_logs) fprintf(node_logger.file, "%.15f;N%d;S%d;%s;%s New generation burst will be triggered in %f ms\n",
 //				SimTime(), node_id, node_state, LOG_F00, LOG_LVL3,
@@ -214,7 +214,6 @@ void TrafficGenerator :: InitializeTrafficGenerator() {
 	 * - This variables are initialized in the code itself
 	 * - While this is not the most efficient approach, it allows us testing new feature
 	 */
-	burst_rate = 10;
 	num_bursts = 0;
 	GenerateTraffic();
 }
@@ -0,0 +1,541 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file contains the methods of the analytical estimation mode (--analytical): the throughput,
+ *   failure probability and channel occupancy of every WLAN are estimated without simulating.
+ *   WLANs are split into groups of WLANs that sense each other. A group forming a single contention
+ *   domain (every AP senses the rest and all transmit in the same single channel) is solved with
+ *   Bianchi's fixed point; any other group (DCB, partially overlapping WLANs, hidden APs) is solved
+ *   as a continuous-time Markov network (CTMN), whose states are the sets of WLANs transmitting and
+ *   the channels they use. The interference between groups (and the offered load of non-saturated
+ *   WLANs) is handled by an outer fixed point on the channel occupancy (and the backoff activity).
+ */
+
+#include <math.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include "../list_of_macros.h"
+#include "../structures/analytical_model.h"
+#include "power_channel_methods.h"
+
+#ifndef _ANALYTICAL_METHODS_
+#define _ANALYTICAL_METHODS_
+
+/*
+ * AnalyticalNumChannelsIndex(): index of the number of channels (0: 1, 1: 2, 2: 4, 3: 8) of a transmission
+ * Input arguments:
+ * - tx_mask: bitmask of the channels used
+ **/
+int AnalyticalNumChannelsIndex(unsigned int tx_mask){
+	int num_channels (__builtin_popcount(tx_mask));
+	int ix_num_channels (31 - __builtin_clz(num_channels));	// Floor of log2
+	return std::min(ix_num_channels, NUM_OPTIONS_CHANNEL_LENGTH - 1);
+}
+
+/*
+ * AnalyticalUsableChannels(): bitmask of the channels a WLAN may transmit in
+ **/
+unsigned int AnalyticalUsableChannels(const AnalyticalScenario &scenario, int w){
+	const AnalyticalWlan &wlan (scenario.wlans[w]);
+	if(wlan.dcb_policy == CB_ONLY_PRIMARY) return 1u << wlan.primary_channel;
+	return ChannelRangeMask(wlan.min_channel_allowed, wlan.max_channel_allowed)
+		& ChannelRangeMask(0, scenario.num_channels - 1);
+}
+
+/*
+ * AnalyticalSenses(): TRUE if the AP of WLAN w senses the transmissions of the AP of WLAN v
+ **/
+int AnalyticalSenses(const AnalyticalScenario &scenario, int w, int v){
+	return scenario.PowerBetweenAps(w, v) > scenario.wlans[w].pd;
+}
+
+/*
+ * AnalyticalTxOptions(): channels a WLAN may start transmitting in (and the probability of each option)
+ * once its backoff expires, according to its DCB policy. The backoff only runs while the primary is free.
+ * Input arguments:
+ * - scenario: analytical scenario
+ * - w: WLAN whose backoff expires
+ * - free_mask: bitmask of the channels sensed free by the AP
+ * Output:
+ * - tx_masks, tx_probs: bitmask of the channels of each option and its probability
+ **/
+void AnalyticalTxOptions(const AnalyticalScenario &scenario, int w, unsigned int free_mask,
+		std::vector<unsigned int> &tx_masks, std::vector<double> &tx_probs){
+
+	const AnalyticalWlan &wlan (scenario.wlans[w]);
+	tx_masks.clear();
+	tx_probs.clear();
+	if(!((free_mask >> wlan.primary_channel) & 1u)) return;
+
+	if(wlan.dcb_policy == CB_PROB_UNIFORM_LOG2){
+		// Any free log2 range containing the primary with the same probability
+		for(int num_channels = 1; num_channels <= (1 << (NUM_OPTIONS_CHANNEL_LENGTH - 1)); num_channels <<= 1){
+			int left_tx_ch (wlan.primary_channel - wlan.primary_channel % num_channels);
+			int right_tx_ch (left_tx_ch + num_channels - 1);
+			unsigned int range_mask (ChannelRangeMask(left_tx_ch, right_tx_ch));
+			if(left_tx_ch >= wlan.min_channel_allowed && right_tx_ch <= wlan.max_channel_allowed
+				&& right_tx_ch < scenario.num_channels && (free_mask & range_mask) == range_mask){
+				tx_masks.push_back(range_mask);
+			}
+		}
+		tx_probs.assign(tx_masks.size(), 1.0 / std::max((int) tx_masks.size(), 1));
+		return;
+	}
+
+	// Deterministic policies: same selection as the nodes
+	std::vector<int> channels_free (scenario.num_channels);
+	std::vector<int> channels_for_tx (scenario.num_channels, FALSE);
+	for(int c = 0; c < scenario.num_channels; ++c) channels_free[c] = (free_mask >> c) & 1u;
+	int mcs_row[NUM_OPTIONS_CHANNEL_LENGTH];
+	for(int ix = 0; ix < NUM_OPTIONS_CHANNEL_LENGTH; ++ix){
+		mcs_row[ix] = wlan.stas.empty() ? MODULATION_BPSK_1_2
+			: std::max((int) wlan.stas[0].mcs_response[ix], (int) MODULATION_BPSK_1_2);
+	}
+	int *mcs_per_node[1] = {mcs_row};
+	GetTxChannelsByChannelBonding(&channels_for_tx[0], wlan.dcb_policy, &channels_free[0],
+		wlan.min_channel_allowed, wlan.max_channel_allowed, wlan.primary_channel, mcs_per_node, 0,
+		scenario.num_channels);
+	if(channels_for_tx[0] == TX_NOT_POSSIBLE) return;
+	unsigned int tx_mask (ChannelsArrayToBitmask(&channels_for_tx[0], scenario.num_channels));
+	if(tx_mask){
+		tx_masks.push_back(tx_mask);
+		tx_probs.push_back(1);
+	}
+}
+
+/*
+ * AnalyticalTxDuration(): average duration of a transmission of a WLAN over its STAs. STAs that cannot
+ * decode any MCS in the number of channels used do not answer the RTS (failed RTS-CTS exchange).
+ **/
+double AnalyticalTxDuration(const AnalyticalScenario &scenario, int w, int ix_num_channels){
+	const AnalyticalWlan &wlan (scenario.wlans[w]);
+	if(wlan.stas.empty()) return scenario.collision_duration;
+	double duration (0);
+	for(size_t k = 0; k < wlan.stas.size(); ++k){
+		duration += (wlan.stas[k].mcs_response[ix_num_channels] == MODULATION_FORBIDDEN) ?
+			scenario.collision_duration : wlan.stas[k].tx_duration[ix_num_channels];
+	}
+	return duration / wlan.stas.size();
+}
+
+/*
+ * AnalyticalLinkSuccess(): probability that a transmission of a WLAN (to any of its STAs, with the
+ * same probability) is decoded, and average bits delivered per transmission
+ * Input arguments:
+ * - scenario: analytical scenario
+ * - w: transmitting WLAN
+ * - ix_num_channels: index of the number of channels used
+ * - interference: interference power at each STA of the WLAN [pW]
+ * Output:
+ * - prob_success: probability of success
+ * - bits_delivered: average bits delivered per transmission
+ **/
+void AnalyticalLinkSuccess(const AnalyticalScenario &scenario, int w, int ix_num_channels,
+		const std::vector<double> &interference, double *prob_success, double *bits_delivered){
+
+	const AnalyticalWlan &wlan (scenario.wlans[w]);
+	*prob_success = 0;
+	*bits_delivered = 0;
+	if(wlan.stas.empty()) return;
+	for(size_t k = 0; k < wlan.stas.size(); ++k){
+		const AnalyticalSta &sta (wlan.stas[k]);
+		if(sta.mcs_response[ix_num_channels] == MODULATION_FORBIDDEN) continue;
+		if(sta.power_from_ap / (scenario.noise_level + interference[k]) >= scenario.capture_effect){
+			*prob_success += 1 - scenario.constant_per;
+			*bits_delivered += (1 - scenario.constant_per) * sta.bits[ix_num_channels];
+		}
+	}
+	*prob_success /= wlan.stas.size();
+	*bits_delivered /= wlan.stas.size();
+}
+
+/*
+ * BianchiTransmissionProbability(): probability that a saturated node transmits in a slot (Bianchi)
+ * Input arguments:
+ * - prob_collision: conditional collision probability
+ * - cw_min: minimum contention window
+ * - num_stages: number of backoff stages (0: constant contention window)
+ **/
+double BianchiTransmissionProbability(double prob_collision, int cw_min, int num_stages){
+	// 2(1-2p) / ((1-2p)(W+1) + pW(1-(2p)^m)), with (1-(2p)^m)/(1-2p) expanded (no singularity at p = 0.5)
+	double geometric_sum (0);
+	for(int k = 0; k < num_stages; ++k) geometric_sum += pow(2 * prob_collision, k);
+	return 2.0 / (cw_min + 1 + prob_collision * cw_min * geometric_sum);
+}
+
+/*
+ * SolveBianchiGroup(): solves a single contention domain with the heterogeneous Bianchi fixed point
+ * (each AP has its own transmission probability, scaled by its backoff activity)
+ * Input arguments:
+ * - scenario: analytical scenario
+ * - group: WLANs of the contention domain
+ * - activity: fraction of time the backoff of each WLAN runs (1: saturated)
+ * - external_interference: interference from other groups at each STA of each WLAN [pW]
+ * Output:
+ * - results: results of the WLANs of the group
+ **/
+void SolveBianchiGroup(const AnalyticalScenario &scenario, const std::vector<int> &group,
+		const std::vector<double> &activity, const std::vector< std::vector<double> > &external_interference,
+		std::vector<AnalyticalWlanResult> &results){
+
+	int n (group.size());
+	std::vector<double> tau (n);
+	std::vector<double> prob_collision (n, 0);
+	for(int i = 0; i < n; ++i){
+		const AnalyticalWlan &wlan (scenario.wlans[group[i]]);
+		int num_stages (scenario.cw_adaptation ? wlan.cw_stage_max : 0);
+		tau[i] = activity[group[i]] * BianchiTransmissionProbability(0, wlan.cw_min, num_stages);
+	}
+
+	for(int iteration = 0; iteration < ANALYTICAL_MAX_ITERATIONS; ++iteration){
+		for(int i = 0; i < n; ++i){
+			double prob_others_silent (1);
+			for(int j = 0; j < n; ++j) if(j != i) prob_others_silent *= 1 - tau[j];
+			prob_collision[i] = 1 - prob_others_silent;
+		}
+		double max_change (0);
+		for(int i = 0; i < n; ++i){
+			const AnalyticalWlan &wlan (scenario.wlans[group[i]]);
+			int num_stages (scenario.cw_adaptation ? wlan.cw_stage_max : 0);
+			double new_tau (activity[group[i]]
+				* BianchiTransmissionProbability(prob_collision[i], wlan.cw_min, num_stages));
+			max_change = std::max(max_change, fabs(new_tau - tau[i]));
+			tau[i] = 0.5 * (tau[i] + new_tau);	// Damped to avoid oscillations
+		}
+		if(max_change < ANALYTICAL_TOLERANCE) break;
+	}
+
+	// Average duration of a slot: empty, successful transmission of each AP, or collision
+	double prob_idle (1);
+	for(int i = 0; i < n; ++i) prob_idle *= 1 - tau[i];
+	std::vector<double> prob_tx_success (n);
+	std::vector<double> tx_duration (n);
+	double prob_any_success (0);
+	double av_slot_duration (prob_idle * SLOT_TIME);
+	for(int i = 0; i < n; ++i){
+		prob_tx_success[i] = tau[i] * (1 - prob_collision[i]);
+		tx_duration[i] = AnalyticalTxDuration(scenario, group[i], 0);
+		prob_any_success += prob_tx_success[i];
+		av_slot_duration += prob_tx_success[i] * tx_duration[i];
+	}
+	av_slot_duration += std::max(1 - prob_idle - prob_any_success, 0.0) * scenario.collision_duration;
+
+	for(int i = 0; i < n; ++i){
+		int w (group[i]);
+		double prob_link_success, bits_delivered;
+		AnalyticalLinkSuccess(scenario, w, 0, external_interference[w], &prob_link_success, &bits_delivered);
+		results[w].model = ANALYTICAL_MODEL_BIANCHI;
+		results[w].num_states = 0;
+		results[w].throughput = prob_tx_success[i] * bits_delivered / av_slot_duration;
+		results[w].prob_failure = (tau[i] > 0) ? 1 - (1 - prob_collision[i]) * prob_link_success : 0;
+		results[w].occupancy = (prob_tx_success[i] * tx_duration[i]
+			+ (tau[i] - prob_tx_success[i]) * scenario.collision_duration) / av_slot_duration;
+		results[w].av_num_channels = 1;
+	}
+}
+
+/*
+ * SolveCtmnGroup(): solves a group of WLANs as a continuous-time Markov network. A WLAN whose primary
+ * channel is free at its AP starts transmitting at rate 1/E[backoff] (scaled by its backoff activity)
+ * in the channels selected by its DCB policy, and stops at rate 1/E[transmission duration]. The states
+ * reachable from the empty one are enumerated and the stationary distribution is found by Gauss-Seidel.
+ * Input arguments:
+ * - scenario: analytical scenario
+ * - group: WLANs of the group
+ * - activity: fraction of time the backoff of each WLAN runs (1: saturated)
+ * - external_interference: interference from other groups at each STA of each WLAN [pW]
+ * - max_states: max. number of states
+ * Output:
+ * - results: results of the WLANs of the group
+ * - channel_occupancy: fraction of time each WLAN transmits in each channel
+ **/
+void SolveCtmnGroup(const AnalyticalScenario &scenario, const std::vector<int> &group,
+		const std::vector<double> &activity, const std::vector< std::vector<double> > &external_interference,
+		int max_states, std::vector<AnalyticalWlanResult> &results,
+		std::vector< std::vector<double> > &channel_occupancy){
+
+	int n (group.size());
+	unsigned int system_mask (ChannelRangeMask(0, scenario.num_channels - 1));
+
+	std::vector< std::vector<int> > senses (n, std::vector<int>(n, FALSE));
+	std::vector<double> activation_rate (n);
+	std::vector< std::vector<double> > departure_rate (n, std::vector<double>(NUM_OPTIONS_CHANNEL_LENGTH));
+	for(int i = 0; i < n; ++i){
+		for(int j = 0; j < n; ++j) if(j != i) senses[i][j] = AnalyticalSenses(scenario, group[i], group[j]);
+		double expected_backoff (std::max(scenario.wlans[group[i]].cw_min - 1, 1) * SLOT_TIME / 2);
+		activation_rate[i] = activity[group[i]] / expected_backoff;
+		for(int ix = 0; ix < NUM_OPTIONS_CHANNEL_LENGTH; ++ix){
+			departure_rate[i][ix] = 1 / AnalyticalTxDuration(scenario, group[i], ix);
+		}
+	}
+
+	// Enumerate the states (channels used by each WLAN, 0 if not transmitting) and their transitions
+	struct Transition { int state; double rate; };
+	std::vector< std::vector<unsigned int> > states (1, std::vector<unsigned int>(n, 0));
+	std::map<std::vector<unsigned int>, int> state_ix;
+	state_ix[states[0]] = 0;
+	std::vector< std::vector<Transition> > incoming (1);
+	std::vector<double> outgoing_rate (1, 0);
+	std::vector<unsigned int> tx_masks;
+	std::vector<double> tx_probs;
+
+	for(size_t s = 0; s < states.size(); ++s){
+		for(int i = 0; i < n; ++i){
+			std::vector<unsigned int> next_state (states[s]);
+			std::vector<unsigned int> next_masks;
+			std::vector<double> next_rates;
+			if(states[s][i]){
+				next_masks.push_back(0);
+				next_rates.push_back(departure_rate[i][AnalyticalNumChannelsIndex(states[s][i])]);
+			} else if(activation_rate[i] > 0){
+				unsigned int free_mask (system_mask);
+				for(int j = 0; j < n; ++j) if(senses[i][j]) free_mask &= ~states[s][j];
+				AnalyticalTxOptions(scenario, group[i], free_mask, tx_masks, tx_probs);
+				next_masks = tx_masks;
+				for(size_t o = 0; o < tx_probs.size(); ++o) next_rates.push_back(activation_rate[i] * tx_probs[o]);
+			}
+			for(size_t o = 0; o < next_masks.size(); ++o){
+				next_state[i] = next_masks[o];
+				std::map<std::vector<unsigned int>, int>::iterator it (state_ix.find(next_state));
+				int next_ix;
+				if(it == state_ix.end()){
+					if((int) states.size() >= max_states){
+						printf("ERROR: the CTMN of %d WLANs exceeds %d states. Increase --analytical_max_states\n",
+							n, max_states);
+						exit(-1);
+					}
+					next_ix = states.size();
+					state_ix[next_state] = next_ix;
+					states.push_back(next_state);
+					incoming.push_back(std::vector<Transition>());
+					outgoing_rate.push_back(0);
+				} else {
+					next_ix = it->second;
+				}
+				incoming[next_ix].push_back({(int) s, next_rates[o]});
+				outgoing_rate[s] += next_rates[o];
+			}
+		}
+	}
+
+	// Stationary distribution (global balance: pi_j * q_j = sum_i pi_i * q_ij)
+	int num_states (states.size());
+	std::vector<double> pi (num_states, 1.0 / num_states);
+	for(int iteration = 0; iteration < ANALYTICAL_MAX_ITERATIONS; ++iteration){
+		double max_change (0);
+		double total (0);
+		for(int j = 0; j < num_states; ++j){
+			if(outgoing_rate[j] == 0) { total += pi[j]; continue; }
+			double inflow (0);
+			for(size_t t = 0; t < incoming[j].size(); ++t) inflow += pi[incoming[j][t].state] * incoming[j][t].rate;
+			double new_pi (inflow / outgoing_rate[j]);
+			max_change = std::max(max_change, fabs(new_pi - pi[j]));
+			pi[j] = new_pi;
+			total += new_pi;
+		}
+		for(int j = 0; j < num_states; ++j) pi[j] /= total;
+		if(max_change / total < ANALYTICAL_TOLERANCE) break;
+	}
+
+	// Performance of each WLAN: weighted by the time in each state and the rate of transmissions ending
+	std::vector<double> tx_rate (n, 0), success_rate (n, 0), bits_rate (n, 0), occupancy (n, 0), channels (n, 0);
+	std::vector<double> interference;
+	for(int s = 0; s < num_states; ++s){
+		for(int i = 0; i < n; ++i){
+			unsigned int tx_mask (states[s][i]);
+			if(!tx_mask) continue;
+			int w (group[i]);
+			const AnalyticalWlan &wlan (scenario.wlans[w]);
+			interference = external_interference[w];
+			for(int j = 0; j < n; ++j){
+				if(j == i || !(states[s][j] & tx_mask)) continue;
+				for(size_t k = 0; k < wlan.stas.size(); ++k) interference[k] += wlan.stas[k].power_from_wlan[group[j]];
+			}
+			int ix_num_channels (AnalyticalNumChannelsIndex(tx_mask));
+			double prob_link_success, bits_delivered;
+			AnalyticalLinkSuccess(scenario, w, ix_num_channels, interference, &prob_link_success, &bits_delivered);
+			double rate (pi[s] * departure_rate[i][ix_num_channels]);
+			tx_rate[i] += rate;
+			success_rate[i] += rate * prob_link_success;
+			bits_rate[i] += rate * bits_delivered;
+			occupancy[i] += pi[s];
+			channels[i] += pi[s] * __builtin_popcount(tx_mask);
+			for(int c = 0; c < scenario.num_channels; ++c) if((tx_mask >> c) & 1u) channel_occupancy[w][c] += pi[s];
+		}
+	}
+
+	for(int i = 0; i < n; ++i){
+		int w (group[i]);
+		results[w].model = ANALYTICAL_MODEL_CTMN;
+		results[w].num_states = num_states;
+		results[w].throughput = bits_rate[i];
+		results[w].prob_failure = (tx_rate[i] > 0) ? 1 - success_rate[i] / tx_rate[i] : 0;
+		results[w].occupancy = occupancy[i];
+		results[w].av_num_channels = (occupancy[i] > 0) ? channels[i] / occupancy[i] : 0;
+	}
+}
+
+/*
+ * FindAnalyticalGroups(): splits the WLANs into groups of WLANs that sense each other (directly or through
+ * other WLANs of the group) in channels they may use
+ * Output:
+ * - groups: WLANs of each group
+ * - single_domain: TRUE for the groups forming a single contention domain (solved with Bianchi)
+ **/
+void FindAnalyticalGroups(const AnalyticalScenario &scenario, std::vector< std::vector<int> > &groups,
+		std::vector<int> &single_domain){
+
+	int num_wlans (scenario.wlans.size());
+	std::vector<int> group_of (num_wlans, -1);
+	groups.clear();
+	single_domain.clear();
+
+	for(int w = 0; w < num_wlans; ++w){
+		if(group_of[w] >= 0) continue;
+		group_of[w] = groups.size();
+		groups.push_back(std::vector<int>(1, w));
+		std::vector<int> &group (groups.back());
+		for(size_t g = 0; g < group.size(); ++g){
+			int u (group[g]);
+			for(int v = 0; v < num_wlans; ++v){
+				if(group_of[v] >= 0) continue;
+				if((AnalyticalSenses(scenario, u, v) || AnalyticalSenses(scenario, v, u))
+					&& (AnalyticalUsableChannels(scenario, u) & AnalyticalUsableChannels(scenario, v))){
+					group_of[v] = group_of[w];
+					group.push_back(v);
+				}
+			}
+		}
+
+		// Single contention domain: same single channel and every AP senses the rest
+		unsigned int channels (AnalyticalUsableChannels(scenario, group[0]));
+		int is_single_domain (__builtin_popcount(channels) == 1);
+		for(size_t g = 0; g < group.size() && is_single_domain; ++g){
+			if(AnalyticalUsableChannels(scenario, group[g]) != channels) is_single_domain = FALSE;
+			for(size_t h = 0; h < group.size() && is_single_domain; ++h){
+				if(h != g && !AnalyticalSenses(scenario, group[g], group[h])) is_single_domain = FALSE;
+			}
+		}
+		single_domain.push_back(is_single_domain);
+	}
+}
+
+/*
+ * EstimatePerformanceAnalytically(): estimates the performance of every WLAN of the scenario
+ * Input arguments:
+ * - scenario: analytical scenario
+ * - max_states: max. number of states of a CTMN
+ * Output:
+ * - results: results of each WLAN
+ **/
+void EstimatePerformanceAnalytically(const AnalyticalScenario &scenario, int max_states,
+		std::vector<AnalyticalWlanResult> &results){
+
+	int num_wlans (scenario.wlans.size());
+	results.assign(num_wlans, AnalyticalWlanResult());
+
+	std::vector< std::vector<int> > groups;
+	std::vector<int> single_domain;
+	FindAnalyticalGroups(scenario, groups, single_domain);
+
+	int saturated (TRUE);
+	std::vector<double> activity (num_wlans, 1);
+	for(int w = 0; w < num_wlans; ++w){
+		if(scenario.wlans[w].offered_load >= 0) saturated = FALSE;
+		if(scenario.wlans[w].offered_load == 0) activity[w] = 0;
+	}
+
+	std::vector< std::vector<double> > channel_occupancy (num_wlans, std::vector<double>(scenario.num_channels, 0));
+	std::vector< std::vector<double> > external_interference (num_wlans);
+	for(int iteration = 0; iteration < ANALYTICAL_LOAD_ITERATIONS; ++iteration){
+
+		// Average interference of the other groups (transmitting in the primary channel of the WLAN)
+		std::vector<int> group_of (num_wlans);
+		for(size_t g = 0; g < groups.size(); ++g) for(size_t i = 0; i < groups[g].size(); ++i) group_of[groups[g][i]] = g;
+		for(int w = 0; w < num_wlans; ++w){
+			const AnalyticalWlan &wlan (scenario.wlans[w]);
+			external_interference[w].assign(wlan.stas.size(), 0);
+			for(int v = 0; v < num_wlans; ++v){
+				double weight (channel_occupancy[v][wlan.primary_channel]);
+				if(group_of[v] == group_of[w] || weight == 0) continue;
+				for(size_t k = 0; k < wlan.stas.size(); ++k) external_interference[w][k] += weight * wlan.stas[k].power_from_wlan[v];
+			}
+		}
+
+		std::vector< std::vector<double> > new_channel_occupancy (num_wlans,
+			std::vector<double>(scenario.num_channels, 0));
+		for(size_t g = 0; g < groups.size(); ++g){
+			if(single_domain[g]){
+				SolveBianchiGroup(scenario, groups[g], activity, external_interference, results);
+				for(size_t i = 0; i < groups[g].size(); ++i){
+					int w (groups[g][i]);
+					new_channel_occupancy[w][scenario.wlans[w].primary_channel] = results[w].occupancy;
+				}
+			} else {
+				SolveCtmnGroup(scenario, groups[g], activity, external_interference, max_states, results,
+					new_channel_occupancy);
+			}
+		}
+
+		// Offered load: the backoff of a non-saturated WLAN only runs while it has packets
+		double max_change (0);
+		for(int w = 0; w < num_wlans; ++w){
+			for(int c = 0; c < scenario.num_channels; ++c){
+				max_change = std::max(max_change, fabs(new_channel_occupancy[w][c] - channel_occupancy[w][c]));
+			}
+			if(scenario.wlans[w].offered_load > 0 && results[w].throughput > 0){
+				double new_activity (std::min(1.0, activity[w] * scenario.wlans[w].offered_load / results[w].throughput));
+				max_change = std::max(max_change, fabs(new_activity - activity[w]));
+				activity[w] = new_activity;
+			}
+		}
+		channel_occupancy.swap(new_channel_occupancy);
+		if((saturated && groups.size() == 1) || max_change < ANALYTICAL_LOAD_TOLERANCE) break;
+	}
+}
+
+#endif
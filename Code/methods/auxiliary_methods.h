@@ -124,9 +124,9 @@ void PrintOrWriteArrayInt(int *list, int list_size, int write_or_print, int save
 		}
 		case WRITE_LOG:{
 			for(int c = 0; c < list_size; ++c){
-				 if(save_node_logs)  fprintf(node_logger.file, "%d  ", list[c]);
+				 if(save_node_logs)  LogPrintf(node_logger, "%d  ", list[c]);
 			}
-			if(save_node_logs)  fprintf(node_logger.file, "\n");
+			if(save_node_logs)  LogPrintf(node_logger, "\n");
 			break;
 		}
 	}
@@ -151,9 +151,9 @@ void PrintOrWriteArrayDouble(double *list, int list_size, int write_or_print, in
 		}
 		case WRITE_LOG:{
 			for(int c = 0; c < list_size; ++c){
-				 if(save_node_logs)  fprintf(node_logger.file, "%f  ", list[c]);
+				 if(save_node_logs)  LogPrintf(node_logger, "%f  ", list[c]);
 			}
-			if(save_node_logs)  fprintf(node_logger.file, "\n");
+			if(save_node_logs)  LogPrintf(node_logger, "\n");
 			break;
 		}
 	}
@@ -215,6 +215,55 @@ double RandomDouble(double min, double max)
     return min + f * (max - min);
 }
 
+/*
+ * DrawBurstSize(): returns the number of packets carried by a new traffic burst
+ * Input arguments:
+ * - burst_size_model: distribution of the burst size (BURST_SIZE_*)
+ * - burst_size: average number of packets per burst
+ */
+int DrawBurstSize(int burst_size_model, double burst_size){
+
+	int num_packets (0);
+
+	switch(burst_size_model){
+
+		case BURST_SIZE_DETERMINISTIC:{
+			// A fractional size is drawn as its floor or its ceiling so that bursts carry burst_size packets on average
+			// - No random number is drawn for integer sizes (the sequence of draws does not change)
+			num_packets = (int) burst_size;
+			double fraction (burst_size - num_packets);
+			if(fraction > 0 && rand() < fraction * ((double) RAND_MAX + 1.0)) ++num_packets;
+			break;
+		}
+
+		case BURST_SIZE_POISSON:{
+			// Count unit-rate arrivals within an interval of length burst_size (no exp() underflow for large means)
+			// - Uniform samples are drawn in (0,1] to keep log() finite
+			double elapsed (-log((rand() + 1.0) / ((double) RAND_MAX + 1.0)));
+			while(elapsed < burst_size){
+				++num_packets;
+				elapsed = elapsed - log((rand() + 1.0) / ((double) RAND_MAX + 1.0));
+			}
+			break;
+		}
+
+		case BURST_SIZE_UNIFORM:{
+			int max_burst_size (std::max(1, (int) round(2 * burst_size) - 1));
+			num_packets = 1 + rand() % max_burst_size;
+			break;
+		}
+
+		default:{
+			printf("Burst size model not found!\n");
+			exit(EXIT_FAILURE);
+			break;
+		}
+	}
+
+	return num_packets;
+
+}
+
 double truncate_Sergio(double number, int floating_position){
 
     double x (pow(10,floating_position) * number);
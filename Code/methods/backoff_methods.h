@@ -56,82 +56,126 @@ double	Random2( double v=1.0)	{ return v*drand48();}
 int		Random2( int v)		{ return (int)(v*drand48()); }
 double	Exponential2(double mean)	{ return -mean*log(Random2());}
 
+// Backoff handlers specialized per model (selected once per node, see SelectComputeBackoff())
+typedef double (*ComputeBackoffFunction)(int cw);
+typedef double (*ComputeRemainingBackoffFunction)(double remaining_backoff);
+
 /*
- * ComputeBackoff(): computes a new backoff
- * */
-double ComputeBackoff(int pdf_backoff, int cw, int backoff_type){
+ * ComputeBackoff<pdf_backoff>_<backoff_type>(): compute a new backoff for a given pdf and backoff type
+ * Input arguments:
+ * - cw: current contention window
+ */
+double ComputeBackoffDeterministicSlotted(int cw){
+	int num_slots (rand() % cw); // Num slots in [0, CW-1]
+	return num_slots * SLOT_TIME;
+}
 
-	double backoff_time;
+double ComputeBackoffDeterministicContinuous(int cw){
 	double expected_backoff ((double) (cw-1)/2);	// [slots]
 	double lambda_backoff (1/(expected_backoff * SLOT_TIME));
+	return 1/lambda_backoff;
+}
+
+double ComputeBackoffExponentialSlotted(int cw){
+	double expected_backoff ((double) (cw-1)/2);	// [slots]
+	return round(Exponential2(expected_backoff)) * SLOT_TIME;
+}
+
+double ComputeBackoffExponentialContinuous(int cw){
+	double expected_backoff ((double) (cw-1)/2);	// [slots]
+	double lambda_backoff (1/(expected_backoff * SLOT_TIME));
+	return Exponential2(1/lambda_backoff);
+}
+
+/*
+ * SelectComputeBackoff(): returns the backoff handler corresponding to the pdf and backoff type
+ * */
+ComputeBackoffFunction SelectComputeBackoff(int pdf_backoff, int backoff_type){
+
+	if(backoff_type != BACKOFF_SLOTTED && backoff_type != BACKOFF_CONTINUOUS){
+		printf("Backoff type not found!\n");
+		exit(EXIT_FAILURE);
+	}
 
 	switch(pdf_backoff){
 
 		case PDF_DETERMINISTIC:{
-			if(backoff_type == BACKOFF_SLOTTED) {
-				int num_slots (rand() % cw); // Num slots in [0, CW-1]
-				backoff_time = num_slots * SLOT_TIME;
-				// printf("num_slots = %d\n", num_slots);
-			} else if(backoff_type == BACKOFF_CONTINUOUS) {
-				backoff_time = 1/lambda_backoff;
-			}
-			break;
+			return (backoff_type == BACKOFF_SLOTTED) ?
+				ComputeBackoffDeterministicSlotted : ComputeBackoffDeterministicContinuous;
 		}
 
 		case PDF_EXPONENTIAL:{
-			if(backoff_type == BACKOFF_SLOTTED) {
-				backoff_time = round(Exponential2(expected_backoff)) * SLOT_TIME;
-			} else if(backoff_type == BACKOFF_CONTINUOUS) {
-				backoff_time = Exponential2(1/lambda_backoff);
-			}
-			break;
+			return (backoff_type == BACKOFF_SLOTTED) ?
+				ComputeBackoffExponentialSlotted : ComputeBackoffExponentialContinuous;
 		}
 
 		default:{
 			printf("Backoff model not found!\n");
-			break;
+			exit(EXIT_FAILURE);
 		}
 	}
 
-	return backoff_time;
 }
 
 /*
- * computeRemainingBackoff(): computes the remaining backoff after some even happens
+ * ComputeBackoff(): computes a new backoff
  * */
-double ComputeRemainingBackoff(int backoff_type, double remaining_backoff){
+double ComputeBackoff(int pdf_backoff, int cw, int backoff_type){
+
+	return SelectComputeBackoff(pdf_backoff, backoff_type)(cw);
+
+}
+
+/*
+ * ComputeRemainingBackoff<backoff_type>(): compute the remaining backoff after some event happens
+ * */
+double ComputeRemainingBackoffSlotted(double remaining_backoff){
+
+	int closest_slot (round(remaining_backoff / SLOT_TIME));
+	if(fabs(remaining_backoff - closest_slot * SLOT_TIME) < MAX_DIFFERENCE_SAME_TIME){
+		return closest_slot * SLOT_TIME;
+	} else {
+		return ceil(remaining_backoff/SLOT_TIME) * SLOT_TIME;
+	}
+
+}
 
-//	printf("remaining_backoff = %f\n", remaining_backoff);
+double ComputeRemainingBackoffContinuous(double remaining_backoff){
 
-	double updated_remaining_backoff;
+	return remaining_backoff;
+
+}
+
+/*
+ * SelectComputeRemainingBackoff(): returns the remaining backoff handler corresponding to the backoff type
+ * */
+ComputeRemainingBackoffFunction SelectComputeRemainingBackoff(int backoff_type){
 
 	switch(backoff_type){
 
 		case BACKOFF_SLOTTED: {
-			int closest_slot (round(remaining_backoff / SLOT_TIME));
-//			printf("- closest_slot = %d\n", closest_slot);
-			if(fabs(remaining_backoff - closest_slot * SLOT_TIME) < MAX_DIFFERENCE_SAME_TIME){
-				updated_remaining_backoff = closest_slot * SLOT_TIME;
-			} else {
-				updated_remaining_backoff = ceil(remaining_backoff/SLOT_TIME) * SLOT_TIME;
-			}
-			break;
+			return ComputeRemainingBackoffSlotted;
 		}
 
 		case BACKOFF_CONTINUOUS: {
-			updated_remaining_backoff = remaining_backoff;
-			break;
+			return ComputeRemainingBackoffContinuous;
 		}
 
 		default:{
 			printf("Backoff type not found!\n");
 			exit(EXIT_FAILURE);
-			break;
 		}
 
 	}
 
-	return updated_remaining_backoff;
+}
+
+/*
+ * computeRemainingBackoff(): computes the remaining backoff after some even happens
+ * */
+double ComputeRemainingBackoff(int backoff_type, double remaining_backoff){
+
+	return SelectComputeRemainingBackoff(backoff_type)(remaining_backoff);
 
 }
 
@@ -167,45 +211,69 @@ int HandleBackoff(int pause_or_resume, double **channel_power, int primary_chann
 
 }
 
+// Contention window handler specialized per cw_adaptation (selected once per node, see SelectContentionWindowHandler())
+typedef void (*HandleContentionWindowFunction)(int increase_or_reset, int* cw_current, int cw_min,
+	int *cw_stage_current, int cw_stage_max);
+
 /*
- * HandleCongestionWindow(): increase or decrease the contention window.
+ * HandleContentionWindowConstant(): constant CW (cw_adaptation == FALSE)
+ * - do nothing: keep cw
  **/
-void HandleContentionWindow(int cw_adaptation, int increase_or_reset, int* cw_current, int cw_min,
+void HandleContentionWindowConstant(int increase_or_reset, int* cw_current, int cw_min,
 		int *cw_stage_current, int cw_stage_max) {
 
-	// CW adaptation: http://article.sapub.org/pdf/10.5923.j.jwnc.20130301.01.pdf
+}
 
-	if(cw_adaptation == TRUE){
+/*
+ * HandleContentionWindowBeb(): binary exponential backoff (cw_adaptation == TRUE)
+ **/
+void HandleContentionWindowBeb(int increase_or_reset, int* cw_current, int cw_min,
+		int *cw_stage_current, int cw_stage_max) {
 
-		switch(increase_or_reset) {
+	// CW adaptation: http://article.sapub.org/pdf/10.5923.j.jwnc.20130301.01.pdf
 
-			case INCREASE_CW:{
-				if(*cw_stage_current < cw_stage_max){
-					*cw_stage_current = *cw_stage_current + 1;
-					*cw_current = cw_min * pow(2, *cw_stage_current);
-				}
-				break;
-			}
+	switch(increase_or_reset) {
 
-			case RESET_CW:{
-				*cw_stage_current = 0;
-				*cw_current = cw_min;
-				break;
+		case INCREASE_CW:{
+			if(*cw_stage_current < cw_stage_max){
+				*cw_stage_current = *cw_stage_current + 1;
+				*cw_current = cw_min * pow(2, *cw_stage_current);
 			}
+			break;
+		}
 
-			default:{
-				printf("Unknown operation on contention window!");
-				exit(EXIT_FAILURE);
-				break;
-			}
+		case RESET_CW:{
+			*cw_stage_current = 0;
+			*cw_current = cw_min;
+			break;
+		}
 
+		default:{
+			printf("Unknown operation on contention window!");
+			exit(EXIT_FAILURE);
+			break;
 		}
 
-	} else {
+	}
 
-		// Constant CW
-		// - do nothing: keep cw
+}
 
-	}
+/*
+ * SelectContentionWindowHandler(): returns the contention window handler of the CW adaptation
+ **/
+HandleContentionWindowFunction SelectContentionWindowHandler(int cw_adaptation){
+
+	return (cw_adaptation == TRUE) ? HandleContentionWindowBeb : HandleContentionWindowConstant;
+
+}
+
+/*
+ * HandleCongestionWindow(): increase or decrease the contention window.
+ **/
+void HandleContentionWindow(int cw_adaptation, int increase_or_reset, int* cw_current, int cw_min,
+		int *cw_stage_current, int cw_stage_max) {
+
+	SelectContentionWindowHandler(cw_adaptation)(increase_or_reset, cw_current, cw_min,
+		cw_stage_current, cw_stage_max);
 
 }
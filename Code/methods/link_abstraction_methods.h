@@ -0,0 +1,239 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file contains the link abstraction layer: per-MCS and per-bandwidth SINR-to-PER tables
+ *   used by the CE_LINK_ABSTRACTION capture effect model
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#include "../list_of_macros.h"
+#include "../structures/modulations.h"
+
+#ifndef _LINK_ABSTRACTION_METHODS_
+#define _LINK_ABSTRACTION_METHODS_
+
+/*
+ * ComputeBerAwgn(): bit error rate of a modulation in an AWGN channel (Gray-coded, uncoded)
+ * Input arguments:
+ * - sinr: SINR per subcarrier [linear ratio]
+ * - modulation: MCS index (MODULATION_BPSK_1_2 to MODULATION_1024QAM_5_6)
+ */
+double ComputeBerAwgn(double sinr, int modulation){
+
+	int bits_per_symbol (Mcs_array::modulation_bits[modulation-1]);
+
+	if(bits_per_symbol == 1) {
+		// BPSK: Q(sqrt(2*SINR))
+		return 0.5 * erfc(sqrt(sinr));
+	} else {
+		// M-QAM: 4/log2(M) * (1 - 1/sqrt(M)) * Q(sqrt(3*SINR/(M-1)))
+		double m (pow(2, bits_per_symbol));
+		double ber ((4.0 / bits_per_symbol) * (1 - 1/sqrt(m)) * 0.5 * erfc(sqrt(3 * sinr / (2 * (m - 1)))));
+		return std::min(ber, 0.5);
+	}
+
+}
+
+/*
+ * ComputeCodingGain(): SINR gain of the binary convolutional code (K = 7) of an MCS with soft-decision
+ * Viterbi decoding, approximated by its asymptotic coding gain R * d_free (d_free = 10, 6, 5 and 4 for the
+ * 1/2 mother code and its 2/3, 3/4 and 5/6 puncturings). MCSs sharing a modulation are thus told apart.
+ * Input arguments:
+ * - modulation: MCS index (MODULATION_BPSK_1_2 to MODULATION_1024QAM_5_6)
+ * Output:
+ * - coding gain [linear ratio]
+ */
+double ComputeCodingGain(int modulation){
+
+	double coding_rate (Mcs_array::coding_rates[modulation-1]);
+	int free_distance;
+	if(coding_rate <= 1/double(2)) {
+		free_distance = 10;
+	} else if(coding_rate <= 2/double(3)) {
+		free_distance = 6;
+	} else if(coding_rate <= 3/double(4)) {
+		free_distance = 5;
+	} else {
+		free_distance = 4;
+	}
+	return coding_rate * free_distance;
+
+}
+
+/*
+ * LinkAbstraction: SINR-to-PER tables per MCS and number of channels (1, 2, 4 or 8), sampled in a
+ * uniform SINR grid [dB] so that GetPer() is an O(1) interpolated lookup.
+ */
+struct LinkAbstraction {
+
+	int num_points;				// Number of SINR points per table
+	std::vector<double> per;	// PER tables [ix_num_channels][mcs-1][sinr point]
+
+	int TableIndex(int ix_num_channels, int modulation) {
+		return (ix_num_channels * NUM_MODULATIONS + modulation - 1) * num_points;
+	}
+
+	/*
+	 * Generate(): fills every table with the analytical AWGN PER of a frame (uncoded BER of the modulation
+	 * at the SINR shifted by the coding gain of the MCS)
+	 * Input arguments:
+	 * - frame_length: length of the frame to be decoded [bits]
+	 */
+	void Generate(int frame_length) {
+
+		num_points = (int) round((PER_TABLE_SINR_MAX_DB - PER_TABLE_SINR_MIN_DB) / PER_TABLE_SINR_STEP_DB) + 1;
+		per.assign(NUM_OPTIONS_CHANNEL_LENGTH * NUM_MODULATIONS * num_points, 1);
+
+		for(int m = MODULATION_BPSK_1_2; m <= NUM_MODULATIONS; ++m) {
+			double coding_gain (ComputeCodingGain(m));
+			for(int i = 0; i < num_points; ++i) {
+				double sinr_db (PER_TABLE_SINR_MIN_DB + i * PER_TABLE_SINR_STEP_DB);
+				double ber (ComputeBerAwgn(coding_gain * pow(10, sinr_db/10), m));
+				// PER = 1 - (1 - BER)^L (log1p keeps precision for tiny BER)
+				double per_value (1 - exp(frame_length * log1p(-ber)));
+				// Same SINR-to-PER relation for any bandwidth (SINR is measured over the whole TX band)
+				for(int ix_ch = 0; ix_ch < NUM_OPTIONS_CHANNEL_LENGTH; ++ix_ch) {
+					per[TableIndex(ix_ch, m) + i] = per_value;
+				}
+			}
+		}
+	}
+
+	/*
+	 * LoadFromFile(): overwrites the tables given in a CSV file (e.g. link-level simulation results).
+	 * Format: one header line and then 'mcs;num_channels;sinr_db;per' lines, sorted by SINR for each
+	 * (mcs, num_channels) pair. Tables not present in the file keep their generated values.
+	 * Input arguments:
+	 * - filename: PER tables filename
+	 */
+	void LoadFromFile(const char *filename) {
+
+		FILE* stream_per = fopen(filename, "r");
+		if (!stream_per){
+			printf("PER tables file '%s' not found!\n", filename);
+			exit(-1);
+		}
+
+		// Points read per table (SINR [dB], PER)
+		std::vector<double> sinr_points[NUM_OPTIONS_CHANNEL_LENGTH][NUM_MODULATIONS];
+		std::vector<double> per_points[NUM_OPTIONS_CHANNEL_LENGTH][NUM_MODULATIONS];
+
+		char line_per[CHAR_BUFFER_SIZE];
+		int line_ix (0);
+		while (fgets(line_per, CHAR_BUFFER_SIZE, stream_per)){
+			++line_ix;
+			if(line_ix == 1) continue;	// Skip informative header line
+			int modulation, num_channels;
+			double sinr_db, per_value;
+			if(sscanf(line_per, "%d;%d;%lf;%lf", &modulation, &num_channels, &sinr_db, &per_value) != 4) continue;
+			int ix_ch ((num_channels > 0) ? (int) log2(num_channels) : -1);
+			if(modulation < MODULATION_BPSK_1_2 || modulation > NUM_MODULATIONS || ix_ch < 0
+				|| ix_ch >= NUM_OPTIONS_CHANNEL_LENGTH || (1 << ix_ch) != num_channels
+				|| per_value < 0 || per_value > 1
+				|| (!sinr_points[ix_ch][modulation-1].empty() && sinr_db <= sinr_points[ix_ch][modulation-1].back())) {
+				printf("\nERROR: wrong entry in PER tables file '%s' (line %d)\n\n", filename, line_ix);
+				exit(-1);
+			}
+			sinr_points[ix_ch][modulation-1].push_back(sinr_db);
+			per_points[ix_ch][modulation-1].push_back(per_value);
+		}
+		fclose(stream_per);
+
+		// Resample the points read into the uniform SINR grid (PER is held constant beyond the points)
+		for(int ix_ch = 0; ix_ch < NUM_OPTIONS_CHANNEL_LENGTH; ++ix_ch) {
+			for(int m = MODULATION_BPSK_1_2; m <= NUM_MODULATIONS; ++m) {
+				std::vector<double> &x = sinr_points[ix_ch][m-1];
+				std::vector<double> &y = per_points[ix_ch][m-1];
+				if(x.empty()) continue;
+				size_t k (0);
+				for(int i = 0; i < num_points; ++i) {
+					double sinr_db (PER_TABLE_SINR_MIN_DB + i * PER_TABLE_SINR_STEP_DB);
+					while(k + 1 < x.size() && x[k + 1] <= sinr_db) ++k;
+					double per_value;
+					if(sinr_db <= x.front()) {
+						per_value = y.front();
+					} else if(k + 1 >= x.size()) {
+						per_value = y.back();
+					} else {
+						per_value = y[k] + (y[k+1] - y[k]) * (sinr_db - x[k]) / (x[k+1] - x[k]);
+					}
+					per[TableIndex(ix_ch, m) + i] = per_value;
+				}
+			}
+		}
+	}
+
+	/*
+	 * GetPer(): returns the PER for a given SINR, linearly interpolated between the two closest points
+	 * Input arguments:
+	 * - modulation: MCS index used in the transmission
+	 * - ix_num_channels: log2 of the number of channels used in the transmission
+	 * - sinr: SINR [linear ratio]
+	 */
+	double GetPer(int modulation, int ix_num_channels, double sinr) {
+
+		double position ((10 * log10(sinr) - PER_TABLE_SINR_MIN_DB) / PER_TABLE_SINR_STEP_DB);
+		const double *table (&per[TableIndex(ix_num_channels, modulation)]);
+
+		if(!(position > 0)) return table[0];	// Also catches NaN and -inf (zero SINR)
+		if(position >= num_points - 1) return table[num_points - 1];
+
+		int i ((int) position);
+		double weight (position - i);
+		return table[i] + weight * (table[i+1] - table[i]);
+
+	}
+
+};
+
+// Link abstraction shared by all the nodes (built in Komondor::Setup() when CE_LINK_ABSTRACTION is used)
+LinkAbstraction link_abstraction;
+
+#endif
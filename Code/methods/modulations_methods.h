@@ -52,6 +52,9 @@
 
 #include "../list_of_macros.h"
 
+// Min. power received [dBm] for using each MCS in 1 channel (+3 dB every time the number of channels is doubled)
+const double mcs_min_power_rx_dbm[NUM_MODULATIONS] = {-82, -79, -77, -74, -70, -66, -65, -64, -59, -57, -54, -52};
+
 /*
  * SelectMCSResponse(): select the proper MCS of transmitter per number of channels
  **/
@@ -59,21 +62,16 @@ void SelectMCSResponse(int *mcs_response, double power_rx_interest) {
 
 	double pw_rx_intereset_dbm (ConvertPower(PW_TO_DBM, power_rx_interest));
 
-	for ( int ch_num_ix = 0; ch_num_ix < 4; ++ ch_num_ix ){	// For 1, 2, 4 and 8 channels
-
-		if(pw_rx_intereset_dbm < -82 +(ch_num_ix*3)){ mcs_response[ch_num_ix] = MODULATION_FORBIDDEN; }
-		else if (pw_rx_intereset_dbm >= -82 + (ch_num_ix*3) && pw_rx_intereset_dbm < -79 +(ch_num_ix*3)){mcs_response[ch_num_ix] = MODULATION_BPSK_1_2;}
-		else if (pw_rx_intereset_dbm >= -79 + (ch_num_ix*3) && pw_rx_intereset_dbm < -77 +(ch_num_ix*3)){mcs_response[ch_num_ix] = MODULATION_QPSK_1_2;}
-		else if (pw_rx_intereset_dbm >= -77 + (ch_num_ix*3) && pw_rx_intereset_dbm < -74 +(ch_num_ix*3)){mcs_response[ch_num_ix] = MODULATION_QPSK_3_4;}
-		else if (pw_rx_intereset_dbm >= -74 + (ch_num_ix*3) && pw_rx_intereset_dbm < -70 +(ch_num_ix*3)){mcs_response[ch_num_ix] = MODULATION_16QAM_1_2;}
-		else if (pw_rx_intereset_dbm >= -70 + (ch_num_ix*3) && pw_rx_intereset_dbm < -66 +(ch_num_ix*3)){mcs_response[ch_num_ix] = MODULATION_16QAM_3_4;}
-		else if (pw_rx_intereset_dbm >= -66 + (ch_num_ix*3) && pw_rx_intereset_dbm < -65 +(ch_num_ix*3)){mcs_response[ch_num_ix] = MODULATION_64QAM_2_3;}
-		else if (pw_rx_intereset_dbm >= -65 + (ch_num_ix*3) && pw_rx_intereset_dbm < -64 +(ch_num_ix*3)){mcs_response[ch_num_ix] = MODULATION_64QAM_3_4;}
-		else if (pw_rx_intereset_dbm >= -64 + (ch_num_ix*3) && pw_rx_intereset_dbm < -59 +(ch_num_ix*3)){mcs_response[ch_num_ix] = MODULATION_64QAM_5_6;}
-		else if (pw_rx_intereset_dbm >= -59 + (ch_num_ix*3) && pw_rx_intereset_dbm < -57 +(ch_num_ix*3)){mcs_response[ch_num_ix] = MODULATION_256QAM_3_4;}
-		else if (pw_rx_intereset_dbm >= -57 + (ch_num_ix*3) && pw_rx_intereset_dbm < -54 +(ch_num_ix*3)){mcs_response[ch_num_ix] = MODULATION_256QAM_5_6;}
-		else if (pw_rx_intereset_dbm >= -54 + (ch_num_ix*3) && pw_rx_intereset_dbm < -52 +(ch_num_ix*3)){mcs_response[ch_num_ix] = MODULATION_1024QAM_3_4;}
-		else { mcs_response[ch_num_ix] = MODULATION_1024QAM_5_6;}
+	for ( int ch_num_ix = 0; ch_num_ix < NUM_OPTIONS_CHANNEL_LENGTH; ++ ch_num_ix ){	// For 1, 2, 4 and 8 channels
+
+		// Highest MCS whose threshold is reached (thresholds are sorted in ascending order)
+		int num_thresholds_reached (0);
+		while(num_thresholds_reached < NUM_MODULATIONS
+			&& pw_rx_intereset_dbm >= mcs_min_power_rx_dbm[num_thresholds_reached] + (ch_num_ix*3)){
+			++num_thresholds_reached;
+		}
+
+		mcs_response[ch_num_ix] = (num_thresholds_reached == 0) ? MODULATION_FORBIDDEN : num_thresholds_reached;
 	}
 }
 
@@ -167,7 +165,7 @@ double ComputeEbToNoise(double sinr, double bit_rate, int badnwidth, int modulat
 //		PER = 1 - pow((1 - BER), notification.packet_length);
 //		is_packet_lost =  ((double) rand() / (RAND_MAX)) < PER;
 //
-//		if(save_node_logs && is_packet_lost) fprintf(node_logger.file, "%f;N%d;S%d;%s;%s Packet has been lost: Modulation used = %d, BER = %f, PER = %f\n",
+//		if(save_node_logs && is_packet_lost) LogPrintf(node_logger, "%f;N%d;S%d;%s;%s Packet has been lost: Modulation used = %d, BER = %f, PER = %f\n",
 //				SimTime(), node_id, node_state, LOG_F00, LOG_LVL5, current_modulation, BER, PER);
 //
 //	}
@@ -48,8 +48,10 @@
 
 #include <math.h>
 #include <algorithm>
+#include <map>
 #include <stddef.h>
 #include "../list_of_macros.h"
+#include "link_abstraction_methods.h"
 
 /*
  * GenerateLogicalNack: generates a logical NACK
@@ -86,7 +88,7 @@ int ProcessNack(LogicalNack logical_nack, int node_id, Logger node_logger, int n
 
 	if(node_a == node_id ||  node_b == node_id){		// If node IMPLIED in the NACK
 
-//		if(save_node_logs) fprintf(node_logger.file,
+//		if(save_node_logs) LogPrintf(node_logger, 
 //				"%.12f;N%d;S%d;%s;%s I am implied in the NACK with packet id #%d\n",
 //				sim_time, node_id, node_state, LOG_H02, LOG_LVL2, logical_nack.packet_id);
 
@@ -97,7 +99,7 @@ int ProcessNack(LogicalNack logical_nack, int node_id, Logger node_logger, int n
 
 			case PACKET_LOST_DESTINATION_TX:{	// Destination was already transmitting when the packet transmission was attempted
 
-				if(save_node_logs) fprintf(node_logger.file, "%.12f;N%d;S%d;%s;%s Destination N%d was transmitting!s\n",
+				if(save_node_logs) LogPrintf(node_logger, "%.12f;N%d;S%d;%s;%s Destination N%d was transmitting!s\n",
 						sim_time, node_id, node_state, LOG_H02, LOG_LVL2, logical_nack.source_id);
 
 //				// Add receiver to hidden nodes list ("I was not listening to him!")
@@ -110,7 +112,7 @@ int ProcessNack(LogicalNack logical_nack, int node_id, Logger node_logger, int n
 
 			case PACKET_LOST_LOW_SIGNAL:{	// Signal strength is not enough to be decoded (less than capture effect)
 
-				if(save_node_logs) fprintf(node_logger.file,
+				if(save_node_logs) LogPrintf(node_logger, 
 						"%.12f;N%d;S%d;%s;%s Power received in destination N%d is less than the required capture effect!\n",
 						sim_time, node_id, node_state, LOG_H02, LOG_LVL2, logical_nack.source_id);
 
@@ -121,7 +123,7 @@ int ProcessNack(LogicalNack logical_nack, int node_id, Logger node_logger, int n
 
 			case PACKET_LOST_INTERFERENCE:{ 	// There are interference signals making node not comply with the capture effect
 
-				if(save_node_logs) fprintf(node_logger.file,
+				if(save_node_logs) LogPrintf(node_logger, 
 					"%.12f;N%d;S%d;%s;%s High interferences sensed in destination N%d (capture effect not accomplished)!\n",
 					sim_time, node_id, node_state, LOG_H02, LOG_LVL2, logical_nack.source_id);
 
@@ -143,7 +145,7 @@ int ProcessNack(LogicalNack logical_nack, int node_id, Logger node_logger, int n
 
 			case PACKET_LOST_PURE_COLLISION:{	// Two nodes transmitting to same destination with signal strengths enough to be decoded
 
-				if(save_node_logs) fprintf(node_logger.file,
+				if(save_node_logs) LogPrintf(node_logger, 
 					"%.12f;N%d;S%d;%s;%s Pure collision detected at destination %d! %d was transmitting and %d appeared\n",
 					sim_time, node_id, node_state, LOG_H02, LOG_LVL2, logical_nack.source_id,
 					node_a, node_b);
@@ -165,7 +167,7 @@ int ProcessNack(LogicalNack logical_nack, int node_id, Logger node_logger, int n
 				// Only node_id_a has lost the packet, so that node_id_b is his hidden node
 				if(node_a == node_id) {
 
-					if(save_node_logs) fprintf(node_logger.file,
+					if(save_node_logs) LogPrintf(node_logger, 
 						"%.12f;N%d;S%d;%s;%s Destination N%d already receiving from N%d and N%d transmitted with not enough"
 						" power to be decoded\n",
 						sim_time, node_id, node_state, LOG_H02, LOG_LVL2, logical_nack.source_id, node_a, node_b);
@@ -181,7 +183,7 @@ int ProcessNack(LogicalNack logical_nack, int node_id, Logger node_logger, int n
 
 			case PACKET_LOST_SINR_PROB:{	// Packet lost due to SINR probability (deprecated)
 
-				if(save_node_logs) fprintf(node_logger.file, "%.12f;N%d;S%d;%s;%s Packet lost due constant PER or due to the BER (%f) "
+				if(save_node_logs) LogPrintf(node_logger, "%.12f;N%d;S%d;%s;%s Packet lost due constant PER or due to the BER (%f) "
 					"associated to the current SINR (%f dB)\n", sim_time, node_id, node_state, LOG_H02, LOG_LVL2,
 					logical_nack.ber, ConvertPower(LINEAR_TO_DB, logical_nack.sinr));
 
@@ -191,7 +193,7 @@ int ProcessNack(LogicalNack logical_nack, int node_id, Logger node_logger, int n
 			}
 
 			case PACKET_LOST_RX_IN_NAV:{			// Packet lost because node was in NAV
-				if(save_node_logs) fprintf(node_logger.file, "%.12f;N%d;S%d;%s;%s Packet lost due to STA was in NAV\n",
+				if(save_node_logs) LogPrintf(node_logger, "%.12f;N%d;S%d;%s;%s Packet lost due to STA was in NAV\n",
 					sim_time, node_id, node_state, LOG_H02, LOG_LVL2);
 
 				reason = PACKET_LOST_RX_IN_NAV;
@@ -200,7 +202,7 @@ int ProcessNack(LogicalNack logical_nack, int node_id, Logger node_logger, int n
 			}
 
 			case PACKET_LOST_BO_COLLISION:{
-				if(save_node_logs) fprintf(node_logger.file, "%.12f;N%d;S%d;%s;%s Packet lost due to Slotted Backoff\n",
+				if(save_node_logs) LogPrintf(node_logger, "%.12f;N%d;S%d;%s;%s Packet lost due to Slotted Backoff\n",
 						sim_time, node_id, node_state, LOG_H02, LOG_LVL2);
 
 				reason = PACKET_LOST_BO_COLLISION;
@@ -213,7 +215,7 @@ int ProcessNack(LogicalNack logical_nack, int node_id, Logger node_logger, int n
 //				printf("%.12f;N%d;S%d;%s;%s AP is sending packets outside STAs range!\n",
 //						sim_time, node_id, node_state, LOG_H02, LOG_LVL2);
 
-				if(save_node_logs) fprintf(node_logger.file, "%.12f;N%d;S%d;%s;%s AP is sending packets outside STAs range!\n",
+				if(save_node_logs) LogPrintf(node_logger, "%.12f;N%d;S%d;%s;%s AP is sending packets outside STAs range!\n",
 						sim_time, node_id, node_state, LOG_H02, LOG_LVL2);
 
 				reason = PACKET_LOST_LOW_SIGNAL_AND_RX;
@@ -224,7 +226,7 @@ int ProcessNack(LogicalNack logical_nack, int node_id, Logger node_logger, int n
 
 			case PACKET_LOST_CAPTURE_EFFECT: {
 
-				if(save_node_logs) fprintf(node_logger.file, "%.12f;N%d;S%d;%s;%s Packet lost by Capture Effect!\n",
+				if(save_node_logs) LogPrintf(node_logger, "%.12f;N%d;S%d;%s;%s Packet lost by Capture Effect!\n",
 						sim_time, node_id, node_state, LOG_H02, LOG_LVL2);
 
 				reason = PACKET_LOST_CAPTURE_EFFECT;
@@ -236,7 +238,7 @@ int ProcessNack(LogicalNack logical_nack, int node_id, Logger node_logger, int n
 
 			default:{
 
-				if(save_node_logs) fprintf(node_logger.file, "%.12f;N%d;S%d;%s;%s Unknown reason for packet loss\n",
+				if(save_node_logs) LogPrintf(node_logger, "%.12f;N%d;S%d;%s;%s Unknown reason for packet loss\n",
 						sim_time, node_id, node_state, LOG_H02, LOG_LVL2);
 				exit(EXIT_FAILURE);
 				break;
@@ -245,7 +247,7 @@ int ProcessNack(LogicalNack logical_nack, int node_id, Logger node_logger, int n
 		}
 
 	} else {	// If node NOT IMPLIED in the NACK, do nothing
-//		if(save_node_logs) fprintf(node_logger.file, "%f;N%d;S%d;%s;%s I am NOT implied in the NACK\n",
+//		if(save_node_logs) LogPrintf(node_logger, "%f;N%d;S%d;%s;%s I am NOT implied in the NACK\n",
 //				sim_time, node_id, node_state, LOG_H02, LOG_LVL2);
 	}
 
@@ -317,68 +319,231 @@ int AttemptToDecodePacket(double sinr, double capture_effect, double pd,
 	return packet_lost;
 }
 
+// Packet loss handler specialized per capture effect model (see SelectCaptureEffectModel())
+typedef int (*IsPacketLostFunction)(int primary_channel, const Notification &incoming_notification,
+	const Notification &new_notification, double sinr, double capture_effect, double pd,
+	double power_rx_interest, double constant_per, int node_id);
+
 /*
- * IsPacketLost(): computes notification loss according to SINR received
+ * IsPacketLostCeDefault(): computes notification loss according to SINR received (CE_DEFAULT)
  **/
-int IsPacketLost(int primary_channel, Notification incoming_notification, Notification new_notification,
-		double sinr, double capture_effect, double pd, double power_rx_interest, double constant_per,
-		int node_id, int capture_effect_model){
+int IsPacketLostCeDefault(int primary_channel, const Notification &incoming_notification,
+		const Notification &new_notification, double sinr, double capture_effect, double pd,
+		double power_rx_interest, double constant_per, int node_id){
 
 	int loss_reason (PACKET_NOT_LOST);
 	int is_packet_lost;	// Determines if the current notification has been lost (1) or not (0)
 
-	switch(capture_effect_model) {
+	// Sergio on 25 Oct 2017:
+	// - Change the way packets are determined are lost
+	// - Use both incoming (interest) and new (sometimes noisy) notifications
+	// - We were missing some cases. E.g. when RX_DATA and new packet arrived
 
-		case CE_DEFAULT: {
+	// Check if incoming notification (of interest) involves the primary channel
+	if(primary_channel >= incoming_notification.left_channel && primary_channel <= incoming_notification.right_channel){
 
-			// Sergio on 25 Oct 2017:
-			// - Change the way packets are determined are lost
-			// - Use both incoming (interest) and new (sometimes noisy) notifications
-			// - We were missing some cases. E.g. when RX_DATA and new packet arrived
-
-			// Check if incoming notification (of interest) involves the primary channel
-			if(primary_channel >= incoming_notification.left_channel && primary_channel <= incoming_notification.right_channel){
-
-				// Attempt to decode (or continue decoding) the notification of interest
-				is_packet_lost = AttemptToDecodePacket(sinr, capture_effect, pd, power_rx_interest, constant_per, node_id,
-					new_notification.packet_type, new_notification.destination_id);
-
-				if (is_packet_lost) {	// Incoming packet is lost
-					if (power_rx_interest < pd) {	// Signal strength is not enough (< pd) to be decoded
-						loss_reason = PACKET_LOST_LOW_SIGNAL;
-//						hidden_nodes_list[new_notification.source_id] = TRUE;
-					} else if (sinr < capture_effect){	// Capture effect not accomplished
-						loss_reason = PACKET_LOST_INTERFERENCE;
-					} else {	// Incoming packet lost due to PER
-						loss_reason = PACKET_LOST_SINR_PROB;
-					}
-				}
+		// Attempt to decode (or continue decoding) the notification of interest
+		is_packet_lost = AttemptToDecodePacket(sinr, capture_effect, pd, power_rx_interest, constant_per, node_id,
+			new_notification.packet_type, new_notification.destination_id);
 
-			} else{
+		if (is_packet_lost) {	// Incoming packet is lost
+			if (power_rx_interest < pd) {	// Signal strength is not enough (< pd) to be decoded
+				loss_reason = PACKET_LOST_LOW_SIGNAL;
+//				hidden_nodes_list[new_notification.source_id] = TRUE;
+			} else if (sinr < capture_effect){	// Capture effect not accomplished
+				loss_reason = PACKET_LOST_INTERFERENCE;
+			} else {	// Incoming packet lost due to PER
+				loss_reason = PACKET_LOST_SINR_PROB;
+			}
+		}
 
-				loss_reason = PACKET_LOST_OUTSIDE_CH_RANGE;
+	} else{
 
-			}
+		loss_reason = PACKET_LOST_OUTSIDE_CH_RANGE;
+
+	}
+
+	return loss_reason;
+
+}
+
+/*
+ * IsPacketLostCeIeee80211(): computes notification loss according to the RSSI (CE_IEEE_802_11)
+ **/
+int IsPacketLostCeIeee80211(int primary_channel, const Notification &incoming_notification,
+		const Notification &new_notification, double sinr, double capture_effect, double pd,
+		double power_rx_interest, double constant_per, int node_id){
+
+	// Check if the RSSI is higher than the CST
+	if (power_rx_interest > pd) {
+		// The packet can be properly decoded
+		return -1;
+	} else {
+		return PACKET_LOST_LOW_SIGNAL;
+	}
+
+}
+
+/*
+ * IsPacketLostLinkAbstraction(): computes notification loss as CE_DEFAULT, but DATA frames addressed to
+ * the node are decoded according to the SINR-to-PER tables of the MCS and bandwidth used (CE_LINK_ABSTRACTION)
+ **/
+int IsPacketLostLinkAbstraction(int primary_channel, const Notification &incoming_notification,
+		const Notification &new_notification, double sinr, double capture_effect, double pd,
+		double power_rx_interest, double constant_per, int node_id){
+
+	// Control frames (legacy rates) and frames not addressed to the node keep the capture effect threshold.
+	// The lookup is keyed off the frame being decoded (incoming), not off the interferer (new)
+	if(incoming_notification.packet_type != PACKET_TYPE_DATA || incoming_notification.destination_id != node_id
+		|| incoming_notification.modulation_id < MODULATION_BPSK_1_2) {
+		return IsPacketLostCeDefault(primary_channel, incoming_notification, new_notification, sinr,
+			capture_effect, pd, power_rx_interest, constant_per, node_id);
+	}
+
+	// Check if incoming notification (of interest) involves the primary channel
+	if(primary_channel < incoming_notification.left_channel || primary_channel > incoming_notification.right_channel){
+		return PACKET_LOST_OUTSIDE_CH_RANGE;
+	}
+
+	// Signal strength is not enough (< pd) to be decoded
+	if(power_rx_interest < pd) return PACKET_LOST_LOW_SIGNAL;
+
+	int ix_num_channels ((int) log2(incoming_notification.right_channel - incoming_notification.left_channel + 1));
+	double per (link_abstraction.GetPer(incoming_notification.modulation_id, ix_num_channels, sinr));
+
+	if(((double) rand() / (RAND_MAX)) < per) return PACKET_LOST_SINR_PROB;
+
+	return PACKET_NOT_LOST;
+
+}
+
+// Capture outcome handlers specialized per capture effect model (see SelectCaptureEffectModel()). Input arguments:
+// - loss_reason: loss reason of the ongoing reception (returned by the IsPacketLostFunction)
+// - packet_type: type of the new frame
+// - power_received_per_node: power received from each transmitter [pW] (only read by the CE_IEEE_802_11 handlers)
+// - new_source_id, ongoing_source_id: transmitters of the new and of the ongoing frames
+typedef int (*CaptureOutcomeFunction)(int loss_reason, int packet_type,
+	const std::map<int, double> &power_received_per_node, int new_source_id, int ongoing_source_id,
+	double capture_effect);
+
+/*
+ * CaptureMarginExceeded(): returns TRUE if the new frame is received with more than the capture effect
+ * margin over the ongoing one (the power of an unknown transmitter is 0)
+ **/
+int CaptureMarginExceeded(const std::map<int, double> &power_received_per_node, int new_source_id,
+		int ongoing_source_id, double capture_effect){
+
+	std::map<int, double>::const_iterator power_new (power_received_per_node.find(new_source_id));
+	std::map<int, double>::const_iterator power_ongoing (power_received_per_node.find(ongoing_source_id));
+	return (power_new != power_received_per_node.end() ? power_new->second : 0)
+		> (power_ongoing != power_received_per_node.end() ? power_ongoing->second : 0) + capture_effect;
+
+}
+
+/*
+ * CaptureAsDestinationCeDefault(): outcome of a frame addressed to the node arriving while it is
+ * receiving another one (CE_DEFAULT and CE_LINK_ABSTRACTION). Both frames collide if the ongoing one is lost.
+ **/
+int CaptureAsDestinationCeDefault(int loss_reason, int packet_type,
+		const std::map<int, double> &power_received_per_node, int new_source_id, int ongoing_source_id,
+		double capture_effect){
 
-			break;
+	if(loss_reason != PACKET_NOT_LOST && loss_reason != PACKET_LOST_OUTSIDE_CH_RANGE) return CAPTURE_COLLISION;
+	return CAPTURE_NONE;
+
+}
+
+/*
+ * CaptureAsDestinationCeIeee80211(): as CaptureAsDestinationCeDefault(), but a frame received with enough
+ * margin over the ongoing one captures the receiver (RTS) or collides with it (CE_IEEE_802_11)
+ **/
+int CaptureAsDestinationCeIeee80211(int loss_reason, int packet_type,
+		const std::map<int, double> &power_received_per_node, int new_source_id, int ongoing_source_id,
+		double capture_effect){
+
+	if(loss_reason == PACKET_NOT_LOST
+		&& CaptureMarginExceeded(power_received_per_node, new_source_id, ongoing_source_id, capture_effect)) {
+		return (packet_type == PACKET_TYPE_RTS) ? CAPTURE_SWITCH : CAPTURE_COLLISION;
+	}
+	return CAPTURE_NONE;
+
+}
+
+/*
+ * CaptureAsInterfererCeDefault(): outcome of a frame not addressed to the node when the ongoing reception
+ * is lost (CE_DEFAULT and CE_LINK_ABSTRACTION)
+ **/
+int CaptureAsInterfererCeDefault(int loss_reason, int packet_type,
+		const std::map<int, double> &power_received_per_node, int new_source_id, int ongoing_source_id,
+		double capture_effect){
+
+	return CAPTURE_LOST_INTERFERENCE;
+
+}
+
+/*
+ * CaptureAsInterfererCeIeee80211(): as CaptureAsInterfererCeDefault(), but the ongoing reception is only
+ * dropped if the new frame is received with enough margin over it (CE_IEEE_802_11)
+ **/
+int CaptureAsInterfererCeIeee80211(int loss_reason, int packet_type,
+		const std::map<int, double> &power_received_per_node, int new_source_id, int ongoing_source_id,
+		double capture_effect){
+
+	if(CaptureMarginExceeded(power_received_per_node, new_source_id, ongoing_source_id, capture_effect)) {
+		return CAPTURE_LOST_CAPTURE_EFFECT;
+	}
+	return CAPTURE_NONE;
+
+}
+
+/*
+ * SelectCaptureEffectModel(): returns the packet loss handler of the capture effect model and, if requested,
+ * its capture outcome handlers (as destination of the new frame and as interfered receiver)
+ **/
+IsPacketLostFunction SelectCaptureEffectModel(int capture_effect_model,
+		CaptureOutcomeFunction *capture_as_destination = NULL, CaptureOutcomeFunction *capture_as_interferer = NULL){
+
+	if(capture_as_destination != NULL) {
+		*capture_as_destination = (capture_effect_model == CE_IEEE_802_11) ?
+			CaptureAsDestinationCeIeee80211 : CaptureAsDestinationCeDefault;
+	}
+	if(capture_as_interferer != NULL) {
+		*capture_as_interferer = (capture_effect_model == CE_IEEE_802_11) ?
+			CaptureAsInterfererCeIeee80211 : CaptureAsInterfererCeDefault;
+	}
+
+	switch(capture_effect_model) {
+
+		case CE_DEFAULT: {
+			return IsPacketLostCeDefault;
 		}
 
 		case CE_IEEE_802_11: {
+			return IsPacketLostCeIeee80211;
+		}
 
-			// Check if the RSSI is higher than the CST
-			if (power_rx_interest > pd) {
-				// The packet can be properly decoded
-				loss_reason = -1;
-			} else {
-				loss_reason = PACKET_LOST_LOW_SIGNAL;
-			}
+		case CE_LINK_ABSTRACTION: {
+			return IsPacketLostLinkAbstraction;
+		}
 
-			break;
+		default:{
+			printf("ERROR: Unknown capture effect model!\n");
+			exit(EXIT_FAILURE);
 		}
 
 	}
 
-	return loss_reason;
+}
+
+/*
+ * IsPacketLost(): computes notification loss according to SINR received
+ **/
+int IsPacketLost(int primary_channel, Notification incoming_notification, Notification new_notification,
+		double sinr, double capture_effect, double pd, double power_rx_interest, double constant_per,
+		int node_id, int capture_effect_model){
+
+	return SelectCaptureEffectModel(capture_effect_model)(primary_channel, incoming_notification,
+		new_notification, sinr, capture_effect, pd, power_rx_interest, constant_per, node_id);
 
 }
 
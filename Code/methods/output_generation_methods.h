@@ -55,120 +55,54 @@
 #include "../structures/performance_metrics.h"
 #include "../structures/node_configuration.h"
 #include "../structures/wlan.h"
+#include "../structures/output_schema.h"
 
 #ifndef _OUT_METHODS_
 #define _OUT_METHODS_
 
-// Process simulation results and provide statistics
-int total_data_packets_sent (0);
-double total_num_packets_generated (0);
-double total_throughput (0);
-double min_throughput (999999999999999999);
-double max_throughput (0);
-double proportional_fairness(0);
-double jains_fairness (0);
-double jains_fairness_aux (0);
-int total_rts_lost_slotted_bo (0);
-int total_rts_cts_sent (0);
-double total_prob_slotted_bo_collision (0);
-int total_num_tx_init_not_possible (0);
-double total_delay (0);
-double max_delay (0);
-double min_delay (9999999999);	// Index of the WLAN experiencing less throughput
-int ix_wlan_min_throughput (99999);	// Index of the WLAN experiencing less throughput
-double total_bandiwdth_tx (0);
-double av_expected_backoff (0);
-double av_expected_waiting_time (0);
-
-/*
- * ComputeSimulationStatistics(): computes the global statistics after finishing the simulation
- */
-void ComputeSimulationStatistics(Performance *performance_report, Configuration *configuration_per_node,
-		int total_nodes_number, int total_wlans_number){
-
-	for(int m=0; m < total_nodes_number; ++m){
-		// Take into account only APs (transmitters)
-		if( configuration_per_node[m].capabilities.node_type == NODE_TYPE_AP ){
-			// Data packets sent in total
-			total_data_packets_sent = total_data_packets_sent + performance_report[m].data_packets_sent;
-			// Aggregate throughput
-			total_throughput = total_throughput + performance_report[m].throughput;
-			// Total number of packets generated
-			total_num_packets_generated = total_num_packets_generated + performance_report[m].num_packets_generated;
-			// Total number of RTS lost due to slotted backoff collisions
-			total_rts_lost_slotted_bo = total_rts_lost_slotted_bo + performance_report[m].rts_lost_slotted_bo;
-			// Total number of RTS sent
-			total_rts_cts_sent = total_rts_cts_sent + performance_report[m].rts_cts_sent;
-			// Sum of probabilities of finding a collision by slotted backoff
-			total_prob_slotted_bo_collision = total_prob_slotted_bo_collision + performance_report[m].prob_slotted_bo_collision;
-			// Total number of trials for transmitting
-			total_num_tx_init_not_possible = total_num_tx_init_not_possible + performance_report[m].num_tx_init_not_possible;
-			// Proportional fairness metric
-			proportional_fairness = proportional_fairness + log10(performance_report[m].throughput);
-			// Jain's fairness metric
-			jains_fairness_aux = jains_fairness_aux + pow(performance_report[m].throughput, 2);
-			// Sum of the average delay experienced by each transmitter
-			total_delay = total_delay + performance_report[m].average_delay;
-			// Maximum average delay in the network
-			if(performance_report[m].average_delay > max_delay) max_delay = performance_report[m].average_delay;
-			// Minimum average delay in the network
-			if(performance_report[m].average_delay < min_delay) min_delay = performance_report[m].average_delay;
-			// Average expected backoff
-			av_expected_backoff = av_expected_backoff + performance_report[m].expected_backoff;
-			// Average waiting time before transmitting
-			av_expected_waiting_time = av_expected_waiting_time + performance_report[m].average_waiting_time;
-			// Total bandwidth used in transmissions
-			total_bandiwdth_tx = total_bandiwdth_tx + performance_report[m].bandwidth_used_txing;
-			// Minimum throughput experienced in the network
-			if(performance_report[m].throughput < min_throughput) {
-				ix_wlan_min_throughput = m;
-				min_throughput = performance_report[m].throughput;
-			}
-			// Maximum throughput experienced in the network
-			if(performance_report[m].throughput > max_throughput) max_throughput = performance_report[m].throughput;
-		}
-	}
-	av_expected_backoff = av_expected_backoff / total_wlans_number;
-	av_expected_waiting_time = av_expected_waiting_time / total_wlans_number;
-	jains_fairness = pow(total_throughput, 2) / (total_nodes_number/2 * jains_fairness_aux); // Supposing that number_aps = number_nodes/2
-}
-
 /*
  * PrintAndWriteSimulationStatistics(): prints and writes logs regarding global statistics
  */
 void PrintAndWriteSimulationStatistics(int print_system_logs, int save_system_logs, Logger &logger_simulation,
-		Performance *performance_report, Configuration *configuration_per_node, int total_nodes_number,
-		int total_wlans_number, double frame_length, int max_num_packets_aggregated, double simulation_time_komondor) {
+		const SimulationResults &results) {
 
-	// Compute global statistics
-	ComputeSimulationStatistics(performance_report, configuration_per_node, total_nodes_number, total_wlans_number);
+	Performance *performance_report (results.performance_report);
+	int total_wlans_number (results.total_wlans_number);
+	double frame_length (results.frame_length);
+	int max_num_packets_aggregated (results.max_num_packets_aggregated);
+	double simulation_time_komondor (results.simulation_time_komondor);
 
 	// Print final statistics in console logs
 	if (print_system_logs) {
 		printf("\n%s General Statistics (NEW FUNCTION):\n", LOG_LVL1);
 		printf("%s Average throughput per WLAN = %.3f Mbps (%.2f pkt/s)\n",
-				LOG_LVL2, (total_throughput * pow(10,-6)/total_wlans_number),
-				(total_throughput / (double) frame_length) /total_wlans_number);
+				LOG_LVL2, (results.total_throughput * pow(10,-6)/total_wlans_number),
+				(results.total_throughput / (double) frame_length) /total_wlans_number);
 		printf("%s Min. throughput = %.2f Mbps (%.2f pkt/s)\n",
-				LOG_LVL3, min_throughput * pow(10,-6), min_throughput / (frame_length * max_num_packets_aggregated));
+				LOG_LVL3, results.min_throughput * pow(10,-6), results.min_throughput / (frame_length * max_num_packets_aggregated));
 		printf("%s Max. throughput = %.2f Mbps (%.2f pkt/s)\n",
-						LOG_LVL3, max_throughput * pow(10,-6), max_throughput / (frame_length * max_num_packets_aggregated));
-		printf("%s Total throughput = %.2f Mbps\n", LOG_LVL3, total_throughput * pow(10,-6));
-		printf("%s Total number of packets sent = %d\n", LOG_LVL3, total_data_packets_sent);
+						LOG_LVL3, results.max_throughput * pow(10,-6), results.max_throughput / (frame_length * max_num_packets_aggregated));
+		printf("%s Total throughput = %.2f Mbps\n", LOG_LVL3, results.total_throughput * pow(10,-6));
+		printf("%s Total number of packets sent = %d\n", LOG_LVL3, results.total_data_packets_sent);
 		printf("%s Average number of data packets successfully sent per WLAN = %.2f\n",
-				LOG_LVL4, ((double) total_data_packets_sent/ (double) total_wlans_number));
+				LOG_LVL4, ((double) results.total_data_packets_sent/ (double) total_wlans_number));
 		printf("%s Average number of RTS packets lost due to slotted BO = %f (%.3f %% loss)\n",
-				LOG_LVL4, (double) total_rts_lost_slotted_bo/(double) total_wlans_number,
-				((double) total_rts_lost_slotted_bo *100/ (double) total_rts_cts_sent));
-		printf("%s Average number of packets sent per WLAN = %d\n", LOG_LVL3, (total_data_packets_sent/total_wlans_number));
-		printf("%s Proportional Fairness = %.2f\n", LOG_LVL2, proportional_fairness);
-		printf("%s Jain's Fairness = %.2f\n",  LOG_LVL2, jains_fairness);
-		printf("%s Prob. collision by slotted BO = %.3f\n", LOG_LVL2, total_prob_slotted_bo_collision / total_wlans_number);
-		printf("%s Av. delay = %.2f ms\n", LOG_LVL2, total_delay * pow(10,3) / total_wlans_number);
-		printf("%s Max. delay = %.2f ms\n", LOG_LVL3, max_delay * pow(10,3));
-		printf("%s Av. expected waiting time = %.2f ms\n", LOG_LVL3, av_expected_waiting_time * pow(10,3));
+				LOG_LVL4, (double) results.total_rts_lost_slotted_bo/(double) total_wlans_number,
+				((double) results.total_rts_lost_slotted_bo *100/ (double) results.total_rts_cts_sent));
+		printf("%s Average number of packets sent per WLAN = %d\n", LOG_LVL3, (results.total_data_packets_sent/total_wlans_number));
+		printf("%s Proportional Fairness = %.2f\n", LOG_LVL2, results.proportional_fairness);
+		printf("%s Jain's Fairness = %.2f\n",  LOG_LVL2, results.jains_fairness);
+		printf("%s Prob. collision by slotted BO = %.3f\n", LOG_LVL2, results.total_prob_slotted_bo_collision / total_wlans_number);
+		printf("%s Av. delay = %.2f ms\n", LOG_LVL2, results.total_delay * pow(10,3) / total_wlans_number);
+		printf("%s Max. delay = %.2f ms\n", LOG_LVL3, results.max_delay * pow(10,3));
+		printf("%s Delay percentiles (all packets): p50 = %.2f ms, p95 = %.2f ms, p99 = %.2f ms, p99.9 = %.2f ms\n",
+			LOG_LVL3, results.network_delay_histogram.Percentile(0.5) * pow(10,3),
+			results.network_delay_histogram.Percentile(0.95) * pow(10,3),
+			results.network_delay_histogram.Percentile(0.99) * pow(10,3),
+			results.network_delay_histogram.Percentile(0.999) * pow(10,3));
+		printf("%s Av. expected waiting time = %.2f ms\n", LOG_LVL3, results.av_expected_waiting_time * pow(10,3));
 		printf("%s Average bandwidth used for transmitting = %.2f MHz\n",
-			LOG_LVL2, total_bandiwdth_tx / (double) total_wlans_number);
+			LOG_LVL2, results.total_bandwidth_tx / (double) total_wlans_number);
 		printf("%s Time channel was idle = %.2f s (%f%%)\n",  LOG_LVL2,
 			performance_report[0].sum_time_channel_idle, (100*performance_report[0].sum_time_channel_idle/simulation_time_komondor));
 		printf("\n\n");
@@ -180,18 +114,18 @@ void PrintAndWriteSimulationStatistics(int print_system_logs, int save_system_lo
 	if (save_system_logs) {
 		// Simulation log file
 		fprintf(logger_simulation.file,"\n%s General Statistics (NEW FUNCTION):\n", LOG_LVL1);
-		fprintf(logger_simulation.file,"%s Average throughput per WLAN = %.2f Mbps\n", LOG_LVL2, (total_throughput * pow(10,-6)/total_wlans_number));
-		fprintf(logger_simulation.file,"%s Total throughput = %.2f Mbps\n", LOG_LVL3, total_throughput * pow(10,-6));
-		fprintf(logger_simulation.file,"%s Total number of packets sent = %d\n", LOG_LVL3, total_data_packets_sent);
+		fprintf(logger_simulation.file,"%s Average throughput per WLAN = %.2f Mbps\n", LOG_LVL2, (results.total_throughput * pow(10,-6)/total_wlans_number));
+		fprintf(logger_simulation.file,"%s Total throughput = %.2f Mbps\n", LOG_LVL3, results.total_throughput * pow(10,-6));
+		fprintf(logger_simulation.file,"%s Total number of packets sent = %d\n", LOG_LVL3, results.total_data_packets_sent);
 		fprintf(logger_simulation.file,"%s Average number of data packets successfully sent per WLAN = %.2f\n",
-			LOG_LVL4, ( (double) total_data_packets_sent/ (double) total_wlans_number));
+			LOG_LVL4, ( (double) results.total_data_packets_sent/ (double) total_wlans_number));
 		fprintf(logger_simulation.file,"%s Average number of RTS packets lost due to slotted BO = %.2f (%.2f %% loss)\n",
 			LOG_LVL4,
-			(double) total_rts_lost_slotted_bo/(double) total_wlans_number,
-			((double) total_rts_lost_slotted_bo *100/ (double) total_rts_cts_sent));
-		fprintf(logger_simulation.file,"%s Average number of packets sent per WLAN = %d\n", LOG_LVL3, (total_data_packets_sent/total_wlans_number));
-		fprintf(logger_simulation.file,"%s Proportional Fairness = %.2f\n", LOG_LVL2, proportional_fairness);
-		fprintf(logger_simulation.file,"%s Jain's Fairness = %.2f\n",  LOG_LVL2, jains_fairness);
+			(double) results.total_rts_lost_slotted_bo/(double) total_wlans_number,
+			((double) results.total_rts_lost_slotted_bo *100/ (double) results.total_rts_cts_sent));
+		fprintf(logger_simulation.file,"%s Average number of packets sent per WLAN = %d\n", LOG_LVL3, (results.total_data_packets_sent/total_wlans_number));
+		fprintf(logger_simulation.file,"%s Proportional Fairness = %.2f\n", LOG_LVL2, results.proportional_fairness);
+		fprintf(logger_simulation.file,"%s Jain's Fairness = %.2f\n",  LOG_LVL2, results.jains_fairness);
 		fprintf(logger_simulation.file,"\n");
 	}
 
@@ -199,10 +133,18 @@ void PrintAndWriteSimulationStatistics(int print_system_logs, int save_system_lo
 
 /*
  * GenerateScriptOutput(): generates the script's output (.txt) according to the introduced simulation index
+ * (legacy layouts, used when no output schema is entered per console)
  */
-void GenerateScriptOutput(int simulation_index, Performance *performance_report, Configuration *configuration_per_node,
-	Logger &logger_script, int total_wlans_number, int	total_nodes_number, int frame_length,
-	int max_num_packets_aggregated, Wlan *wlan_container, double simulation_time_komondor) {
+void GenerateScriptOutput(int simulation_index, const SimulationResults &results, Logger &logger_script) {
+
+	Performance *performance_report (results.performance_report);
+	Configuration *configuration_per_node (results.configuration_per_node);
+	Wlan *wlan_container (results.wlan_container);
+	int total_nodes_number (results.total_nodes_number);
+	int total_wlans_number (results.total_wlans_number);
+	int frame_length (results.frame_length);
+	int max_num_packets_aggregated (results.max_num_packets_aggregated);
+	double simulation_time_komondor (results.simulation_time_komondor);
 
 	// Generate the content for the "Script output"
 	switch(simulation_index){
@@ -220,12 +162,12 @@ void GenerateScriptOutput(int simulation_index, Performance *performance_report,
 		case 1:{
 			// For large scenarios (Node density vs. throughput)
 			fprintf(logger_script.file, ";%.2f;%.2f;%f;%.2f;%d;%.2f\n",
-				(total_throughput * pow(10,-6)/total_wlans_number),
-				proportional_fairness,
-				jains_fairness,
-				min_throughput * pow(10,-6),
-				ix_wlan_min_throughput,
-				total_bandiwdth_tx / (double) total_wlans_number);
+				(results.total_throughput * pow(10,-6)/total_wlans_number),
+				results.proportional_fairness,
+				results.jains_fairness,
+				results.min_throughput * pow(10,-6),
+				results.ix_wlan_min_throughput,
+				results.total_bandwidth_tx / (double) total_wlans_number);
 			break;
 		}
 
@@ -246,16 +188,16 @@ void GenerateScriptOutput(int simulation_index, Performance *performance_report,
 		case 3:{
 			// Bianchi multiple WLANs
 			fprintf(logger_script.file, ";%.2f;%.3f;%.5f\n",
-				av_expected_backoff / SLOT_TIME,
-				(total_throughput * pow(10,-6)/total_wlans_number),
-				total_prob_slotted_bo_collision / total_wlans_number);
+				results.av_expected_backoff / SLOT_TIME,
+				(results.total_throughput * pow(10,-6)/total_wlans_number),
+				results.total_prob_slotted_bo_collision / total_wlans_number);
 			break;
 		}
 
 		case 4:{
 			// DCB validation
 			fprintf(logger_script.file, ";%.5f",
-				total_prob_slotted_bo_collision / total_wlans_number);
+				results.total_prob_slotted_bo_collision / total_wlans_number);
 			for(int w = 0; w < total_wlans_number; ++w) {
 				fprintf(logger_script.file, ";%.3f", performance_report[w*2].throughput * pow(10,-6));
 			}
@@ -343,19 +285,19 @@ void GenerateScriptOutput(int simulation_index, Performance *performance_report,
 		case 9:{
 			// Sergio logs for Paper #5: 6 WLAN random
 			fprintf(logger_script.file, ";%.2f;%.2f;%.2f;%d;%.4f;%.4f;%.4f;%.2f;%.2f;%.2f;%f;%f;%f\n",
-				total_throughput/(frame_length * max_num_packets_aggregated * total_wlans_number),
-				(total_throughput * pow(10,-6)/total_wlans_number),
-				min_throughput/(frame_length * max_num_packets_aggregated),
-				ix_wlan_min_throughput,
-				proportional_fairness,
-				jains_fairness,
-				total_prob_slotted_bo_collision / total_wlans_number,
-				total_delay * pow(10,3) / total_wlans_number,
-				max_delay * pow(10,3),
-				total_bandiwdth_tx / (double) total_wlans_number,
-				av_expected_waiting_time * pow(10,3),
-				min_delay * pow(10,3),
-				max_throughput/(frame_length * max_num_packets_aggregated)
+				results.total_throughput/(frame_length * max_num_packets_aggregated * total_wlans_number),
+				(results.total_throughput * pow(10,-6)/total_wlans_number),
+				results.min_throughput/(frame_length * max_num_packets_aggregated),
+				results.ix_wlan_min_throughput,
+				results.proportional_fairness,
+				results.jains_fairness,
+				results.total_prob_slotted_bo_collision / total_wlans_number,
+				results.total_delay * pow(10,3) / total_wlans_number,
+				results.max_delay * pow(10,3),
+				results.total_bandwidth_tx / (double) total_wlans_number,
+				results.av_expected_waiting_time * pow(10,3),
+				results.min_delay * pow(10,3),
+				results.max_throughput/(frame_length * max_num_packets_aggregated)
 				);
 			break;
 		}
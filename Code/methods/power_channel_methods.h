@@ -467,146 +467,174 @@ void UpdatePowerSensedPerNode(int primary_channel, std::map<int,double> &power_r
 
 }
 
+// Adjacent channel interference handler specialized per model (see SelectAdjacentChannelInterferenceModel())
+typedef void (*AdjacentChannelModelFunction)(double total_power[], const Notification &notification,
+	int num_channels_komondor, double pw_received);
+
 /*
- * ApplyAdjacentChannelInterferenceModel: applies a cochannel interference model
+ * AdjacentChannel<model>(): add the power of a transmission to the channels it affects
+ * Input arguments:
+ * - total_power: power per channel generated by the transmission (to be filled)
+ * - notification: notification of the transmission
+ * - num_channels_komondor: number of channels in the system
+ * - pw_received: power received from the transmitter [pW]
  **/
-void ApplyAdjacentChannelInterferenceModel(int adjacent_channel_model, double total_power[],
-	Notification notification, int num_channels_komondor, double rx_gain,
-	double central_frequency, double pw_received, int path_loss_model){
-
-//	for (int i = 0 ; i < num_channels_komondor ; ++i) (total_power)[i] = 0;
-
-//	double distance (ComputeDistance(x, y, z, notification.tx_info.x, notification.tx_info.y,
-//		notification.tx_info.z));
-
-//	double pw_received (ComputePowerReceived(distance, notification.tx_info.tx_power,
-//		notification.tx_info.tx_gain, rx_gain, central_frequency, path_loss_model));
+void AdjacentChannelNone(double total_power[], const Notification &notification,
+	int num_channels_komondor, double pw_received){
 
 	// Direct power (power of the channels used for transmitting)
 	for(int i = notification.left_channel; i <= notification.right_channel; ++i){
 		(total_power)[i] = pw_received;
 	}
 
+}
+
+// (RECOMMENDED) Boundary co-channel interference: only boundary channels (left and right) used in the TX affect the rest of channels
+void AdjacentChannelBoundary(double total_power[], const Notification &notification,
+	int num_channels_komondor, double pw_received){
+
+	AdjacentChannelNone(total_power, notification, num_channels_komondor, pw_received);
+
+	double pw_received_dbm (ConvertPower(PW_TO_DBM, pw_received));
 	double pw_loss_db;
 	double total_power_dbm;
 
-	// Co-channel interference power
-	switch(adjacent_channel_model){
+	for(int c = 0; c < num_channels_komondor; ++c) {
 
-		case ADJACENT_CHANNEL_NONE:{
-			// Do nothing
-			break;
-		}
+		if(c < notification.left_channel || c > notification.right_channel){
 
-		// (RECOMMENDED) Boundary co-channel interference: only boundary channels (left and right) used in the TX affect the rest of channels
-		case ADJACENT_CHANNEL_BOUNDARY:{
-			for(int c = 0; c < num_channels_komondor; ++c) {
+			if(c < notification.left_channel) {
 
-				if(c < notification.left_channel || c > notification.right_channel){
+				pw_loss_db = 20 * abs(c-notification.left_channel);
+				total_power_dbm = pw_received_dbm - pw_loss_db;
+				(total_power)[c] = (total_power)[c] + ConvertPower(DBM_TO_PW, total_power_dbm);
 
-					if(c < notification.left_channel) {
+			} else if(c > notification.right_channel) {
 
-						pw_loss_db = 20 * abs(c-notification.left_channel);
-						total_power_dbm = ConvertPower(PW_TO_DBM, pw_received) - pw_loss_db;
-						(total_power)[c] = (total_power)[c] + ConvertPower(DBM_TO_PW, total_power_dbm);
+				pw_loss_db = 20 * abs(c-notification.right_channel);
+				total_power_dbm = pw_received_dbm - pw_loss_db;
+				(total_power)[c] = (total_power)[c] + ConvertPower(DBM_TO_PW, total_power_dbm);
 
-					} else if(c > notification.right_channel) {
+			}
 
-						pw_loss_db = 20 * abs(c-notification.right_channel);
-						total_power_dbm = ConvertPower(PW_TO_DBM, pw_received) - pw_loss_db;
-						(total_power)[c] = (total_power)[c] + ConvertPower(DBM_TO_PW, total_power_dbm);
+			if((total_power)[c] < MIN_VALUE_C_LANGUAGE){
 
-					}
+				(total_power)[c] = 0;
 
-					if((total_power)[c] < MIN_VALUE_C_LANGUAGE){
+			}
 
-						(total_power)[c] = 0;
+		} else {
+			// Inside TX range --> do nothing
+		}
+	}
 
-					}
+}
+
+// Extreme co-channel interference: ALL channels used in the TX affect the rest of channels
+void AdjacentChannelExtreme(double total_power[], const Notification &notification,
+	int num_channels_komondor, double pw_received){
+
+	AdjacentChannelNone(total_power, notification, num_channels_komondor, pw_received);
+
+	double pw_received_dbm (ConvertPower(PW_TO_DBM, pw_received));
+	double pw_loss_db;
+	double total_power_dbm;
+
+	for(int c = 0; c < num_channels_komondor; ++c) {
+
+		for(int j = notification.left_channel; j <= notification.right_channel; ++j){
+
+			if(c != j) {
+
+				pw_loss_db = 20 * abs(c-j);
+				total_power_dbm = pw_received_dbm - pw_loss_db;
+				(total_power)[c] = (total_power)[c] + ConvertPower(DBM_TO_PW, total_power_dbm);
+				if((total_power)[c] < MIN_DOUBLE_VALUE_KOMONDOR) (total_power)[c] = 0;
 
-				} else {
-					// Inside TX range --> do nothing
-				}
 			}
-			break;
 		}
+	}
 
-		case ADJACENT_CHANNEL_EXTREME:{
+}
 
-			for(int c = 0; c < num_channels_komondor; ++c) {
+/*
+ * SelectAdjacentChannelInterferenceModel(): returns the handler of the adjacent channel interference model
+ **/
+AdjacentChannelModelFunction SelectAdjacentChannelInterferenceModel(int adjacent_channel_model){
 
-				for(int j = notification.left_channel; j <= notification.right_channel; ++j){
+	switch(adjacent_channel_model){
 
-					if(c != j) {
+		case ADJACENT_CHANNEL_NONE:{
+			return AdjacentChannelNone;
+		}
 
-						pw_loss_db = 20 * abs(c-j);
-						total_power_dbm = ConvertPower(PW_TO_DBM, pw_received) - pw_loss_db;
-						(total_power)[c] = (total_power)[c] + ConvertPower(DBM_TO_PW, total_power_dbm);
-						if((total_power)[c] < MIN_DOUBLE_VALUE_KOMONDOR) (total_power)[c] = 0;
+		case ADJACENT_CHANNEL_BOUNDARY:{
+			return AdjacentChannelBoundary;
+		}
 
-					}
-				}
-			}
-			break;
+		case ADJACENT_CHANNEL_EXTREME:{
+			return AdjacentChannelExtreme;
 		}
 
 		default:{
 			printf("ERROR: Unkown cochannel model!");
 			exit(EXIT_FAILURE);
-			break;
 		}
 	}
 
 }
 
 /*
- * UpdateChannelsPower: updates the aggregated power sensed by the node in every channel
+ * ApplyAdjacentChannelInterferenceModel: applies a cochannel interference model
  **/
-void UpdateChannelsPower(double **channel_power, Notification notification,
-    int update_type, double central_frequency, int num_channels_komondor, int path_loss_model,
-	double rx_gain, int adjacent_channel_model, double pw_received, int node_id){
+void ApplyAdjacentChannelInterferenceModel(int adjacent_channel_model, double total_power[],
+	Notification notification, int num_channels_komondor, double rx_gain,
+	double central_frequency, double pw_received, int path_loss_model){
 
-//	if(update_type != TX_FINISHED && update_type != TX_INITIATED) {
-//		printf("ERROR: update_type %d does not exist!!!", update_type);
-//		exit(EXIT_FAILURE);
-//	}
+	SelectAdjacentChannelInterferenceModel(adjacent_channel_model)(total_power,
+		notification, num_channels_komondor, pw_received);
 
-	// Total power [pW] (of interest and interference) generated ONLY by the incoming or outgoing TX
-//	double total_power[num_channels_komondor];
-//	for(int i = 0; i < num_channels_komondor; ++i) {
-//		total_power[i] = 0;
-//	}
+}
 
+/*
+ * UpdateChannelsPower: updates the aggregated power sensed by the node in every channel
+ * Input arguments:
+ * - apply_adjacent_channel_model: adjacent channel handler selected at setup
+ *   (see SelectAdjacentChannelInterferenceModel())
+ **/
+void UpdateChannelsPower(double **channel_power, const Notification &notification,
+    int update_type, int num_channels_komondor,
+	AdjacentChannelModelFunction apply_adjacent_channel_model, double pw_received){
+
+	// Total power [pW] (of interest and interference) generated ONLY by the incoming or outgoing TX
 	double total_power[num_channels_komondor];
 	memset(total_power, 0, num_channels_komondor * sizeof(double));
 
 	// Updates total_power array
-	ApplyAdjacentChannelInterferenceModel(adjacent_channel_model, total_power,
-		notification, num_channels_komondor, rx_gain, central_frequency, pw_received, path_loss_model);
+	apply_adjacent_channel_model(total_power, notification, num_channels_komondor, pw_received);
 
 	// Increase/decrease power sensed if TX started/finished
-	for(int c = 0; c < num_channels_komondor; ++c){
-
-		switch(update_type){
-
-			case TX_FINISHED:{
+	switch(update_type){
 
+		case TX_FINISHED:{
+			for(int c = 0; c < num_channels_komondor; ++c){
 				(*channel_power)[c] = (*channel_power)[c] - total_power[c];
-
 				// Avoid near-zero negative values
 				if ((*channel_power)[c] < 0.000001) (*channel_power)[c] = 0;
-				break;
 			}
+			break;
+		}
 
-			case TX_INITIATED:{
+		case TX_INITIATED:{
+			for(int c = 0; c < num_channels_komondor; ++c){
 				(*channel_power)[c] = (*channel_power)[c] + total_power[c];
-				break;
 			}
-
-			default:{}
+			break;
 		}
 
+		default:{}
 	}
+
 }
 
 /*
@@ -646,401 +674,210 @@ void ComputeMaxInterference(double *max_pw_interference, int *channel_max_intere
 }
 
 /*
- * GetTxChannelsByChannelBonding: identifies the channels to TX in depending on the channel_bonding scheme
- * and channel_power state.
+ * ChannelRangeMask(): returns the bitmask of channels [left_channel, right_channel]
  **/
-void GetTxChannelsByChannelBonding(int *channels_for_tx, int channel_bonding_model, int *channels_free,
-    int min_channel_allowed, int max_channel_allowed, int primary_channel, int **mcs_per_node,
-	int ix_mcs_per_node, int num_channels_system){
+unsigned int ChannelRangeMask(int left_channel, int right_channel){
 
-	// Reset channels for transmitting
-	for(int c = min_channel_allowed; c <= max_channel_allowed; ++c){
-		channels_for_tx[c] = FALSE;
-	}
+	if(right_channel < left_channel) return 0;
+	int num_channels (right_channel - left_channel + 1);
+	unsigned int range_mask ((num_channels >= MAX_NUM_CHANNELS_BITMASK) ? ~0u : ((1u << num_channels) - 1));
+	return range_mask << left_channel;
 
-	// Get left and right channels available (or free)
-	int left_free_ch (0);
-	int left_free_ch_is_set (0);	// True if left channel could be set true
-	int right_free_ch (0);
+}
 
-	for(int c = min_channel_allowed; c <= max_channel_allowed; ++c){
-		if(channels_free[c]){
-			if(!left_free_ch_is_set){
-				left_free_ch = c;
-				left_free_ch_is_set = TRUE;
-			}
-			if(right_free_ch < c){
-				right_free_ch = c;
-			}
-		}
-	}
+/*
+ * ChannelsArrayToBitmask(): returns the bitmask of the TRUE elements of a channels array
+ * Input arguments:
+ * - channels: array of channels (TRUE/FALSE per channel)
+ * - num_channels: number of channels in the array
+ **/
+unsigned int ChannelsArrayToBitmask(int *channels, int num_channels){
 
-	int num_free_ch (right_free_ch - left_free_ch + 1);
-	int num_available_ch (max_channel_allowed - min_channel_allowed + 1);
-	int log2_modulus;	// Auxiliary variable representing a modulus
-	int left_tx_ch;		// Left channel to TX
-	int right_tx_ch; 	// Right channel to TX
+	unsigned int channels_mask (0);
+	for(int c = 0; c < num_channels && c < MAX_NUM_CHANNELS_BITMASK; ++c){
+		if(channels[c]) channels_mask |= (1u << c);
+	}
+	return channels_mask;
 
-	// SERGIO 18/09/2017:
-	// - Modify CB policies. Identify first of all the log2 channel ranges available
-	int all_channels_free_in_range ( TRUE );	// auxiliar variable for identifying free channel ranges
+}
 
-	// Boolean array indicating if possible or not to transmit in 1, 2, 4 or 8 channels.
-	int possible_channel_ranges_ixs[4] = {FALSE, FALSE, FALSE, FALSE};
+/*
+ * Log2ChannelRanges: channels used for transmitting in 1, 2, 4 or 8 channels (log2 mapping), per primary channel.
+ * Computed once at start-up and accessed as log2_channel_ranges.mask[primary_channel][range_ix].
+ **/
+struct Log2ChannelRanges {
 
-	// Check primary
-	if(channels_free[primary_channel]) possible_channel_ranges_ixs[0] = TRUE;
+	unsigned int mask[MAX_NUM_CHANNELS_BITMASK][NUM_OPTIONS_CHANNEL_LENGTH];
 
-	// Check primary and 1 secondary
-	if(num_channels_system > 1){
-		if(primary_channel % 2 == 1){	// If primary is odd
-			if(channels_free[primary_channel - 1]) possible_channel_ranges_ixs[1] = TRUE;
-		} else{
-			if(channels_free[primary_channel + 1]) possible_channel_ranges_ixs[1] = TRUE;
+	Log2ChannelRanges(){
+		for(int p = 0; p < MAX_NUM_CHANNELS_BITMASK; ++p){
+			mask[p][0] = 1u << p;						// Primary
+			mask[p][1] = mask[p][0] | (1u << (p ^ 1));	// Primary and 1 secondary (p-1 if odd, p+1 if even)
+			mask[p][2] = mask[p][0] | ((p > 3) ? 0xF0 : 0x0F);	// Primary and 3 secondaries (range 0-3 or 4-7)
+			mask[p][3] = mask[p][0] | 0xFF;				// Primary and 7 secondaries (full system range)
 		}
 	}
 
-	// Check primary and 3 secondaries
-	if(num_channels_system > 3){
-		if(primary_channel > 3){	// primary in channel range 4-7
-			for(int c = 0; c < 4; ++c){
-				if(!channels_free[4 + c]) all_channels_free_in_range = FALSE;
-			}
-			if(all_channels_free_in_range) possible_channel_ranges_ixs[2] = TRUE;
+};
 
-		} else { // primary in channel range 0-3
-			for(int c = 0; c < 4; ++c){
-				if(!channels_free[c]) all_channels_free_in_range = FALSE;
-			}
-			if(all_channels_free_in_range) possible_channel_ranges_ixs[2] = TRUE;
-		}
-	}
+const Log2ChannelRanges log2_channel_ranges;
 
+/*
+ * GetTxChannelsByChannelBonding: identifies the channels to TX in depending on the channel_bonding scheme
+ * and channel_power state. Channels are handled as bitmasks (bit c corresponds to channel c).
+ **/
+void GetTxChannelsByChannelBonding(int *channels_for_tx, int channel_bonding_model, int *channels_free,
+    int min_channel_allowed, int max_channel_allowed, int primary_channel, int **mcs_per_node,
+	int ix_mcs_per_node, int num_channels_system){
 
-	// Check primary and 7 secondaries (full system range)
-	if(num_channels_system > 7){
-		for(int c = 0; c < 8; ++c){
-			if(!channels_free[c]) all_channels_free_in_range = FALSE;
-		}
-		if(all_channels_free_in_range) possible_channel_ranges_ixs[3] = TRUE;
+	// Reset channels for transmitting
+	for(int c = min_channel_allowed; c <= max_channel_allowed; ++c){
+		channels_for_tx[c] = FALSE;
 	}
 
-	if(left_free_ch_is_set){
-
-		// Select channels to transmit depending on the sensed power
-		switch(channel_bonding_model){
-
-			// Only Primary Channel used if FREE
-			case CB_ONLY_PRIMARY:{
+	unsigned int free_mask (ChannelsArrayToBitmask(channels_free, num_channels_system));
+	unsigned int allowed_mask (ChannelRangeMask(min_channel_allowed, max_channel_allowed));
+	unsigned int free_allowed_mask (free_mask & allowed_mask);
 
-				if(primary_channel >= left_free_ch && primary_channel <= right_free_ch){
-					channels_for_tx[primary_channel] = TRUE;
-				}
-				break;
-			}
-
-			// SCB: if all channels are FREE, transmit. If not, generate a new backoff.
-			case CB_SCB:{
+	// No channel is free
+	if(!free_allowed_mask){
+		channels_for_tx[0] = TX_NOT_POSSIBLE;
+		return;
+	}
 
-				int tx_possible = TRUE;
-				// If all channels are FREE, transmit. If not, generate a new backoff.
-				for(int c = min_channel_allowed; c <= max_channel_allowed; ++c){
-					if(!channels_free[c]){
-						tx_possible = FALSE;
-					}
-				}
+	// Get left and right channels available (or free)
+	int left_free_ch (__builtin_ctz(free_allowed_mask));
+	int right_free_ch (MAX_NUM_CHANNELS_BITMASK - 1 - __builtin_clz(free_allowed_mask));
 
-				if(tx_possible){
-					left_tx_ch = left_free_ch;
-					right_tx_ch = right_free_ch;
-					for(int c = min_channel_allowed; c <= max_channel_allowed; ++c){
-						channels_for_tx[c] = TRUE;
-					}
-				} else {
-					// TX not possible (code it with negative value)
-					channels_for_tx[0] = TX_NOT_POSSIBLE;
-				}
-				break;
+	// SERGIO 18/09/2017:
+	// - Modify CB policies. Identify first of all the log2 channel ranges available
+	// - Number of log2 ranges (1, 2, 4 or 8 channels) found free
+	unsigned int quad_mask ((primary_channel > 3) ? 0xF0 : 0x0F);
+	int num_possible_ranges (((free_mask >> primary_channel) & 1u)
+		+ (num_channels_system > 1 && ((free_mask >> (primary_channel ^ 1)) & 1u))
+		+ (num_channels_system > 3 && (free_mask & quad_mask) == quad_mask)
+		+ (num_channels_system > 7 && (free_mask & 0xFF) == 0xFF));
+
+	unsigned int tx_mask (0);
+	int tx_possible (TRUE);
+
+	// Select channels to transmit depending on the sensed power
+	switch(channel_bonding_model){
+
+		// Only Primary Channel used if FREE
+		case CB_ONLY_PRIMARY:{
+			if(primary_channel >= left_free_ch && primary_channel <= right_free_ch){
+				tx_mask = 1u << primary_channel;
 			}
+			break;
+		}
 
-			// SCB log2:  if all channels accepted by the log2 mapping are FREE, transmit. If not, generate a new backoff.
-			case CB_SCB_LOG2:{
-
-				while(1){
-					// II. If num_free_ch is power of 2
-					if(fmod(log10(num_available_ch)/log10(2), 1) == 0){
-						log2_modulus = primary_channel % num_available_ch;
-						left_tx_ch = primary_channel - log2_modulus;
-						right_tx_ch = primary_channel + num_available_ch - log2_modulus - 1;
-						// Check if tx channels are inside the free ones
-						if((left_tx_ch >= min_channel_allowed) && (right_tx_ch <= max_channel_allowed)){
-							// TX channels found!
-							break;
-
-						} else {
-							--num_available_ch;
-						}
-
-					} else{
-						--num_available_ch;
-					}
-				}
-
-				// If all channels accepted by the log2 mapping, transmit. If not, generate a new backoff.
-				int tx_possible = TRUE;
-				for(int c = left_tx_ch; c <= right_tx_ch; ++c){
-					if(!channels_free[c]){
-						tx_possible = FALSE;
-					}
-				}
-				if(tx_possible){
-					for(int c = left_tx_ch; c <= right_tx_ch; ++c){
-						channels_for_tx[c] = TRUE;
-					}
-				} else {
-					// TX not possible (code it with negative value)
-					channels_for_tx[0] = TX_NOT_POSSIBLE;
-				}
-				break;
+		// SCB: if all channels are FREE, transmit. If not, generate a new backoff.
+		case CB_SCB:{
+			if(free_allowed_mask == allowed_mask){
+				tx_mask = allowed_mask;
+			} else {
+				tx_possible = FALSE;
 			}
+			break;
+		}
 
-			// Always-max (DCB): TX in all the free channels contiguous to the primary channel
-			// TODO: (skectch) check if it is valid!
-			case CB_ALWAYS_MAX:{
-				for(int c = left_free_ch; c <= right_free_ch; ++c){
-					channels_for_tx[c] = TRUE;
+		// SCB log2:  if all channels accepted by the log2 mapping are FREE, transmit. If not, generate a new backoff.
+		case CB_SCB_LOG2:{
+			// Largest log2 range containing the primary inside the allowed channels
+			unsigned int range_mask (0);
+			for(int num_channels = max_channel_allowed - min_channel_allowed + 1; num_channels > 0; --num_channels){
+				if(num_channels & (num_channels - 1)) continue;	// Not a power of 2
+				int left_tx_ch (primary_channel - primary_channel % num_channels);
+				int right_tx_ch (left_tx_ch + num_channels - 1);
+				if((left_tx_ch >= min_channel_allowed) && (right_tx_ch <= max_channel_allowed)){
+					range_mask = ChannelRangeMask(left_tx_ch, right_tx_ch);
+					break;
 				}
-				break;
 			}
-
-			// Always-map log2: TX in the larger channel range allowed by the log2 mapping
-			// TODO: (skectch) check if it is valid!
-			case CB_ALWAYS_MAX_LOG2:{
-
-				int ch_range_ix (GetNumberOfSpecificElementInArray(1, possible_channel_ranges_ixs, 4));
-
-				switch(ch_range_ix){
-
-					case 1:{
-						channels_for_tx[primary_channel] = TRUE;
-						break;
-					}
-
-					case 2:{
-						channels_for_tx[primary_channel] = TRUE;
-						if(primary_channel % 2 == 1){	// If primary is odd
-							channels_for_tx[primary_channel - 1] = TRUE;
-						} else{
-							channels_for_tx[primary_channel + 1] = TRUE;
-						}
-						break;
-					}
-
-					case 3:{
-						// Check primary and 3 secondaries
-						if(primary_channel > 3){	// primary in channel range 4-7
-							channels_for_tx[4] = TRUE;
-							channels_for_tx[5] = TRUE;
-							channels_for_tx[6] = TRUE;
-							channels_for_tx[7] = TRUE;
-						} else { // primary in channel range 0-3
-							channels_for_tx[0] = TRUE;
-							channels_for_tx[1] = TRUE;
-							channels_for_tx[2] = TRUE;
-							channels_for_tx[3] = TRUE;
-						}
-						break;
-					}
-
-					case 4:{
-						for(int c = 0; c < 8; ++c){
-							channels_for_tx[c] = TRUE;
-						}
-						break;
-					}
-
-					default:{
-						break;
-					}
-
-				}
-
-
-				break;
-
+			if(range_mask && (free_mask & range_mask) == range_mask){
+				tx_mask = range_mask;
+			} else {
+				tx_possible = FALSE;
 			}
+			break;
+		}
 
-			// Always-map (DCB) log2 with optimal MCS: picks the channel range + MCS providing max throughput
-			case CB_ALWAYS_MAX_LOG2_MCS:{
-
-				int num_channels = 0;
-				int modulation = 0;
-				int modulation_num_channels_ix = 0;
-				double max_throughput = 0;
-				double aux_throughput = 0;
-
-				while(num_free_ch > 0){
-
-					// If num_free_ch is power of 2
-					if(fmod(log10(num_free_ch)/log10(2), 1) == 0){
-
-						log2_modulus = primary_channel % num_free_ch;
-						left_tx_ch = primary_channel - log2_modulus;
-						right_tx_ch = primary_channel + num_free_ch - log2_modulus - 1;
-						num_channels = right_tx_ch - left_tx_ch + 1;
-						modulation_num_channels_ix = (int) log2(num_channels);
-
-						// Check if tx channels are inside the free ones
-						if((left_tx_ch >= min_channel_allowed) && (right_tx_ch <= max_channel_allowed)){
-
-							// Security check for ensuring picked range is free
-							int range_is_free = TRUE;
-							for(int c = left_tx_ch; c <= right_tx_ch; ++c){
-								if(!channels_free[c]){
-									range_is_free = FALSE;
-									break;
-								}
-							}
-
-							if (range_is_free){
-
-								/* MCS optimization */
-								modulation = mcs_per_node[ix_mcs_per_node][modulation_num_channels_ix];
-								aux_throughput = Mcs_array::mcs_array[modulation_num_channels_ix][modulation-1];
-
-								if(aux_throughput > max_throughput){
-									// TX channels found!
-									for(int c = left_tx_ch; c <= right_tx_ch; ++c){
-										channels_for_tx[c] = TRUE;
-									}
-								}
-							}
-						}
-						--num_free_ch;
-					} else {
-						--num_free_ch;
-					}
-				}
-
-				break;
-				}
-
-			// Log2 probabilistic uniform: pick with same probabilty any available channel range
-			case CB_PROB_UNIFORM_LOG2:{
-
-				int ch_range_ix = GetNumberOfSpecificElementInArray(1, possible_channel_ranges_ixs, 4);
-
-				int random_value = 1 + rand() % (ch_range_ix);	// 1 to ch_range_ix
-
-				switch(ch_range_ix){
-
-					case 1:{
-						channels_for_tx[primary_channel] = TRUE;
-						break;
-					}
-
-					case 2:{
-
-						channels_for_tx[primary_channel] = TRUE;
-
-						if(random_value > 1){
-							if(primary_channel % 2 == 1){	// If primary is odd
-								channels_for_tx[primary_channel - 1] = TRUE;
-							} else{
-								channels_for_tx[primary_channel + 1] = TRUE;
-							}
-						}
-						break;
-					}
+		// Always-max (DCB): TX in all the free channels contiguous to the primary channel
+		// TODO: (skectch) check if it is valid!
+		case CB_ALWAYS_MAX:{
+			tx_mask = ChannelRangeMask(left_free_ch, right_free_ch);
+			break;
+		}
 
-					case 3:{
+		// Always-map log2: TX in the larger channel range allowed by the log2 mapping
+		// TODO: (skectch) check if it is valid!
+		case CB_ALWAYS_MAX_LOG2:{
+			if(num_possible_ranges > 0) tx_mask = log2_channel_ranges.mask[primary_channel][num_possible_ranges - 1];
+			break;
+		}
 
-						channels_for_tx[primary_channel] = TRUE;
+		// Always-map (DCB) log2 with optimal MCS: picks the channel range + MCS providing max throughput
+		case CB_ALWAYS_MAX_LOG2_MCS:{
 
-						if(random_value == 2){
-							if(primary_channel % 2 == 1){	// If primary is odd
-								channels_for_tx[primary_channel - 1] = TRUE;
-							} else{
-								channels_for_tx[primary_channel + 1] = TRUE;
-							}
-						} else if( random_value == 3){
-							// Check primary and 3 secondaries
-							if(primary_channel > 3){	// primary in channel range 4-7
+			int modulation (0);
+			int modulation_num_channels_ix (0);
+			double max_throughput (0);
+			double aux_throughput (0);
 
-								channels_for_tx[4] = TRUE;
-								channels_for_tx[5] = TRUE;
-								channels_for_tx[6] = TRUE;
-								channels_for_tx[7] = TRUE;
+			// Log2 ranges not larger than the span of free channels
+			int num_channels (1);
+			while((num_channels << 1) <= right_free_ch - left_free_ch + 1) num_channels <<= 1;
 
-							} else { // primary in channel range 0-3
+			for(; num_channels > 0; num_channels >>= 1){
 
-								channels_for_tx[0] = TRUE;
-								channels_for_tx[1] = TRUE;
-								channels_for_tx[2] = TRUE;
-								channels_for_tx[3] = TRUE;
-							}
-						}
+				int left_tx_ch (primary_channel - primary_channel % num_channels);
+				int right_tx_ch (left_tx_ch + num_channels - 1);
+				unsigned int range_mask (ChannelRangeMask(left_tx_ch, right_tx_ch));
 
-						break;
-					}
+				// Check if tx channels are inside the allowed ones and free
+				if((left_tx_ch >= min_channel_allowed) && (right_tx_ch <= max_channel_allowed)
+					&& (free_mask & range_mask) == range_mask){
 
-					case 4:{
-
-						channels_for_tx[primary_channel] = TRUE;
-
-						if(random_value == 2){
-							if(primary_channel % 2 == 1){	// If primary is odd
-								channels_for_tx[primary_channel - 1] = TRUE;
-							} else{
-								channels_for_tx[primary_channel + 1] = TRUE;
-							}
-						} else if( random_value == 3){
-							// Check primary and 3 secondaries
-							if(primary_channel > 3){	// primary in channel range 4-7
-
-								channels_for_tx[4] = TRUE;
-								channels_for_tx[5] = TRUE;
-								channels_for_tx[6] = TRUE;
-								channels_for_tx[7] = TRUE;
-
-							} else { // primary in channel range 0-3
-
-								channels_for_tx[0] = TRUE;
-								channels_for_tx[1] = TRUE;
-								channels_for_tx[2] = TRUE;
-								channels_for_tx[3] = TRUE;
-							}
-						} else if(random_value == 4){
-							for(int c = 0; c < 8; ++c ){
-								channels_for_tx[c] = TRUE;
-							}
-						}
-						break;
-					}
+					/* MCS optimization */
+					modulation_num_channels_ix = __builtin_ctz(num_channels);
+					modulation = mcs_per_node[ix_mcs_per_node][modulation_num_channels_ix];
+					aux_throughput = Mcs_array::mcs_array[modulation_num_channels_ix][modulation-1];
 
-					default:{
-						break;
+					if(aux_throughput > max_throughput){
+						// TX channels found!
+						tx_mask |= range_mask;
 					}
-
 				}
-
-
-				break;
-
-
-				break;
 			}
+			break;
+		}
 
-			default:{
-				printf("channel_bonding_model %d is NOT VALID!\n", channel_bonding_model);
-				exit(EXIT_FAILURE);
-				break;
+		// Log2 probabilistic uniform: pick with same probabilty any available channel range
+		case CB_PROB_UNIFORM_LOG2:{
+			if(num_possible_ranges > 0) {
+				int random_value (rand() % num_possible_ranges);	// 0 to num_possible_ranges - 1
+				tx_mask = log2_channel_ranges.mask[primary_channel][random_value];
+			} else {
+				tx_possible = FALSE;
 			}
+			break;
 		}
-	} else {  // No channel is free
 
-	channels_for_tx[0] = TX_NOT_POSSIBLE;
+		default:{
+			printf("channel_bonding_model %d is NOT VALID!\n", channel_bonding_model);
+			exit(EXIT_FAILURE);
+			break;
+		}
+	}
 
+	if(tx_possible){
+		for(int c = 0; tx_mask != 0; ++c, tx_mask >>= 1){
+			if(tx_mask & 1u) channels_for_tx[c] = TRUE;
+		}
+	} else {
+		// TX not possible (code it with negative value)
+		channels_for_tx[0] = TX_NOT_POSSIBLE;
 	}
 
 }
@@ -1091,9 +928,9 @@ void PrintOrWriteChannelPower(int write_or_print, int save_node_logs, Logger nod
 		}
 		case WRITE_LOG:{
 			for(int c = 0; c < num_channels_komondor; ++c){
-				if(save_node_logs) fprintf(node_logger.file, "%f  ", ConvertPower(PW_TO_DBM, (*channel_power)[c]));
+				if(save_node_logs) LogPrintf(node_logger, "%f  ", ConvertPower(PW_TO_DBM, (*channel_power)[c]));
 			}
-			if(save_node_logs)  fprintf(node_logger.file, "\n");
+			if(save_node_logs)  LogPrintf(node_logger, "\n");
 			break;
 		}
 	}
@@ -1119,9 +956,9 @@ void PrintOrWriteChannelsFree(int write_or_print,
 		}
 		case WRITE_LOG:{
 			for(int c = 0; c < num_channels_komondor; ++c){
-				 if(save_node_logs) fprintf(node_logger.file, "%d ", channels_free[c]);
+				 if(save_node_logs) LogPrintf(node_logger, "%d ", channels_free[c]);
 			}
-			if(save_node_logs)  fprintf(node_logger.file, "\n");
+			if(save_node_logs)  LogPrintf(node_logger, "\n");
 			break;
 		}
 	}
@@ -1148,10 +985,10 @@ void PrintOrWriteNodesTransmitting(int write_or_print,
 		case WRITE_LOG:{
 			for(int n = 0; n < total_nodes_number; ++n){
 				 if(save_node_logs){
-					 if(nodes_transmitting[n])  fprintf(node_logger.file, "N%d ", n);
+					 if(nodes_transmitting[n])  LogPrintf(node_logger, "N%d ", n);
 				 }
 			}
-			if(save_node_logs)  fprintf(node_logger.file, "\n");
+			if(save_node_logs)  LogPrintf(node_logger, "\n");
 			break;
 		}
 	}
@@ -1178,9 +1015,9 @@ void PrintOrWriteChannelForTx(int write_or_print,
 		}
 		case WRITE_LOG:{
 			for(int c = 0; c < num_channels_komondor; ++c){
-				 if(save_node_logs)  fprintf(node_logger.file, "%d  ", channels_for_tx[c]);
+				 if(save_node_logs)  LogPrintf(node_logger, "%d  ", channels_for_tx[c]);
 			}
-			if(save_node_logs)  fprintf(node_logger.file, "\n");
+			if(save_node_logs)  LogPrintf(node_logger, "\n");
 			break;
 		}
 	}
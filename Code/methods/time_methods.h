@@ -49,7 +49,9 @@
 #include <math.h>
 #include <algorithm>
 #include <stddef.h>
+#include <vector>
 #include "../list_of_macros.h"
+#include "../structures/modulations.h"
 
 // Exponential redefinition
 double	Random( double v=1.0)	{ return v*drand48();}
@@ -297,3 +299,78 @@ void ComputeFramesDuration(double *rts_duration, double *cts_duration,
 	}
 
 }
+
+/*
+ * FrameDurationTable: frame durations and PHY rates for every MCS, number of channels (1, 2, 4 or 8)
+ * and number of packets aggregated. The domain is small and fixed during the simulation, so the table
+ * is built once per transmitter (Build()) and EndBackoff() only performs lookups.
+ **/
+struct FrameDurationTable {
+
+	int max_num_packets_aggregated;		// Max. number of packets aggregated covered by the table
+	double rts_duration;				// RTS duration [s]
+	double cts_duration;				// CTS duration [s]
+	double ack_duration_single;			// ACK duration for a single packet [s]
+	double ack_duration_aggregated;		// Block ACK duration for aggregated packets [s]
+	double bits_ofdm_sym[NUM_OPTIONS_CHANNEL_LENGTH][NUM_MODULATIONS];			// Bits per OFDM symbol [ix_num_channels][mcs-1]
+	int max_packets_in_ppdu[NUM_OPTIONS_CHANNEL_LENGTH][NUM_MODULATIONS];		// Packets fitting in the max. PPDU duration
+	std::vector<double> data_duration;	// DATA duration [s], indexed by DataIndex()
+
+	int DataIndex(int ix_num_channels, int modulation, int num_packets_aggregated) {
+		return (ix_num_channels * NUM_MODULATIONS + modulation - 1) * (max_num_packets_aggregated + 1)
+			+ num_packets_aggregated;
+	}
+
+	/*
+	 * Build(): computes every entry of the table
+	 * Input arguments:
+	 * - data_packet_length: length of a data packet [bits]
+	 * - max_num_packets_aggregated_in: max. number of packets aggregated in a PPDU
+	 **/
+	void Build(int data_packet_length, int max_num_packets_aggregated_in) {
+
+		max_num_packets_aggregated = max_num_packets_aggregated_in;
+		rts_duration = computeRtsTxTime80211ax(IEEE_BITS_OFDM_SYM_LEGACY);
+		cts_duration = computeCtsTxTime80211ax(IEEE_BITS_OFDM_SYM_LEGACY);
+		ack_duration_single = computeAckTxTime80211ax(1, IEEE_BITS_OFDM_SYM_LEGACY);
+		ack_duration_aggregated = computeAckTxTime80211ax(2, IEEE_BITS_OFDM_SYM_LEGACY);
+
+		data_duration.assign(NUM_OPTIONS_CHANNEL_LENGTH * NUM_MODULATIONS * (max_num_packets_aggregated + 1), 0);
+
+		for(int ix_ch = 0; ix_ch < NUM_OPTIONS_CHANNEL_LENGTH; ++ix_ch) {
+			for(int m = MODULATION_BPSK_1_2; m <= NUM_MODULATIONS; ++m) {
+				// data rate depending on CB and streams: Nsc * ym * yc * SUSS
+				bits_ofdm_sym[ix_ch][m-1] = getNumberSubcarriers(1 << ix_ch) *
+					Mcs_array::modulation_bits[m-1] *
+					Mcs_array::coding_rates[m-1] *
+					IEEE_AX_SU_SPATIAL_STREAMS;
+				max_packets_in_ppdu[ix_ch][m-1] = findMaximumPacketsAggregated(max_num_packets_aggregated,
+					data_packet_length, bits_ofdm_sym[ix_ch][m-1]);
+				// Data duration uses the integer bits per OFDM symbol (as in ComputeFramesDuration())
+				for(int n = 0; n <= max_num_packets_aggregated; ++n) {
+					data_duration[DataIndex(ix_ch, m, n)] = computeDataTxTime80211ax(n, data_packet_length,
+						(int) bits_ofdm_sym[ix_ch][m-1]);
+				}
+			}
+		}
+	}
+
+	/*
+	 * GetMaximumPacketsAggregated(): lookup equivalent of findMaximumPacketsAggregated()
+	 **/
+	int GetMaximumPacketsAggregated(int ix_num_channels, int modulation, int num_packets_aggregated) {
+		return std::min(num_packets_aggregated, max_packets_in_ppdu[ix_num_channels][modulation-1]);
+	}
+
+	/*
+	 * GetFramesDuration(): lookup equivalent of ComputeFramesDuration()
+	 **/
+	void GetFramesDuration(double *rts_duration_out, double *cts_duration_out, double *data_duration_out,
+			double *ack_duration_out, int ix_num_channels, int modulation, int num_packets_aggregated) {
+		*rts_duration_out = rts_duration;
+		*cts_duration_out = cts_duration;
+		*data_duration_out = data_duration[DataIndex(ix_num_channels, modulation, num_packets_aggregated)];
+		*ack_duration_out = (num_packets_aggregated == 1) ? ack_duration_single : ack_duration_aggregated;
+	}
+
+};
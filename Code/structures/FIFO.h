@@ -16,6 +16,7 @@ struct FIFO
 		void DelFirstPacket();		
 		void DeletePacketIn(int i);
 		void PutPacket(Notification &packet);
+		void PutPackets(Notification &packet, int num_packets);
 		void PutPacketFront(Notification &packet);
 		void PutPacketIn(Notification &packet, int);
 		int QueueSize();
@@ -42,6 +43,17 @@ void FIFO :: PutPacket(Notification &packet)
 	m_queue.push_back(packet);
 }; 
 
+/*
+ * PutPackets(): appends a block of packets in one operation. Packets are copies of 'packet' with
+ * consecutive identifiers starting from packet.packet_id.
+ */
+void FIFO :: PutPackets(Notification &packet, int num_packets)
+{
+	int first_position (m_queue.size());
+	m_queue.insert(m_queue.end(), num_packets, packet);
+	for(int i = 0; i < num_packets; ++i) m_queue[first_position + i].packet_id = packet.packet_id + i;
+};
+
 void FIFO :: PutPacketFront(Notification &packet)
 {	
 	m_queue.push_front(packet);
@@ -0,0 +1,162 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the input and the results of the analytical estimation mode (see
+ *   methods/analytical_methods.h) and the analytical options entered per console
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "../list_of_macros.h"
+
+#ifndef _AUX_ANALYTICAL_MODEL_
+#define _AUX_ANALYTICAL_MODEL_
+
+/*
+ * AnalyticalSta: link between an AP and one of its STAs
+ */
+struct AnalyticalSta
+{
+	double power_from_ap;								// Power received from the AP [pW]
+	std::vector<double> power_from_wlan;				// Power received from the AP of every WLAN [pW]
+	int mcs_response[NUM_OPTIONS_CHANNEL_LENGTH];		// MCS per number of channels (1, 2, 4 or 8)
+	double tx_duration[NUM_OPTIONS_CHANNEL_LENGTH];		// RTS-CTS-DATA-ACK exchange (DIFS included) per number of channels [s]
+	double bits[NUM_OPTIONS_CHANNEL_LENGTH];			// Data bits delivered per exchange per number of channels [bits]
+};
+
+/*
+ * AnalyticalWlan: contention parameters of a WLAN (the AP is the only transmitter)
+ */
+struct AnalyticalWlan
+{
+	int primary_channel;			// Primary channel
+	int min_channel_allowed;		// Min. allowed channel
+	int max_channel_allowed;		// Max. allowed channel
+	int dcb_policy;					// Channel bonding model
+	int cw_min;						// Backoff minimum Contention Window
+	int cw_stage_max;				// Backoff maximum Contention Window stage
+	double pd;						// Sensitivity (CCA) threshold of the AP [pW]
+	double offered_load;			// Offered load [bps] (negative: full buffer)
+	std::vector<AnalyticalSta> stas;	// STAs of the WLAN
+};
+
+/*
+ * AnalyticalScenario: input of the analytical estimation, built from the same system and nodes files
+ * as the simulation (WLANs in the order of the nodes file)
+ */
+struct AnalyticalScenario
+{
+	std::vector<AnalyticalWlan> wlans;			// WLANs of the system
+	std::vector<double> power_between_aps;		// Power received by the AP of WLAN w from the AP of WLAN v [pW], at [w*N+v]
+	int num_channels;							// Number of channels of the system
+	int cw_adaptation;							// CW adaptation (0: constant, 1: binary exponential backoff)
+	double collision_duration;					// Duration of a failed RTS-CTS exchange (DIFS included) [s]
+	double noise_level;							// Environment noise [pW]
+	double capture_effect;						// Capture effect threshold [linear ratio]
+	double constant_per;						// Constant PER for successful transmissions
+
+	double PowerBetweenAps(int w, int v) const {
+		return power_between_aps[(size_t) w * wlans.size() + v];
+	}
+};
+
+/*
+ * AnalyticalWlanResult: estimated performance of a WLAN
+ */
+struct AnalyticalWlanResult
+{
+	int model;					// Model used for the WLAN (ANALYTICAL_MODEL_BIANCHI or ANALYTICAL_MODEL_CTMN)
+	int num_states;				// States of the CTMN solved for the group of WLANs (0: Bianchi)
+	double throughput;			// Throughput [bps]
+	double prob_failure;		// Probability that a transmission fails (collision or insufficient SINR)
+	double occupancy;			// Fraction of time the AP is transmitting
+	double av_num_channels;		// Average number of channels used per transmission
+};
+
+/*
+ * AnalyticalConfig: analytical estimation options entered per console
+ */
+struct AnalyticalConfig
+{
+	int enabled;				// TRUE: estimate the performance analytically instead of simulating
+	int max_states;				// Max. number of states of a CTMN
+
+	AnalyticalConfig() : enabled(FALSE), max_states(ANALYTICAL_DEFAULT_MAX_STATES) {}
+
+	/*
+	 * ParseArgument(): parses an analytical console argument
+	 * Input arguments:
+	 * - argument: console argument. Accepted options:
+	 *   --analytical					estimate the performance analytically (no simulation)
+	 *   --analytical_max_states=<N>	max. number of states of a CTMN
+	 * Output:
+	 * - TRUE if the argument is an analytical option, FALSE otherwise
+	 */
+	int ParseArgument(const char *argument){
+
+		if(strcmp(argument, "--analytical") == 0){
+			enabled = TRUE;
+
+		} else if(strncmp(argument, "--analytical_max_states=", 24) == 0){
+			max_states = atoi(argument + 24);
+			if(max_states < 1){
+				printf("ERROR: --analytical_max_states must be positive\n");
+				exit(-1);
+			}
+
+		} else {
+			return FALSE;
+		}
+		return TRUE;
+	}
+};
+
+AnalyticalConfig analytical_config;
+
+#endif
@@ -0,0 +1,275 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the asynchronous log pipeline (opt-in, log_writer_mode != LOG_WRITER_SYNC): the
+ *   components (nodes, agents, central controller) queue their log lines, tagged with their log sink
+ *   owner, into one single-producer ring per log sink shard, and a background writer thread drains the
+ *   rings to the sharded log sink. Memory is thus bounded by the number of shards, not of components.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include "../list_of_macros.h"
+#include "log_sink.h"
+
+#ifndef _AUX_ASYNC_LOG_
+#define _AUX_ASYNC_LOG_
+
+struct LogRing;
+
+/*
+ * AsyncLogWriter: background thread draining the log rings (one ring per log sink shard)
+ */
+struct AsyncLogWriter
+{
+	std::thread thread;						// Writer thread
+	std::mutex mutex;						// Protects 'rings', the draining and the thread lifecycle
+	std::condition_variable wake_up;		// Signals the writer thread that there is work to do
+	std::vector<LogRing*> rings;			// Ring of each log sink shard (created by the first OpenRing())
+	std::atomic<bool> running;				// TRUE while the writer thread is alive
+
+	AsyncLogWriter() : running(false) {}
+
+	~AsyncLogWriter(){
+		Stop();
+	}
+
+	LogRing *OpenRing(int sink_owner_id, int log_writer_mode);
+	void Stop();
+	void Run();
+	size_t DrainAll();
+	void Flush();
+
+	void WakeUp(){
+		wake_up.notify_one();
+	}
+};
+
+AsyncLogWriter async_log_writer;	// Writer shared by all the components of the simulation
+
+/*
+ * LogRing: lock-free single-producer/single-consumer byte ring of a log sink shard. The producer is the
+ * simulation thread (shared by all the components) and the consumer is the writer thread. Messages are
+ * stored as log sink records: owner id (uint32), length (uint32) and bytes.
+ */
+struct LogRing
+{
+	std::vector<char> buffer;			// Ring storage (LOG_RING_SIZE bytes)
+	std::atomic<size_t> head;			// Bytes written by the producer (monotonic)
+	std::atomic<size_t> tail;			// Bytes written to the log sink by the consumer (monotonic)
+	int backpressure_mode;				// LOG_WRITER_ASYNC_BLOCK or LOG_WRITER_ASYNC_DROP
+	std::vector<unsigned long long> num_dropped;	// Messages dropped (ring full) per owner id
+
+	LogRing(int log_writer_mode) : buffer(LOG_RING_SIZE), head(0), tail(0), backpressure_mode(log_writer_mode) {}
+
+	/*
+	 * NumDropped(): messages of an owner dropped because the ring was full
+	 */
+	unsigned long long NumDropped(int owner_id){
+		return (owner_id < (int) num_dropped.size()) ? num_dropped[owner_id] : 0;
+	}
+
+	/*
+	 * Push(): queues a message of an owner (producer side). Messages longer than LOG_RING_MAX_RECORD
+	 * are queued as several consecutive records.
+	 * Input arguments:
+	 * - owner_id: log sink owner of the message
+	 * - message: bytes to be written
+	 * - length: number of bytes
+	 */
+	void Push(int owner_id, const char *message, size_t length){
+
+		size_t write_ix = head.load(std::memory_order_relaxed);
+
+		if(backpressure_mode == LOG_WRITER_ASYNC_DROP
+			&& LOG_RING_SIZE - (write_ix - tail.load(std::memory_order_acquire))
+				< length + LOG_SINK_RECORD_HEADER_SIZE * (1 + length / LOG_RING_MAX_RECORD)){
+			if(owner_id >= (int) num_dropped.size()) num_dropped.resize(owner_id + 1, 0);
+			++num_dropped[owner_id];
+			return;
+		}
+
+		while(length > 0){
+			size_t record_length (std::min(length, (size_t) LOG_RING_MAX_RECORD));
+			// In blocking mode, wait for the writer to free space for the whole record
+			while(LOG_RING_SIZE - (write_ix - tail.load(std::memory_order_acquire))
+					< record_length + LOG_SINK_RECORD_HEADER_SIZE){
+				WaitForWriter();
+			}
+			uint32_t header[2] = {(uint32_t) owner_id, (uint32_t) record_length};
+			write_ix = CopyIn(write_ix, (const char *) header, LOG_SINK_RECORD_HEADER_SIZE);
+			write_ix = CopyIn(write_ix, message, record_length);
+			head.store(write_ix, std::memory_order_release);
+			message += record_length;
+			length -= record_length;
+		}
+	}
+
+	/*
+	 * CopyIn(): copies bytes at a position of the ring (wrapping around its end)
+	 * Output:
+	 * - position following the copied bytes
+	 */
+	size_t CopyIn(size_t write_ix, const char *bytes, size_t length){
+		size_t offset = write_ix & (LOG_RING_SIZE - 1);
+		size_t first_part = std::min(length, (size_t) LOG_RING_SIZE - offset);
+		memcpy(&buffer[offset], bytes, first_part);
+		memcpy(&buffer[0], bytes + first_part, length - first_part);
+		return write_ix + length;
+	}
+
+	/*
+	 * Drain(): appends every queued record to the log sink (consumer side, writer mutex held)
+	 * Output:
+	 * - number of bytes drained
+	 */
+	size_t Drain(){
+
+		size_t read_ix = tail.load(std::memory_order_relaxed);
+		size_t end_ix = head.load(std::memory_order_acquire);
+		size_t available = end_ix - read_ix;
+
+		while(read_ix != end_ix){
+			uint32_t header[2];
+			char *header_bytes = (char *) header;
+			for(int b = 0; b < LOG_SINK_RECORD_HEADER_SIZE; ++b){
+				header_bytes[b] = buffer[(read_ix + b) & (LOG_RING_SIZE - 1)];
+			}
+			read_ix += LOG_SINK_RECORD_HEADER_SIZE;
+			size_t offset = read_ix & (LOG_RING_SIZE - 1);
+			size_t first_part = std::min((size_t) header[1], (size_t) LOG_RING_SIZE - offset);
+			log_sink.Append(header[0], &buffer[offset], first_part, &buffer[0], header[1] - first_part);
+			read_ix += header[1];
+		}
+
+		tail.store(end_ix, std::memory_order_release);
+		return available;
+	}
+
+	/*
+	 * WaitForWriter(): lets the writer thread make progress. If it has already been stopped
+	 * (e.g., components writing after Komondor::Stop()), the producer drains the ring itself.
+	 */
+	void WaitForWriter(){
+		if(async_log_writer.running.load()){
+			async_log_writer.WakeUp();
+			std::this_thread::yield();
+		} else {
+			std::lock_guard<std::mutex> lock(async_log_writer.mutex);
+			Drain();
+		}
+	}
+};
+
+/*
+ * OpenRing(): returns the ring of the log sink shard of an owner (creating the rings and starting the
+ * writer thread the first time)
+ * Input arguments:
+ * - sink_owner_id: owner id of the component in the log sink
+ * - log_writer_mode: LOG_WRITER_ASYNC_BLOCK or LOG_WRITER_ASYNC_DROP
+ */
+LogRing *AsyncLogWriter :: OpenRing(int sink_owner_id, int log_writer_mode){
+	std::lock_guard<std::mutex> lock(mutex);
+	if(rings.empty()){
+		for(int k = 0; k < log_sink.num_shards; ++k) rings.push_back(new LogRing(log_writer_mode));
+	}
+	if(!running.load()){
+		if(thread.joinable()) thread.join();
+		running.store(true);
+		thread = std::thread(&AsyncLogWriter::Run, this);
+	}
+	return rings[sink_owner_id % rings.size()];
+}
+
+/*
+ * Stop(): drains all the rings and terminates the writer thread (the rings are kept for the
+ * components still writing, which drain them themselves)
+ */
+void AsyncLogWriter :: Stop(){
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if(!running.load()) return;
+		running.store(false);
+	}
+	WakeUp();
+	thread.join();
+	std::lock_guard<std::mutex> lock(mutex);
+	DrainAll();
+}
+
+/*
+ * Flush(): writes every queued message to the log sink (producer side)
+ */
+void AsyncLogWriter :: Flush(){
+	std::lock_guard<std::mutex> lock(mutex);
+	DrainAll();
+}
+
+size_t AsyncLogWriter :: DrainAll(){
+	size_t num_bytes (0);
+	for(size_t i = 0; i < rings.size(); ++i) num_bytes += rings[i]->Drain();
+	return num_bytes;
+}
+
+void AsyncLogWriter :: Run(){
+	std::unique_lock<std::mutex> lock(mutex);
+	while(running.load()){
+		if(DrainAll() == 0){
+			wake_up.wait_for(lock, std::chrono::microseconds(LOG_WRITER_IDLE_WAIT_US));
+		}
+	}
+}
+
+#endif
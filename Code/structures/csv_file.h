@@ -0,0 +1,281 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the loader of the input CSV files (system, nodes and agents): the file is
+ *   memory-mapped and indexed in a single pass, fields are read in place (no copies, no strtok)
+ *   and any malformed value is reported with its file, line and column.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+#include "../list_of_macros.h"
+
+#ifndef _AUX_CSV_FILE_
+#define _AUX_CSV_FILE_
+
+/*
+ * CsvFile: input CSV file (';'-separated fields, first line being the header)
+ * - Rows and fields are numbered as in list_of_macros.h: rows from 0 (header excluded), fields from 1.
+ * - Blank lines are ignored.
+ */
+struct CsvFile
+{
+	std::string filename;
+	const char *data;					// Content of the file (mapped, or copied if it does not end with '\n')
+	size_t size;
+	int mapped;							// TRUE if data is mapped (FALSE if it is a heap copy)
+	std::vector<size_t> field_offsets;	// Offset of each field (fields of each row are contiguous)
+	std::vector<size_t> field_ends;		// End of each field (';', '\r' or '\n')
+	std::vector<size_t> row_first_field;	// Index of the first field of each row (plus one past the last row)
+	std::vector<int> row_lines;			// Line of each row in the file (1-based)
+
+	CsvFile() : data(NULL), size(0), mapped(FALSE) {}
+
+	~CsvFile(){
+		Close();
+	}
+
+	/*
+	 * Load(): maps the file and indexes its rows and fields
+	 * Input arguments:
+	 * - file_path: path of the CSV file (the program exits if it cannot be read)
+	 */
+	void Load(const char *file_path){
+
+		Close();
+		filename = file_path;
+		int fd (open(file_path, O_RDONLY));
+		struct stat file_stat;
+		if(fd < 0 || fstat(fd, &file_stat) != 0){
+			printf("ERROR: input file '%s' not found!\n", file_path);
+			exit(-1);
+		}
+		size = file_stat.st_size;
+
+		// Numbers are parsed in place: the content must end with a delimiter so that strtod() stops inside it
+		if(size > 0){
+			void *map (mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0));
+			if(map == MAP_FAILED){
+				printf("ERROR: input file '%s' could not be mapped\n", file_path);
+				exit(-1);
+			}
+			data = (const char *) map;
+			mapped = TRUE;
+		}
+		if(size == 0 || data[size - 1] != '\n'){
+			char *copy ((char *) malloc(size + 1));
+			if(size > 0) memcpy(copy, data, size);
+			copy[size] = '\n';
+			if(mapped) munmap((void *) data, size);
+			data = copy;
+			size = size + 1;
+			mapped = FALSE;
+		}
+		close(fd);
+
+		Index();
+	}
+
+	/*
+	 * Close(): releases the content of the file
+	 */
+	void Close(){
+		if(data != NULL){
+			if(mapped) munmap((void *) data, size);
+			else free((void *) data);
+		}
+		data = NULL;
+		size = 0;
+		mapped = FALSE;
+		field_offsets.clear();
+		field_ends.clear();
+		row_first_field.clear();
+		row_lines.clear();
+	}
+
+	/*
+	 * Index(): finds the rows and fields of the file in a single pass (the header line is skipped)
+	 */
+	void Index(){
+
+		size_t position (0);
+		int line (1);
+
+		// Header
+		while(position < size && data[position] != '\n') ++position;
+		++position;
+		++line;
+
+		while(position < size){
+			size_t line_end (position);
+			while(data[line_end] != '\n') ++line_end;
+			size_t content_end (line_end);
+			if(content_end > position && data[content_end - 1] == '\r') --content_end;
+
+			int blank (TRUE);
+			for(size_t c = position; c < content_end && blank; ++c) blank = (data[c] == ' ' || data[c] == '\t');
+			if(!blank){
+				row_first_field.push_back(field_offsets.size());
+				row_lines.push_back(line);
+				size_t field_start (position);
+				for(size_t c = position; c <= content_end; ++c){
+					if(c == content_end || data[c] == ';'){
+						field_offsets.push_back(field_start);
+						field_ends.push_back(c);
+						field_start = c + 1;
+					}
+				}
+			}
+			position = line_end + 1;
+			++line;
+		}
+		row_first_field.push_back(field_offsets.size());
+	}
+
+	/*
+	 * NumRows(): number of rows (header and blank lines excluded)
+	 */
+	int NumRows() const {
+		return (int) row_lines.size();
+	}
+
+	/*
+	 * HasField(): TRUE if the row contains a non-empty field (used for optional columns)
+	 */
+	int HasField(int row, int field_ix) const {
+		size_t field (row_first_field[row] + field_ix - 1);
+		return field_ix >= 1 && field < row_first_field[row + 1] && field_ends[field] > field_offsets[field];
+	}
+
+	/*
+	 * Error(): reports a malformed field and exits
+	 */
+	void Error(int row, int field_ix, const char *field_name, const char *message) const {
+		size_t field (row_first_field[row] + field_ix - 1);
+		if(field < row_first_field[row + 1]){
+			size_t line_start (field_offsets[row_first_field[row]]);
+			printf("ERROR: %s:%d:%d: field '%s' (#%d) %s: '%.*s'\n", filename.c_str(), row_lines[row],
+				(int) (field_offsets[field] - line_start + 1), field_name, field_ix, message,
+				(int) (field_ends[field] - field_offsets[field]), data + field_offsets[field]);
+		} else {
+			printf("ERROR: %s:%d: field '%s' (#%d) %s (the line has %d fields)\n", filename.c_str(), row_lines[row],
+				field_name, field_ix, message, (int) (row_first_field[row + 1] - row_first_field[row]));
+		}
+		exit(-1);
+	}
+
+	/*
+	 * GetString(): text of a field
+	 */
+	std::string GetString(int row, int field_ix, const char *field_name) const {
+		if(!HasField(row, field_ix)) Error(row, field_ix, field_name, "is missing");
+		size_t field (row_first_field[row] + field_ix - 1);
+		return std::string(data + field_offsets[field], field_ends[field] - field_offsets[field]);
+	}
+
+	/*
+	 * ParseNumber(): parses a number between begin and end (surrounding blanks allowed)
+	 * Output:
+	 * - TRUE if the whole text is a number
+	 */
+	static int ParseNumber(const char *begin, const char *end, double *value){
+		while(begin < end && (*begin == ' ' || *begin == '\t')) ++begin;
+		if(begin == end) return FALSE;
+		char *number_end;
+		*value = strtod(begin, &number_end);
+		if(number_end == begin || number_end > end) return FALSE;
+		while(number_end < end && (*number_end == ' ' || *number_end == '\t')) ++number_end;
+		return number_end == end;
+	}
+
+	/*
+	 * GetDouble(): numeric value of a field
+	 */
+	double GetDouble(int row, int field_ix, const char *field_name) const {
+		if(!HasField(row, field_ix)) Error(row, field_ix, field_name, "is missing");
+		size_t field (row_first_field[row] + field_ix - 1);
+		double value;
+		if(!ParseNumber(data + field_offsets[field], data + field_ends[field], &value)){
+			Error(row, field_ix, field_name, "is not a number");
+		}
+		return value;
+	}
+
+	/*
+	 * GetInt(): integer value of a field (decimals are truncated, as atoi() did with the former parser)
+	 */
+	int GetInt(int row, int field_ix, const char *field_name) const {
+		return (int) GetDouble(row, field_ix, field_name);
+	}
+
+	/*
+	 * GetList(): numeric values of a comma-separated field (e.g., "-82, -62")
+	 */
+	void GetList(int row, int field_ix, const char *field_name, std::vector<double> &values) const {
+		if(!HasField(row, field_ix)) Error(row, field_ix, field_name, "is missing");
+		size_t field (row_first_field[row] + field_ix - 1);
+		values.clear();
+		const char *item (data + field_offsets[field]);
+		const char *field_end (data + field_ends[field]);
+		while(item <= field_end){
+			const char *item_end (item);
+			while(item_end < field_end && *item_end != ',') ++item_end;
+			double value;
+			if(!ParseNumber(item, item_end, &value)) Error(row, field_ix, field_name, "is not a list of numbers");
+			values.push_back(value);
+			item = item_end + 1;
+		}
+	}
+};
+
+#endif
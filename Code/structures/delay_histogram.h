@@ -0,0 +1,148 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the delay histograms: HDR-style log-bucketed histograms with a fixed
+ *   number of buckets (exact below 2^SUB_BUCKET_BITS units, bounded relative error above),
+ *   updated in O(1) per frame and mergeable across nodes, WLANs and simulations.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "../list_of_macros.h"
+
+#ifndef _AUX_DELAY_HISTOGRAM_
+#define _AUX_DELAY_HISTOGRAM_
+
+const int DELAY_HISTOGRAM_HALF_SUB_BUCKETS = 1 << (DELAY_HISTOGRAM_SUB_BUCKET_BITS - 1);
+const int DELAY_HISTOGRAM_NUM_BUCKETS = (DELAY_HISTOGRAM_MAX_EXPONENT - DELAY_HISTOGRAM_SUB_BUCKET_BITS + 3)
+	* DELAY_HISTOGRAM_HALF_SUB_BUCKETS;
+
+/*
+ * DelayHistogram: histogram of packet delays
+ * - Values below 2^SUB_BUCKET_BITS units have their own bucket. Above, every power of two is split
+ *   into 2^(SUB_BUCKET_BITS-1) buckets, so that the relative error of a bucket is bounded.
+ */
+struct DelayHistogram
+{
+	unsigned long long counts[DELAY_HISTOGRAM_NUM_BUCKETS];
+	unsigned long long total_count;
+	double max_delay;		// Exact maximum [s]
+
+	DelayHistogram(){
+		Reset();
+	}
+
+	/*
+	 * Reset(): removes every measurement
+	 */
+	void Reset(){
+		memset(counts, 0, sizeof(counts));
+		total_count = 0;
+		max_delay = 0;
+	}
+
+	/*
+	 * BucketIndex(): bucket of a value expressed in units
+	 */
+	static int BucketIndex(unsigned long long value){
+		if(value < (1ULL << DELAY_HISTOGRAM_SUB_BUCKET_BITS)) return (int) value;
+		int msb (63 - __builtin_clzll(value));
+		if(msb > DELAY_HISTOGRAM_MAX_EXPONENT) return DELAY_HISTOGRAM_NUM_BUCKETS - 1;
+		int shift (msb - (DELAY_HISTOGRAM_SUB_BUCKET_BITS - 1));
+		return shift * DELAY_HISTOGRAM_HALF_SUB_BUCKETS + (int) (value >> shift);
+	}
+
+	/*
+	 * BucketValue(): value represented by a bucket (middle of its range) [s]
+	 */
+	static double BucketValue(int bucket){
+		if(bucket < (1 << DELAY_HISTOGRAM_SUB_BUCKET_BITS)) return bucket * DELAY_HISTOGRAM_UNIT;
+		int shift (bucket / DELAY_HISTOGRAM_HALF_SUB_BUCKETS - 1);
+		unsigned long long lowest ((unsigned long long) (bucket - shift * DELAY_HISTOGRAM_HALF_SUB_BUCKETS) << shift);
+		return (lowest + ((1ULL << shift) - 1) / 2.0) * DELAY_HISTOGRAM_UNIT;
+	}
+
+	/*
+	 * Add(): adds a delay measurement [s]
+	 */
+	void Add(double delay){
+		if(delay < 0) delay = 0;
+		++counts[BucketIndex((unsigned long long) (delay / DELAY_HISTOGRAM_UNIT + 0.5))];
+		++total_count;
+		if(delay > max_delay) max_delay = delay;
+	}
+
+	/*
+	 * Merge(): adds the measurements of another histogram
+	 */
+	void Merge(const DelayHistogram &other){
+		for(int b = 0; b < DELAY_HISTOGRAM_NUM_BUCKETS; ++b) counts[b] += other.counts[b];
+		total_count += other.total_count;
+		if(other.max_delay > max_delay) max_delay = other.max_delay;
+	}
+
+	/*
+	 * Percentile(): delay below which a given fraction of the measurements fall
+	 * Input arguments:
+	 * - fraction: fraction of the measurements (e.g., 0.99 for the 99th percentile)
+	 * Output:
+	 * - delay [s] (0 if there are no measurements, never above the exact maximum)
+	 */
+	double Percentile(double fraction) const {
+		if(total_count == 0) return 0;
+		unsigned long long rank ((unsigned long long) ceil(fraction * total_count));
+		if(rank < 1) rank = 1;
+		if(rank >= total_count) return max_delay;
+		unsigned long long accumulated (0);
+		for(int b = 0; b < DELAY_HISTOGRAM_NUM_BUCKETS; ++b){
+			accumulated += counts[b];
+			if(accumulated >= rank) return BucketValue(b) < max_delay ? BucketValue(b) : max_delay;
+		}
+		return max_delay;
+	}
+};
+
+#endif
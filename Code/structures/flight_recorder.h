@@ -0,0 +1,440 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the flight recorder: a fixed-size in-memory ring with the last log events
+ *   of a node (LOGS call site and raw argument slots, see trace.h). Recording an event only stores
+ *   its arguments in the ring: nothing is formatted or written during normal operation. The ring is
+ *   formatted and dumped, together with the node state, when a trigger fires. If the process aborts,
+ *   every ring is written with write(2) as a binary trace (decode it with 'trace_decoder').
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <type_traits>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../list_of_macros.h"
+#include "trace.h"
+
+#ifndef _AUX_FLIGHT_RECORDER_
+#define _AUX_FLIGHT_RECORDER_
+
+/*
+ * FlightRecorderConfig: flight recorder options entered per console
+ */
+struct FlightRecorderConfig
+{
+	int num_events;			// Events kept per node
+	unsigned int triggers;	// Enabled triggers (FLIGHT_RECORDER_TRIGGER_XXX bitmask)
+	int max_dumps;			// Maximum number of dumps per node
+
+	FlightRecorderConfig() : num_events(FLIGHT_RECORDER_DEFAULT_EVENTS), triggers(FLIGHT_RECORDER_TRIGGER_ALL),
+		max_dumps(FLIGHT_RECORDER_DEFAULT_MAX_DUMPS) {}
+
+	/*
+	 * ParseArgument(): parses a flight recorder console argument
+	 * Input arguments:
+	 * - argument: console argument. Accepted options:
+	 *   --flight_recorder_events=<N>		events kept per node
+	 *   --flight_recorder_max_dumps=<N>	dumps written per node
+	 *   --flight_recorder_triggers=<list>	comma-separated list of bo_collision, ack_timeout, cts_timeout, nack, abort
+	 * Output:
+	 * - TRUE if the argument is a flight recorder option, FALSE otherwise
+	 */
+	int ParseArgument(const char *argument){
+
+		if(strncmp(argument, "--flight_recorder_events=", 25) == 0){
+			num_events = atoi(argument + 25);
+			if(num_events < 1){
+				printf("ERROR: --flight_recorder_events must be positive\n");
+				exit(-1);
+			}
+
+		} else if(strncmp(argument, "--flight_recorder_max_dumps=", 28) == 0){
+			max_dumps = atoi(argument + 28);
+
+		} else if(strncmp(argument, "--flight_recorder_triggers=", 27) == 0){
+			triggers = 0;
+			std::string list(argument + 27);
+			size_t from = 0;
+			while(from <= list.size()){
+				size_t to = list.find(',', from);
+				if(to == std::string::npos) to = list.size();
+				std::string trigger = list.substr(from, to - from);
+				if(trigger == "bo_collision") triggers |= FLIGHT_RECORDER_TRIGGER_BO_COLLISION;
+				else if(trigger == "ack_timeout") triggers |= FLIGHT_RECORDER_TRIGGER_ACK_TIMEOUT;
+				else if(trigger == "cts_timeout") triggers |= FLIGHT_RECORDER_TRIGGER_CTS_TIMEOUT;
+				else if(trigger == "nack") triggers |= FLIGHT_RECORDER_TRIGGER_NACK;
+				else if(trigger == "abort") triggers |= FLIGHT_RECORDER_TRIGGER_ABORT;
+				else {
+					printf("ERROR: unknown flight recorder trigger '%s'\n", trigger.c_str());
+					exit(-1);
+				}
+				from = to + 1;
+			}
+
+		} else {
+			return FALSE;
+		}
+		return TRUE;
+	}
+};
+
+FlightRecorderConfig flight_recorder_config;
+
+/*
+ * FlightRecorder: ring with the last log events of a node
+ */
+struct FlightRecorder
+{
+	struct Event
+	{
+		const LogSite *site;						// Call site (format string and argument types)
+		uint64_t args[FLIGHT_RECORDER_MAX_ARGS];	// Arguments (see LogSlotOf())
+		char strings[FLIGHT_RECORDER_STRING_SIZE];	// Copies of the strings passed by pointer (truncated)
+	};
+
+	std::vector<Event> events;				// Ring of events (allocated once in Open())
+	size_t next_event;						// Position of the next event in the ring
+	unsigned long long num_recorded;		// Events recorded since the beginning
+	int owner_id;							// Identifier of the owner (node id)
+	std::string filename;					// File where dumps are appended
+	int num_dumps;							// Dumps written so far
+	std::function<void(FILE *)> write_state;	// Writes the state of the owner at dump time
+
+	FlightRecorder() : next_event(0), num_recorded(0), owner_id(-1), num_dumps(0) {}
+
+	void Open(int num_events, int id, const char *dump_filename, const char *abort_filename,
+		std::function<void(FILE *)> state_writer);
+	void Close();
+	void Dump(const char *reason, double sim_time);
+	void Record(const char *format, va_list args);
+
+	/*
+	 * Record(): stores an event of a LOGS call site, overwriting the oldest one. Arguments are stored
+	 * by type in their slots; only strings passed by pointer are copied (string literals, such as the
+	 * LOG_Xnn codes, are kept by address).
+	 * Input arguments:
+	 * - site: call site
+	 * - args: arguments of the call
+	 */
+	template <typename... Args>
+	void Record(const LogSite &site, const Args&... args){
+		static_assert(sizeof...(Args) <= FLIGHT_RECORDER_MAX_ARGS, "too many arguments for the flight recorder");
+		Event &event = NextEvent();
+		event.site = &site;
+		size_t strings_used (0);
+		uint64_t *slot (event.args);
+		int expand[] = {0, (*slot++ = Slot(event, strings_used, args), 0)...};
+		(void) expand;
+		(void) slot;
+		(void) strings_used;
+	}
+
+	Event &NextEvent(){
+		Event &event = events[next_event];
+		if(++next_event == events.size()) next_event = 0;
+		++num_recorded;
+		return event;
+	}
+
+	template <typename T>
+	static typename std::enable_if<!(std::is_pointer<T>::value && std::is_same<char,
+		typename std::remove_cv<typename std::remove_pointer<T>::type>::type>::value), uint64_t>::type
+	Slot(Event &, size_t &, const T &value){
+		return LogSlotOf(value);
+	}
+
+	template <typename T>
+	static typename std::enable_if<std::is_pointer<T>::value && std::is_same<char,
+		typename std::remove_cv<typename std::remove_pointer<T>::type>::type>::value, uint64_t>::type
+	Slot(Event &event, size_t &strings_used, const T &value){
+		return CopyString(event, strings_used, value);
+	}
+
+	/*
+	 * CopyString(): copies a string in the strings of an event and returns its slot
+	 */
+	static uint64_t CopyString(Event &event, size_t &strings_used, const char *value){
+		if(value == NULL) return 0;
+		char *copy (event.strings + strings_used);
+		size_t length (0);
+		while(strings_used + length + 1 < FLIGHT_RECORDER_STRING_SIZE && value[length] != '\0'){
+			copy[length] = value[length];
+			++length;
+		}
+		if(strings_used + length >= FLIGHT_RECORDER_STRING_SIZE) return LogSlotOf("");
+		copy[length] = '\0';
+		strings_used += length + 1;
+		return LogSlotOf(copy);
+	}
+};
+
+std::vector<FlightRecorder*> flight_recorders;	// Recorders currently open (dumped if the process aborts)
+std::string flight_recorder_abort_filename;		// Binary trace written if the process aborts
+int flight_recorder_abort_fd (-1);				// Opened with the first recorder (write(2) is async-signal-safe)
+char flight_recorder_abort_buffer[FLIGHT_RECORDER_ABORT_BUFFER_SIZE];	// Preallocated for the abort handler
+
+/*
+ * FlightRecorderAbortSite(): site of the header written before the events of each recorder in the abort dump
+ */
+const LogSite &FlightRecorderAbortSite(){
+	static LogSite abort_site("\n==== FLIGHT RECORDER N%d: process aborted (last %llu events) ====\n");
+	return abort_site;
+}
+
+/*
+ * FindFlightRecorder(): returns the open recorder of a given owner (NULL if none)
+ */
+FlightRecorder *FindFlightRecorder(int owner_id){
+	for(size_t i = 0; i < flight_recorders.size(); ++i){
+		if(flight_recorders[i]->owner_id == owner_id) return flight_recorders[i];
+	}
+	return NULL;
+}
+
+/*
+ * FlightRecorderAbortOutput: fills the preallocated abort buffer and writes it with write(2)
+ */
+struct FlightRecorderAbortOutput
+{
+	size_t used;
+
+	FlightRecorderAbortOutput() : used(0) {}
+
+	void Put(const void *data, size_t num_bytes){
+		const char *p = (const char *) data;
+		while(num_bytes > 0){
+			size_t chunk (FLIGHT_RECORDER_ABORT_BUFFER_SIZE - used);
+			if(chunk > num_bytes) chunk = num_bytes;
+			memcpy(flight_recorder_abort_buffer + used, p, chunk);
+			used += chunk;
+			p += chunk;
+			num_bytes -= chunk;
+			if(used == FLIGHT_RECORDER_ABORT_BUFFER_SIZE) Flush();
+		}
+	}
+
+	void Flush(){
+		size_t written (0);
+		while(written < used){
+			ssize_t result (write(flight_recorder_abort_fd, flight_recorder_abort_buffer + written, used - written));
+			if(result <= 0) break;
+			written += result;
+		}
+		used = 0;
+	}
+};
+
+/*
+ * FlightRecorderAbortHandler(): writes every open recorder before the process terminates. Only
+ * async-signal-safe calls are made: the events are copied to a preallocated buffer and written
+ * with write(2) as a binary trace (format records of every site, then the events of each recorder).
+ */
+void FlightRecorderAbortHandler(int signal_number){
+	signal(signal_number, SIG_DFL);
+	if((flight_recorder_config.triggers & FLIGHT_RECORDER_TRIGGER_ABORT) && flight_recorder_abort_fd >= 0){
+		FlightRecorderAbortOutput output;
+		output.Put(TRACE_MAGIC, TRACE_MAGIC_SIZE);
+		for(size_t s = 0; s < log_sites.size(); ++s){
+			char record_type (TRACE_RECORD_FORMAT);
+			uint32_t format_length ((uint32_t) strlen(log_sites[s]->format));
+			uint32_t no_string (0);	// LOG code and level (only used by TRACE_RECORD_LOG)
+			output.Put(&record_type, 1);
+			output.Put(&log_sites[s]->site_id, sizeof(uint32_t));
+			output.Put(&format_length, sizeof(format_length));
+			output.Put(log_sites[s]->format, format_length);
+			output.Put(&no_string, sizeof(no_string));
+			output.Put(&no_string, sizeof(no_string));
+		}
+		const LogSite &abort_site (FlightRecorderAbortSite());
+		for(size_t r = 0; r < flight_recorders.size(); ++r){
+			const FlightRecorder &recorder (*flight_recorders[r]);
+			size_t num_events (recorder.events.size());
+			if(recorder.num_recorded < num_events) num_events = (size_t) recorder.num_recorded;
+			char record_type (TRACE_RECORD_EVENT);
+			uint64_t header_args[2] = {LogSlotOf(recorder.owner_id), LogSlotOf(num_events)};
+			output.Put(&record_type, 1);
+			output.Put(&abort_site.site_id, sizeof(uint32_t));
+			AppendLogSlots(output, abort_site, header_args);
+			size_t position ((recorder.next_event + recorder.events.size() - num_events) % recorder.events.size());
+			for(size_t i = 0; i < num_events; ++i){
+				const FlightRecorder::Event &event (recorder.events[position]);
+				output.Put(&record_type, 1);
+				output.Put(&event.site->site_id, sizeof(uint32_t));
+				AppendLogSlots(output, *event.site, event.args);
+				if(++position == recorder.events.size()) position = 0;
+			}
+		}
+		output.Flush();
+	}
+	raise(signal_number);
+}
+
+/*
+ * Open(): allocates the ring and registers the recorder
+ * Input arguments:
+ * - num_events: number of events kept
+ * - id: identifier of the owner
+ * - dump_filename: file where dumps are appended
+ * - abort_filename: binary trace written if the process aborts (shared by all the recorders)
+ * - state_writer: writes the state of the owner at dump time
+ */
+void FlightRecorder :: Open(int num_events, int id, const char *dump_filename, const char *abort_filename,
+	std::function<void(FILE *)> state_writer){
+	events.assign(num_events, Event());
+	next_event = 0;
+	num_recorded = 0;
+	num_dumps = 0;
+	owner_id = id;
+	filename = dump_filename;
+	write_state = state_writer;
+	if(flight_recorders.empty()) {
+		FlightRecorderAbortSite();
+		flight_recorder_abort_filename = abort_filename;
+		flight_recorder_abort_fd = open(abort_filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		signal(SIGABRT, FlightRecorderAbortHandler);
+	}
+	flight_recorders.push_back(this);
+}
+
+/*
+ * Close(): unregisters the recorder. The abort dump file is removed with the last recorder
+ * (it is only written if the process aborts).
+ */
+void FlightRecorder :: Close(){
+	for(size_t i = 0; i < flight_recorders.size(); ++i){
+		if(flight_recorders[i] == this){
+			flight_recorders.erase(flight_recorders.begin() + i);
+			if(flight_recorders.empty() && flight_recorder_abort_fd >= 0) {
+				signal(SIGABRT, SIG_DFL);
+				close(flight_recorder_abort_fd);
+				flight_recorder_abort_fd = -1;
+				unlink(flight_recorder_abort_filename.c_str());
+			}
+			break;
+		}
+	}
+}
+
+/*
+ * Record(): stores an event of a LogPrintf() call made outside the LOGS macro (setup and statistics
+ * output). The format string is looked up by address, as these lines have no static site.
+ * Input arguments:
+ * - format: printf format string
+ * - args: arguments of the call
+ */
+void FlightRecorder :: Record(const char *format, va_list args){
+	const LogSite &site (*LogSiteOf(format));
+	if(site.arg_types.size() > FLIGHT_RECORDER_MAX_ARGS){
+		printf("ERROR: too many arguments for the flight recorder in \"%s\"\n", format);
+		exit(-1);
+	}
+	Event &event = NextEvent();
+	event.site = &site;
+	ReadLogSlots(site, args, event.args);
+	size_t strings_used (0);
+	for(size_t i = 0; i < site.arg_types.size(); ++i){
+		if(site.arg_types[i] == TRACE_ARG_STRING){
+			event.args[i] = CopyString(event, strings_used, (const char *) (uintptr_t) event.args[i]);
+		}
+	}
+}
+
+/*
+ * Dump(): appends the events in the ring (oldest first) and the state of the owner to the dump file
+ * Input arguments:
+ * - reason: trigger that fired
+ * - sim_time: simulation time of the trigger (negative if unknown)
+ */
+void FlightRecorder :: Dump(const char *reason, double sim_time){
+
+	if(num_dumps >= flight_recorder_config.max_dumps) return;
+	++num_dumps;
+
+	FILE *file = fopen(filename.c_str(), "at");
+	if(file == NULL) return;
+
+	size_t num_events = (num_recorded < events.size()) ? (size_t) num_recorded : events.size();
+	if(sim_time >= 0){
+		fprintf(file, "\n==== FLIGHT RECORDER N%d: %s at %.15f s (last %zu events) ====\n",
+			OriginalNodeId(owner_id), reason, sim_time, num_events);
+	} else {
+		fprintf(file, "\n==== FLIGHT RECORDER N%d: %s (last %zu events) ====\n", OriginalNodeId(owner_id), reason,
+			num_events);
+	}
+
+	std::vector<char> encoded;
+	std::string text;
+	size_t position ((next_event + events.size() - num_events) % events.size());
+	for(size_t i = 0; i < num_events; ++i){
+		const Event &event = events[position];
+		encoded.clear();
+		TraceVectorOutput output(encoded);
+		AppendLogSlots(output, *event.site, event.args);
+		TraceBufferReader reader;
+		reader.position = encoded.empty() ? NULL : &encoded[0];
+		text.clear();
+		DecodeTraceEvent(reader, event.site->format, text);
+		fwrite(text.data(), 1, text.size(), file);
+		if(++position == events.size()) position = 0;
+	}
+
+	if(write_state){
+		fprintf(file, "==== STATE N%d ====\n", OriginalNodeId(owner_id));
+		write_state(file);
+	}
+	fclose(file);
+}
+
+#endif
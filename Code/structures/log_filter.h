@@ -0,0 +1,207 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the runtime filter applied by the LOGS macro: maximum level (LOG_LVLx),
+ *   categories (letter of the LOG_Xnn codes), node ids and simulation time window.
+ *   Level and category are extracted at compile time from the LOGS arguments, so a filtered
+ *   line costs one branch and its arguments are never evaluated (with logging off, LOGS only
+ *   tests its flag). Lines without a LOG_LVLx argument or a LOG_Xnn code are never filtered
+ *   by level or category.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#include "../list_of_macros.h"
+
+#ifndef _AUX_LOG_FILTER_
+#define _AUX_LOG_FILTER_
+
+/*
+ * LogLevelOf(): level of a LOGS line given its stringified arguments (e.g., "..., LOG_E03, LOG_LVL4")
+ */
+constexpr int LogLevelOf(const char *args){
+	for(int i = 0; args[i] != '\0'; ++i){
+		if(args[i] == 'L' && args[i+1] == 'O' && args[i+2] == 'G' && args[i+3] == '_'
+			&& args[i+4] == 'L' && args[i+5] == 'V' && args[i+6] == 'L'
+			&& args[i+7] >= '0' && args[i+7] <= '9'){
+			return args[i+7] - '0';
+		}
+	}
+	return LOG_FILTER_NO_LEVEL;
+}
+
+/*
+ * LogCategoryOf(): category of a LOGS line (0 for LOG_Axx, 1 for LOG_Bxx...) given its stringified arguments
+ */
+constexpr int LogCategoryOf(const char *args){
+	for(int i = 0; args[i] != '\0'; ++i){
+		if(args[i] == 'L' && args[i+1] == 'O' && args[i+2] == 'G' && args[i+3] == '_'
+			&& args[i+4] >= 'A' && args[i+4] <= 'Z'
+			&& args[i+5] >= '0' && args[i+5] <= '9' && args[i+6] >= '0' && args[i+6] <= '9'){
+			return args[i+4] - 'A';
+		}
+	}
+	return LOG_FILTER_NO_CATEGORY;
+}
+
+/*
+ * LogFilter: runtime log filter configured from the command line
+ */
+struct LogFilter
+{
+	unsigned int level_mask;		// Bit L set: lines of level L are written
+	unsigned int category_mask;		// Bit C set: lines of category C are written
+	double time_from;				// Beginning of the time window [s]
+	double time_until;				// End of the time window [s]
+	std::vector<int> node_ranges;	// Selected node ids as [first, last] pairs (empty: all nodes)
+
+	LogFilter() : level_mask(~0u), category_mask(~0u), time_from(0), time_until(HUGE_VAL) {}
+
+	/*
+	 * Passes(): returns TRUE if a line must be written. Conditions are combined without
+	 * short-circuit so that the caller evaluates a single branch.
+	 * Input arguments:
+	 * - level: level of the line (compile-time constant)
+	 * - category: category of the line (compile-time constant)
+	 * - sim_time: current simulation time
+	 */
+	int Passes(int level, int category, double sim_time) const {
+		return (int) ((level_mask >> level) & (category_mask >> category) & 1u
+			& (sim_time >= time_from) & (sim_time <= time_until));
+	}
+
+	/*
+	 * NodeSelected(): returns TRUE if the logs of a node must be written
+	 * Input arguments:
+	 * - node_id: node identifier
+	 */
+	int NodeSelected(int node_id) const {
+		if(node_ranges.empty()) return TRUE;
+		for(size_t i = 0; i < node_ranges.size(); i += 2){
+			if(node_id >= node_ranges[i] && node_id <= node_ranges[i+1]) return TRUE;
+		}
+		return FALSE;
+	}
+
+	/*
+	 * ParseArgument(): parses a log filter console argument
+	 * Input arguments:
+	 * - argument: console argument. Accepted options:
+	 *   --log_level=<max level>			writes LOG_LVL1 to LOG_LVL<max level> lines (and lines without level)
+	 *   --log_categories=<letters>		writes lines whose LOG_Xnn code starts with one of the letters, e.g.,
+	 *   								DEF (and lines without code)
+	 *   --log_nodes=<ids>				writes logs of the given nodes only (e.g., 0,3,5-7)
+	 *   --log_time=<from>:<until>		writes lines within the simulation time window [s]
+	 * Output:
+	 * - TRUE if the argument is a log filter option, FALSE otherwise
+	 */
+	int ParseArgument(const char *argument){
+
+		if(strncmp(argument, "--log_level=", 12) == 0){
+			int max_level (atoi(argument + 12));
+			if(max_level < 1 || max_level > 5){
+				printf("ERROR: --log_level must be between 1 and 5\n");
+				exit(-1);
+			}
+			level_mask = ((1u << (max_level + 1)) - 1) | (1u << LOG_FILTER_NO_LEVEL);
+
+		} else if(strncmp(argument, "--log_categories=", 17) == 0){
+			category_mask = 1u << LOG_FILTER_NO_CATEGORY;
+			for(const char *c = argument + 17; *c != '\0'; ++c){
+				if(*c < 'A' || *c > 'Z'){
+					printf("ERROR: --log_categories only accepts capital letters (found '%c')\n", *c);
+					exit(-1);
+				}
+				category_mask |= 1u << (*c - 'A');
+			}
+
+		} else if(strncmp(argument, "--log_nodes=", 12) == 0){
+			const char *p = argument + 12;
+			while(*p != '\0'){
+				char *end;
+				int first ((int) strtol(p, &end, 10));
+				int last (first);
+				if(end == p) break;
+				if(*end == '-'){
+					p = end + 1;
+					last = (int) strtol(p, &end, 10);
+					if(end == p) break;
+				}
+				node_ranges.push_back(first);
+				node_ranges.push_back(last);
+				p = end;
+				if(*p == ',') ++p;
+				else if(*p != '\0') break;
+			}
+			if(*p != '\0' || node_ranges.empty()){
+				printf("ERROR: --log_nodes expects a list of node ids or ranges (e.g., 0,3,5-7)\n");
+				exit(-1);
+			}
+
+		} else if(strncmp(argument, "--log_time=", 11) == 0){
+			if(sscanf(argument + 11, "%lf:%lf", &time_from, &time_until) != 2 || time_from > time_until){
+				printf("ERROR: --log_time expects <from>:<until> in seconds (e.g., 10:12.5)\n");
+				exit(-1);
+			}
+
+		} else {
+			return FALSE;
+		}
+		return TRUE;
+	}
+
+	void PrintFilter(){
+		printf("%s log filter: level_mask = 0x%x, category_mask = 0x%x, time = [%f, %f] s, node ranges = %d\n",
+			LOG_LVL2, level_mask, category_mask, time_from, time_until, (int) node_ranges.size() / 2);
+	}
+};
+
+LogFilter log_filter;	// Filter applied to the node, agent and central controller LOGS lines
+
+#endif
@@ -0,0 +1,250 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the sharded log sink: the logs of all nodes, agents and the central controller
+ *   are appended to a fixed number of segment files (<prefix>_shard<k>.log) as records tagged with
+ *   their owner. Records are buffered per segment and appended in large chunks. An index
+ *   (<prefix>_index.csv) lists the owners and the chunks containing records of each owner, so that
+ *   'log_extractor' regenerates the per-node log files.
+ * - The index is written incrementally: an owner line when the owner is registered and a chunk line
+ *   once the chunk is in its segment file. Both files are flushed, so the index never refers to data
+ *   that is not in the segments. A crash loses at most the chunk still buffered in each segment
+ *   (Komondor also closes the sink when exiting through exit(-1)).
+ *
+ * Index format (one entry per line, fields separated by ';'):
+ * - shard;<shard>;<segment file name>
+ * - owner;<owner id>;<shard>;<log file name>
+ * - chunk;<owner id>;<shard>;<offset>;<length>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../list_of_macros.h"
+
+#ifndef _AUX_LOG_SINK_
+#define _AUX_LOG_SINK_
+
+/*
+ * LogShard: segment file shared by the owners with the same (owner id % number of shards)
+ */
+struct LogShard
+{
+	FILE *file;									// Segment file
+	std::string filename;						// Segment file name (without directory)
+	std::vector<char> buffer;					// Records not yet appended to the file
+	unsigned long long offset;					// Bytes already appended to the file
+	std::vector<int> owners_in_chunk;			// Owners with records in 'buffer'
+	std::mutex mutex;							// Appends come from the simulation and the writer threads
+
+	LogShard() : file(NULL), offset(0) {}
+
+	/*
+	 * FlushChunk(): appends the buffered records to the segment file as one chunk and lists it in the
+	 * index (mutex held by the caller)
+	 * Input arguments:
+	 * - shard_id: position of the segment
+	 * - index_file: index file
+	 * - index_mutex: protects the index file (shared by all the segments)
+	 */
+	void FlushChunk(int shard_id, FILE *index_file, std::mutex &index_mutex){
+		if(buffer.empty()) return;
+		fwrite(&buffer[0], 1, buffer.size(), file);
+		fflush(file);
+		{
+			std::lock_guard<std::mutex> lock(index_mutex);
+			for(size_t i = 0; i < owners_in_chunk.size(); ++i){
+				fprintf(index_file, "chunk;%d;%d;%llu;%llu\n", owners_in_chunk[i], shard_id, offset,
+					(unsigned long long) buffer.size());
+			}
+			fflush(index_file);
+		}
+		offset += buffer.size();
+		buffer.clear();
+		owners_in_chunk.clear();
+	}
+};
+
+/*
+ * ShardedLogSink: fixed set of append-only segment files receiving all component logs
+ */
+struct ShardedLogSink
+{
+	std::string prefix;						// Path prefix of the segment and index files
+	int num_shards;							// Number of segment files
+	std::vector<LogShard*> shards;			// Segment files
+	int num_owners;							// Registered owners (owner id = registration order)
+	std::mutex owners_mutex;				// Protects 'num_owners'
+	FILE *index_file;						// Index of owners and chunks (written incrementally)
+	std::mutex index_mutex;					// Protects 'index_file'
+
+	ShardedLogSink() : num_shards(LOG_SINK_DEFAULT_SHARDS), num_owners(0), index_file(NULL) {}
+
+	/*
+	 * ParseArgument(): parses the console argument --log_shards=<N> (number of segment files)
+	 * Output:
+	 * - TRUE if the argument is a log sink option, FALSE otherwise
+	 */
+	int ParseArgument(const char *argument){
+		if(strncmp(argument, "--log_shards=", 13) != 0) return FALSE;
+		num_shards = atoi(argument + 13);
+		if(num_shards < 1){
+			printf("ERROR: --log_shards must be positive\n");
+			exit(-1);
+		}
+		return TRUE;
+	}
+
+	int IsOpen(){
+		return !shards.empty();
+	}
+
+	/*
+	 * Open(): creates the segment files and the index
+	 * Input arguments:
+	 * - path_prefix: path prefix of the segment and index files
+	 */
+	void Open(const std::string &path_prefix){
+		prefix = path_prefix;
+		size_t slash = prefix.find_last_of('/');
+		std::string basename = (slash == std::string::npos) ? prefix : prefix.substr(slash + 1);
+		std::string index_path = prefix + "_index.csv";
+		index_file = fopen(index_path.c_str(), "w");
+		if(index_file == NULL){
+			printf("ERROR: log index %s could not be opened\n", index_path.c_str());
+			exit(-1);
+		}
+		for(int k = 0; k < num_shards; ++k){
+			LogShard *shard = new LogShard();
+			shard->filename = basename + "_shard" + std::to_string(k) + ".log";
+			std::string path = prefix + "_shard" + std::to_string(k) + ".log";
+			shard->file = fopen(path.c_str(), "wb");
+			if(shard->file == NULL){
+				printf("ERROR: log segment %s could not be opened\n", path.c_str());
+				exit(-1);
+			}
+			shard->buffer.reserve(LOG_SINK_SHARD_BUFFER_SIZE);
+			shards.push_back(shard);
+			fprintf(index_file, "shard;%d;%s\n", k, shard->filename.c_str());
+		}
+		fflush(index_file);
+	}
+
+	/*
+	 * RegisterOwner(): registers a component writing logs
+	 * Input arguments:
+	 * - log_filename: name of the per-component log file that 'log_extractor' will regenerate
+	 * Output:
+	 * - owner id (tag of the records of the component)
+	 */
+	int RegisterOwner(const std::string &log_filename){
+		size_t slash = log_filename.find_last_of('/');
+		std::string name ((slash == std::string::npos) ? log_filename : log_filename.substr(slash + 1));
+		std::lock_guard<std::mutex> lock(owners_mutex);
+		int owner_id (num_owners++);
+		std::lock_guard<std::mutex> index_lock(index_mutex);
+		fprintf(index_file, "owner;%d;%d;%s\n", owner_id, owner_id % num_shards, name.c_str());
+		fflush(index_file);
+		return owner_id;
+	}
+
+	/*
+	 * Append(): appends a record of an owner (the record may be given in two parts, e.g., wrapped ring data)
+	 * Input arguments:
+	 * - owner_id: owner of the record
+	 * - first, first_length: first part of the record
+	 * - second, second_length: second part of the record (optional)
+	 */
+	void Append(int owner_id, const char *first, size_t first_length,
+		const char *second = NULL, size_t second_length = 0){
+
+		LogShard &shard = *shards[owner_id % num_shards];
+		uint32_t header[2] = {(uint32_t) owner_id, (uint32_t) (first_length + second_length)};
+		size_t record_length = LOG_SINK_RECORD_HEADER_SIZE + first_length + second_length;
+
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		if(shard.buffer.size() + record_length > LOG_SINK_SHARD_BUFFER_SIZE){
+			shard.FlushChunk(owner_id % num_shards, index_file, index_mutex);
+		}
+		if(shard.owners_in_chunk.empty() || shard.owners_in_chunk.back() != owner_id){
+			if(std::find(shard.owners_in_chunk.begin(), shard.owners_in_chunk.end(), owner_id)
+				== shard.owners_in_chunk.end()){
+				shard.owners_in_chunk.push_back(owner_id);
+			}
+		}
+		const char *header_bytes = (const char *) header;
+		shard.buffer.insert(shard.buffer.end(), header_bytes, header_bytes + LOG_SINK_RECORD_HEADER_SIZE);
+		shard.buffer.insert(shard.buffer.end(), first, first + first_length);
+		if(second_length > 0) shard.buffer.insert(shard.buffer.end(), second, second + second_length);
+	}
+
+	/*
+	 * Close(): appends the pending chunks and closes the segment files and the index
+	 */
+	void Close(){
+		if(!IsOpen()) return;
+		for(int k = 0; k < (int) shards.size(); ++k){
+			LogShard *shard = shards[k];
+			std::lock_guard<std::mutex> lock(shard->mutex);
+			shard->FlushChunk(k, index_file, index_mutex);
+			fclose(shard->file);
+		}
+		fclose(index_file);
+		index_file = NULL;
+		for(size_t k = 0; k < shards.size(); ++k) delete shards[k];
+		shards.clear();
+		num_owners = 0;
+	}
+};
+
+ShardedLogSink log_sink;	// Sink shared by all the components of the simulation
+
+#endif
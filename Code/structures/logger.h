@@ -46,6 +46,10 @@
  * - This file defines a LOGGER to generate logs
  */
 
+#include "trace.h"
+#include "async_log.h"
+#include "flight_recorder.h"
+
 #ifndef _AUX_LOGGER_
 #define _AUX_LOGGER_
 
@@ -53,12 +57,113 @@ struct Logger
 {
 	int save_logs;		// Flag for activating the log writting
 	FILE *file;			// File for writting logs
+	TraceWriter *trace;	// Binary trace writer (NULL: logs are written as text in 'file')
+	LogRing *ring;		// Ring of the asynchronous writer (NULL: text logs are written synchronously)
+	FlightRecorder *recorder;	// Flight recorder (NULL: logs are written, not only kept in memory)
+	int sink_owner;		// Owner id in the sharded log sink (-1: text logs are written in 'file')
 	char head_string[INTEGER_SIZE];	// Header string (to be passed as argument when it is needed to write info from other class or component)
 
+	Logger() : save_logs(0), file(NULL), trace(NULL), ring(NULL), recorder(NULL), sink_owner(-1) {
+		head_string[0] = '\0';
+	}
+
 	void SetVoidHeadString(){
 		sprintf(head_string, "%s", " ");
 	}
 	// TODO: create 'getter' methods
 };
 
+/*
+ * LogPrintf(): writes a log entry as a binary trace record, keeps it in the flight recorder,
+ * or writes it as text (queued to the asynchronous writer, appended to the log sink or written
+ * directly with fprintf). The "N%d" node ids of renumbered nodes are written as the original ones.
+ * Input arguments:
+ * - logger: logger to write to
+ * - format: printf format string (followed by its arguments)
+ */
+void LogPrintf(Logger &logger, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+// Only used in unevaluated context by the LOGS macro, so that its arguments are still checked against the format
+int LogFormatCheck(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+void LogPrintf(Logger &logger, const char *format, ...){
+	va_list args;
+	va_start(args, format);
+	if(logger.trace != NULL){
+		logger.trace->Write(format, args);
+	} else if(logger.recorder != NULL){
+		logger.recorder->Record(format, args);
+	} else if(logger.ring != NULL || logger.sink_owner >= 0 || !original_node_ids.empty()){
+		char message[CHAR_BUFFER_SIZE];
+		std::vector<char> long_message;
+		std::string renumbered_message;
+		const char *text = message;
+		int length;
+		if(!original_node_ids.empty()){
+			FormatWithOriginalNodeIds(format, args, renumbered_message);
+			text = renumbered_message.c_str();
+			length = (int) renumbered_message.size();
+		} else {
+			va_list args_copy;
+			va_copy(args_copy, args);
+			length = vsnprintf(message, sizeof(message), format, args);
+			if(length >= (int) sizeof(message)){
+				long_message.resize(length + 1);
+				vsnprintf(&long_message[0], long_message.size(), format, args_copy);
+				text = &long_message[0];
+			}
+			va_end(args_copy);
+		}
+		if(length > 0){
+			if(logger.ring != NULL){
+				logger.ring->Push(logger.sink_owner, text, length);
+			} else if(logger.sink_owner >= 0){
+				log_sink.Append(logger.sink_owner, text, length);
+			} else {
+				fwrite(text, 1, length, logger.file);
+			}
+		}
+	} else {
+		vfprintf(logger.file, format, args);
+	}
+	va_end(args);
+}
+
+/*
+ * LogPrintf(): writes a log entry of a LOGS call site. Binary traces get a fixed-schema record
+ * (see TraceWriter::Write()), and in flight recorder mode the arguments are only stored in the
+ * ring (see FlightRecorder::Record()); otherwise the entry is written as above.
+ * Input arguments:
+ * - logger: logger to write to
+ * - site: call site (format descriptor built once, see LogSite)
+ * - format: printf format string (followed by its arguments)
+ */
+template <typename... Args>
+void LogPrintf(Logger &logger, const LogSite &site, const char *format, const Args&... args){
+	if(logger.trace != NULL){
+		logger.trace->Write(site, args...);
+	} else if(logger.recorder != NULL){
+		logger.recorder->Record(site, args...);
+	} else {
+		LogPrintf(logger, format, args...);
+	}
+}
+
+/*
+ * CloseLogRing(): writes the messages still queued in the asynchronous writer and detaches
+ * the ring from the logger. Dropped messages are reported at the end of the log.
+ * Input arguments:
+ * - logger: logger whose ring is closed
+ */
+void CloseLogRing(Logger &logger){
+	if(logger.ring == NULL) return;
+	unsigned long long num_dropped (logger.ring->NumDropped(logger.sink_owner));
+	async_log_writer.Flush();
+	logger.ring = NULL;
+	if(num_dropped > 0) {
+		LogPrintf(logger, "WARNING: %llu log messages were dropped (asynchronous log ring full)\n", num_dropped);
+		printf("WARNING: %llu log messages were dropped (asynchronous log ring full)\n", num_dropped);
+	}
+}
+
 #endif
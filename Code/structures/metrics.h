@@ -0,0 +1,134 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the snapshot of counters collected by the metrics sampler (see
+ *   main/metrics_sampler.h) and the sampler options entered per console
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "../list_of_macros.h"
+
+#ifndef _AUX_METRICS_
+#define _AUX_METRICS_
+
+/*
+ * NodeMetrics: counters of a node at the sampling instant
+ */
+struct NodeMetrics
+{
+	int node_id;				// Node identifier
+	int node_type;				// Node type (e.g., AP, STA, ...)
+	std::string wlan_code;		// Code of the WLAN to which the node belongs
+	double bits_acked;			// Bits of own data frames acked since the beginning [bits]
+	int buffer_size;			// Packets in the buffer
+	double primary_power;		// Power sensed in the primary channel [dBm]
+	int cw_stage;				// Current CW stage
+	double time_in_nav;			// Time spent in NAV since the beginning [s]
+};
+
+/*
+ * AgentMetrics: state of an agent at the sampling instant
+ */
+struct AgentMetrics
+{
+	int agent_id;				// Agent identifier
+	int selected_arm;			// Last arm selected by the learning method (-1: none yet)
+};
+
+/*
+ * MetricsSnapshot: filled by every node and agent when the sampler requests it
+ */
+struct MetricsSnapshot
+{
+	std::vector<NodeMetrics> nodes;		// Indexed by node_id
+	std::vector<AgentMetrics> agents;	// Indexed by agent_id
+};
+
+/*
+ * MetricsSamplerConfig: metrics sampler options entered per console
+ */
+struct MetricsSamplerConfig
+{
+	double sampling_interval;		// Time between samples [s] (0: sampler disabled)
+	std::string filename;			// Output file (empty: ../output/metrics_<simulation_code>.csv)
+
+	MetricsSamplerConfig() : sampling_interval(0) {}
+
+	/*
+	 * ParseArgument(): parses a metrics sampler console argument
+	 * Input arguments:
+	 * - argument: console argument. Accepted options:
+	 *   --metrics_interval=<s>		time between samples in seconds (enables the sampler)
+	 *   --metrics_file=<path>		output CSV file
+	 * Output:
+	 * - TRUE if the argument is a metrics sampler option, FALSE otherwise
+	 */
+	int ParseArgument(const char *argument){
+
+		if(strncmp(argument, "--metrics_interval=", 19) == 0){
+			sampling_interval = atof(argument + 19);
+			if(sampling_interval < 0){
+				printf("ERROR: --metrics_interval must be positive\n");
+				exit(-1);
+			}
+
+		} else if(strncmp(argument, "--metrics_file=", 15) == 0){
+			filename = std::string(argument + 15);
+
+		} else {
+			return FALSE;
+		}
+		return TRUE;
+	}
+};
+
+MetricsSamplerConfig metrics_sampler_config;
+
+#endif
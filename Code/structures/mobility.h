@@ -0,0 +1,141 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the position update broadcast by the mobility manager (see
+ *   main/mobility_manager.h) and the mobility options entered per console
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "../list_of_macros.h"
+#include "wlan.h"
+
+#ifndef _AUX_MOBILITY_
+#define _AUX_MOBILITY_
+
+/*
+ * MobilityUpdate: nodes that moved during the last mobility interval. The per-node arrays are owned by
+ * the mobility manager and indexed by node_id, so that each node only recomputes the distances and powers
+ * related to the moved nodes (or its whole row if it moved itself).
+ */
+struct MobilityUpdate
+{
+	std::vector<int> moved_nodes;		// Ids of the nodes that moved
+	const double *x;					// X position of every node [m]
+	const double *y;					// Y position of every node [m]
+	const double *z;					// Z position of every node [m]
+	const double *tx_power;				// Default transmission power of every node [pW]
+	const double *tx_gain;				// Transmission gain of every node [linear]
+	const int *wlan_ix;					// Index of the WLAN of every node in 'wlan_container'
+	const Wlan *wlan_container;			// WLANs of the system
+	int total_nodes_number;				// Number of nodes in the system
+};
+
+/*
+ * MobilityConfig: mobility options entered per console
+ */
+struct MobilityConfig
+{
+	double interval;			// Time between position updates [s] (0: mobility disabled)
+	double speed;				// Speed of the mobile STAs [m/s]
+	double fraction;			// Fraction of STAs that move
+	double radius;				// Maximum distance between a STA and its AP [m] (0: initial distance)
+
+	MobilityConfig() : interval(0), speed(MOBILITY_DEFAULT_SPEED), fraction(MOBILITY_DEFAULT_FRACTION), radius(0) {}
+
+	/*
+	 * ParseArgument(): parses a mobility console argument
+	 * Input arguments:
+	 * - argument: console argument. Accepted options:
+	 *   --mobility_interval=<s>	time between position updates in seconds (enables mobility)
+	 *   --mobility_speed=<m/s>		speed of the mobile STAs
+	 *   --mobility_fraction=<f>	fraction of STAs that move (between 0 and 1)
+	 *   --mobility_radius=<m>		maximum distance between a STA and its AP
+	 * Output:
+	 * - TRUE if the argument is a mobility option, FALSE otherwise
+	 */
+	int ParseArgument(const char *argument){
+
+		if(strncmp(argument, "--mobility_interval=", 20) == 0){
+			interval = atof(argument + 20);
+			if(interval < 0){
+				printf("ERROR: --mobility_interval must be positive\n");
+				exit(-1);
+			}
+
+		} else if(strncmp(argument, "--mobility_speed=", 17) == 0){
+			speed = atof(argument + 17);
+			if(speed < 0){
+				printf("ERROR: --mobility_speed must be positive\n");
+				exit(-1);
+			}
+
+		} else if(strncmp(argument, "--mobility_fraction=", 20) == 0){
+			fraction = atof(argument + 20);
+			if(fraction < 0 || fraction > 1){
+				printf("ERROR: --mobility_fraction must be between 0 and 1\n");
+				exit(-1);
+			}
+
+		} else if(strncmp(argument, "--mobility_radius=", 18) == 0){
+			radius = atof(argument + 18);
+			if(radius < 0){
+				printf("ERROR: --mobility_radius must be positive\n");
+				exit(-1);
+			}
+
+		} else {
+			return FALSE;
+		}
+		return TRUE;
+	}
+};
+
+MobilityConfig mobility_config;
+
+#endif
@@ -50,6 +50,7 @@
 #define _AUX_CONFIGURATION_
 
 #include "../methods/power_channel_methods.h"
+#include "node_order.h"
 
 struct Capabilities
 {
@@ -81,7 +82,7 @@ struct Capabilities
 	// Function to print the node's capabilities
 	void PrintCapabilities(){
 
-		printf("%s Capabilities of node %d:\n", LOG_LVL3, node_id);
+		printf("%s Capabilities of node %d:\n", LOG_LVL3, OriginalNodeId(node_id));
 		printf("%s node_type = %d\n", LOG_LVL4, node_type);
 		printf("%s position = (%.2f, %.2f, %.2f)\n", LOG_LVL4, x, y, z);
 		printf("%s primary_channel = %d\n", LOG_LVL4, primary_channel);
@@ -90,7 +91,7 @@ struct Capabilities
 		printf("%s current_dcb_policy = %d\n", LOG_LVL4, current_dcb_policy);
 		printf("%s lambda = %f packets/s\n", LOG_LVL4, lambda);
 		printf("%s traffic_load = %.2f packets/s\n", LOG_LVL4, traffic_load);
-		printf("%s destination_id = %d\n", LOG_LVL4, destination_id);
+		printf("%s destination_id = %d\n", LOG_LVL4, OriginalNodeId(destination_id));
 		printf("%s tx_power_min = %f pW (%f dBm)\n", LOG_LVL4, tx_power_min, ConvertPower(PW_TO_DBM, tx_power_min));
 		printf("%s tx_power_default = %f pW (%f dBm)\n", LOG_LVL4, tx_power_default, ConvertPower(PW_TO_DBM, tx_power_default));
 		printf("%s tx_power_max = %f pW (%f dBm)\n", LOG_LVL4, tx_power_max, ConvertPower(PW_TO_DBM, tx_power_max));
@@ -107,42 +108,42 @@ struct Capabilities
 
 	// Function to write the node's capabilities
 	void WriteCapabilities(Logger logger, double sim_time){
-		fprintf(logger.file, "%.15f;CC;%s;%s WLAN capabilities:\n", sim_time, LOG_F00, LOG_LVL3);
-		fprintf(logger.file, "%.15f;CC;%s;%s node_type = %d\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s WLAN capabilities:\n", sim_time, LOG_F00, LOG_LVL3);
+		LogPrintf(logger, "%.15f;CC;%s;%s node_type = %d\n",
 			sim_time, LOG_F00, LOG_LVL4, node_type);
-		fprintf(logger.file, "%.15f;CC;%s;%s position = (%.2f, %.2f, %.2f)\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s position = (%.2f, %.2f, %.2f)\n",
 			sim_time, LOG_F00, LOG_LVL4, x, y, z);
-		fprintf(logger.file, "%.15f;CC;%s;%s primary_channel = %d\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s primary_channel = %d\n",
 			sim_time, LOG_F00, LOG_LVL4, primary_channel);
-		fprintf(logger.file, "%.15f;CC;%s;%s min_channel_allowed = %d\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s min_channel_allowed = %d\n",
 			sim_time, LOG_F00, LOG_LVL4, min_channel_allowed);
-		fprintf(logger.file, "%.15f;CC;%s;%s max_channel_allowed = %d\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s max_channel_allowed = %d\n",
 			sim_time, LOG_F00, LOG_LVL4, max_channel_allowed);
-		fprintf(logger.file, "%.15f;CC;%s;%s current_dcb_policy = %d\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s current_dcb_policy = %d\n",
 			sim_time, LOG_F00, LOG_LVL4, current_dcb_policy);
-		fprintf(logger.file, "%.15f;CC;%s;%s lambda = %f packets/s\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s lambda = %f packets/s\n",
 			sim_time, LOG_F00, LOG_LVL4, lambda);
-		fprintf(logger.file, "%.15f;CC;%s;%s traffic_load = %.2f packets/s\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s traffic_load = %.2f packets/s\n",
 			sim_time, LOG_F00, LOG_LVL4, traffic_load);
-		fprintf(logger.file, "%.15f;CC;%s;%s destination_id = %d\n",
-			sim_time, LOG_F00, LOG_LVL4, destination_id);
-		fprintf(logger.file, "%.15f;CC;%s;%s tx_power_min = %f pW (%f dBm)\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s destination_id = %d\n",
+			sim_time, LOG_F00, LOG_LVL4, OriginalNodeId(destination_id));
+		LogPrintf(logger, "%.15f;CC;%s;%s tx_power_min = %f pW (%f dBm)\n",
 			sim_time, LOG_F00, LOG_LVL4, tx_power_min, ConvertPower(PW_TO_DBM, tx_power_min));
-		fprintf(logger.file, "%.15f;CC;%s;%s tx_power_default = %f pW (%f dBm)\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s tx_power_default = %f pW (%f dBm)\n",
 			sim_time, LOG_F00, LOG_LVL4, tx_power_default, ConvertPower(PW_TO_DBM, tx_power_default));
-		fprintf(logger.file, "%.15f;CC;%s;%s tx_power_max = %f pW (%f dBm)\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s tx_power_max = %f pW (%f dBm)\n",
 			sim_time, LOG_F00, LOG_LVL4, tx_power_max, ConvertPower(PW_TO_DBM, tx_power_max));
-		fprintf(logger.file, "%.15f;CC;%s;%s sensitivity_min = %f pW (%f dBm)\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s sensitivity_min = %f pW (%f dBm)\n",
 			sim_time, LOG_F00, LOG_LVL4, sensitivity_min, ConvertPower(PW_TO_DBM, sensitivity_min));
-		fprintf(logger.file, "%.15f;CC;%s;%s sensitivity_default = %f pW (%f dBm)\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s sensitivity_default = %f pW (%f dBm)\n",
 			sim_time, LOG_F00, LOG_LVL4, sensitivity_default, ConvertPower(PW_TO_DBM, sensitivity_default));
-		fprintf(logger.file, "%.15f;CC;%s;%s sensitivity_max = %f pW (%f dBm)\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s sensitivity_max = %f pW (%f dBm)\n",
 			sim_time, LOG_F00, LOG_LVL4, sensitivity_max, ConvertPower(PW_TO_DBM, sensitivity_max));
-		fprintf(logger.file, "%.15f;CC;%s;%s tx_gain = %f (%f dBi)\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s tx_gain = %f (%f dBi)\n",
 			sim_time, LOG_F00, LOG_LVL4, tx_gain, ConvertPower(LINEAR_TO_DB, tx_gain));
-		fprintf(logger.file, "%.15f;CC;%s;%s rx_gain = %f (%f dBi)\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s rx_gain = %f (%f dBi)\n",
 			sim_time, LOG_F00, LOG_LVL4, rx_gain, ConvertPower(LINEAR_TO_DB, rx_gain));
-		fprintf(logger.file, "%.15f;CC;%s;%s modulation_default = %d\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s modulation_default = %d\n",
 			sim_time, LOG_F00, LOG_LVL4, modulation_default);
 	}
 
@@ -187,14 +188,14 @@ struct Configuration
 
 	// Function to write the node's configuration
 	void WriteConfiguration(Logger logger, double sim_time){
-		fprintf(logger.file, "%.15f;CC;%s;%s WLAN configuration:\n", sim_time, LOG_F00, LOG_LVL3);
-		fprintf(logger.file, "%.15f;CC;%s;%s selected_primary = %d\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s WLAN configuration:\n", sim_time, LOG_F00, LOG_LVL3);
+		LogPrintf(logger, "%.15f;CC;%s;%s selected_primary = %d\n",
 			sim_time, LOG_F00, LOG_LVL4, selected_primary_channel);
-		fprintf(logger.file, "%.15f;CC;%s;%s pd_default = %f pW (%f dBm)\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s pd_default = %f pW (%f dBm)\n",
 			sim_time, LOG_F00, LOG_LVL4, selected_pd, ConvertPower(PW_TO_DBM, selected_pd));
-		fprintf(logger.file, "%.15f;CC;%s;%s tx_power_default = %f pW (%f dBm)\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s tx_power_default = %f pW (%f dBm)\n",
 			sim_time, LOG_F00, LOG_LVL4, selected_tx_power, ConvertPower(PW_TO_DBM, selected_tx_power));
-		fprintf(logger.file, "%.15f;CC;%s;%s selected_dcb_policy = %d\n",
+		LogPrintf(logger, "%.15f;CC;%s;%s selected_dcb_policy = %d\n",
 			sim_time, LOG_F00, LOG_LVL4, selected_dcb_policy);
 	}
 
@@ -0,0 +1,200 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the optional renumbering of the nodes along a space-filling curve of their
+ *   positions (entered per console), and the map from the renumbered node ids to the original ones
+ *   (i.e., the rows of the nodes file) used in every output and log
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+
+#include "../list_of_macros.h"
+
+#ifndef _AUX_NODE_ORDER_
+#define _AUX_NODE_ORDER_
+
+std::vector<int> original_node_ids;			// Original id of each renumbered node (empty: nodes not renumbered)
+std::vector<int> node_ids_in_original_order;	// Renumbered id of each original node (empty: nodes not renumbered)
+
+/*
+ * OriginalNodeId(): returns the original id of a node (ids out of range, e.g. NODE_ID_NONE, are kept)
+ */
+int OriginalNodeId(int node_id){
+	if(node_id < 0 || node_id >= (int) original_node_ids.size()) return node_id;
+	return original_node_ids[node_id];
+}
+
+/*
+ * NodeIdInOriginalOrder(): returns the id of the k-th node of the nodes file, so that outputs iterating
+ * over k keep the order of the nodes file
+ */
+int NodeIdInOriginalOrder(int k){
+	if(k < 0 || k >= (int) node_ids_in_original_order.size()) return k;
+	return node_ids_in_original_order[k];
+}
+
+/*
+ * SetOriginalNodeIds(): sets the map from the node ids to the original ones
+ * Input arguments:
+ * - original_ids: original id of each node (the map is left empty if no node was renumbered)
+ */
+void SetOriginalNodeIds(const std::vector<int> &original_ids){
+	original_node_ids.clear();
+	node_ids_in_original_order.clear();
+	for(size_t n = 0; n < original_ids.size(); ++n){
+		if(original_ids[n] != (int) n){
+			original_node_ids = original_ids;
+			node_ids_in_original_order.resize(original_ids.size());
+			for(size_t m = 0; m < original_ids.size(); ++m) node_ids_in_original_order[original_ids[m]] = m;
+			return;
+		}
+	}
+}
+
+/*
+ * InterleaveCurveBits(): key of the cell (x, y, z) of a space-filling curve, made of the bits of
+ * the three coordinates interleaved from the most significant one (i.e., the Morton key)
+ */
+uint64_t InterleaveCurveBits(const uint32_t coordinates[3]){
+	uint64_t key (0);
+	for(int bit = NODE_ORDER_CURVE_BITS - 1; bit >= 0; --bit){
+		for(int i = 0; i < 3; ++i) key = (key << 1) | ((coordinates[i] >> bit) & 1);
+	}
+	return key;
+}
+
+/*
+ * HilbertCurveKey(): key of the cell (x, y, z) along the Hilbert curve (Skilling's transform of the
+ * coordinates into the transposed Hilbert index, then interleaved as a Morton key)
+ */
+uint64_t HilbertCurveKey(const uint32_t coordinates[3]){
+	uint32_t X[3] = {coordinates[0], coordinates[1], coordinates[2]};
+	uint32_t M (1u << (NODE_ORDER_CURVE_BITS - 1));
+
+	// Inverse undo
+	for(uint32_t Q = M; Q > 1; Q >>= 1){
+		uint32_t P (Q - 1);
+		for(int i = 0; i < 3; ++i){
+			if(X[i] & Q){
+				X[0] ^= P;
+			} else {
+				uint32_t t ((X[0] ^ X[i]) & P);
+				X[0] ^= t;
+				X[i] ^= t;
+			}
+		}
+	}
+
+	// Gray encode
+	for(int i = 1; i < 3; ++i) X[i] ^= X[i-1];
+	uint32_t t (0);
+	for(uint32_t Q = M; Q > 1; Q >>= 1){
+		if(X[2] & Q) t ^= Q - 1;
+	}
+	for(int i = 0; i < 3; ++i) X[i] ^= t;
+
+	return InterleaveCurveBits(X);
+}
+
+/*
+ * NodeOrderConfig: node renumbering options entered per console
+ */
+struct NodeOrderConfig
+{
+	int curve;		// NODE_ORDER_XXX
+
+	NodeOrderConfig() : curve(NODE_ORDER_FILE) {}
+
+	/*
+	 * ParseArgument(): parses a node renumbering console argument
+	 * Input arguments:
+	 * - argument: console argument. Accepted options:
+	 *   --node_order=<file|morton|hilbert>		order of the node ids (default: order of the nodes file)
+	 * Output:
+	 * - TRUE if the argument is a node renumbering option, FALSE otherwise
+	 */
+	int ParseArgument(const char *argument){
+
+		if(strncmp(argument, "--node_order=", 13) == 0){
+			const char *name = argument + 13;
+			if(strcmp(name, "file") == 0) curve = NODE_ORDER_FILE;
+			else if(strcmp(name, "morton") == 0) curve = NODE_ORDER_MORTON;
+			else if(strcmp(name, "hilbert") == 0) curve = NODE_ORDER_HILBERT;
+			else {
+				printf("ERROR: unknown node order '%s' (file, morton or hilbert)\n", name);
+				exit(-1);
+			}
+
+		} else {
+			return FALSE;
+		}
+		return TRUE;
+	}
+
+	/*
+	 * CurveKey(): key of a position along the curve
+	 * Input arguments:
+	 * - position: coordinates of the position [m]
+	 * - min_position, max_position: bounding box of all the positions [m]
+	 */
+	uint64_t CurveKey(const double position[3], const double min_position[3], const double max_position[3]) const {
+		uint32_t coordinates[3];
+		uint32_t max_coordinate ((1u << NODE_ORDER_CURVE_BITS) - 1);
+		for(int i = 0; i < 3; ++i){
+			double range (max_position[i] - min_position[i]);
+			coordinates[i] = (range > 0) ?
+				(uint32_t) ((position[i] - min_position[i]) / range * max_coordinate + 0.5) : 0;
+		}
+		return (curve == NODE_ORDER_HILBERT) ? HilbertCurveKey(coordinates) : InterleaveCurveBits(coordinates);
+	}
+};
+
+NodeOrderConfig node_order_config;
+
+#endif
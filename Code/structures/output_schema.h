@@ -0,0 +1,505 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the results of a simulation (performance of every node and global statistics,
+ *   computed in a single pass) and the output schema: the list of metric@scope[:format] entries
+ *   written as one line of the script output, selected at runtime.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "../list_of_macros.h"
+#include "performance_metrics.h"
+#include "node_configuration.h"
+#include "wlan.h"
+#include "delay_histogram.h"
+
+#ifndef _AUX_OUTPUT_SCHEMA_
+#define _AUX_OUTPUT_SCHEMA_
+
+/*
+ * SimulationResults: performance of every node at the end of a simulation and the global statistics
+ * derived from it. There is one instance per simulation, nothing is kept in file-scope variables.
+ */
+struct SimulationResults
+{
+	// Results entered by Komondor
+	Performance *performance_report;		// Performance of each node
+	Configuration *configuration_per_node;	// Configuration of each node
+	Wlan *wlan_container;					// Container of WLANs
+	int total_nodes_number;					// Total number of nodes
+	int total_wlans_number;					// Total number of WLANs
+	int frame_length;						// Packet length [bits]
+	int max_num_packets_aggregated;			// Number of packets aggregated in one transmission
+	double simulation_time_komondor;		// Simulation time [s]
+
+	// Global statistics (only APs are taken into account)
+	int total_data_packets_sent;
+	double total_num_packets_generated;
+	double total_throughput;
+	double min_throughput;
+	double max_throughput;
+	double proportional_fairness;
+	double jains_fairness;
+	int total_rts_lost_slotted_bo;
+	int total_rts_cts_sent;
+	double total_prob_slotted_bo_collision;
+	int total_num_tx_init_not_possible;
+	double total_delay;
+	double max_delay;
+	double min_delay;
+	int ix_wlan_min_throughput;			// Index of the WLAN experiencing less throughput
+	double total_bandwidth_tx;
+	double av_expected_backoff;
+	double av_expected_waiting_time;
+	DelayHistogram network_delay_histogram;	// Delays of every AP
+
+	SimulationResults(Performance *performance_report, Configuration *configuration_per_node, Wlan *wlan_container,
+		int total_nodes_number, int total_wlans_number, int frame_length, int max_num_packets_aggregated,
+		double simulation_time_komondor) :
+		performance_report(performance_report), configuration_per_node(configuration_per_node),
+		wlan_container(wlan_container), total_nodes_number(total_nodes_number), total_wlans_number(total_wlans_number),
+		frame_length(frame_length), max_num_packets_aggregated(max_num_packets_aggregated),
+		simulation_time_komondor(simulation_time_komondor) {
+		ComputeStatistics();
+	}
+
+	/*
+	 * ComputeStatistics(): computes the global statistics in a single pass over the nodes
+	 */
+	void ComputeStatistics(){
+
+		total_data_packets_sent = 0;
+		total_num_packets_generated = 0;
+		total_throughput = 0;
+		min_throughput = 999999999999999999;
+		max_throughput = 0;
+		proportional_fairness = 0;
+		total_rts_lost_slotted_bo = 0;
+		total_rts_cts_sent = 0;
+		total_prob_slotted_bo_collision = 0;
+		total_num_tx_init_not_possible = 0;
+		total_delay = 0;
+		max_delay = 0;
+		min_delay = 9999999999;
+		ix_wlan_min_throughput = 99999;
+		total_bandwidth_tx = 0;
+		av_expected_backoff = 0;
+		av_expected_waiting_time = 0;
+		double jains_fairness_aux (0);
+		network_delay_histogram.Reset();
+
+		for(int m = 0; m < total_nodes_number; ++m){
+			// Take into account only APs (transmitters)
+			if(configuration_per_node[m].capabilities.node_type != NODE_TYPE_AP) continue;
+			const Performance &performance = performance_report[m];
+			total_data_packets_sent += performance.data_packets_sent;
+			total_throughput += performance.throughput;
+			total_num_packets_generated += performance.num_packets_generated;
+			total_rts_lost_slotted_bo += performance.rts_lost_slotted_bo;
+			total_rts_cts_sent += performance.rts_cts_sent;
+			total_prob_slotted_bo_collision += performance.prob_slotted_bo_collision;
+			total_num_tx_init_not_possible += performance.num_tx_init_not_possible;
+			proportional_fairness += log10(performance.throughput);
+			jains_fairness_aux += pow(performance.throughput, 2);
+			total_delay += performance.average_delay;
+			network_delay_histogram.Merge(*performance.delay_histogram);
+			if(performance.average_delay > max_delay) max_delay = performance.average_delay;
+			if(performance.average_delay < min_delay) min_delay = performance.average_delay;
+			av_expected_backoff += performance.expected_backoff;
+			av_expected_waiting_time += performance.average_waiting_time;
+			total_bandwidth_tx += performance.bandwidth_used_txing;
+			if(performance.throughput < min_throughput) {
+				ix_wlan_min_throughput = m;
+				min_throughput = performance.throughput;
+			}
+			if(performance.throughput > max_throughput) max_throughput = performance.throughput;
+		}
+		av_expected_backoff = av_expected_backoff / total_wlans_number;
+		av_expected_waiting_time = av_expected_waiting_time / total_wlans_number;
+		jains_fairness = pow(total_throughput, 2) / (total_nodes_number/2 * jains_fairness_aux); // Supposing that number_aps = number_nodes/2
+	}
+
+	/*
+	 * NodeDelayHistogram(): delays of the packets sent by an AP, or of the packets received by a STA
+	 * (kept by its AP, indexed as in Node)
+	 */
+	const DelayHistogram &NodeDelayHistogram(int node_ix) const {
+		for(int w = 0; w < total_wlans_number; ++w){
+			const Wlan &wlan = wlan_container[w];
+			for(int s = 0; s < wlan.num_stas; ++s){
+				if(wlan.list_sta_id[s] == node_ix){
+					return performance_report[wlan.ap_id].delay_histogram_per_sta[node_ix - wlan.ap_id - 1];
+				}
+			}
+		}
+		return *performance_report[node_ix].delay_histogram;
+	}
+};
+
+/*
+ * OutputMetric: metric that can be entered in the output schema
+ */
+struct OutputMetric
+{
+	const char *name;				// Name used in the schema
+	int scope;						// OUTPUT_SCOPE_NODE (also valid per WLAN) or OUTPUT_SCOPE_GLOBAL
+	const char *default_format;		// printf format used if the entry does not give one
+	const char *description;		// Description (and units)
+	double (*value)(const SimulationResults &results, int node_ix);	// node_ix is not used by global metrics
+};
+
+const OutputMetric output_metrics[] = {
+
+	// Per node (or per WLAN: metric of the AP)
+	{"throughput", OUTPUT_SCOPE_NODE, "%.2f", "throughput [Mbps]",
+		[](const SimulationResults &r, int i) { return r.performance_report[i].throughput * pow(10,-6); }},
+	{"throughput_pkt", OUTPUT_SCOPE_NODE, "%.0f", "throughput [pkt/s]",
+		[](const SimulationResults &r, int i) { return r.performance_report[i].throughput
+			/ (r.frame_length * r.max_num_packets_aggregated); }},
+	{"data_packets_sent", OUTPUT_SCOPE_NODE, "%.0f", "data packets sent",
+		[](const SimulationResults &r, int i) { return (double) r.performance_report[i].data_packets_sent; }},
+	{"data_packets_lost", OUTPUT_SCOPE_NODE, "%.0f", "data packets lost",
+		[](const SimulationResults &r, int i) { return (double) r.performance_report[i].data_packets_lost; }},
+	{"rts_cts_sent", OUTPUT_SCOPE_NODE, "%.0f", "RTS/CTS sent",
+		[](const SimulationResults &r, int i) { return (double) r.performance_report[i].rts_cts_sent; }},
+	{"rts_cts_lost", OUTPUT_SCOPE_NODE, "%.0f", "RTS/CTS lost",
+		[](const SimulationResults &r, int i) { return (double) r.performance_report[i].rts_cts_lost; }},
+	{"rts_lost_slotted_bo", OUTPUT_SCOPE_NODE, "%.0f", "RTS lost due to slotted BO collisions",
+		[](const SimulationResults &r, int i) { return (double) r.performance_report[i].rts_lost_slotted_bo; }},
+	{"num_packets_generated", OUTPUT_SCOPE_NODE, "%.0f", "packets generated",
+		[](const SimulationResults &r, int i) { return (double) r.performance_report[i].num_packets_generated; }},
+	{"num_packets_dropped", OUTPUT_SCOPE_NODE, "%.0f", "packets dropped",
+		[](const SimulationResults &r, int i) { return (double) r.performance_report[i].num_packets_dropped; }},
+	{"drop_ratio", OUTPUT_SCOPE_NODE, "%.2f", "packets dropped [%]",
+		[](const SimulationResults &r, int i) { return (double) r.performance_report[i].num_packets_dropped * 100
+			/ r.performance_report[i].num_packets_generated; }},
+	{"frames_per_packet", OUTPUT_SCOPE_NODE, "%.2f", "frames acked per data packet acked",
+		[](const SimulationResults &r, int i) { return (double) r.performance_report[i].data_frames_acked
+			/ r.performance_report[i].data_packets_acked; }},
+	{"average_delay", OUTPUT_SCOPE_NODE, "%.4f", "average delay [ms]",
+		[](const SimulationResults &r, int i) { return r.performance_report[i].average_delay * pow(10,3); }},
+	{"delay_p50", OUTPUT_SCOPE_NODE, "%.4f", "median delay [ms]",
+		[](const SimulationResults &r, int i) { return r.NodeDelayHistogram(i).Percentile(0.5) * pow(10,3); }},
+	{"delay_p95", OUTPUT_SCOPE_NODE, "%.4f", "95th percentile delay [ms]",
+		[](const SimulationResults &r, int i) { return r.NodeDelayHistogram(i).Percentile(0.95) * pow(10,3); }},
+	{"delay_p99", OUTPUT_SCOPE_NODE, "%.4f", "99th percentile delay [ms]",
+		[](const SimulationResults &r, int i) { return r.NodeDelayHistogram(i).Percentile(0.99) * pow(10,3); }},
+	{"delay_p999", OUTPUT_SCOPE_NODE, "%.4f", "99.9th percentile delay [ms]",
+		[](const SimulationResults &r, int i) { return r.NodeDelayHistogram(i).Percentile(0.999) * pow(10,3); }},
+	{"delay_max", OUTPUT_SCOPE_NODE, "%.4f", "maximum delay [ms]",
+		[](const SimulationResults &r, int i) { return r.NodeDelayHistogram(i).max_delay * pow(10,3); }},
+	{"average_waiting_time", OUTPUT_SCOPE_NODE, "%.4f", "average waiting time before transmitting [ms]",
+		[](const SimulationResults &r, int i) { return r.performance_report[i].average_waiting_time * pow(10,3); }},
+	{"average_rho", OUTPUT_SCOPE_NODE, "%.2f", "average rho",
+		[](const SimulationResults &r, int i) { return r.performance_report[i].average_rho; }},
+	{"average_utilization", OUTPUT_SCOPE_NODE, "%.2f", "average utilization",
+		[](const SimulationResults &r, int i) { return r.performance_report[i].average_utilization; }},
+	{"prob_slotted_bo_collision", OUTPUT_SCOPE_NODE, "%.4f", "probability of slotted BO collision",
+		[](const SimulationResults &r, int i) { return r.performance_report[i].prob_slotted_bo_collision; }},
+	{"expected_backoff", OUTPUT_SCOPE_NODE, "%.2f", "expected backoff [slots]",
+		[](const SimulationResults &r, int i) { return r.performance_report[i].expected_backoff / SLOT_TIME; }},
+	{"bandwidth_used_txing", OUTPUT_SCOPE_NODE, "%.2f", "bandwidth used for transmitting [MHz]",
+		[](const SimulationResults &r, int i) { return r.performance_report[i].bandwidth_used_txing; }},
+	{"channel_occupancy", OUTPUT_SCOPE_NODE, "%.2f", "time occupying the channel successfully [%]",
+		[](const SimulationResults &r, int i) { return (r.performance_report[i].total_time_transmitting_in_num_channels[0]
+			- r.performance_report[i].total_time_lost_in_num_channels[0]) * 100 / r.simulation_time_komondor; }},
+	{"time_in_nav", OUTPUT_SCOPE_NODE, "%.2f", "time in NAV [%]",
+		[](const SimulationResults &r, int i) { return r.performance_report[i].time_in_nav * 100
+			/ r.simulation_time_komondor; }},
+	{"num_tx_init_tried", OUTPUT_SCOPE_NODE, "%.0f", "transmissions tried",
+		[](const SimulationResults &r, int i) { return (double) r.performance_report[i].num_tx_init_tried; }},
+	{"num_tx_init_not_possible", OUTPUT_SCOPE_NODE, "%.0f", "transmissions not possible",
+		[](const SimulationResults &r, int i) { return (double) r.performance_report[i].num_tx_init_not_possible; }},
+	{"dcb_policy", OUTPUT_SCOPE_NODE, "%.0f", "current DCB policy",
+		[](const SimulationResults &r, int i) {
+			return (double) r.configuration_per_node[i].capabilities.current_dcb_policy; }},
+
+	// Whole network (APs only)
+	{"average_throughput", OUTPUT_SCOPE_GLOBAL, "%.2f", "average throughput per WLAN [Mbps]",
+		[](const SimulationResults &r, int) { return r.total_throughput * pow(10,-6) / r.total_wlans_number; }},
+	{"total_throughput", OUTPUT_SCOPE_GLOBAL, "%.2f", "total throughput [Mbps]",
+		[](const SimulationResults &r, int) { return r.total_throughput * pow(10,-6); }},
+	{"min_throughput", OUTPUT_SCOPE_GLOBAL, "%.2f", "minimum throughput [Mbps]",
+		[](const SimulationResults &r, int) { return r.min_throughput * pow(10,-6); }},
+	{"max_throughput", OUTPUT_SCOPE_GLOBAL, "%.2f", "maximum throughput [Mbps]",
+		[](const SimulationResults &r, int) { return r.max_throughput * pow(10,-6); }},
+	{"ix_min_throughput", OUTPUT_SCOPE_GLOBAL, "%.0f", "index of the node experiencing less throughput",
+		[](const SimulationResults &r, int) { return (double) r.ix_wlan_min_throughput; }},
+	{"proportional_fairness", OUTPUT_SCOPE_GLOBAL, "%.4f", "proportional fairness",
+		[](const SimulationResults &r, int) { return r.proportional_fairness; }},
+	{"jains_fairness", OUTPUT_SCOPE_GLOBAL, "%.4f", "Jain's fairness",
+		[](const SimulationResults &r, int) { return r.jains_fairness; }},
+	{"prob_slotted_bo_collision", OUTPUT_SCOPE_GLOBAL, "%.5f", "average probability of slotted BO collision",
+		[](const SimulationResults &r, int) { return r.total_prob_slotted_bo_collision / r.total_wlans_number; }},
+	{"average_delay", OUTPUT_SCOPE_GLOBAL, "%.2f", "average delay per WLAN [ms]",
+		[](const SimulationResults &r, int) { return r.total_delay * pow(10,3) / r.total_wlans_number; }},
+	{"max_delay", OUTPUT_SCOPE_GLOBAL, "%.2f", "maximum delay [ms]",
+		[](const SimulationResults &r, int) { return r.max_delay * pow(10,3); }},
+	{"min_delay", OUTPUT_SCOPE_GLOBAL, "%.2f", "minimum delay [ms]",
+		[](const SimulationResults &r, int) { return r.min_delay * pow(10,3); }},
+	{"delay_p50", OUTPUT_SCOPE_GLOBAL, "%.4f", "median delay of all the packets [ms]",
+		[](const SimulationResults &r, int) { return r.network_delay_histogram.Percentile(0.5) * pow(10,3); }},
+	{"delay_p95", OUTPUT_SCOPE_GLOBAL, "%.4f", "95th percentile delay of all the packets [ms]",
+		[](const SimulationResults &r, int) { return r.network_delay_histogram.Percentile(0.95) * pow(10,3); }},
+	{"delay_p99", OUTPUT_SCOPE_GLOBAL, "%.4f", "99th percentile delay of all the packets [ms]",
+		[](const SimulationResults &r, int) { return r.network_delay_histogram.Percentile(0.99) * pow(10,3); }},
+	{"delay_p999", OUTPUT_SCOPE_GLOBAL, "%.4f", "99.9th percentile delay of all the packets [ms]",
+		[](const SimulationResults &r, int) { return r.network_delay_histogram.Percentile(0.999) * pow(10,3); }},
+	{"average_bandwidth", OUTPUT_SCOPE_GLOBAL, "%.2f", "average bandwidth used for transmitting [MHz]",
+		[](const SimulationResults &r, int) { return r.total_bandwidth_tx / r.total_wlans_number; }},
+	{"expected_backoff", OUTPUT_SCOPE_GLOBAL, "%.2f", "average expected backoff [slots]",
+		[](const SimulationResults &r, int) { return r.av_expected_backoff / SLOT_TIME; }},
+	{"expected_waiting_time", OUTPUT_SCOPE_GLOBAL, "%.2f", "average expected waiting time [ms]",
+		[](const SimulationResults &r, int) { return r.av_expected_waiting_time * pow(10,3); }},
+	{"total_data_packets_sent", OUTPUT_SCOPE_GLOBAL, "%.0f", "data packets sent",
+		[](const SimulationResults &r, int) { return (double) r.total_data_packets_sent; }},
+};
+
+/*
+ * OutputSchemaEntry: metric, scope and format of one (or, per node/WLAN, several) output columns
+ */
+struct OutputSchemaEntry
+{
+	const OutputMetric *metric;
+	int scope;
+	std::string format;
+};
+
+/*
+ * OutputSchema: layout of the script output line entered per console
+ */
+struct OutputSchema
+{
+	std::vector<OutputSchemaEntry> entries;	// Columns (empty: legacy layout 'script_output_index')
+	int script_output_index;				// Legacy layout of GenerateScriptOutput()
+
+	OutputSchema() : script_output_index(DEFAULT_SCRIPT_OUTPUT_INDEX) {}
+
+	/*
+	 * ParseArgument(): parses an output schema console argument
+	 * Input arguments:
+	 * - argument: console argument. Accepted options:
+	 *   --output_schema=<entries>		comma-separated list of metric@scope[:format], scope being node, wlan or global
+	 *   --output_schema_file=<path>	file with the entries (one or more per line, '#' starts a comment)
+	 *   --script_output_index=<N>		legacy layout (used if no schema is entered)
+	 * Output:
+	 * - TRUE if the argument is an output schema option, FALSE otherwise
+	 */
+	int ParseArgument(const char *argument){
+
+		if(strncmp(argument, "--output_schema=", 16) == 0){
+			AddEntries(argument + 16);
+
+		} else if(strncmp(argument, "--output_schema_file=", 21) == 0){
+			LoadFromFile(argument + 21);
+
+		} else if(strncmp(argument, "--script_output_index=", 22) == 0){
+			script_output_index = atoi(argument + 22);
+
+		} else {
+			return FALSE;
+		}
+		return TRUE;
+	}
+
+	/*
+	 * AddEntries(): adds the comma-separated entries of a list
+	 */
+	void AddEntries(const std::string &list){
+		size_t from (0);
+		while(from <= list.size()){
+			size_t to = list.find(',', from);
+			if(to == std::string::npos) to = list.size();
+			std::string entry (list.substr(from, to - from));
+			entry.erase(0, entry.find_first_not_of(" \t\r\n"));
+			entry.erase(entry.find_last_not_of(" \t\r\n") + 1);
+			if(!entry.empty()) AddEntry(entry);
+			from = to + 1;
+		}
+	}
+
+	/*
+	 * AddEntry(): adds an entry metric@scope[:format]
+	 */
+	void AddEntry(const std::string &entry){
+
+		size_t at (entry.find('@'));
+		if(at == std::string::npos){
+			printf("ERROR: output schema entry '%s' has no scope (metric@node, metric@wlan or metric@global)\n",
+				entry.c_str());
+			exit(-1);
+		}
+		size_t colon (entry.find(':', at));
+		std::string name (entry.substr(0, at));
+		std::string scope_name (entry.substr(at + 1, colon == std::string::npos ? std::string::npos : colon - at - 1));
+
+		OutputSchemaEntry schema_entry;
+		if(scope_name == "node") schema_entry.scope = OUTPUT_SCOPE_NODE;
+		else if(scope_name == "wlan") schema_entry.scope = OUTPUT_SCOPE_WLAN;
+		else if(scope_name == "global") schema_entry.scope = OUTPUT_SCOPE_GLOBAL;
+		else {
+			printf("ERROR: unknown scope '%s' in output schema entry '%s'\n", scope_name.c_str(), entry.c_str());
+			exit(-1);
+		}
+
+		int metric_scope (schema_entry.scope == OUTPUT_SCOPE_GLOBAL ? OUTPUT_SCOPE_GLOBAL : OUTPUT_SCOPE_NODE);
+		schema_entry.metric = NULL;
+		for(size_t m = 0; m < sizeof(output_metrics) / sizeof(output_metrics[0]); ++m){
+			if(output_metrics[m].scope == metric_scope && name == output_metrics[m].name){
+				schema_entry.metric = &output_metrics[m];
+			}
+		}
+		if(schema_entry.metric == NULL){
+			printf("ERROR: metric '%s' is not available with scope '%s'\n", name.c_str(), scope_name.c_str());
+			PrintAvailableMetrics();
+			exit(-1);
+		}
+
+		schema_entry.format = (colon == std::string::npos) ? schema_entry.metric->default_format : entry.substr(colon + 1);
+		if(!IsValidFormat(schema_entry.format.c_str())){
+			printf("ERROR: format '%s' of output schema entry '%s' must contain a single floating point conversion"
+				" (e.g., %%.2f)\n", schema_entry.format.c_str(), entry.c_str());
+			exit(-1);
+		}
+
+		entries.push_back(schema_entry);
+	}
+
+	/*
+	 * LoadFromFile(): adds the entries written in a file
+	 */
+	void LoadFromFile(const char *filename){
+		FILE *file = fopen(filename, "r");
+		if(file == NULL){
+			printf("ERROR: output schema file '%s' could not be opened\n", filename);
+			exit(-1);
+		}
+		char line[CHAR_BUFFER_SIZE];
+		while(fgets(line, sizeof(line), file)){
+			char *comment = strchr(line, '#');
+			if(comment != NULL) *comment = '\0';
+			AddEntries(line);
+		}
+		fclose(file);
+	}
+
+	/*
+	 * IsValidFormat(): checks that a format contains exactly one conversion, of floating point type
+	 */
+	static int IsValidFormat(const char *format){
+		int num_conversions (0);
+		for(const char *c = format; *c != '\0'; ++c){
+			if(*c != '%') continue;
+			if(*(c+1) == '%') { ++c; continue; }
+			++c;
+			while(*c != '\0' && strchr("-+ #0", *c) != NULL) ++c;
+			while(*c >= '0' && *c <= '9') ++c;
+			if(*c == '.') { ++c; while(*c >= '0' && *c <= '9') ++c; }
+			if(*c == '\0' || strchr("fFeEgG", *c) == NULL) return FALSE;
+			++num_conversions;
+		}
+		return num_conversions == 1;
+	}
+
+	/*
+	 * PrintAvailableMetrics(): prints the metrics that can be entered in the schema
+	 */
+	static void PrintAvailableMetrics(){
+		printf("%s Metrics with scope node or wlan:\n", LOG_LVL1);
+		for(size_t m = 0; m < sizeof(output_metrics) / sizeof(output_metrics[0]); ++m){
+			if(output_metrics[m].scope == OUTPUT_SCOPE_NODE)
+				printf("%s %s: %s\n", LOG_LVL2, output_metrics[m].name, output_metrics[m].description);
+		}
+		printf("%s Metrics with scope global:\n", LOG_LVL1);
+		for(size_t m = 0; m < sizeof(output_metrics) / sizeof(output_metrics[0]); ++m){
+			if(output_metrics[m].scope == OUTPUT_SCOPE_GLOBAL)
+				printf("%s %s: %s\n", LOG_LVL2, output_metrics[m].name, output_metrics[m].description);
+		}
+	}
+
+	/*
+	 * Write(): writes the line of a simulation (every column is preceded by ';')
+	 * Input arguments:
+	 * - file: script output file
+	 * - results: results of the simulation
+	 */
+	void Write(FILE *file, const SimulationResults &results){
+		for(size_t e = 0; e < entries.size(); ++e){
+			const OutputSchemaEntry &entry = entries[e];
+			switch(entry.scope){
+				case OUTPUT_SCOPE_NODE:{
+					for(int n = 0; n < results.total_nodes_number; ++n){
+						fputc(';', file);
+						fprintf(file, entry.format.c_str(), entry.metric->value(results, n));
+					}
+					break;
+				}
+				case OUTPUT_SCOPE_WLAN:{
+					for(int w = 0; w < results.total_wlans_number; ++w){
+						fputc(';', file);
+						fprintf(file, entry.format.c_str(), entry.metric->value(results, results.wlan_container[w].ap_id));
+					}
+					break;
+				}
+				case OUTPUT_SCOPE_GLOBAL:{
+					fputc(';', file);
+					fprintf(file, entry.format.c_str(), entry.metric->value(results, -1));
+					break;
+				}
+			}
+		}
+		fprintf(file, "\n");
+	}
+};
+
+OutputSchema output_schema;
+
+#endif
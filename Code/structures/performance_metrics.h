@@ -46,6 +46,8 @@
  * - This file defines a NOTIFICATION and provides basic displaying methods
  */
 
+#include "delay_histogram.h"
+
 #ifndef _AUX_PERFORMANCE_
 #define _AUX_PERFORMANCE_
 
@@ -75,6 +77,7 @@ struct Performance
 	int num_delay_measurements;
 	double sum_delays;
 	double average_delay;
+	DelayHistogram *delay_histogram;
 	double average_rho;
 	double average_utilization;
 	double generation_drop_ratio;
@@ -100,6 +103,7 @@ struct Performance
 	int *rts_cts_lost_per_sta;
 	int *data_packets_acked_per_sta;
 	int *data_frames_acked_per_sta;
+	DelayHistogram *delay_histogram_per_sta;
 
 	// Other
 	int num_tx_init_tried;
@@ -153,6 +157,7 @@ struct Performance
 		rts_cts_lost_per_sta = new int[num_stas];
 		data_packets_acked_per_sta = new int[num_stas];
 		data_frames_acked_per_sta = new int[num_stas];
+		delay_histogram_per_sta = new DelayHistogram[num_stas];
 		for(int i = 0; i < num_stas; ++i){
 			throughput_per_sta[i] = 0;
 			data_packets_sent_per_sta[i] = 0;
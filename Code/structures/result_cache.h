@@ -0,0 +1,382 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the result cache: a local directory storing the outputs of simulations (script
+ *   output line and console log with the statistics), keyed by a hash of their canonicalized inputs
+ *   (input files, seed, simulation time, output schema and build version). Simulations found in the
+ *   cache are not run again. Least recently used entries are evicted beyond a size limit.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "../list_of_macros.h"
+
+#ifndef _AUX_RESULT_CACHE_
+#define _AUX_RESULT_CACHE_
+
+/*
+ * ResultKey: 128-bit hash (two FNV-1a streams with different offsets) of the inputs of a simulation
+ */
+struct ResultKey
+{
+	unsigned long long hash[2];
+
+	ResultKey(){
+		hash[0] = 14695981039346656037ULL;
+		hash[1] = 9650029242287828579ULL;
+	}
+
+	void AddByte(unsigned char byte){
+		hash[0] = (hash[0] ^ byte) * 1099511628211ULL;
+		hash[1] = (hash[1] ^ (unsigned char) (byte + 0x5B)) * 1099511628211ULL;
+	}
+
+	/*
+	 * AddString(): adds a value (followed by a separator, so that consecutive values do not merge)
+	 */
+	void AddString(const std::string &value){
+		for(size_t c = 0; c < value.size(); ++c) AddByte(value[c]);
+		AddByte(0xFF);
+	}
+
+	void AddNumber(double value){
+		char text[64];
+		snprintf(text, sizeof(text), "%.17g", value);
+		AddString(text);
+	}
+
+	/*
+	 * AddFile(): adds the canonicalized content of an input file: carriage returns, trailing blanks
+	 * and blank lines are ignored, so that equivalent files share their results
+	 */
+	void AddFile(const char *filename){
+		FILE *file = fopen(filename, "rb");
+		if(file == NULL){
+			printf("ERROR: input file '%s' not found!\n", filename);
+			exit(-1);
+		}
+		std::string line;
+		int c;
+		while((c = fgetc(file)) != EOF){
+			if(c == '\r') continue;
+			if(c != '\n'){
+				line.push_back((char) c);
+				continue;
+			}
+			AddLine(line);
+		}
+		AddLine(line);
+		fclose(file);
+		AddByte(0xFF);
+	}
+
+	void AddLine(std::string &line){
+		line.erase(line.find_last_not_of(" \t") + 1);
+		if(!line.empty()){
+			for(size_t c = 0; c < line.size(); ++c) AddByte(line[c]);
+			AddByte('\n');
+		}
+		line.clear();
+	}
+
+	std::string Hex() const {
+		char text[33];
+		snprintf(text, sizeof(text), "%016llx%016llx", hash[0], hash[1]);
+		return text;
+	}
+};
+
+/*
+ * CachedResult: outputs of a simulation
+ */
+struct CachedResult
+{
+	std::string script_output;		// Output written to the script file (without the simulation header)
+	std::string console_log;		// Content of the console log file (logs_console_<code>.txt)
+};
+
+/*
+ * ResultCache: result cache options entered per console and directory store
+ * - Entries are files named <key>.kres. Hits refresh their modification time, which orders the
+ *   least recently used entries for eviction.
+ * - Events (hit, miss, store, evict) are appended to <directory>/stats.log, read by --result_cache_stats.
+ */
+struct ResultCache
+{
+	std::string directory;		// Cache directory (empty: results are not cached)
+	long long max_bytes;		// Size of the entries beyond which the least recently used ones are evicted
+	int print_statistics;		// Print the statistics of the cache and exit
+	int lookups_enabled;		// FALSE if the simulation must run anyway (e.g., it writes node logs), results are still stored
+
+	ResultCache() : max_bytes((long long) RESULT_CACHE_DEFAULT_MAX_MB << 20), print_statistics(FALSE),
+		lookups_enabled(TRUE) {}
+
+	/*
+	 * ParseArgument(): parses a result cache console argument
+	 * Input arguments:
+	 * - argument: console argument. Accepted options:
+	 *   --result_cache=<dir>			look up the results of the simulation in <dir>, and store them there
+	 *   --result_cache_max_mb=<N>		evict the least recently used entries beyond N MB
+	 *   --result_cache_stats			print the statistics of the cache and exit (requires --result_cache)
+	 * Output:
+	 * - TRUE if the argument is a result cache option, FALSE otherwise
+	 */
+	int ParseArgument(const char *argument){
+
+		if(strncmp(argument, "--result_cache=", 15) == 0){
+			directory = std::string(argument + 15);
+
+		} else if(strncmp(argument, "--result_cache_max_mb=", 22) == 0){
+			max_bytes = atoll(argument + 22) << 20;
+
+		} else if(strcmp(argument, "--result_cache_stats") == 0){
+			print_statistics = TRUE;
+
+		} else {
+			return FALSE;
+		}
+		return TRUE;
+	}
+
+	std::string EntryPath(const ResultKey &key) const {
+		return directory + "/" + key.Hex() + RESULT_CACHE_EXTENSION;
+	}
+
+	/*
+	 * Lookup(): reads the results of a simulation
+	 * Output:
+	 * - TRUE on a hit (result filled), FALSE otherwise (always FALSE if lookups are disabled)
+	 */
+	int Lookup(const ResultKey &key, CachedResult &result){
+
+		if(!lookups_enabled) return FALSE;
+		std::string path (EntryPath(key));
+		FILE *file = fopen(path.c_str(), "rb");
+		int hit (FALSE);
+		if(file != NULL){
+			char magic[16];
+			unsigned long long script_length, console_length;
+			if(fscanf(file, "%15s %llu %llu", magic, &script_length, &console_length) == 3
+				&& strcmp(magic, RESULT_CACHE_MAGIC) == 0 && fgetc(file) == '\n'){
+				result.script_output.resize(script_length);
+				result.console_log.resize(console_length);
+				hit = fread(&result.script_output[0], 1, script_length, file) == script_length
+					&& fread(&result.console_log[0], 1, console_length, file) == console_length;
+			}
+			fclose(file);
+		}
+		if(hit) utime(path.c_str(), NULL);
+		RecordEvent(hit ? "hit" : "miss", key);
+		return hit;
+	}
+
+	/*
+	 * Store(): writes the results of a simulation (to a temporary file first, so that concurrent
+	 * simulations never read a partial entry) and evicts entries if the cache is full
+	 */
+	void Store(const ResultKey &key, const CachedResult &result){
+
+		mkdir(directory.c_str(), 0755);
+		std::string path (EntryPath(key));
+		std::string temporary_path (path + ".tmp" + std::to_string(getpid()));
+		FILE *file = fopen(temporary_path.c_str(), "wb");
+		if(file == NULL){
+			printf("%s WARNING: result cache entry '%s' could not be written\n", LOG_LVL2, path.c_str());
+			return;
+		}
+		fprintf(file, "%s %llu %llu\n", RESULT_CACHE_MAGIC, (unsigned long long) result.script_output.size(),
+			(unsigned long long) result.console_log.size());
+		fwrite(result.script_output.data(), 1, result.script_output.size(), file);
+		fwrite(result.console_log.data(), 1, result.console_log.size(), file);
+		int failed (ferror(file));
+		fclose(file);
+		if(failed || rename(temporary_path.c_str(), path.c_str()) != 0){
+			printf("%s WARNING: result cache entry '%s' could not be written\n", LOG_LVL2, path.c_str());
+			remove(temporary_path.c_str());
+			return;
+		}
+		RecordEvent("store", key);
+		Evict();
+	}
+
+	/*
+	 * Evict(): removes the least recently used entries until the cache takes RESULT_CACHE_EVICTION_TARGET
+	 * of its maximum size (only if the maximum is exceeded)
+	 */
+	void Evict(){
+
+		std::vector<std::pair<time_t, std::string> > entries;
+		long long total_bytes (ListEntries(entries));
+		if(total_bytes <= max_bytes) return;
+		std::sort(entries.begin(), entries.end());
+		for(size_t e = 0; e < entries.size() && total_bytes > max_bytes * RESULT_CACHE_EVICTION_TARGET; ++e){
+			struct stat entry_stat;
+			std::string path (directory + "/" + entries[e].second);
+			if(stat(path.c_str(), &entry_stat) != 0 || remove(path.c_str()) != 0) continue;
+			total_bytes -= entry_stat.st_size;
+			RecordEvent("evict", entries[e].second);
+		}
+	}
+
+	/*
+	 * ListEntries(): modification time and name of every entry
+	 * Output:
+	 * - total size of the entries [bytes]
+	 */
+	long long ListEntries(std::vector<std::pair<time_t, std::string> > &entries) const {
+		long long total_bytes (0);
+		DIR *dir = opendir(directory.c_str());
+		if(dir == NULL) return 0;
+		size_t extension_length (strlen(RESULT_CACHE_EXTENSION));
+		struct dirent *item;
+		while((item = readdir(dir)) != NULL){
+			std::string name (item->d_name);
+			if(name.size() <= extension_length
+				|| name.compare(name.size() - extension_length, extension_length, RESULT_CACHE_EXTENSION) != 0) continue;
+			struct stat entry_stat;
+			if(stat((directory + "/" + name).c_str(), &entry_stat) != 0) continue;
+			entries.push_back(std::make_pair(entry_stat.st_mtime, name));
+			total_bytes += entry_stat.st_size;
+		}
+		closedir(dir);
+		return total_bytes;
+	}
+
+	void RecordEvent(const char *event, const ResultKey &key){
+		RecordEvent(event, key.Hex());
+	}
+
+	/*
+	 * RecordEvent(): appends an event to the statistics (single write in append mode, so that
+	 * concurrent simulations do not interleave their lines)
+	 */
+	void RecordEvent(const char *event, const std::string &entry){
+		mkdir(directory.c_str(), 0755);
+		char line[128];
+		int length (snprintf(line, sizeof(line), "%ld;%s;%s\n", (long) time(NULL), event, entry.c_str()));
+		int fd (open((directory + "/" + RESULT_CACHE_STATS_FILENAME).c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644));
+		if(fd < 0) return;
+		if(write(fd, line, length) != length) printf("%s WARNING: result cache statistics could not be written\n", LOG_LVL2);
+		close(fd);
+	}
+
+	/*
+	 * PrintStatistics(): prints the entries held and the events recorded
+	 */
+	void PrintStatistics() const {
+
+		std::vector<std::pair<time_t, std::string> > entries;
+		long long total_bytes (ListEntries(entries));
+		long long hits (0), misses (0), stores (0), evictions (0);
+		FILE *file = fopen((directory + "/" + RESULT_CACHE_STATS_FILENAME).c_str(), "r");
+		if(file != NULL){
+			char line[256];
+			while(fgets(line, sizeof(line), file) != NULL){
+				const char *event (strchr(line, ';'));
+				if(event == NULL) continue;
+				++event;
+				if(strncmp(event, "hit;", 4) == 0) ++hits;
+				else if(strncmp(event, "miss;", 5) == 0) ++misses;
+				else if(strncmp(event, "store;", 6) == 0) ++stores;
+				else if(strncmp(event, "evict;", 6) == 0) ++evictions;
+			}
+			fclose(file);
+		}
+		printf("%s Result cache '%s':\n", LOG_LVL1, directory.c_str());
+		printf("%s Entries: %d (%.2f MB of %.2f MB)\n", LOG_LVL2, (int) entries.size(),
+			total_bytes / 1048576.0, max_bytes / 1048576.0);
+		printf("%s Lookups: %lld (%lld hits, %lld misses, hit ratio %.2f %%)\n", LOG_LVL2, hits + misses, hits, misses,
+			hits + misses > 0 ? 100.0 * hits / (hits + misses) : 0.0);
+		printf("%s Stores: %lld, evictions: %lld\n", LOG_LVL2, stores, evictions);
+	}
+};
+
+ResultCache result_cache;
+
+/*
+ * ReadWholeFile(): content of a file (empty if it cannot be read)
+ */
+std::string ReadWholeFile(const std::string &filename){
+	std::string content;
+	FILE *file = fopen(filename.c_str(), "rb");
+	if(file == NULL) return content;
+	char buffer[1 << 16];
+	size_t bytes_read;
+	while((bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0) content.append(buffer, bytes_read);
+	fclose(file);
+	return content;
+}
+
+/*
+ * WriteCachedResult(): writes the results of a simulation found in the result cache, as the simulation would
+ * Input arguments:
+ * - script_file: script output file
+ * - simulation_code: simulation code
+ * - seed: simulation seed
+ * - cached_result: results found in the cache
+ */
+void WriteCachedResult(FILE *script_file, const std::string &simulation_code, int seed, const CachedResult &cached_result){
+
+	fprintf(script_file, "%s KOMONDOR SIMULATION '%s' (seed %d)", LOG_LVL1, simulation_code.c_str(), seed);
+	fwrite(cached_result.script_output.data(), 1, cached_result.script_output.size(), script_file);
+	FILE *console_file = fopen(("../output/logs_console_" + simulation_code + ".txt").c_str(), "w");
+	if(console_file != NULL){
+		fwrite(cached_result.console_log.data(), 1, cached_result.console_log.size(), console_file);
+		fclose(console_file);
+	}
+}
+
+#endif
@@ -0,0 +1,484 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the compiled scenarios: a versioned binary file holding the system and
+ *   nodes records read from the input CSVs and the path gain data derived from them (distances,
+ *   received power and maximum power received from each WLAN). Compiled scenarios are stored in
+ *   a cache directory, keyed by a hash of the input files, and memory-mapped on startup.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+#include "../list_of_macros.h"
+#include "csv_file.h"
+
+#ifndef _AUX_SCENARIO_FILE_
+#define _AUX_SCENARIO_FILE_
+
+/*
+ * SystemRecord: system (environment) parameters, as written in the system file
+ */
+struct SystemRecord
+{
+	int num_channels;
+	int basic_channel_bandwidth;
+	int pdf_backoff;
+	int pdf_tx_time;
+	int frame_length;
+	int max_num_packets_aggregated;
+	int path_loss_model;
+	double capture_effect_db;
+	double noise_level_dbm;
+	int adjacent_channel_model;
+	int collisions_model;
+	double constant_per;
+	int traffic_model;
+	int backoff_type;
+	int cw_adaptation;
+	int pifs_activated;
+	int capture_effect_model;
+	int burst_size_model;
+	double burst_size;
+	int log_writer_mode;
+	char per_tables_filename[4 * SCENARIO_STRING_LENGTH];
+
+	/*
+	 * ReadFromCsv(): reads a row of the system file
+	 */
+	void ReadFromCsv(const CsvFile &system_file, int row){
+
+		memset(this, 0, sizeof(SystemRecord));
+		num_channels = system_file.GetInt(row, IX_NUM_CHANNELS, "num_channels");
+		basic_channel_bandwidth = system_file.GetInt(row, IX_BASIC_CH_BW, "basic_channel_bandwidth");
+		pdf_backoff = system_file.GetInt(row, IX_PDF_BACKOFF, "pdf_backoff");
+		pdf_tx_time = system_file.GetInt(row, IX_PDF_TX_TIME, "pdf_tx_time");
+		frame_length = system_file.GetInt(row, IX_PACKET_LENGTH, "packet_length");
+		max_num_packets_aggregated = system_file.GetInt(row, IX_NUM_PACKETS_AGGREGATED, "num_packets_aggregated");
+		path_loss_model = system_file.GetInt(row, IX_PATH_LOSS, "path_loss_model");
+		capture_effect_db = system_file.GetDouble(row, IX_CAPTURE_EFFECT, "capture_effect");
+		noise_level_dbm = system_file.GetDouble(row, IX_NOISE_LEVEL, "noise_level");
+		adjacent_channel_model = system_file.GetInt(row, IX_COCHANNEL_MODEL, "adjacent_channel_model");
+		collisions_model = system_file.GetInt(row, IX_COLLISIONS_MODEL, "collisions_model");
+		constant_per = system_file.GetDouble(row, IX_CONSTANT_PER, "constant_per");
+		traffic_model = system_file.GetInt(row, IX_TRAFFIC_MODEL, "traffic_model");
+		backoff_type = system_file.GetInt(row, IX_BO_TYPE, "backoff_type");
+		cw_adaptation = system_file.GetInt(row, IX_CW_ADAPTATION, "cw_adaptation");
+		pifs_activated = system_file.GetInt(row, IX_PIFS_ACTIVATION, "pifs_activated");
+		capture_effect_model = system_file.GetInt(row, IX_CAPTURE_EFFECT_MODEL, "capture_effect_model");
+
+		// Optional fields (old system files do not include them)
+		burst_size_model = system_file.HasField(row, IX_BURST_SIZE_MODEL) ?
+			system_file.GetInt(row, IX_BURST_SIZE_MODEL, "burst_size_model") : DEFAULT_BURST_SIZE_MODEL;
+		burst_size = system_file.HasField(row, IX_BURST_SIZE) ?
+			system_file.GetDouble(row, IX_BURST_SIZE, "burst_size") : DEFAULT_BURST_SIZE;
+		log_writer_mode = system_file.HasField(row, IX_LOG_WRITER_MODE) ?
+			system_file.GetInt(row, IX_LOG_WRITER_MODE, "log_writer_mode") : DEFAULT_LOG_WRITER_MODE;
+		if(system_file.HasField(row, IX_PER_TABLES_FILENAME)){
+			std::string per_tables (system_file.GetString(row, IX_PER_TABLES_FILENAME, "per_tables_filename"));
+			if(per_tables.size() >= sizeof(per_tables_filename)){
+				system_file.Error(row, IX_PER_TABLES_FILENAME, "per_tables_filename", "is too long");
+			}
+			strcpy(per_tables_filename, per_tables.c_str());
+		}
+	}
+};
+
+/*
+ * NodeRecord: parameters of a node, as written in the nodes file
+ */
+struct NodeRecord
+{
+	char node_code[SCENARIO_STRING_LENGTH];
+	char wlan_code[SCENARIO_STRING_LENGTH];
+	int node_type;
+	int destination_id;
+	double x;
+	double y;
+	double z;
+	int primary_channel;
+	int min_channel_allowed;
+	int max_channel_allowed;
+	int cw_min;
+	int cw_stage_max;
+	double tx_power_min_dbm;
+	double tx_power_default_dbm;
+	double tx_power_max_dbm;
+	int sensitivity_min_dbm;
+	int sensitivity_default_dbm;
+	int sensitivity_max_dbm;
+	int tx_gain_db;
+	int rx_gain_db;
+	int dcb_policy;
+	int modulation_default;
+	double central_frequency_ghz;
+	double lambda;
+	int ieee_protocol;
+	double traffic_load;
+	int spatial_reuse_enabled;		// FALSE if the file does not include the spatial reuse columns
+	int bss_color;
+	int srg;
+	double non_srg_obss_pd_dbm;
+	double srg_obss_pd_dbm;
+	int original_node_id;			// Row of the node in the nodes file (differs from its id if nodes are renumbered)
+
+	/*
+	 * ReadFromCsv(): reads a row of the nodes file
+	 */
+	void ReadFromCsv(const CsvFile &nodes_file, int row){
+
+		memset(this, 0, sizeof(NodeRecord));
+		CopyCode(nodes_file, row, IX_NODE_CODE, "node_code", node_code);
+		node_type = nodes_file.GetInt(row, IX_NODE_TYPE, "node_type");
+		CopyCode(nodes_file, row, IX_WLAN_CODE, "wlan_code", wlan_code);
+		destination_id = nodes_file.GetInt(row, IX_DESTINATION_ID, "destination_id");
+		x = nodes_file.GetDouble(row, IX_POSITION_X, "x");
+		y = nodes_file.GetDouble(row, IX_POSITION_Y, "y");
+		z = nodes_file.GetDouble(row, IX_POSITION_Z, "z");
+		primary_channel = nodes_file.GetInt(row, IX_PRIMARY_CHANNEL, "primary_channel");
+		min_channel_allowed = nodes_file.GetInt(row, IX_MIN_CH_ALLOWED, "min_channel_allowed");
+		max_channel_allowed = nodes_file.GetInt(row, IX_MAX_CH_ALLOWED, "max_channel_allowed");
+		cw_min = nodes_file.GetInt(row, IX_CW_MIN, "cw");
+		cw_stage_max = nodes_file.GetInt(row, IX_CW_STAGE_MAX, "cw_stage");
+		tx_power_min_dbm = nodes_file.GetDouble(row, IX_TX_POWER_MIN, "tpc_min");
+		tx_power_default_dbm = nodes_file.GetDouble(row, IX_TX_POWER_DEFAULT, "tpc_default");
+		tx_power_max_dbm = nodes_file.GetDouble(row, IX_TX_POWER_MAX, "tpc_max");
+		sensitivity_min_dbm = nodes_file.GetInt(row, IX_PD_MIN, "cca_min");
+		sensitivity_default_dbm = nodes_file.GetInt(row, IX_PD_DEFAULT, "cca_default");
+		sensitivity_max_dbm = nodes_file.GetInt(row, IX_PD_MAX, "cca_max");
+		tx_gain_db = nodes_file.GetInt(row, IX_TX_GAIN, "tx_antenna_gain");
+		rx_gain_db = nodes_file.GetInt(row, IX_RX_GAIN, "rx_antenna_gain");
+		dcb_policy = nodes_file.GetInt(row, IX_CHANNEL_BONDING_MODEL, "channel_bonding_model");
+		modulation_default = nodes_file.GetInt(row, IX_MODULATION_DEFAULT, "modulation_default");
+		central_frequency_ghz = nodes_file.GetDouble(row, IX_CENTRAL_FREQ, "central_freq");
+		lambda = nodes_file.GetDouble(row, IX_LAMBDA, "lambda");
+		ieee_protocol = nodes_file.GetInt(row, IX_IEEE_PROTOCOL_TYPE, "ieee_protocol");
+		traffic_load = nodes_file.GetDouble(row, IX_TRAFFIC_LOAD, "traffic_load");
+
+		// Spatial reuse (only if the input file is compliant with SR)
+		spatial_reuse_enabled = nodes_file.HasField(row, IX_BSS_COLOR);
+		if(spatial_reuse_enabled){
+			bss_color = nodes_file.GetInt(row, IX_BSS_COLOR, "bss_color");
+			srg = nodes_file.GetInt(row, IX_SRG, "srg");
+			non_srg_obss_pd_dbm = nodes_file.GetDouble(row, IX_NON_SRG_OBSS_PD, "non_srg_obss_pd");
+			srg_obss_pd_dbm = nodes_file.GetDouble(row, IX_SRG_OBSS_PD, "srg_obss_pd");
+		}
+	}
+
+	/*
+	 * CopyCode(): copies a node or WLAN code into a fixed-size field
+	 */
+	static void CopyCode(const CsvFile &nodes_file, int row, int field_ix, const char *field_name, char *code){
+		std::string value (nodes_file.GetString(row, field_ix, field_name));
+		if(value.size() >= SCENARIO_STRING_LENGTH) nodes_file.Error(row, field_ix, field_name, "is too long");
+		strcpy(code, value.c_str());
+	}
+};
+
+/*
+ * ScenarioFileHeader: first bytes of a compiled scenario. The sections follow in this order
+ * (each one starting at an offset multiple of 8):
+ * - SystemRecord
+ * - NodeRecord[total_nodes_number]
+ * - double distances[total_nodes_number][total_nodes_number]					[m]
+ * - double received_power[total_nodes_number][total_nodes_number]				[pW]
+ * - double max_received_power_per_wlan[num_aps][total_wlans_number] (APs in node order)	[pW]
+ */
+struct ScenarioFileHeader
+{
+	char magic[8];
+	int version;
+	int record_sizes;				// sizeof(SystemRecord) + sizeof(NodeRecord), to detect incompatible builds
+	unsigned long long input_hash;	// Hash of the input files the scenario was compiled from
+	int total_nodes_number;
+	int total_wlans_number;
+	int num_aps;
+	int padding;
+	unsigned long long system_offset;
+	unsigned long long nodes_offset;
+	unsigned long long distances_offset;
+	unsigned long long received_power_offset;
+	unsigned long long max_power_offset;
+	unsigned long long file_size;
+};
+
+/*
+ * HashFile(): adds the content of a file to a 64-bit FNV-1a hash
+ */
+unsigned long long HashFile(const char *filename, unsigned long long hash){
+	FILE *file = fopen(filename, "rb");
+	if(file == NULL){
+		printf("ERROR: input file '%s' not found!\n", filename);
+		exit(-1);
+	}
+	unsigned char buffer[1 << 16];
+	size_t bytes_read;
+	while((bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0){
+		for(size_t b = 0; b < bytes_read; ++b){
+			hash ^= buffer[b];
+			hash *= 1099511628211ULL;
+		}
+	}
+	fclose(file);
+	// Separator, so that moving bytes from one file to the next changes the hash
+	hash ^= 0xFF;
+	hash *= 1099511628211ULL;
+	return hash;
+}
+
+/*
+ * ScenarioFile: compiled scenario mapped in memory
+ * - The mapping is private and writable: nodes may update their received power (e.g., after a
+ *   change of transmission power) without modifying the file.
+ */
+struct ScenarioFile
+{
+	char *data;
+	size_t size;
+	const ScenarioFileHeader *header;
+	const SystemRecord *system_record;
+	const NodeRecord *node_records;
+	double *distances;
+	double *received_power;
+	double *max_received_power_per_wlan;
+
+	ScenarioFile() : data(NULL), size(0), header(NULL), system_record(NULL), node_records(NULL),
+		distances(NULL), received_power(NULL), max_received_power_per_wlan(NULL) {}
+
+	/*
+	 * InputHash(): hash identifying the inputs of a scenario (and the order of its nodes, NODE_ORDER_XXX)
+	 */
+	static unsigned long long InputHash(const char *system_filename, const char *nodes_filename, int node_order){
+		unsigned long long hash (14695981039346656037ULL);
+		char model[64];
+		sprintf(model, "%s;%d;%d;%d;%d", SCENARIO_FILE_MAGIC, SCENARIO_FILE_VERSION,
+			(int) sizeof(SystemRecord), (int) sizeof(NodeRecord), node_order);
+		hash = HashString(model, hash);
+		hash = HashFile(system_filename, hash);
+		// Generated scenarios (see structures/scenario_generator.h) are identified by their spec
+		if(strncmp(nodes_filename, SCENARIO_GENERATOR_PREFIX, strlen(SCENARIO_GENERATOR_PREFIX)) == 0){
+			return HashString(nodes_filename, hash);
+		}
+		return HashFile(nodes_filename, hash);
+	}
+
+	static unsigned long long HashString(const char *text, unsigned long long hash){
+		for(const char *c = text; *c; ++c){
+			hash ^= (unsigned char) *c;
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	/*
+	 * CachePath(): path of the compiled scenario of some inputs in a cache directory
+	 */
+	static std::string CachePath(const std::string &directory, unsigned long long input_hash){
+		char name[64];
+		sprintf(name, "scenario_%016llx%s", input_hash, SCENARIO_FILE_EXTENSION);
+		return directory + "/" + name;
+	}
+
+	/*
+	 * Load(): maps a compiled scenario
+	 * Output:
+	 * - TRUE if the file exists and was compiled from the given inputs by a compatible build
+	 */
+	int Load(const char *filename, unsigned long long input_hash){
+
+		int fd (open(filename, O_RDONLY));
+		if(fd < 0) return FALSE;
+		struct stat file_stat;
+		if(fstat(fd, &file_stat) != 0 || (size_t) file_stat.st_size < sizeof(ScenarioFileHeader)){
+			close(fd);
+			return FALSE;
+		}
+		size = file_stat.st_size;
+		void *map (mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0));
+		close(fd);
+		if(map == MAP_FAILED) return FALSE;
+		data = (char *) map;
+		header = (const ScenarioFileHeader *) data;
+
+		if(strcmp(header->magic, SCENARIO_FILE_MAGIC) != 0 || header->version != SCENARIO_FILE_VERSION
+			|| header->record_sizes != (int) (sizeof(SystemRecord) + sizeof(NodeRecord))
+			|| header->input_hash != input_hash || header->file_size != size){
+			printf("%s WARNING: compiled scenario '%s' is outdated or corrupted, it will be compiled again\n",
+				LOG_LVL2, filename);
+			Close();
+			return FALSE;
+		}
+
+		system_record = (const SystemRecord *) (data + header->system_offset);
+		node_records = (const NodeRecord *) (data + header->nodes_offset);
+		distances = (double *) (data + header->distances_offset);
+		received_power = (double *) (data + header->received_power_offset);
+		max_received_power_per_wlan = (double *) (data + header->max_power_offset);
+		return TRUE;
+	}
+
+	/*
+	 * Close(): unmaps the scenario
+	 */
+	void Close(){
+		if(data != NULL) munmap(data, size);
+		data = NULL;
+		size = 0;
+		header = NULL;
+	}
+
+	/*
+	 * Write(): compiles a scenario
+	 * Input arguments:
+	 * - filename: compiled scenario (written to a temporary file first, so that concurrent runs
+	 *   never map a partial file)
+	 * - input_hash: hash of the inputs (see InputHash())
+	 * - system_record, node_records: records read from the input files
+	 * - total_wlans_number: number of WLANs
+	 * - distances, received_power: arrays of each node ([total_nodes_number] each)
+	 * - max_received_power_per_wlan: arrays of each node ([total_wlans_number] each, NULL if not an AP)
+	 */
+	static void Write(const char *filename, unsigned long long input_hash, const SystemRecord &system_record,
+		const std::vector<NodeRecord> &node_records, int total_wlans_number, double *const *distances,
+		double *const *received_power, double *const *max_received_power_per_wlan){
+
+		int total_nodes_number (node_records.size());
+		ScenarioFileHeader header;
+		memset(&header, 0, sizeof(header));
+		strcpy(header.magic, SCENARIO_FILE_MAGIC);
+		header.version = SCENARIO_FILE_VERSION;
+		header.record_sizes = sizeof(SystemRecord) + sizeof(NodeRecord);
+		header.input_hash = input_hash;
+		header.total_nodes_number = total_nodes_number;
+		header.total_wlans_number = total_wlans_number;
+		for(int n = 0; n < total_nodes_number; ++n) if(max_received_power_per_wlan[n] != NULL) ++header.num_aps;
+
+		size_t matrix_size (sizeof(double) * total_nodes_number * total_nodes_number);
+		header.system_offset = Align(sizeof(ScenarioFileHeader));
+		header.nodes_offset = Align(header.system_offset + sizeof(SystemRecord));
+		header.distances_offset = Align(header.nodes_offset + sizeof(NodeRecord) * total_nodes_number);
+		header.received_power_offset = header.distances_offset + matrix_size;
+		header.max_power_offset = header.received_power_offset + matrix_size;
+		header.file_size = header.max_power_offset + sizeof(double) * header.num_aps * total_wlans_number;
+
+		std::string temporary_filename (std::string(filename) + ".tmp" + std::to_string(getpid()));
+		FILE *file = fopen(temporary_filename.c_str(), "wb");
+		if(file == NULL){
+			printf("%s WARNING: compiled scenario '%s' could not be written\n", LOG_LVL2, filename);
+			return;
+		}
+		WriteAt(file, 0, &header, sizeof(header));
+		WriteAt(file, header.system_offset, &system_record, sizeof(SystemRecord));
+		WriteAt(file, header.nodes_offset, node_records.data(), sizeof(NodeRecord) * total_nodes_number);
+		fseek(file, header.distances_offset, SEEK_SET);
+		for(int n = 0; n < total_nodes_number; ++n) fwrite(distances[n], sizeof(double), total_nodes_number, file);
+		for(int n = 0; n < total_nodes_number; ++n) fwrite(received_power[n], sizeof(double), total_nodes_number, file);
+		for(int n = 0; n < total_nodes_number; ++n){
+			if(max_received_power_per_wlan[n] != NULL){
+				fwrite(max_received_power_per_wlan[n], sizeof(double), total_wlans_number, file);
+			}
+		}
+		int failed (ferror(file));
+		fclose(file);
+		if(failed || rename(temporary_filename.c_str(), filename) != 0){
+			printf("%s WARNING: compiled scenario '%s' could not be written\n", LOG_LVL2, filename);
+			remove(temporary_filename.c_str());
+		}
+	}
+
+	static size_t Align(size_t offset){
+		return (offset + 7) & ~((size_t) 7);
+	}
+
+	static void WriteAt(FILE *file, size_t offset, const void *content, size_t length){
+		fseek(file, offset, SEEK_SET);
+		fwrite(content, 1, length, file);
+	}
+};
+
+/*
+ * ScenarioCacheConfig: compiled scenario options entered per console
+ */
+struct ScenarioCacheConfig
+{
+	std::string directory;		// Cache of compiled scenarios (empty: scenarios are not compiled)
+	int compile_only;			// Exit once the scenario is compiled (no simulation)
+
+	ScenarioCacheConfig() : compile_only(FALSE) {}
+
+	/*
+	 * ParseArgument(): parses a compiled scenario console argument
+	 * Input arguments:
+	 * - argument: console argument. Accepted options:
+	 *   --scenario_cache=<dir>		load the compiled scenario of the inputs from <dir>, or compile it there
+	 *   --compile_only				compile the scenario and exit (requires --scenario_cache)
+	 * Output:
+	 * - TRUE if the argument is a compiled scenario option, FALSE otherwise
+	 */
+	int ParseArgument(const char *argument){
+
+		if(strncmp(argument, "--scenario_cache=", 17) == 0){
+			directory = std::string(argument + 17);
+
+		} else if(strcmp(argument, "--compile_only") == 0){
+			compile_only = TRUE;
+
+		} else {
+			return FALSE;
+		}
+		return TRUE;
+	}
+};
+
+ScenarioCacheConfig scenario_cache_config;
+
+#endif
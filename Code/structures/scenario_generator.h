@@ -0,0 +1,513 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the procedural scenario generator: it builds the nodes of large deployments
+ *   (grid, random, enterprise floors and stadium) with N APs x M STAs and channel/power assignment
+ *   rules, directly as node records (no nodes file needed). Scenarios are described by a spec such
+ *   as "generate:topology=grid,aps=100,stas=10,num_channels=4,channels=reuse", which can be entered
+ *   instead of the nodes input filename.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "../list_of_macros.h"
+#include "scenario_file.h"
+
+#ifndef _AUX_SCENARIO_GENERATOR_
+#define _AUX_SCENARIO_GENERATOR_
+
+/*
+ * IsScenarioGeneratorSpec(): checks if a nodes input "filename" is a generator spec
+ */
+int IsScenarioGeneratorSpec(const char *nodes_filename){
+	return strncmp(nodes_filename, SCENARIO_GENERATOR_PREFIX, strlen(SCENARIO_GENERATOR_PREFIX)) == 0;
+}
+
+/*
+ * GeneratorRandom: small PRNG (xorshift64*), so that a spec generates the same scenario in every
+ * build and platform, regardless of the seed of the simulation
+ */
+struct GeneratorRandom
+{
+	unsigned long long state;
+
+	GeneratorRandom(unsigned long long seed) : state(seed * 2685821657736338717ULL + 1) {}
+
+	unsigned long long Next(){
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		return state * 2685821657736338717ULL;
+	}
+
+	// Uniform in [0, 1)
+	double Uniform(){
+		return (Next() >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	// Uniform in [min, max)
+	double Uniform(double min, double max){
+		return min + (max - min) * Uniform();
+	}
+
+	// Uniform in [0, n)
+	int Integer(int n){
+		return (int) (Uniform() * n);
+	}
+};
+
+/*
+ * ScenarioGeneratorConfig: parameters of a generated scenario
+ */
+struct ScenarioGeneratorConfig
+{
+	int topology;				// TOPOLOGY_GRID, TOPOLOGY_RANDOM, TOPOLOGY_ENTERPRISE or TOPOLOGY_STADIUM
+	int num_aps;				// Number of APs (= WLANs)
+	int stas_per_ap;			// Number of STAs per AP
+	unsigned long long seed;	// Seed of the generator (independent of the simulation seed)
+	double ap_distance;			// Distance between neighboring APs (grid, enterprise and stadium tiers) [m]
+	double min_ap_distance;		// Minimum distance between APs (random topology) [m]
+	double width;				// Side of the area (random topology, 0: sqrt(num_aps) * ap_distance) [m]
+	double sta_distance;		// Maximum distance between an AP and its STAs [m]
+	int floors;					// Number of floors (enterprise)
+	double floor_height;		// Height of each floor (enterprise) [m]
+	double pitch_radius;		// Radius of the pitch (stadium) [m]
+	int tiers;					// Number of rings of APs around the pitch (stadium)
+	double tier_height;			// Height increase of each ring of APs (stadium) [m]
+	int num_channels;			// Channels to assign among (must not exceed the channels of the system file)
+	int channel_rule;			// CHANNEL_RULE_SINGLE, CHANNEL_RULE_ROUND_ROBIN, CHANNEL_RULE_RANDOM or CHANNEL_RULE_REUSE
+	double reuse_distance;		// Neighborhood of the greedy channel reuse rule (0: 3 * ap_distance) [m]
+	int power_rule;				// POWER_RULE_FIXED or POWER_RULE_RANDOM
+	double tx_power;			// Transmission power (fixed rule) [dBm]
+	double tx_power_min;		// Transmission power range (random rule) [dBm]
+	double tx_power_max;
+	int cca;					// CCA threshold [dBm]
+	int cw_min;
+	int cw_stage_max;
+	int dcb_policy;
+	int ieee_protocol;
+	double traffic_load;		// Load of each AP [packets/s]
+	int spatial_reuse;			// Write the spatial reuse fields (BSS color of each WLAN)
+	double obss_pd;				// Non-SRG OBSS/PD threshold when spatial reuse is enabled [dBm]
+
+	ScenarioGeneratorConfig() : topology(TOPOLOGY_GRID), num_aps(GENERATOR_DEFAULT_APS),
+		stas_per_ap(GENERATOR_DEFAULT_STAS_PER_AP), seed(1), ap_distance(GENERATOR_DEFAULT_AP_DISTANCE),
+		min_ap_distance(GENERATOR_DEFAULT_MIN_AP_DISTANCE), width(0), sta_distance(GENERATOR_DEFAULT_STA_DISTANCE),
+		floors(GENERATOR_DEFAULT_FLOORS), floor_height(GENERATOR_DEFAULT_FLOOR_HEIGHT),
+		pitch_radius(GENERATOR_DEFAULT_PITCH_RADIUS), tiers(GENERATOR_DEFAULT_TIERS),
+		tier_height(GENERATOR_DEFAULT_TIER_HEIGHT), num_channels(1), channel_rule(CHANNEL_RULE_ROUND_ROBIN),
+		reuse_distance(0), power_rule(POWER_RULE_FIXED), tx_power(GENERATOR_DEFAULT_TX_POWER),
+		tx_power_min(GENERATOR_DEFAULT_TX_POWER), tx_power_max(GENERATOR_DEFAULT_TX_POWER),
+		cca(GENERATOR_DEFAULT_CCA), cw_min(16), cw_stage_max(5), dcb_policy(0), ieee_protocol(1),
+		traffic_load(GENERATOR_DEFAULT_TRAFFIC_LOAD), spatial_reuse(FALSE), obss_pd(GENERATOR_DEFAULT_CCA) {}
+
+	/*
+	 * Parse(): parses a generator spec
+	 * Input arguments:
+	 * - spec: "generate:<key>=<value>,<key>=<value>,..." Accepted keys:
+	 *   topology=<grid|random|enterprise|stadium>, aps=<N>, stas=<M>, seed=<n>, ap_distance=<m>,
+	 *   min_ap_distance=<m>, width=<m>, sta_distance=<m>, floors=<n>, floor_height=<m>, pitch_radius=<m>,
+	 *   tiers=<n>, tier_height=<m>, num_channels=<n>, channels=<single|round_robin|random|reuse>,
+	 *   reuse_distance=<m>, power=<fixed|random>, tx_power=<dBm>, tx_power_min=<dBm>, tx_power_max=<dBm>,
+	 *   cca=<dBm>, cw=<n>, cw_stage=<n>, dcb_policy=<n>, ieee_protocol=<n>, traffic_load=<pkt/s>,
+	 *   spatial_reuse=<0|1>, obss_pd=<dBm>
+	 */
+	void Parse(const char *spec){
+
+		std::string text (spec + strlen(SCENARIO_GENERATOR_PREFIX));
+		size_t start (0);
+		while(start < text.size()){
+			size_t end (text.find(',', start));
+			if(end == std::string::npos) end = text.size();
+			std::string option (text.substr(start, end - start));
+			start = end + 1;
+			if(option.empty()) continue;
+			size_t equal (option.find('='));
+			if(equal == std::string::npos) Error(spec, option, "expected <key>=<value>");
+			SetOption(spec, option.substr(0, equal), option.substr(equal + 1));
+		}
+
+		if(num_aps < 1 || stas_per_ap < 0) Error(spec, "aps", "at least 1 AP is required");
+		if(num_channels < 1) Error(spec, "num_channels", "at least 1 channel is required");
+		if(topology == TOPOLOGY_ENTERPRISE && floors < 1) Error(spec, "floors", "at least 1 floor is required");
+		if(topology == TOPOLOGY_STADIUM && tiers < 1) Error(spec, "tiers", "at least 1 tier is required");
+		if(power_rule == POWER_RULE_RANDOM && tx_power_min > tx_power_max) {
+			Error(spec, "tx_power_min", "must not exceed tx_power_max");
+		}
+	}
+
+	void SetOption(const char *spec, const std::string &key, const std::string &value){
+
+		const char *v (value.c_str());
+		if(key == "topology"){
+			if(value == "grid") topology = TOPOLOGY_GRID;
+			else if(value == "random") topology = TOPOLOGY_RANDOM;
+			else if(value == "enterprise") topology = TOPOLOGY_ENTERPRISE;
+			else if(value == "stadium") topology = TOPOLOGY_STADIUM;
+			else Error(spec, key, "unknown topology");
+		} else if(key == "channels"){
+			if(value == "single") channel_rule = CHANNEL_RULE_SINGLE;
+			else if(value == "round_robin") channel_rule = CHANNEL_RULE_ROUND_ROBIN;
+			else if(value == "random") channel_rule = CHANNEL_RULE_RANDOM;
+			else if(value == "reuse") channel_rule = CHANNEL_RULE_REUSE;
+			else Error(spec, key, "unknown channel rule");
+		} else if(key == "power"){
+			if(value == "fixed") power_rule = POWER_RULE_FIXED;
+			else if(value == "random") power_rule = POWER_RULE_RANDOM;
+			else Error(spec, key, "unknown power rule");
+		} else if(key == "aps") num_aps = atoi(v);
+		else if(key == "stas") stas_per_ap = atoi(v);
+		else if(key == "seed") seed = strtoull(v, NULL, 10);
+		else if(key == "ap_distance") ap_distance = atof(v);
+		else if(key == "min_ap_distance") min_ap_distance = atof(v);
+		else if(key == "width") width = atof(v);
+		else if(key == "sta_distance") sta_distance = atof(v);
+		else if(key == "floors") floors = atoi(v);
+		else if(key == "floor_height") floor_height = atof(v);
+		else if(key == "pitch_radius") pitch_radius = atof(v);
+		else if(key == "tiers") tiers = atoi(v);
+		else if(key == "tier_height") tier_height = atof(v);
+		else if(key == "num_channels") num_channels = atoi(v);
+		else if(key == "reuse_distance") reuse_distance = atof(v);
+		else if(key == "tx_power") tx_power = atof(v);
+		else if(key == "tx_power_min") tx_power_min = atof(v);
+		else if(key == "tx_power_max") tx_power_max = atof(v);
+		else if(key == "cca") cca = atoi(v);
+		else if(key == "cw") cw_min = atoi(v);
+		else if(key == "cw_stage") cw_stage_max = atoi(v);
+		else if(key == "dcb_policy") dcb_policy = atoi(v);
+		else if(key == "ieee_protocol") ieee_protocol = atoi(v);
+		else if(key == "traffic_load") traffic_load = atof(v);
+		else if(key == "spatial_reuse") spatial_reuse = atoi(v);
+		else if(key == "obss_pd") obss_pd = atof(v);
+		else Error(spec, key, "unknown option");
+	}
+
+	static void Error(const char *spec, const std::string &option, const char *message){
+		printf("ERROR: scenario generator spec '%s': '%s' %s\n", spec, option.c_str(), message);
+		exit(-1);
+	}
+};
+
+/*
+ * ScenarioGenerator: builds the node records of a generated scenario. Nodes are written AP first,
+ * followed by its STAs (as in the nodes files), WLANs being named A, B, ..., Z, AA, AB, ...
+ */
+struct ScenarioGenerator
+{
+	ScenarioGeneratorConfig config;
+	GeneratorRandom random;
+	std::vector<double> ap_x;
+	std::vector<double> ap_y;
+	std::vector<double> ap_z;
+
+	ScenarioGenerator(const ScenarioGeneratorConfig &config) : config(config), random(config.seed) {}
+
+	/*
+	 * Generate(): generates the node records
+	 * Output:
+	 * - node_records: records of the APs and STAs ((stas_per_ap + 1) * num_aps)
+	 */
+	void Generate(std::vector<NodeRecord> &node_records){
+
+		switch(config.topology){
+			case TOPOLOGY_GRID: PlaceGrid(1); break;
+			case TOPOLOGY_RANDOM: PlaceRandom(); break;
+			case TOPOLOGY_ENTERPRISE: PlaceGrid(config.floors); break;
+			case TOPOLOGY_STADIUM: PlaceStadium(); break;
+		}
+
+		std::vector<int> channels;
+		AssignChannels(channels);
+
+		node_records.assign((size_t) config.num_aps * (config.stas_per_ap + 1), NodeRecord());
+		size_t node_ix (0);
+		for(int a = 0; a < config.num_aps; ++a){
+
+			std::string wlan_code (WlanCode(a));
+			double tx_power (config.power_rule == POWER_RULE_RANDOM ?
+				config.tx_power_min + random.Integer((int) (config.tx_power_max - config.tx_power_min) + 1) : config.tx_power);
+
+			NodeRecord &ap = node_records[node_ix++];
+			FillRecord(ap, a, wlan_code, channels[a], tx_power);
+			snprintf(ap.node_code, SCENARIO_STRING_LENGTH, "AP_%s", wlan_code.c_str());
+			ap.node_type = NODE_TYPE_AP;
+			ap.x = ap_x[a];
+			ap.y = ap_y[a];
+			ap.z = ap_z[a];
+			ap.traffic_load = config.traffic_load;
+
+			for(int s = 0; s < config.stas_per_ap; ++s){
+				NodeRecord &sta = node_records[node_ix++];
+				FillRecord(sta, a, wlan_code, channels[a], tx_power);
+				snprintf(sta.node_code, SCENARIO_STRING_LENGTH, "STA_%s%d", wlan_code.c_str(), s + 1);
+				sta.node_type = NODE_TYPE_STA;
+				PlaceSta(a, sta);
+			}
+		}
+	}
+
+	/*
+	 * WlanCode(): code of the WLAN of the a-th AP (bijective base 26: A, ..., Z, AA, AB, ...)
+	 */
+	static std::string WlanCode(int a){
+		std::string code;
+		for(++a; a > 0; a = (a - 1) / 26) code.insert(code.begin(), (char) ('A' + (a - 1) % 26));
+		return code;
+	}
+
+	void FillRecord(NodeRecord &record, int a, const std::string &wlan_code, int channel, double tx_power){
+		strcpy(record.wlan_code, wlan_code.c_str());
+		record.destination_id = -1;
+		record.primary_channel = channel;
+		record.min_channel_allowed = channel;
+		record.max_channel_allowed = channel;
+		record.cw_min = config.cw_min;
+		record.cw_stage_max = config.cw_stage_max;
+		record.tx_power_min_dbm = config.power_rule == POWER_RULE_RANDOM ? config.tx_power_min : tx_power;
+		record.tx_power_default_dbm = tx_power;
+		record.tx_power_max_dbm = config.power_rule == POWER_RULE_RANDOM ? config.tx_power_max : tx_power;
+		record.sensitivity_min_dbm = config.cca;
+		record.sensitivity_default_dbm = config.cca;
+		record.sensitivity_max_dbm = config.cca;
+		record.dcb_policy = config.dcb_policy;
+		record.central_frequency_ghz = 5;
+		record.lambda = 10000;
+		record.ieee_protocol = config.ieee_protocol;
+		record.spatial_reuse_enabled = config.spatial_reuse;
+		if(config.spatial_reuse){
+			record.bss_color = a % 63 + 1;
+			record.srg = 0;
+			record.non_srg_obss_pd_dbm = config.obss_pd;
+			record.srg_obss_pd_dbm = config.obss_pd;
+		}
+	}
+
+	/*
+	 * PlaceGrid(): APs on a square grid, spaced ap_distance. With several floors (enterprise) the APs
+	 * are split among the floors and mounted on the ceiling.
+	 */
+	void PlaceGrid(int floors){
+		int aps_per_floor ((config.num_aps + floors - 1) / floors);
+		int columns ((int) ceil(sqrt((double) aps_per_floor)));
+		for(int a = 0; a < config.num_aps; ++a){
+			int floor_ix (a / aps_per_floor);
+			int position (a % aps_per_floor);
+			ap_x.push_back((position % columns) * config.ap_distance);
+			ap_y.push_back((position / columns) * config.ap_distance);
+			ap_z.push_back(config.topology == TOPOLOGY_ENTERPRISE ?
+				(floor_ix + 1) * config.floor_height - GENERATOR_CEILING_OFFSET : 0);
+		}
+	}
+
+	/*
+	 * PlaceRandom(): APs uniformly distributed over a square area, at least min_ap_distance apart
+	 * (best effort: a position is drawn up to GENERATOR_MAX_ATTEMPTS times). Neighbors are looked up
+	 * in cells of side min_ap_distance, so that placing N APs takes O(N).
+	 */
+	void PlaceRandom(){
+		double width (config.width > 0 ? config.width : sqrt((double) config.num_aps) * config.ap_distance);
+		double cell_size (config.min_ap_distance > 0 ? config.min_ap_distance : width);
+		std::map<std::pair<long, long>, std::vector<int> > cells;
+		for(int a = 0; a < config.num_aps; ++a){
+			double x (0), y (0);
+			for(int attempt = 0; attempt < GENERATOR_MAX_ATTEMPTS; ++attempt){
+				x = random.Uniform(0, width);
+				y = random.Uniform(0, width);
+				if(config.min_ap_distance <= 0 || !HasNeighbor(cells, cell_size, x, y, config.min_ap_distance)) break;
+			}
+			cells[std::make_pair((long) floor(x / cell_size), (long) floor(y / cell_size))].push_back(a);
+			ap_x.push_back(x);
+			ap_y.push_back(y);
+			ap_z.push_back(0);
+		}
+	}
+
+	int HasNeighbor(const std::map<std::pair<long, long>, std::vector<int> > &cells, double cell_size,
+		double x, double y, double distance){
+		long cell_x ((long) floor(x / cell_size)), cell_y ((long) floor(y / cell_size));
+		for(long i = cell_x - 1; i <= cell_x + 1; ++i){
+			for(long j = cell_y - 1; j <= cell_y + 1; ++j){
+				std::map<std::pair<long, long>, std::vector<int> >::const_iterator cell (cells.find(std::make_pair(i, j)));
+				if(cell == cells.end()) continue;
+				for(size_t k = 0; k < cell->second.size(); ++k){
+					int b (cell->second[k]);
+					if((ap_x[b] - x) * (ap_x[b] - x) + (ap_y[b] - y) * (ap_y[b] - y) < distance * distance) return TRUE;
+				}
+			}
+		}
+		return FALSE;
+	}
+
+	/*
+	 * PlaceStadium(): APs on concentric rings (tiers) around the pitch, spaced ap_distance, each tier
+	 * being higher than the previous one. APs are split among the tiers proportionally to their length.
+	 */
+	void PlaceStadium(){
+		double total_length (0);
+		for(int t = 0; t < config.tiers; ++t) total_length += 2 * M_PI * (config.pitch_radius + t * config.ap_distance);
+		int placed (0);
+		for(int t = 0; t < config.tiers; ++t){
+			double radius (config.pitch_radius + t * config.ap_distance);
+			int tier_aps (t == config.tiers - 1 ? config.num_aps - placed :
+				(int) round(config.num_aps * 2 * M_PI * radius / total_length));
+			if(tier_aps > config.num_aps - placed) tier_aps = config.num_aps - placed;
+			for(int k = 0; k < tier_aps; ++k){
+				double angle (2 * M_PI * (k + 0.5 * (t % 2)) / tier_aps);
+				ap_x.push_back(radius * cos(angle));
+				ap_y.push_back(radius * sin(angle));
+				ap_z.push_back(t * config.tier_height);
+			}
+			placed += tier_aps;
+		}
+	}
+
+	/*
+	 * PlaceSta(): STA uniformly distributed within sta_distance of its AP (at 1 m at least). In the
+	 * enterprise topology STAs stand on the floor of their AP.
+	 */
+	void PlaceSta(int a, NodeRecord &sta){
+		double min_distance (config.sta_distance > 1 ? 1 : 0);
+		double distance (sqrt(random.Uniform(min_distance * min_distance, config.sta_distance * config.sta_distance)));
+		double angle (random.Uniform(0, 2 * M_PI));
+		sta.x = ap_x[a] + distance * cos(angle);
+		sta.y = ap_y[a] + distance * sin(angle);
+		sta.z = config.topology == TOPOLOGY_ENTERPRISE ?
+			floor(ap_z[a] / config.floor_height) * config.floor_height + GENERATOR_STA_HEIGHT : ap_z[a];
+	}
+
+	/*
+	 * AssignChannels(): primary channel of each WLAN according to the channel rule. The reuse rule is
+	 * greedy: each AP picks the channel with the lowest interference (sum of 1/d^2) from the APs
+	 * already assigned within reuse_distance.
+	 */
+	void AssignChannels(std::vector<int> &channels){
+
+		channels.assign(config.num_aps, 0);
+		if(config.channel_rule == CHANNEL_RULE_SINGLE) return;
+		if(config.channel_rule == CHANNEL_RULE_ROUND_ROBIN){
+			for(int a = 0; a < config.num_aps; ++a) channels[a] = a % config.num_channels;
+			return;
+		}
+		if(config.channel_rule == CHANNEL_RULE_RANDOM){
+			for(int a = 0; a < config.num_aps; ++a) channels[a] = random.Integer(config.num_channels);
+			return;
+		}
+
+		double reuse_distance (config.reuse_distance > 0 ? config.reuse_distance : 3 * config.ap_distance);
+		std::map<std::pair<long, long>, std::vector<int> > cells;
+		std::vector<double> interference (config.num_channels);
+		for(int a = 0; a < config.num_aps; ++a){
+			long cell_x ((long) floor(ap_x[a] / reuse_distance)), cell_y ((long) floor(ap_y[a] / reuse_distance));
+			interference.assign(config.num_channels, 0);
+			for(long i = cell_x - 1; i <= cell_x + 1; ++i){
+				for(long j = cell_y - 1; j <= cell_y + 1; ++j){
+					std::map<std::pair<long, long>, std::vector<int> >::const_iterator cell (cells.find(std::make_pair(i, j)));
+					if(cell == cells.end()) continue;
+					for(size_t k = 0; k < cell->second.size(); ++k){
+						int b (cell->second[k]);
+						double distance_2 ((ap_x[b] - ap_x[a]) * (ap_x[b] - ap_x[a]) + (ap_y[b] - ap_y[a]) * (ap_y[b] - ap_y[a])
+							+ (ap_z[b] - ap_z[a]) * (ap_z[b] - ap_z[a]));
+						if(distance_2 < reuse_distance * reuse_distance) interference[channels[b]] += 1 / (distance_2 + 1);
+					}
+				}
+			}
+			int best (0);
+			for(int c = 1; c < config.num_channels; ++c) if(interference[c] < interference[best]) best = c;
+			channels[a] = best;
+			cells[std::make_pair(cell_x, cell_y)].push_back(a);
+		}
+	}
+};
+
+/*
+ * GenerateScenario(): generates the node records of a spec
+ */
+void GenerateScenario(const char *spec, std::vector<NodeRecord> &node_records){
+	ScenarioGeneratorConfig config;
+	config.Parse(spec);
+	ScenarioGenerator generator (config);
+	generator.Generate(node_records);
+}
+
+/*
+ * WriteNodesFile(): writes node records as a nodes input file (with the spatial reuse columns
+ * only if the records enable spatial reuse)
+ */
+int WriteNodesFile(const char *filename, const std::vector<NodeRecord> &node_records){
+
+	FILE *file = fopen(filename, "w");
+	if(file == NULL) return FALSE;
+	int spatial_reuse (!node_records.empty() && node_records[0].spatial_reuse_enabled);
+	fprintf(file, "node_code;node_type;wlan_code;destination_id;x(m);y(m);z(m);primary_channel;"
+		"min_channel_allowed;max_channel_allowed;cw;cw_stage;tpc_min(dBm);tpc_default(dBm);tpc_max(dBm);"
+		"cca_min(dBm);cca_default(dBm);cca_max(dBm);tx_antenna_gain;rx_antenna_gain;channel_bonding_model;"
+		"modulation_default;central_freq (GHz);lambda;ieee_protocol;traffic_load(pkts/s)%s\n",
+		spatial_reuse ? ";bss_color;spatial_reuse_group;non_srg_obss_pd;srg_obss_pd" : "");
+	for(size_t n = 0; n < node_records.size(); ++n){
+		const NodeRecord &r = node_records[n];
+		fprintf(file, "%s;%d;%s;%d;%.3f;%.3f;%.3f;%d;%d;%d;%d;%d;%g;%g;%g;%d;%d;%d;%d;%d;%d;%d;%g;%g;%d;%g",
+			r.node_code, r.node_type, r.wlan_code, r.destination_id, r.x, r.y, r.z, r.primary_channel,
+			r.min_channel_allowed, r.max_channel_allowed, r.cw_min, r.cw_stage_max, r.tx_power_min_dbm,
+			r.tx_power_default_dbm, r.tx_power_max_dbm, r.sensitivity_min_dbm, r.sensitivity_default_dbm,
+			r.sensitivity_max_dbm, r.tx_gain_db, r.rx_gain_db, r.dcb_policy, r.modulation_default,
+			r.central_frequency_ghz, r.lambda, r.ieee_protocol, r.traffic_load);
+		if(spatial_reuse){
+			fprintf(file, ";%d;%d;%g;%g", r.bss_color, r.srg, r.non_srg_obss_pd_dbm, r.srg_obss_pd_dbm);
+		}
+		fprintf(file, "\n");
+	}
+	int failed (ferror(file));
+	fclose(file);
+	return !failed;
+}
+
+#endif
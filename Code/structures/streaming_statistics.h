@@ -0,0 +1,161 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the streaming statistics used to aggregate the results of several
+ *   simulations (e.g., seeds): Welford's running mean and variance and Student's t
+ *   confidence intervals. Nothing but the running moments is kept per metric.
+ */
+
+#include <math.h>
+
+#ifndef _AUX_STREAMING_STATISTICS_
+#define _AUX_STREAMING_STATISTICS_
+
+/*
+ * NormalQuantile(): inverse of the standard normal CDF (bisection over erfc, 1e-12 accuracy)
+ */
+double NormalQuantile(double probability){
+	double low (-40), high (40);
+	while(high - low > 1e-12){
+		double middle ((low + high) / 2);
+		if(0.5 * erfc(-middle / sqrt(2.0)) < probability) low = middle;
+		else high = middle;
+	}
+	return (low + high) / 2;
+}
+
+/*
+ * StudentTQuantile(): quantile of Student's t distribution
+ * Input arguments:
+ * - probability: cumulative probability (e.g., 0.975 for a two-sided 95% interval)
+ * - degrees_of_freedom: degrees of freedom (>= 1)
+ * Output:
+ * - quantile (exact for 1 and 2 degrees of freedom, Cornish-Fisher expansion otherwise)
+ */
+double StudentTQuantile(double probability, int degrees_of_freedom){
+
+	if(degrees_of_freedom == 1) return tan(M_PI * (probability - 0.5));
+	if(degrees_of_freedom == 2) return (2 * probability - 1) / sqrt(2 * probability * (1 - probability));
+
+	double z (NormalQuantile(probability));
+	double n (degrees_of_freedom);
+	double z3 (pow(z,3)), z5 (pow(z,5)), z7 (pow(z,7)), z9 (pow(z,9));
+	return z + (z3 + z) / (4 * n)
+		+ (5 * z5 + 16 * z3 + 3 * z) / (96 * pow(n,2))
+		+ (3 * z7 + 19 * z5 + 17 * z3 - 15 * z) / (384 * pow(n,3))
+		+ (79 * z9 + 776 * z7 + 1482 * z5 - 1920 * z3 - 945 * z) / (92160 * pow(n,4));
+}
+
+/*
+ * RunningStatistics: Welford's streaming mean and variance of a metric
+ */
+struct RunningStatistics
+{
+	long num_samples;	// Samples added
+	double mean;		// Running mean
+	double m2;			// Sum of squared deviations from the running mean
+
+	RunningStatistics() : num_samples(0), mean(0), m2(0) {}
+
+	/*
+	 * Add(): adds a sample (NaN samples are ignored)
+	 */
+	void Add(double value){
+		if(isnan(value)) return;
+		++num_samples;
+		double delta (value - mean);
+		mean += delta / num_samples;
+		m2 += delta * (value - mean);
+	}
+
+	/*
+	 * Merge(): adds the samples summarized by another instance (Chan et al. pairwise update)
+	 */
+	void Merge(const RunningStatistics &other){
+		if(other.num_samples == 0) return;
+		long total_samples (num_samples + other.num_samples);
+		double delta (other.mean - mean);
+		mean += delta * other.num_samples / total_samples;
+		m2 += other.m2 + delta * delta * ((double) num_samples * other.num_samples / total_samples);
+		num_samples = total_samples;
+	}
+
+	/*
+	 * Variance(): unbiased sample variance (0 with less than two samples)
+	 */
+	double Variance() const {
+		return (num_samples > 1) ? m2 / (num_samples - 1) : 0;
+	}
+
+	/*
+	 * PopulationVariance(): variance normalized by the number of samples (0 without samples)
+	 */
+	double PopulationVariance() const {
+		return (num_samples > 0) ? m2 / num_samples : 0;
+	}
+
+	/*
+	 * HalfWidth(): half-width of the two-sided confidence interval of the mean
+	 * Input arguments:
+	 * - confidence: confidence level (e.g., 0.95)
+	 * Output:
+	 * - half-width (infinite with less than two samples)
+	 */
+	double HalfWidth(double confidence) const {
+		if(num_samples < 2) return INFINITY;
+		return StudentTQuantile(1 - (1 - confidence) / 2, num_samples - 1) * sqrt(Variance() / num_samples);
+	}
+
+	/*
+	 * IsPrecise(): TRUE if the relative half-width is below the target (a zero mean only requires a zero half-width)
+	 */
+	int IsPrecise(double confidence, double relative_half_width) const {
+		double half_width (HalfWidth(confidence));
+		if(mean == 0) return half_width == 0;
+		return half_width <= relative_half_width * fabs(mean);
+	}
+};
+
+#endif
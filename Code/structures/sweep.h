@@ -0,0 +1,208 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the parameter sweeps: a sweep file lists parameters, the nodes they apply to
+ *   and their values. Sweep points (cartesian product or listed element-wise) are applied as deltas
+ *   on the scenario loaded once by Komondor, each one being simulated in a forked process.
+ *
+ *   Sweep file (';' separated, first line is a header):
+ *     parameter;target;values
+ *     tx_power;AP_A;10, 15, 20		(target: node code, WLAN code or '*' for all the nodes)
+ *     cca;*;-82, -72, -62
+ *     seed;*;1, 2, 3
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "../list_of_macros.h"
+#include "csv_file.h"
+
+#ifndef _AUX_SWEEP_
+#define _AUX_SWEEP_
+
+/*
+ * SweepParameter: parameter swept on some nodes
+ */
+struct SweepParameter
+{
+	int parameter;				// SWEEP_PARAMETER_XXX
+	std::string name;			// Name in the sweep file
+	std::string target;			// Node code, WLAN code or SWEEP_TARGET_ALL
+	std::vector<double> values;
+};
+
+/*
+ * SweepConfig: sweep options entered per console and sweep file
+ */
+struct SweepConfig
+{
+	std::string filename;		// Sweep file (empty: no sweep)
+	int design;					// SWEEP_DESIGN_CARTESIAN or SWEEP_DESIGN_LISTED
+	int num_jobs;				// Sweep points simulated concurrently (0: one per core)
+	std::vector<SweepParameter> parameters;
+
+	SweepConfig() : design(SWEEP_DESIGN_CARTESIAN), num_jobs(0) {}
+
+	/*
+	 * ParseArgument(): parses a sweep console argument
+	 * Input arguments:
+	 * - argument: console argument. Accepted options:
+	 *   --sweep=<file>							sweep file (see above)
+	 *   --sweep_design=<cartesian|listed>		every combination of values, or the k-th value of every parameter
+	 *   --sweep_jobs=<N>						points simulated concurrently (default: one per core)
+	 * Output:
+	 * - TRUE if the argument is a sweep option, FALSE otherwise
+	 */
+	int ParseArgument(const char *argument){
+
+		if(strncmp(argument, "--sweep=", 8) == 0){
+			filename = std::string(argument + 8);
+
+		} else if(strcmp(argument, "--sweep_design=cartesian") == 0){
+			design = SWEEP_DESIGN_CARTESIAN;
+
+		} else if(strcmp(argument, "--sweep_design=listed") == 0){
+			design = SWEEP_DESIGN_LISTED;
+
+		} else if(strncmp(argument, "--sweep_jobs=", 13) == 0){
+			num_jobs = atoi(argument + 13);
+
+		} else {
+			return FALSE;
+		}
+		return TRUE;
+	}
+
+	/*
+	 * Load(): reads the sweep file
+	 */
+	void Load(){
+
+		CsvFile sweep_file;
+		sweep_file.Load(filename.c_str());
+		parameters.resize(sweep_file.NumRows());
+		for(int row = 0; row < sweep_file.NumRows(); ++row){
+			SweepParameter &parameter = parameters[row];
+			parameter.name = sweep_file.GetString(row, IX_SWEEP_PARAMETER, "parameter");
+			parameter.target = sweep_file.GetString(row, IX_SWEEP_TARGET, "target");
+			sweep_file.GetList(row, IX_SWEEP_VALUES, "values", parameter.values);
+			if(parameter.name == "tx_power") parameter.parameter = SWEEP_PARAMETER_TX_POWER;
+			else if(parameter.name == "cca") parameter.parameter = SWEEP_PARAMETER_CCA;
+			else if(parameter.name == "traffic_load") parameter.parameter = SWEEP_PARAMETER_TRAFFIC_LOAD;
+			else if(parameter.name == "primary_channel") parameter.parameter = SWEEP_PARAMETER_PRIMARY_CHANNEL;
+			else if(parameter.name == "cw") parameter.parameter = SWEEP_PARAMETER_CW;
+			else if(parameter.name == "seed") parameter.parameter = SWEEP_PARAMETER_SEED;
+			else sweep_file.Error(row, IX_SWEEP_PARAMETER, "parameter",
+				"is unknown (tx_power, cca, traffic_load, primary_channel, cw or seed)");
+			if(design == SWEEP_DESIGN_LISTED && parameter.values.size() != parameters[0].values.size()){
+				sweep_file.Error(row, IX_SWEEP_VALUES, "values", "must have as many values as the first parameter (listed design)");
+			}
+		}
+		if(parameters.empty()){
+			printf("ERROR: sweep file '%s' has no parameters\n", filename.c_str());
+			exit(-1);
+		}
+	}
+
+	/*
+	 * NumPoints(): number of sweep points
+	 */
+	int NumPoints() const {
+		if(design == SWEEP_DESIGN_LISTED) return parameters[0].values.size();
+		int num_points (1);
+		for(size_t p = 0; p < parameters.size(); ++p) num_points *= parameters[p].values.size();
+		return num_points;
+	}
+
+	/*
+	 * PointValues(): value of each parameter at a sweep point (cartesian design: the last parameter
+	 * varies fastest)
+	 */
+	void PointValues(int point, std::vector<double> &values) const {
+		values.resize(parameters.size());
+		for(int p = parameters.size() - 1; p >= 0; --p){
+			if(design == SWEEP_DESIGN_LISTED){
+				values[p] = parameters[p].values[point];
+			} else {
+				int num_values (parameters[p].values.size());
+				values[p] = parameters[p].values[point % num_values];
+				point /= num_values;
+			}
+		}
+	}
+
+	/*
+	 * WriteIndex(): writes the values of every sweep point, so that the script output lines
+	 * (simulation code "<code>_p<point>") can be matched to them
+	 */
+	void WriteIndex(const std::string &index_filename, const std::string &simulation_code) const {
+		FILE *file = fopen(index_filename.c_str(), "w");
+		if(file == NULL){
+			printf("ERROR: sweep index '%s' could not be written\n", index_filename.c_str());
+			exit(-1);
+		}
+		fprintf(file, "point;simulation_code");
+		for(size_t p = 0; p < parameters.size(); ++p){
+			fprintf(file, ";%s@%s", parameters[p].name.c_str(), parameters[p].target.c_str());
+		}
+		fprintf(file, "\n");
+		std::vector<double> values;
+		for(int point = 0; point < NumPoints(); ++point){
+			PointValues(point, values);
+			fprintf(file, "%d;%s_p%d", point, simulation_code.c_str(), point);
+			for(size_t p = 0; p < values.size(); ++p) fprintf(file, ";%g", values[p]);
+			fprintf(file, "\n");
+		}
+		fclose(file);
+	}
+};
+
+SweepConfig sweep_config;
+
+#endif
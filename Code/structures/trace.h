@@ -0,0 +1,847 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file defines the binary event trace written instead of text logs when
+ *   save_logs == SAVE_LOG_BINARY_TRACE. Each LOGS call site is described once (LogSite) and
+ *   defined once per file. Node log lines are written with a fixed header (LOG code id,
+ *   timestamp, node id, state) followed by the typed arguments, so that 'trace_decoder'
+ *   regenerates exactly the text that fprintf would have written.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../list_of_macros.h"
+#include "log_sink.h"
+#include "node_order.h"
+
+#ifndef _AUX_TRACE_
+#define _AUX_TRACE_
+
+/*
+ * TraceConversion: one printf conversion specification found in a format string
+ */
+struct TraceConversion
+{
+	int start;				// Offset of the '%' character in the format string
+	int length;				// Length of the specification ('%' and conversion character included)
+	int arg_type;			// Type of the argument consumed (TRACE_ARG_XXX)
+	char length_modifier;	// 0, 'h', 'H' (hh), 'l', 'L' (ll), 'q' (L), 'j', 'z' or 't'
+	int num_star_args;		// Number of '*' width/precision arguments (int) preceding the value
+};
+
+/*
+ * NextTraceConversion(): finds the next conversion specification of a printf format string.
+ * Shared by the trace writer and the decoder so that both consume arguments identically.
+ * Input arguments:
+ * - format: printf format string
+ * - from: offset where the search starts
+ * - conversion: conversion found (output)
+ * Output:
+ * - TRUE if a conversion was found, FALSE if the end of the format string was reached
+ */
+int NextTraceConversion(const char *format, int from, TraceConversion *conversion){
+
+	const char *p = strchr(format + from, '%');
+	if(p == NULL) return FALSE;
+
+	conversion->start = (int) (p - format);
+	conversion->length_modifier = 0;
+	conversion->num_star_args = 0;
+	++p;
+
+	// Flags, width and precision
+	while(*p != '\0' && strchr("-+ #0123456789.*'", *p) != NULL){
+		if(*p == '*') ++conversion->num_star_args;
+		++p;
+	}
+
+	// Length modifier
+	switch(*p){
+		case 'h':
+			conversion->length_modifier = (p[1] == 'h') ? 'H' : 'h';
+			p += (p[1] == 'h') ? 2 : 1;
+			break;
+		case 'l':
+			conversion->length_modifier = (p[1] == 'l') ? 'L' : 'l';
+			p += (p[1] == 'l') ? 2 : 1;
+			break;
+		case 'L':
+			conversion->length_modifier = 'q';
+			++p;
+			break;
+		case 'j': case 'z': case 't':
+			conversion->length_modifier = *p;
+			++p;
+			break;
+	}
+
+	switch(*p){
+		case 'd': case 'i': case 'c':
+			conversion->arg_type = TRACE_ARG_INT;
+			break;
+		case 'u': case 'x': case 'X': case 'o':
+			conversion->arg_type = TRACE_ARG_UINT;
+			break;
+		case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+			conversion->arg_type = TRACE_ARG_DOUBLE;
+			break;
+		case 's':
+			conversion->arg_type = TRACE_ARG_STRING;
+			break;
+		case 'p':
+			conversion->arg_type = TRACE_ARG_POINTER;
+			break;
+		case '%':
+			conversion->arg_type = TRACE_ARG_NONE;
+			break;
+		default:
+			printf("ERROR: unsupported conversion '%c' in trace format \"%s\"\n", *p, format);
+			exit(-1);
+	}
+
+	conversion->length = (int) (p - format) - conversion->start + 1;
+	return TRUE;
+}
+
+/*
+ * AppendTraceBytes(): appends raw bytes to an encoded record
+ */
+void AppendTraceBytes(std::vector<char> &output, const void *bytes, size_t num_bytes){
+	const char *p = (const char *) bytes;
+	output.insert(output.end(), p, p + num_bytes);
+}
+
+/*
+ * EncodeTraceArguments(): appends the typed arguments of a printf-like call to an encoded record
+ * Input arguments:
+ * - format: printf format string
+ * - args: arguments of the call
+ * - output: encoded record
+ */
+void EncodeTraceArguments(const char *format, va_list args, std::vector<char> &output){
+
+	TraceConversion conversion;
+	int from = 0;
+	while(NextTraceConversion(format, from, &conversion)){
+		from = conversion.start + conversion.length;
+		for(int i = 0; i < conversion.num_star_args; ++i){
+			int32_t star_arg = va_arg(args, int);
+			AppendTraceBytes(output, &star_arg, sizeof(star_arg));
+		}
+		switch(conversion.arg_type){
+			case TRACE_ARG_INT:{
+				int64_t value;
+				switch(conversion.length_modifier){
+					case 'l': value = va_arg(args, long); break;
+					case 'L': value = va_arg(args, long long); break;
+					case 'j': value = va_arg(args, intmax_t); break;
+					case 'z': value = va_arg(args, size_t); break;
+					case 't': value = va_arg(args, ptrdiff_t); break;
+					default: value = va_arg(args, int); break;
+				}
+				// Node ids ("N%d") of renumbered nodes are written as the original ones
+				if(conversion.length == 2 && conversion.start > 0 && format[conversion.start - 1] == 'N'){
+					value = OriginalNodeId((int) value);
+				}
+				AppendTraceBytes(output, &value, sizeof(value));
+				break;
+			}
+			case TRACE_ARG_UINT:{
+				uint64_t value;
+				switch(conversion.length_modifier){
+					case 'l': value = va_arg(args, unsigned long); break;
+					case 'L': value = va_arg(args, unsigned long long); break;
+					case 'j': value = va_arg(args, uintmax_t); break;
+					case 'z': value = va_arg(args, size_t); break;
+					case 't': value = va_arg(args, ptrdiff_t); break;
+					default: value = va_arg(args, unsigned int); break;
+				}
+				AppendTraceBytes(output, &value, sizeof(value));
+				break;
+			}
+			case TRACE_ARG_DOUBLE:{
+				double value = (conversion.length_modifier == 'q') ?
+					(double) va_arg(args, long double) : va_arg(args, double);
+				AppendTraceBytes(output, &value, sizeof(value));
+				break;
+			}
+			case TRACE_ARG_STRING:{
+				const char *value = va_arg(args, const char *);
+				if(value == NULL) value = "(null)";
+				uint32_t value_length = (uint32_t) strlen(value);
+				AppendTraceBytes(output, &value_length, sizeof(value_length));
+				AppendTraceBytes(output, value, value_length);
+				break;
+			}
+			case TRACE_ARG_POINTER:{
+				uint64_t value = (uint64_t) (uintptr_t) va_arg(args, void *);
+				AppendTraceBytes(output, &value, sizeof(value));
+				break;
+			}
+		}
+	}
+}
+
+/*
+ * DecodeTraceConversion(): formats one conversion specification with its encoded argument
+ * Input arguments:
+ * - reader: source of the encoded arguments (must provide Read(void *bytes, size_t num_bytes))
+ * - format: printf format string
+ * - conversion: conversion to be formatted
+ * - output: text where the result is appended
+ */
+template <typename Reader>
+void DecodeTraceConversion(Reader &reader, const char *format, const TraceConversion &conversion,
+	std::string &output){
+
+	int star_args[2] = {0, 0};
+	for(int i = 0; i < conversion.num_star_args; ++i){
+		int32_t star_arg;
+		reader.Read(&star_arg, sizeof(star_arg));
+		if(i < 2) star_args[i] = star_arg;
+	}
+
+	if(conversion.arg_type == TRACE_ARG_NONE){
+		output += '%';
+		return;
+	}
+
+	std::string spec(format + conversion.start, conversion.length);
+	std::string value_string;
+	int64_t int_value = 0;
+	uint64_t uint_value = 0;
+	double double_value = 0;
+	switch(conversion.arg_type){
+		case TRACE_ARG_INT: reader.Read(&int_value, sizeof(int_value)); break;
+		case TRACE_ARG_UINT: case TRACE_ARG_POINTER: reader.Read(&uint_value, sizeof(uint_value)); break;
+		case TRACE_ARG_DOUBLE: reader.Read(&double_value, sizeof(double_value)); break;
+		case TRACE_ARG_STRING:{
+			uint32_t value_length;
+			reader.Read(&value_length, sizeof(value_length));
+			value_string.resize(value_length);
+			if(value_length > 0) reader.Read(&value_string[0], value_length);
+			break;
+		}
+	}
+
+	// Format with the same C type that the original call passed to printf
+	#define TRACE_SNPRINTF(buffer, size, value) \
+		(conversion.num_star_args == 0 ? snprintf(buffer, size, spec.c_str(), value) : \
+		conversion.num_star_args == 1 ? snprintf(buffer, size, spec.c_str(), star_args[0], value) : \
+		snprintf(buffer, size, spec.c_str(), star_args[0], star_args[1], value))
+
+	#define TRACE_FORMAT_VALUE(value) { \
+		char buffer[CHAR_BUFFER_SIZE]; \
+		int length = TRACE_SNPRINTF(buffer, sizeof(buffer), value); \
+		if(length >= (int) sizeof(buffer)){ \
+			std::vector<char> long_buffer(length + 1); \
+			TRACE_SNPRINTF(&long_buffer[0], long_buffer.size(), value); \
+			output.append(&long_buffer[0], length); \
+		} else if(length > 0) { \
+			output.append(buffer, length); \
+		} \
+	}
+
+	switch(conversion.arg_type){
+		case TRACE_ARG_INT:
+			switch(conversion.length_modifier){
+				case 'l': TRACE_FORMAT_VALUE((long) int_value); break;
+				case 'L': TRACE_FORMAT_VALUE((long long) int_value); break;
+				case 'j': TRACE_FORMAT_VALUE((intmax_t) int_value); break;
+				case 'z': TRACE_FORMAT_VALUE((size_t) int_value); break;
+				case 't': TRACE_FORMAT_VALUE((ptrdiff_t) int_value); break;
+				default: TRACE_FORMAT_VALUE((int) int_value); break;
+			}
+			break;
+		case TRACE_ARG_UINT:
+			switch(conversion.length_modifier){
+				case 'l': TRACE_FORMAT_VALUE((unsigned long) uint_value); break;
+				case 'L': TRACE_FORMAT_VALUE((unsigned long long) uint_value); break;
+				case 'j': TRACE_FORMAT_VALUE((uintmax_t) uint_value); break;
+				case 'z': TRACE_FORMAT_VALUE((size_t) uint_value); break;
+				case 't': TRACE_FORMAT_VALUE((ptrdiff_t) uint_value); break;
+				default: TRACE_FORMAT_VALUE((unsigned int) uint_value); break;
+			}
+			break;
+		case TRACE_ARG_DOUBLE:
+			if(conversion.length_modifier == 'q'){
+				TRACE_FORMAT_VALUE((long double) double_value);
+			} else {
+				TRACE_FORMAT_VALUE(double_value);
+			}
+			break;
+		case TRACE_ARG_STRING:
+			TRACE_FORMAT_VALUE(value_string.c_str());
+			break;
+		case TRACE_ARG_POINTER:
+			TRACE_FORMAT_VALUE((void *) (uintptr_t) uint_value);
+			break;
+	}
+
+	#undef TRACE_FORMAT_VALUE
+	#undef TRACE_SNPRINTF
+}
+
+/*
+ * DecodeTraceEvent(): regenerates the text of an event from its format and encoded arguments
+ * Input arguments:
+ * - reader: source of the encoded arguments (must provide Read(void *bytes, size_t num_bytes))
+ * - format: printf format string of the event
+ * - output: text where the result is appended
+ */
+template <typename Reader>
+void DecodeTraceEvent(Reader &reader, const char *format, std::string &output){
+	TraceConversion conversion;
+	int from = 0;
+	while(NextTraceConversion(format, from, &conversion)){
+		output.append(format + from, conversion.start - from);
+		DecodeTraceConversion(reader, format, conversion, output);
+		from = conversion.start + conversion.length;
+	}
+	output.append(format + from);
+}
+
+/*
+ * TraceBufferReader: reads encoded arguments from memory
+ */
+struct TraceBufferReader
+{
+	const char *position;
+	void Read(void *bytes, size_t num_bytes){
+		memcpy(bytes, position, num_bytes);
+		position += num_bytes;
+	}
+};
+
+/*
+ * LogSite: format descriptor of a LOGS call site. It is built the first time the line is written
+ * (static local of the LOGS macro), so the format string is parsed once instead of on every call.
+ */
+struct LogSite
+{
+	const char *format;						// Format string of the call site
+	uint32_t site_id;						// Identifier of the site (index in log_sites)
+	std::vector<TraceConversion> conversions;	// Conversion specifications of the format string
+	std::vector<int> arg_types;				// Type of each argument (TRACE_ARG_XXX, TRACE_ARG_STAR for '*')
+	uint64_t node_id_args;					// Bit i set: argument i is a node id ("N%d")
+	int log_header;							// TRUE if the line starts with TRACE_LOG_HEADER (time, node, state, code, level)
+
+	explicit LogSite(const char *site_format);
+};
+
+std::vector<LogSite*> log_sites;	// Sites built so far (indexed by site_id)
+
+LogSite :: LogSite(const char *site_format) : format(site_format), node_id_args(0),
+	log_header(strncmp(site_format, TRACE_LOG_HEADER, strlen(TRACE_LOG_HEADER)) == 0) {
+	TraceConversion conversion;
+	int from = 0;
+	while(NextTraceConversion(format, from, &conversion)){
+		from = conversion.start + conversion.length;
+		conversions.push_back(conversion);
+		for(int i = 0; i < conversion.num_star_args; ++i) arg_types.push_back(TRACE_ARG_STAR);
+		if(conversion.arg_type == TRACE_ARG_NONE) continue;
+		if(conversion.arg_type == TRACE_ARG_INT && conversion.length == 2 && conversion.start > 0
+			&& format[conversion.start - 1] == 'N' && arg_types.size() < 64){
+			node_id_args |= 1ull << arg_types.size();
+		}
+		arg_types.push_back(conversion.arg_type);
+	}
+	site_id = (uint32_t) log_sites.size();
+	log_sites.push_back(this);
+}
+
+/*
+ * LogSiteOf(): returns the site of a format string that is not written through the LOGS macro
+ * (LogPrintf() calls when printing setup or statistics), building it on first use
+ * Input arguments:
+ * - format: printf format string (string literal, so that its address identifies it)
+ */
+LogSite *LogSiteOf(const char *format){
+	static std::map<const char*, LogSite*> sites_by_format;
+	std::map<const char*, LogSite*>::iterator it = sites_by_format.find(format);
+	if(it != sites_by_format.end()) return it->second;
+	LogSite *site = new LogSite(format);
+	sites_by_format[format] = site;
+	return site;
+}
+
+/*
+ * LogSlotOf(): stores an argument of a LOGS call in a 64-bit slot, according to its C++ type
+ * (integers as int64, floating point values as double, strings and pointers by address).
+ * No format parsing is involved: the site descriptor tells later how to read each slot.
+ */
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, uint64_t>::type
+LogSlotOf(const T &value){
+	return (uint64_t) (int64_t) value;
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, uint64_t>::type LogSlotOf(const T &value){
+	double double_value = (double) value;
+	uint64_t slot;
+	memcpy(&slot, &double_value, sizeof(slot));
+	return slot;
+}
+
+template <typename T>
+uint64_t LogSlotOf(T *const &value){
+	return (uint64_t) (uintptr_t) value;
+}
+
+template <typename T, size_t N>
+uint64_t LogSlotOf(T (&value)[N]){
+	return (uint64_t) (uintptr_t) value;
+}
+
+/*
+ * ReadLogSlots(): stores the arguments of a printf-like call in slots (see LogSlotOf())
+ * Input arguments:
+ * - site: site of the format string
+ * - args: arguments of the call
+ * - slots: one per argument of the site (output)
+ */
+void ReadLogSlots(const LogSite &site, va_list args, uint64_t *slots){
+	size_t i = 0;
+	for(size_t c = 0; c < site.conversions.size(); ++c){
+		const TraceConversion &conversion = site.conversions[c];
+		for(int s = 0; s < conversion.num_star_args; ++s) slots[i++] = LogSlotOf(va_arg(args, int));
+		switch(conversion.arg_type){
+			case TRACE_ARG_INT:
+			case TRACE_ARG_UINT:{
+				switch(conversion.length_modifier){
+					case 'l': slots[i++] = LogSlotOf(va_arg(args, long)); break;
+					case 'L': slots[i++] = LogSlotOf(va_arg(args, long long)); break;
+					case 'j': slots[i++] = LogSlotOf(va_arg(args, intmax_t)); break;
+					case 'z': slots[i++] = LogSlotOf(va_arg(args, size_t)); break;
+					case 't': slots[i++] = LogSlotOf(va_arg(args, ptrdiff_t)); break;
+					default:
+						slots[i++] = (conversion.arg_type == TRACE_ARG_INT) ?
+							LogSlotOf(va_arg(args, int)) : LogSlotOf(va_arg(args, unsigned int));
+						break;
+				}
+				break;
+			}
+			case TRACE_ARG_DOUBLE:{
+				slots[i++] = (conversion.length_modifier == 'q') ?
+					LogSlotOf(va_arg(args, long double)) : LogSlotOf(va_arg(args, double));
+				break;
+			}
+			case TRACE_ARG_STRING:{
+				slots[i++] = LogSlotOf(va_arg(args, const char *));
+				break;
+			}
+			case TRACE_ARG_POINTER:{
+				slots[i++] = LogSlotOf(va_arg(args, void *));
+				break;
+			}
+		}
+	}
+}
+
+/*
+ * AppendLogSlots(): appends the arguments stored in slots to an encoded record, with the same
+ * encoding as EncodeTraceArguments() (so that DecodeTraceEvent() reads them back)
+ * Input arguments:
+ * - output: encoded record (must provide Put(const void *bytes, size_t num_bytes))
+ * - site: site of the event
+ * - slots: arguments of the event (see LogSlotOf())
+ * - first_arg: index of the argument stored in slots[0] (the preceding ones are already encoded)
+ */
+template <typename Output>
+void AppendLogSlots(Output &output, const LogSite &site, const uint64_t *slots, size_t first_arg = 0){
+	for(size_t i = first_arg; i < site.arg_types.size(); ++i){
+		uint64_t slot = slots[i - first_arg];
+		switch(site.arg_types[i]){
+			case TRACE_ARG_STAR:{
+				int32_t star_arg = (int32_t) (int64_t) slot;
+				output.Put(&star_arg, sizeof(star_arg));
+				break;
+			}
+			case TRACE_ARG_INT:{
+				int64_t value = (int64_t) slot;
+				if((site.node_id_args >> i) & 1) value = OriginalNodeId((int) value);
+				output.Put(&value, sizeof(value));
+				break;
+			}
+			case TRACE_ARG_STRING:{
+				const char *value = (const char *) (uintptr_t) slot;
+				if(value == NULL) value = "(null)";
+				uint32_t value_length = (uint32_t) strlen(value);
+				output.Put(&value_length, sizeof(value_length));
+				output.Put(value, value_length);
+				break;
+			}
+			default:{	// TRACE_ARG_UINT, TRACE_ARG_DOUBLE and TRACE_ARG_POINTER are stored as they are
+				output.Put(&slot, sizeof(slot));
+				break;
+			}
+		}
+	}
+}
+
+/*
+ * TraceVectorOutput: appends encoded bytes to a vector (see AppendLogSlots())
+ */
+struct TraceVectorOutput
+{
+	std::vector<char> &bytes;
+	explicit TraceVectorOutput(std::vector<char> &output) : bytes(output) {}
+	void Put(const void *data, size_t num_bytes){
+		const char *p = (const char *) data;
+		bytes.insert(bytes.end(), p, p + num_bytes);
+	}
+};
+
+/*
+ * FormatWithOriginalNodeIds(): formats a printf-like call writing the original ids of renumbered nodes
+ * (the arguments are encoded and decoded back, see EncodeTraceArguments())
+ * Input arguments:
+ * - format: printf format string
+ * - args: arguments of the call
+ * - output: text where the result is appended
+ */
+void FormatWithOriginalNodeIds(const char *format, va_list args, std::string &output){
+	std::vector<char> encoded;
+	EncodeTraceArguments(format, args, encoded);
+	TraceBufferReader reader;
+	reader.position = encoded.empty() ? NULL : &encoded[0];
+	DecodeTraceEvent(reader, format, output);
+}
+
+/*
+ * TraceCodeId(): identifier of a LOG_Xnn code string (e.g., "D07" -> 307, TRACE_NO_CODE if it is not a code)
+ */
+uint16_t TraceCodeId(const char *code){
+	if(code == NULL || code[0] < 'A' || code[0] > 'Z' || code[1] < '0' || code[1] > '9'
+		|| code[2] < '0' || code[2] > '9' || code[3] != '\0'){
+		return TRACE_NO_CODE;
+	}
+	return (uint16_t) ((code[0] - 'A') * 100 + (code[1] - '0') * 10 + (code[2] - '0'));
+}
+
+/*
+ * TraceWriter: buffered writer of binary trace records (one per node, appended to the log sink).
+ * Node log lines starting with TRACE_LOG_HEADER are written with a fixed header (TRACE_RECORD_LOG);
+ * any other line is written as a TRACE_RECORD_EVENT. Each call site is defined once per trace.
+ */
+struct TraceWriter
+{
+	int owner_id;						// Owner of the trace in the log sink (-1: trace not open)
+	std::vector<char> buffer;			// Records pending to be written
+	std::vector<char> site_defined;		// TRUE for the sites already defined in the trace (indexed by site_id)
+	std::vector<uint16_t> site_codes;	// LOG code id of each defined site (indexed by site_id)
+
+	TraceWriter() : owner_id(-1) {}
+
+	/*
+	 * Open(): starts the trace of a log sink owner by writing its signature
+	 * Input arguments:
+	 * - sink_owner_id: owner id of the component in the log sink
+	 */
+	void Open(int sink_owner_id){
+		owner_id = sink_owner_id;
+		buffer.clear();
+		buffer.reserve(TRACE_BUFFER_SIZE);
+		site_defined.clear();
+		site_codes.clear();
+		PutBytes(TRACE_MAGIC, TRACE_MAGIC_SIZE);
+	}
+
+	void Flush(){
+		if(owner_id >= 0 && !buffer.empty()) log_sink.Append(owner_id, &buffer[0], buffer.size());
+		buffer.clear();
+	}
+
+	void Close(){
+		if(owner_id < 0) return;
+		Flush();
+		owner_id = -1;
+	}
+
+	void PutBytes(const void *bytes, size_t num_bytes){
+		const char *p = (const char *) bytes;
+		buffer.insert(buffer.end(), p, p + num_bytes);
+	}
+
+	void Put(const void *bytes, size_t num_bytes){
+		PutBytes(bytes, num_bytes);
+	}
+
+	void PutUint32(uint32_t value){
+		PutBytes(&value, sizeof(value));
+	}
+
+	void PutString(const char *value){
+		uint32_t length = (uint32_t) strlen(value);
+		PutUint32(length);
+		PutBytes(value, length);
+	}
+
+	/*
+	 * DefineSite(): defines a call site in the trace on first use. The LOG code and level of a line
+	 * are compile-time constants of its site (see log_filter.h), so they are written only here.
+	 * Input arguments:
+	 * - site: call site
+	 * - code: LOG_Xnn code of the site ("" if none)
+	 * - level: LOG_LVLx string of the site ("" if none)
+	 */
+	void DefineSite(const LogSite &site, const char *code, const char *level){
+		if(site.site_id >= site_defined.size()){
+			site_defined.resize(site.site_id + 1, FALSE);
+			site_codes.resize(site.site_id + 1, TRACE_NO_CODE);
+		}
+		site_defined[site.site_id] = TRUE;
+		site_codes[site.site_id] = TraceCodeId(code);
+		buffer.push_back(TRACE_RECORD_FORMAT);
+		PutUint32(site.site_id);
+		PutString(site.format);
+		PutString(code);
+		PutString(level);
+	}
+
+	int SiteDefined(const LogSite &site) const {
+		return site.site_id < site_defined.size() && site_defined[site.site_id];
+	}
+
+	/*
+	 * Write(): appends the record of a LOGS call
+	 * Input arguments:
+	 * - site: call site
+	 * - args: arguments of the call
+	 */
+	template <typename... Args>
+	void Write(const LogSite &site, const Args&... args){
+		WriteRecord(site, args...);
+		if(buffer.size() >= TRACE_BUFFER_SIZE) Flush();
+	}
+
+	/*
+	 * WriteEvent(): appends a TRACE_RECORD_EVENT with every argument
+	 */
+	template <typename... Args>
+	void WriteEvent(const LogSite &site, const Args&... args){
+		if(!SiteDefined(site)) DefineSite(site, "", "");
+		uint64_t slots[sizeof...(Args) + 1] = {LogSlotOf(args)...};
+		buffer.push_back(TRACE_RECORD_EVENT);
+		PutUint32(site.site_id);
+		AppendLogSlots(*this, site, slots);
+	}
+
+	/*
+	 * WriteRecord(): appends a TRACE_RECORD_LOG (fixed header, then the remaining arguments)
+	 * if the line starts with TRACE_LOG_HEADER, or a TRACE_RECORD_EVENT otherwise
+	 */
+	template <typename Time, typename Node, typename State, typename Code, typename Level, typename... Args>
+	void WriteRecord(const LogSite &site, const Time &sim_time, const Node &node_id, const State &node_state,
+		const Code &code, const Level &level, const Args&... args){
+
+		if(!site.log_header){
+			WriteEvent(site, sim_time, node_id, node_state, code, level, args...);
+			return;
+		}
+
+		// Header arguments are read through their slots, so that this also compiles for the other sites
+		uint64_t header_slots[5] = {LogSlotOf(sim_time), LogSlotOf(node_id), LogSlotOf(node_state),
+			LogSlotOf(code), LogSlotOf(level)};
+		if(!SiteDefined(site)) DefineSite(site, (const char *) (uintptr_t) header_slots[3],
+			(const char *) (uintptr_t) header_slots[4]);
+		uint16_t code_id = site_codes[site.site_id];
+		double timestamp;
+		memcpy(&timestamp, &header_slots[0], sizeof(timestamp));
+		uint32_t original_node_id = (uint32_t) OriginalNodeId((int) (int64_t) header_slots[1]);
+		int32_t state = (int32_t) (int64_t) header_slots[2];
+		buffer.push_back(TRACE_RECORD_LOG);
+		PutBytes(&code_id, sizeof(code_id));
+		PutUint32(site.site_id);
+		PutBytes(&timestamp, sizeof(timestamp));
+		PutUint32(original_node_id);
+		PutBytes(&state, sizeof(state));
+		uint64_t slots[sizeof...(Args) + 1] = {LogSlotOf(args)...};
+		AppendLogSlots(*this, site, slots, 5);
+	}
+
+	template <typename... Args>
+	void WriteRecord(const LogSite &site, const Args&... args){
+		WriteEvent(site, args...);
+	}
+
+	/*
+	 * Write(): appends the record of a LogPrintf() call made outside the LOGS macro (setup and statistics
+	 * output). The format string is looked up by address, as these lines have no static site.
+	 * Input arguments:
+	 * - format: printf format string
+	 * - args: arguments of the call
+	 */
+	void Write(const char *format, va_list args){
+		const LogSite &site = *LogSiteOf(format);
+		if(!SiteDefined(site)) DefineSite(site, "", "");
+		buffer.push_back(TRACE_RECORD_EVENT);
+		PutUint32(site.site_id);
+		EncodeTraceArguments(format, args, buffer);
+
+		if(buffer.size() >= TRACE_BUFFER_SIZE) Flush();
+	}
+};
+
+/*
+ * TraceFileReader: sequential reader of a trace file
+ */
+struct TraceFileReader
+{
+	FILE *file;
+	const char *filename;
+
+	void Read(void *bytes, size_t num_bytes){
+		if(fread(bytes, 1, num_bytes, file) != num_bytes){
+			printf("ERROR: trace file %s is truncated\n", filename);
+			exit(-1);
+		}
+	}
+
+	template <typename T> T Get(){
+		T value;
+		Read(&value, sizeof(value));
+		return value;
+	}
+
+	std::string GetString(){
+		uint32_t length = Get<uint32_t>();
+		std::string value(length, '\0');
+		if(length > 0) Read(&value[0], length);
+		return value;
+	}
+};
+
+/*
+ * DecodeTraceFile(): regenerates the text logs of a trace file
+ * Input arguments:
+ * - input_file: trace file (positioned at its signature)
+ * - filename: name of the trace file (for error messages)
+ * - output_file: file where the text logs are written
+ */
+void DecodeTraceFile(FILE *input_file, const char *filename, FILE *output_file){
+
+	TraceFileReader reader;
+	reader.file = input_file;
+	reader.filename = filename;
+
+	char magic[TRACE_MAGIC_SIZE];
+	reader.Read(magic, TRACE_MAGIC_SIZE);
+	if(memcmp(magic, TRACE_MAGIC, TRACE_MAGIC_SIZE) != 0){
+		printf("ERROR: %s is not a Komondor trace file (or was written by another version)\n", filename);
+		exit(-1);
+	}
+
+	struct SiteDefinition
+	{
+		int defined;
+		std::string format;
+		std::string code;
+		std::string level;
+	};
+	std::vector<SiteDefinition> sites;
+	size_t header_length = strlen(TRACE_LOG_HEADER);
+	std::string output;
+	int record_type;
+
+	while((record_type = fgetc(input_file)) != EOF){
+
+		if(record_type == TRACE_RECORD_FORMAT){
+
+			uint32_t site_id = reader.Get<uint32_t>();
+			if(site_id >= sites.size()) sites.resize(site_id + 1, SiteDefinition());
+			sites[site_id].defined = TRUE;
+			sites[site_id].format = reader.GetString();
+			sites[site_id].code = reader.GetString();
+			sites[site_id].level = reader.GetString();
+
+		} else if(record_type == TRACE_RECORD_EVENT || record_type == TRACE_RECORD_LOG){
+
+			if(record_type == TRACE_RECORD_LOG) reader.Get<uint16_t>();	// LOG code id (also in the site)
+			uint32_t site_id = reader.Get<uint32_t>();
+			if(site_id >= sites.size() || !sites[site_id].defined){
+				printf("ERROR: undefined site id %u in trace file %s\n", site_id, filename);
+				exit(-1);
+			}
+			const SiteDefinition &site = sites[site_id];
+			const char *format = site.format.c_str();
+
+			if(record_type == TRACE_RECORD_LOG){
+				double timestamp = reader.Get<double>();
+				uint32_t node_id = reader.Get<uint32_t>();
+				int32_t state = reader.Get<int32_t>();
+				char header[CHAR_BUFFER_SIZE];
+				int length = snprintf(header, sizeof(header), TRACE_LOG_HEADER, timestamp, (int) node_id, state,
+					site.code.c_str(), site.level.c_str());
+				output.append(header, (length < (int) sizeof(header)) ? length : sizeof(header) - 1);
+				format += header_length;
+			}
+			DecodeTraceEvent(reader, format, output);
+
+			if(output.size() >= TRACE_BUFFER_SIZE){
+				fwrite(output.data(), 1, output.size(), output_file);
+				output.clear();
+			}
+
+		} else {
+			printf("ERROR: unknown record type %d in trace file %s\n", record_type, filename);
+			exit(-1);
+		}
+	}
+
+	fwrite(output.data(), 1, output.size(), output_file);
+}
+
+#endif
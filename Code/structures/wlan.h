@@ -84,7 +84,7 @@ struct Wlan
 	 */
 	void PrintStaIds(){
 		for(int s = 0; s < num_stas; s++){
-			printf("%d  ", list_sta_id[s]);
+			printf("%d  ", OriginalNodeId(list_sta_id[s]));
 		}
 		printf("\n");
 	}
@@ -97,7 +97,7 @@ struct Wlan
 	void WriteStaIds(Logger logger){
 		if (logger.save_logs){
 			for(int s = 0; s < num_stas; s++){
-				fprintf(logger.file, "%d  ", list_sta_id[s]);
+				LogPrintf(logger, "%d  ", OriginalNodeId(list_sta_id[s]));
 			}
 		}
 	}
@@ -109,7 +109,7 @@ struct Wlan
 		printf("%s WLAN %s:\n", LOG_LVL3, wlan_code.c_str());
 		printf("%s wlan_id: %d\n", LOG_LVL4, wlan_id);
 		printf("%s num_stas: %d\n", LOG_LVL4, num_stas);
-		printf("%s ap_id: %d\n", LOG_LVL4, ap_id);
+		printf("%s ap_id: %d\n", LOG_LVL4, OriginalNodeId(ap_id));
 		printf("%s list of STAs IDs: ", LOG_LVL4);
 		PrintStaIds();
 	}
@@ -122,13 +122,13 @@ struct Wlan
 	 */
 	void WriteWlanInfo(Logger logger, std::string header_str){
 		if (logger.save_logs){
-			fprintf(logger.file, "%s WLAN %s:\n", header_str.c_str(), wlan_code.c_str());
-			fprintf(logger.file, "%s - wlan_id: %d\n", header_str.c_str(), wlan_id);
-			fprintf(logger.file, "%s - num_stas: %d\n", header_str.c_str(), num_stas);
-			fprintf(logger.file, "%s - ap_id: %d\n", header_str.c_str(), ap_id);
-			fprintf(logger.file, "%s - list of STAs IDs: ", header_str.c_str());
+			LogPrintf(logger, "%s WLAN %s:\n", header_str.c_str(), wlan_code.c_str());
+			LogPrintf(logger, "%s - wlan_id: %d\n", header_str.c_str(), wlan_id);
+			LogPrintf(logger, "%s - num_stas: %d\n", header_str.c_str(), num_stas);
+			LogPrintf(logger, "%s - ap_id: %d\n", header_str.c_str(), OriginalNodeId(ap_id));
+			LogPrintf(logger, "%s - list of STAs IDs: ", header_str.c_str());
 			WriteStaIds(logger);
-			fprintf(logger.file, "\n");
+			LogPrintf(logger, "\n");
 		}
 	}
 };
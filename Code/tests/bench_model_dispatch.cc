@@ -0,0 +1,180 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file benchmarks the per-notification model handlers of the Node: adjacent channel interference,
+ *   packet loss (capture effect), contention window and backoff. Each synthetic event runs the four of
+ *   them, first through the model-id entry points (one model switch per call, as the Node did before the
+ *   handlers were selected once in InitializeVariables()) and then through the selected handlers.
+ *   It reports events/s for every model combination. It is not run by tests/run_tests.
+ *
+ * - Usage: ./bench_model_dispatch [num_events]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <map>
+
+#include "../list_of_macros.h"
+#include "../structures/logger.h"
+#include "../structures/notification.h"
+#include "../structures/logical_nack.h"
+#include "../methods/auxiliary_methods.h"
+#include "../methods/power_channel_methods.h"
+#include "../methods/backoff_methods.h"
+#include "../methods/notification_methods.h"
+
+#define BENCH_NUM_CHANNELS		8		// Channels in the benchmarked system
+#define BENCH_NUM_NOTIFICATIONS	1024	// Synthetic notifications cycled through
+#define BENCH_DEFAULT_EVENTS	5000000	// Events per run (if not given)
+#define BENCH_CW_MIN			16		// Minimum contention window
+#define BENCH_CW_STAGE_MAX		5		// Maximum backoff stage
+
+// Models are re-read on every event, as the Node members are
+volatile int adjacent_channel_model;
+volatile int capture_effect_model;
+volatile int cw_adaptation;
+volatile int pdf_backoff;
+volatile int backoff_type;
+
+Notification notifications[BENCH_NUM_NOTIFICATIONS];
+double sink;	// Keeps the results alive
+
+/*
+ * CpuSeconds(): process CPU time [s]
+ */
+double CpuSeconds(){
+	struct timespec now;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/*
+ * RunPerCallSwitch(): events dispatched through the model-id entry points
+ */
+double RunPerCallSwitch(long num_events){
+	double total_power[BENCH_NUM_CHANNELS];
+	int cw_current (BENCH_CW_MIN), cw_stage_current (0);
+	srand(1);
+	double start (CpuSeconds());
+	for(long e = 0; e < num_events; ++e){
+		const Notification &notification (notifications[e % BENCH_NUM_NOTIFICATIONS]);
+		memset(total_power, 0, sizeof(total_power));
+		ApplyAdjacentChannelInterferenceModel(adjacent_channel_model, total_power, notification,
+			BENCH_NUM_CHANNELS, 1, 5, 1e-3, 0);
+		int loss_reason (IsPacketLost(0, notification, notification, total_power[0] * 1e6, 10, 1e-6,
+			total_power[0], 0, 0, capture_effect_model));
+		HandleContentionWindow(cw_adaptation, (loss_reason == PACKET_NOT_LOST) ? RESET_CW : INCREASE_CW,
+			&cw_current, BENCH_CW_MIN, &cw_stage_current, BENCH_CW_STAGE_MAX);
+		sink += ComputeBackoff(pdf_backoff, cw_current, backoff_type) + total_power[BENCH_NUM_CHANNELS - 1];
+	}
+	return num_events / (CpuSeconds() - start);
+}
+
+/*
+ * RunSelectedHandlers(): events dispatched through the handlers selected once
+ */
+double RunSelectedHandlers(long num_events){
+	double total_power[BENCH_NUM_CHANNELS];
+	int cw_current (BENCH_CW_MIN), cw_stage_current (0);
+	AdjacentChannelModelFunction volatile apply_adjacent_channel_model
+		(SelectAdjacentChannelInterferenceModel(adjacent_channel_model));
+	IsPacketLostFunction volatile is_packet_lost (SelectCaptureEffectModel(capture_effect_model));
+	HandleContentionWindowFunction volatile handle_contention_window
+		(SelectContentionWindowHandler(cw_adaptation));
+	ComputeBackoffFunction volatile compute_backoff (SelectComputeBackoff(pdf_backoff, backoff_type));
+	srand(1);
+	double start (CpuSeconds());
+	for(long e = 0; e < num_events; ++e){
+		const Notification &notification (notifications[e % BENCH_NUM_NOTIFICATIONS]);
+		memset(total_power, 0, sizeof(total_power));
+		apply_adjacent_channel_model(total_power, notification, BENCH_NUM_CHANNELS, 1e-3);
+		int loss_reason (is_packet_lost(0, notification, notification, total_power[0] * 1e6, 10, 1e-6,
+			total_power[0], 0, 0));
+		handle_contention_window((loss_reason == PACKET_NOT_LOST) ? RESET_CW : INCREASE_CW,
+			&cw_current, BENCH_CW_MIN, &cw_stage_current, BENCH_CW_STAGE_MAX);
+		sink += compute_backoff(cw_current) + total_power[BENCH_NUM_CHANNELS - 1];
+	}
+	return num_events / (CpuSeconds() - start);
+}
+
+int main(int argc, char *argv[]){
+
+	long num_events ((argc > 1) ? atol(argv[1]) : BENCH_DEFAULT_EVENTS);
+
+	srand(1);
+	for(int n = 0; n < BENCH_NUM_NOTIFICATIONS; ++n){
+		int width (1 << (rand() % 4));
+		notifications[n].left_channel = (rand() % (BENCH_NUM_CHANNELS / width)) * width;
+		notifications[n].right_channel = notifications[n].left_channel + width - 1;
+		notifications[n].packet_type = PACKET_TYPE_DATA;
+		notifications[n].destination_id = 1;
+		notifications[n].modulation_id = MODULATION_BPSK_1_2;
+	}
+
+	int adjacent_channel_models[3] = {ADJACENT_CHANNEL_NONE, ADJACENT_CHANNEL_BOUNDARY, ADJACENT_CHANNEL_EXTREME};
+	int capture_effect_models[2] = {CE_DEFAULT, CE_IEEE_802_11};
+
+	printf("adjacent;capture_effect;cw_adaptation;pdf_backoff;switch_events_per_s;handler_events_per_s;speedup\n");
+	for(int a = 0; a < 3; ++a)
+	for(int c = 0; c < 2; ++c)
+	for(int cw = 0; cw < 2; ++cw)
+	for(int pdf = PDF_DETERMINISTIC; pdf <= PDF_EXPONENTIAL; ++pdf){
+		adjacent_channel_model = adjacent_channel_models[a];
+		capture_effect_model = capture_effect_models[c];
+		cw_adaptation = cw;
+		pdf_backoff = pdf;
+		backoff_type = BACKOFF_SLOTTED;
+		double switch_rate (RunPerCallSwitch(num_events));
+		double handler_rate (RunSelectedHandlers(num_events));
+		printf("%d;%d;%d;%d;%.0f;%.0f;%.3f\n", adjacent_channel_model, capture_effect_model, cw_adaptation,
+			pdf_backoff, switch_rate, handler_rate, handler_rate / switch_rate);
+	}
+
+	return (sink == 0.123) ? 1 : 0;
+}
@@ -0,0 +1,527 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file checks GetTxChannelsByChannelBonding() (bitmask implementation) against the previous
+ *   implementation (kept below as ReferenceGetTxChannelsByChannelBonding()) for every system size
+ *   (1, 2, 4 and 8 channels), allowed range, primary channel, free-channel pattern, DCB policy and
+ *   several MCS tables. Outputs and the rand() stream must match. The only intended difference is
+ *   CB_PROB_UNIFORM_LOG2 without any free log2 range, where the previous code computed rand() % 0
+ *   (those cases must now report TX_NOT_POSSIBLE).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <map>
+
+#include "../list_of_macros.h"
+#include "../structures/logger.h"
+#include "../structures/notification.h"
+#include "../methods/auxiliary_methods.h"
+#include "../methods/power_channel_methods.h"
+#include "check.h"
+
+/*
+ * ReferenceGetTxChannelsByChannelBonding(): GetTxChannelsByChannelBonding() before the bitmask rewrite
+ **/
+void ReferenceGetTxChannelsByChannelBonding(int *channels_for_tx, int channel_bonding_model, int *channels_free,
+    int min_channel_allowed, int max_channel_allowed, int primary_channel, int **mcs_per_node,
+	int ix_mcs_per_node, int num_channels_system){
+
+	// Reset channels for transmitting
+	for(int c = min_channel_allowed; c <= max_channel_allowed; ++c){
+		channels_for_tx[c] = FALSE;
+	}
+
+	// Get left and right channels available (or free)
+	int left_free_ch (0);
+	int left_free_ch_is_set (0);	// True if left channel could be set true
+	int right_free_ch (0);
+
+	for(int c = min_channel_allowed; c <= max_channel_allowed; ++c){
+		if(channels_free[c]){
+			if(!left_free_ch_is_set){
+				left_free_ch = c;
+				left_free_ch_is_set = TRUE;
+			}
+			if(right_free_ch < c){
+				right_free_ch = c;
+			}
+		}
+	}
+
+	int num_free_ch (right_free_ch - left_free_ch + 1);
+	int num_available_ch (max_channel_allowed - min_channel_allowed + 1);
+	int log2_modulus;	// Auxiliary variable representing a modulus
+	int left_tx_ch;		// Left channel to TX
+	int right_tx_ch; 	// Right channel to TX
+
+	// SERGIO 18/09/2017:
+	// - Modify CB policies. Identify first of all the log2 channel ranges available
+	int all_channels_free_in_range ( TRUE );	// auxiliar variable for identifying free channel ranges
+
+	// Boolean array indicating if possible or not to transmit in 1, 2, 4 or 8 channels.
+	int possible_channel_ranges_ixs[4] = {FALSE, FALSE, FALSE, FALSE};
+
+	// Check primary
+	if(channels_free[primary_channel]) possible_channel_ranges_ixs[0] = TRUE;
+
+	// Check primary and 1 secondary
+	if(num_channels_system > 1){
+		if(primary_channel % 2 == 1){	// If primary is odd
+			if(channels_free[primary_channel - 1]) possible_channel_ranges_ixs[1] = TRUE;
+		} else{
+			if(channels_free[primary_channel + 1]) possible_channel_ranges_ixs[1] = TRUE;
+		}
+	}
+
+	// Check primary and 3 secondaries
+	if(num_channels_system > 3){
+		if(primary_channel > 3){	// primary in channel range 4-7
+			for(int c = 0; c < 4; ++c){
+				if(!channels_free[4 + c]) all_channels_free_in_range = FALSE;
+			}
+			if(all_channels_free_in_range) possible_channel_ranges_ixs[2] = TRUE;
+
+		} else { // primary in channel range 0-3
+			for(int c = 0; c < 4; ++c){
+				if(!channels_free[c]) all_channels_free_in_range = FALSE;
+			}
+			if(all_channels_free_in_range) possible_channel_ranges_ixs[2] = TRUE;
+		}
+	}
+
+
+	// Check primary and 7 secondaries (full system range)
+	if(num_channels_system > 7){
+		for(int c = 0; c < 8; ++c){
+			if(!channels_free[c]) all_channels_free_in_range = FALSE;
+		}
+		if(all_channels_free_in_range) possible_channel_ranges_ixs[3] = TRUE;
+	}
+
+	if(left_free_ch_is_set){
+
+		// Select channels to transmit depending on the sensed power
+		switch(channel_bonding_model){
+
+			// Only Primary Channel used if FREE
+			case CB_ONLY_PRIMARY:{
+
+				if(primary_channel >= left_free_ch && primary_channel <= right_free_ch){
+					channels_for_tx[primary_channel] = TRUE;
+				}
+				break;
+			}
+
+			// SCB: if all channels are FREE, transmit. If not, generate a new backoff.
+			case CB_SCB:{
+
+				int tx_possible = TRUE;
+				// If all channels are FREE, transmit. If not, generate a new backoff.
+				for(int c = min_channel_allowed; c <= max_channel_allowed; ++c){
+					if(!channels_free[c]){
+						tx_possible = FALSE;
+					}
+				}
+
+				if(tx_possible){
+					left_tx_ch = left_free_ch;
+					right_tx_ch = right_free_ch;
+					for(int c = min_channel_allowed; c <= max_channel_allowed; ++c){
+						channels_for_tx[c] = TRUE;
+					}
+				} else {
+					// TX not possible (code it with negative value)
+					channels_for_tx[0] = TX_NOT_POSSIBLE;
+				}
+				break;
+			}
+
+			// SCB log2:  if all channels accepted by the log2 mapping are FREE, transmit. If not, generate a new backoff.
+			case CB_SCB_LOG2:{
+
+				while(1){
+					// II. If num_free_ch is power of 2
+					if(fmod(log10(num_available_ch)/log10(2), 1) == 0){
+						log2_modulus = primary_channel % num_available_ch;
+						left_tx_ch = primary_channel - log2_modulus;
+						right_tx_ch = primary_channel + num_available_ch - log2_modulus - 1;
+						// Check if tx channels are inside the free ones
+						if((left_tx_ch >= min_channel_allowed) && (right_tx_ch <= max_channel_allowed)){
+							// TX channels found!
+							break;
+
+						} else {
+							--num_available_ch;
+						}
+
+					} else{
+						--num_available_ch;
+					}
+				}
+
+				// If all channels accepted by the log2 mapping, transmit. If not, generate a new backoff.
+				int tx_possible = TRUE;
+				for(int c = left_tx_ch; c <= right_tx_ch; ++c){
+					if(!channels_free[c]){
+						tx_possible = FALSE;
+					}
+				}
+				if(tx_possible){
+					for(int c = left_tx_ch; c <= right_tx_ch; ++c){
+						channels_for_tx[c] = TRUE;
+					}
+				} else {
+					// TX not possible (code it with negative value)
+					channels_for_tx[0] = TX_NOT_POSSIBLE;
+				}
+				break;
+			}
+
+			// Always-max (DCB): TX in all the free channels contiguous to the primary channel
+			// TODO: (skectch) check if it is valid!
+			case CB_ALWAYS_MAX:{
+				for(int c = left_free_ch; c <= right_free_ch; ++c){
+					channels_for_tx[c] = TRUE;
+				}
+				break;
+			}
+
+			// Always-map log2: TX in the larger channel range allowed by the log2 mapping
+			// TODO: (skectch) check if it is valid!
+			case CB_ALWAYS_MAX_LOG2:{
+
+				int ch_range_ix (GetNumberOfSpecificElementInArray(1, possible_channel_ranges_ixs, 4));
+
+				switch(ch_range_ix){
+
+					case 1:{
+						channels_for_tx[primary_channel] = TRUE;
+						break;
+					}
+
+					case 2:{
+						channels_for_tx[primary_channel] = TRUE;
+						if(primary_channel % 2 == 1){	// If primary is odd
+							channels_for_tx[primary_channel - 1] = TRUE;
+						} else{
+							channels_for_tx[primary_channel + 1] = TRUE;
+						}
+						break;
+					}
+
+					case 3:{
+						// Check primary and 3 secondaries
+						if(primary_channel > 3){	// primary in channel range 4-7
+							channels_for_tx[4] = TRUE;
+							channels_for_tx[5] = TRUE;
+							channels_for_tx[6] = TRUE;
+							channels_for_tx[7] = TRUE;
+						} else { // primary in channel range 0-3
+							channels_for_tx[0] = TRUE;
+							channels_for_tx[1] = TRUE;
+							channels_for_tx[2] = TRUE;
+							channels_for_tx[3] = TRUE;
+						}
+						break;
+					}
+
+					case 4:{
+						for(int c = 0; c < 8; ++c){
+							channels_for_tx[c] = TRUE;
+						}
+						break;
+					}
+
+					default:{
+						break;
+					}
+
+				}
+
+
+				break;
+
+			}
+
+			// Always-map (DCB) log2 with optimal MCS: picks the channel range + MCS providing max throughput
+			case CB_ALWAYS_MAX_LOG2_MCS:{
+
+				int num_channels = 0;
+				int modulation = 0;
+				int modulation_num_channels_ix = 0;
+				double max_throughput = 0;
+				double aux_throughput = 0;
+
+				while(num_free_ch > 0){
+
+					// If num_free_ch is power of 2
+					if(fmod(log10(num_free_ch)/log10(2), 1) == 0){
+
+						log2_modulus = primary_channel % num_free_ch;
+						left_tx_ch = primary_channel - log2_modulus;
+						right_tx_ch = primary_channel + num_free_ch - log2_modulus - 1;
+						num_channels = right_tx_ch - left_tx_ch + 1;
+						modulation_num_channels_ix = (int) log2(num_channels);
+
+						// Check if tx channels are inside the free ones
+						if((left_tx_ch >= min_channel_allowed) && (right_tx_ch <= max_channel_allowed)){
+
+							// Security check for ensuring picked range is free
+							int range_is_free = TRUE;
+							for(int c = left_tx_ch; c <= right_tx_ch; ++c){
+								if(!channels_free[c]){
+									range_is_free = FALSE;
+									break;
+								}
+							}
+
+							if (range_is_free){
+
+								/* MCS optimization */
+								modulation = mcs_per_node[ix_mcs_per_node][modulation_num_channels_ix];
+								aux_throughput = Mcs_array::mcs_array[modulation_num_channels_ix][modulation-1];
+
+								if(aux_throughput > max_throughput){
+									// TX channels found!
+									for(int c = left_tx_ch; c <= right_tx_ch; ++c){
+										channels_for_tx[c] = TRUE;
+									}
+								}
+							}
+						}
+						--num_free_ch;
+					} else {
+						--num_free_ch;
+					}
+				}
+
+				break;
+				}
+
+			// Log2 probabilistic uniform: pick with same probabilty any available channel range
+			case CB_PROB_UNIFORM_LOG2:{
+
+				int ch_range_ix = GetNumberOfSpecificElementInArray(1, possible_channel_ranges_ixs, 4);
+
+				int random_value = 1 + rand() % (ch_range_ix);	// 1 to ch_range_ix
+
+				switch(ch_range_ix){
+
+					case 1:{
+						channels_for_tx[primary_channel] = TRUE;
+						break;
+					}
+
+					case 2:{
+
+						channels_for_tx[primary_channel] = TRUE;
+
+						if(random_value > 1){
+							if(primary_channel % 2 == 1){	// If primary is odd
+								channels_for_tx[primary_channel - 1] = TRUE;
+							} else{
+								channels_for_tx[primary_channel + 1] = TRUE;
+							}
+						}
+						break;
+					}
+
+					case 3:{
+
+						channels_for_tx[primary_channel] = TRUE;
+
+						if(random_value == 2){
+							if(primary_channel % 2 == 1){	// If primary is odd
+								channels_for_tx[primary_channel - 1] = TRUE;
+							} else{
+								channels_for_tx[primary_channel + 1] = TRUE;
+							}
+						} else if( random_value == 3){
+							// Check primary and 3 secondaries
+							if(primary_channel > 3){	// primary in channel range 4-7
+
+								channels_for_tx[4] = TRUE;
+								channels_for_tx[5] = TRUE;
+								channels_for_tx[6] = TRUE;
+								channels_for_tx[7] = TRUE;
+
+							} else { // primary in channel range 0-3
+
+								channels_for_tx[0] = TRUE;
+								channels_for_tx[1] = TRUE;
+								channels_for_tx[2] = TRUE;
+								channels_for_tx[3] = TRUE;
+							}
+						}
+
+						break;
+					}
+
+					case 4:{
+
+						channels_for_tx[primary_channel] = TRUE;
+
+						if(random_value == 2){
+							if(primary_channel % 2 == 1){	// If primary is odd
+								channels_for_tx[primary_channel - 1] = TRUE;
+							} else{
+								channels_for_tx[primary_channel + 1] = TRUE;
+							}
+						} else if( random_value == 3){
+							// Check primary and 3 secondaries
+							if(primary_channel > 3){	// primary in channel range 4-7
+
+								channels_for_tx[4] = TRUE;
+								channels_for_tx[5] = TRUE;
+								channels_for_tx[6] = TRUE;
+								channels_for_tx[7] = TRUE;
+
+							} else { // primary in channel range 0-3
+
+								channels_for_tx[0] = TRUE;
+								channels_for_tx[1] = TRUE;
+								channels_for_tx[2] = TRUE;
+								channels_for_tx[3] = TRUE;
+							}
+						} else if(random_value == 4){
+							for(int c = 0; c < 8; ++c ){
+								channels_for_tx[c] = TRUE;
+							}
+						}
+						break;
+					}
+
+					default:{
+						break;
+					}
+
+				}
+
+
+				break;
+
+
+				break;
+			}
+
+			default:{
+				printf("channel_bonding_model %d is NOT VALID!\n", channel_bonding_model);
+				exit(EXIT_FAILURE);
+				break;
+			}
+		}
+	} else {  // No channel is free
+
+	channels_for_tx[0] = TX_NOT_POSSIBLE;
+
+	}
+
+}
+
+
+int main(){
+
+	int systems[NUM_OPTIONS_CHANNEL_LENGTH] = {1, 2, 4, 8};
+	int mcs_row[NUM_OPTIONS_CHANNEL_LENGTH];
+	int *mcs_per_node[1] = {mcs_row};
+	long num_cases (0);
+
+	for(int s = 0; s < NUM_OPTIONS_CHANNEL_LENGTH; ++s){
+		int num_channels (systems[s]);
+		for(int min_ch = 0; min_ch < num_channels; ++min_ch)
+		for(int max_ch = min_ch; max_ch < num_channels; ++max_ch)
+		for(int primary = min_ch; primary <= max_ch; ++primary)
+		for(int free_mask = 0; free_mask < (1 << num_channels); ++free_mask)
+		for(int policy = CB_ONLY_PRIMARY; policy <= CB_PROB_UNIFORM_LOG2; ++policy)
+		for(int mcs_table = 0; mcs_table < 3; ++mcs_table){
+
+			int channels_free[8];
+			for(int c = 0; c < num_channels; ++c) channels_free[c] = (free_mask >> c) & 1;
+			for(int ix = 0; ix < NUM_OPTIONS_CHANNEL_LENGTH; ++ix){
+				mcs_row[ix] = (mcs_table == 0) ? 1 + ix : ((mcs_table == 1) ? NUM_MODULATIONS - 3 * ix : 5);
+			}
+
+			int expected[8], obtained[8];
+			for(int c = 0; c < 8; ++c) expected[c] = obtained[c] = -7;	// Untouched entries must stay untouched
+
+			// Previous implementation: rand() % 0 with CB_PROB_UNIFORM_LOG2 and no free log2 range
+			unsigned int allowed_mask (ChannelRangeMask(min_ch, max_ch));
+			unsigned int quad_mask ((primary > 3) ? 0xF0 : 0x0F);
+			int num_possible_ranges (((free_mask >> primary) & 1)
+				+ (num_channels > 1 && ((free_mask >> (primary ^ 1)) & 1))
+				+ (num_channels > 3 && (free_mask & quad_mask) == quad_mask)
+				+ (num_channels > 7 && (free_mask & 0xFF) == 0xFF));
+			if(policy == CB_PROB_UNIFORM_LOG2 && (free_mask & allowed_mask) && num_possible_ranges == 0){
+				GetTxChannelsByChannelBonding(obtained, policy, channels_free, min_ch, max_ch, primary,
+					mcs_per_node, 0, num_channels);
+				CHECK(obtained[0] == TX_NOT_POSSIBLE);
+				continue;
+			}
+
+			srand(num_cases);
+			ReferenceGetTxChannelsByChannelBonding(expected, policy, channels_free, min_ch, max_ch, primary,
+				mcs_per_node, 0, num_channels);
+			int expected_random (rand());
+			srand(num_cases);
+			GetTxChannelsByChannelBonding(obtained, policy, channels_free, min_ch, max_ch, primary,
+				mcs_per_node, 0, num_channels);
+			int obtained_random (rand());
+			++num_cases;
+
+			if(memcmp(expected, obtained, sizeof(expected)) != 0 || expected_random != obtained_random){
+				printf("Mismatch: %d channels, allowed %d-%d, primary %d, free 0x%x, policy %d, MCS table %d\n",
+					num_channels, min_ch, max_ch, primary, free_mask, policy, mcs_table);
+				CHECK(memcmp(expected, obtained, sizeof(expected)) == 0 && expected_random == obtained_random);
+			}
+		}
+	}
+
+	printf("%ld cases compared\n", num_cases);
+	return TestResult("test_channel_bonding");
+}
@@ -0,0 +1,151 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file tests the delay histograms (structures/delay_histogram.h): samples split across several
+ *   histograms and then merged must give the same histogram as adding them to a single one, and the
+ *   percentiles must match the exact quantiles of the samples (exactly below 2^SUB_BUCKET_BITS units,
+ *   within the bucket relative error above).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include "../structures/delay_histogram.h"
+#include "check.h"
+
+#define TEST_NUM_SAMPLES	100000
+#define TEST_NUM_SPLITS		7
+
+const double test_fractions[] = {0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.95, 0.99, 0.999, 0.9999, 1.0};
+
+/*
+ * ExactQuantile(): quantile of sorted samples with the rank definition of DelayHistogram::Percentile()
+ */
+double ExactQuantile(const std::vector<double> &sorted_samples, double fraction){
+	size_t rank ((size_t) ceil(fraction * sorted_samples.size()));
+	if(rank < 1) rank = 1;
+	return sorted_samples[rank - 1];
+}
+
+/*
+ * SplitAndMerge(): adds the samples to TEST_NUM_SPLITS histograms (randomly) and merges them
+ * Output:
+ * - merged histogram (checked against the histogram of all the samples)
+ */
+DelayHistogram *SplitAndMerge(const std::vector<double> &samples){
+	DelayHistogram *parts (new DelayHistogram[TEST_NUM_SPLITS]);
+	DelayHistogram *single (new DelayHistogram());
+	for(size_t i = 0; i < samples.size(); ++i){
+		parts[rand() % TEST_NUM_SPLITS].Add(samples[i]);
+		single->Add(samples[i]);
+	}
+	DelayHistogram *merged (new DelayHistogram());
+	for(int p = 0; p < TEST_NUM_SPLITS; ++p) merged->Merge(parts[p]);
+	CHECK(merged->total_count == samples.size());
+	CHECK(merged->max_delay == single->max_delay);
+	CHECK(memcmp(merged->counts, single->counts, sizeof(merged->counts)) == 0);
+	delete[] parts;
+	delete single;
+	return merged;
+}
+
+int main(){
+
+	srand(1);
+
+	// Empty histogram
+	DelayHistogram *empty (new DelayHistogram());
+	CHECK(empty->Percentile(0.5) == 0);
+	delete empty;
+
+	// Bucket values increase with the bucket index
+	for(int b = 1; b < DELAY_HISTOGRAM_NUM_BUCKETS; ++b) {
+		CHECK(DelayHistogram::BucketValue(b) > DelayHistogram::BucketValue(b - 1));
+	}
+
+	// Delays below 2^SUB_BUCKET_BITS units: exact quantiles
+	std::vector<double> samples;
+	for(int i = 0; i < TEST_NUM_SAMPLES; ++i){
+		samples.push_back((rand() % (1 << DELAY_HISTOGRAM_SUB_BUCKET_BITS)) * DELAY_HISTOGRAM_UNIT);
+	}
+	DelayHistogram *merged (SplitAndMerge(samples));
+	std::sort(samples.begin(), samples.end());
+	for(size_t f = 0; f < sizeof(test_fractions) / sizeof(test_fractions[0]); ++f){
+		CHECK(merged->Percentile(test_fractions[f]) == ExactQuantile(samples, test_fractions[f]));
+	}
+	delete merged;
+
+	// Every value once: each rank falls on a bucket boundary
+	samples.clear();
+	for(int v = (1 << DELAY_HISTOGRAM_SUB_BUCKET_BITS) - 1; v >= 0; --v) samples.push_back(v * DELAY_HISTOGRAM_UNIT);
+	merged = SplitAndMerge(samples);
+	std::sort(samples.begin(), samples.end());
+	for(size_t rank = 1; rank <= samples.size(); ++rank){
+		double fraction ((double) rank / samples.size());
+		CHECK(merged->Percentile(fraction) == ExactQuantile(samples, fraction));
+	}
+	delete merged;
+
+	// Exponential delays (mean 2 ms): exact maximum, quantiles within the bucket relative error
+	// (half a bucket of 2^-(SUB_BUCKET_BITS-1) of the value, plus the rounding to units)
+	samples.clear();
+	for(int i = 0; i < TEST_NUM_SAMPLES; ++i) samples.push_back(-log((rand() + 1.0) / (RAND_MAX + 1.0)) * 0.002);
+	merged = SplitAndMerge(samples);
+	std::sort(samples.begin(), samples.end());
+	CHECK(merged->Percentile(1.0) == samples.back());
+	for(size_t f = 0; f < sizeof(test_fractions) / sizeof(test_fractions[0]); ++f){
+		double exact (ExactQuantile(samples, test_fractions[f]));
+		double relative_error (1.0 / (1 << DELAY_HISTOGRAM_SUB_BUCKET_BITS));
+		CHECK(fabs(merged->Percentile(test_fractions[f]) - exact) <= exact * relative_error + DELAY_HISTOGRAM_UNIT);
+	}
+	delete merged;
+
+	return TestResult("test_delay_histogram");
+}
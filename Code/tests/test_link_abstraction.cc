@@ -0,0 +1,95 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file tests the SINR-to-PER tables of the link abstraction (methods/link_abstraction_methods.h):
+ *   PER must not decrease with the MCS index nor increase with the SINR, and MCSs sharing a modulation
+ *   must be told apart by their coding rate.
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "../methods/link_abstraction_methods.h"
+#include "check.h"
+
+int main(){
+
+	LinkAbstraction tables;
+	tables.Generate(12000);
+
+	for(int ix_ch = 0; ix_ch < NUM_OPTIONS_CHANNEL_LENGTH; ++ix_ch) {
+		for(int m = MODULATION_BPSK_1_2; m <= NUM_MODULATIONS; ++m) {
+			const double *table (&tables.per[tables.TableIndex(ix_ch, m)]);
+			for(int i = 0; i < tables.num_points; ++i) {
+				CHECK(table[i] >= 0 && table[i] <= 1);
+				// Monotonic in the SINR
+				if(i > 0) CHECK(table[i] <= table[i-1] + 1e-12);
+				// Monotonic across MCS indices
+				if(m < NUM_MODULATIONS) {
+					CHECK(table[i] <= tables.per[tables.TableIndex(ix_ch, m + 1) + i] + 1e-12);
+				}
+			}
+		}
+	}
+
+	// MCSs with the same modulation and different coding rates get different tables
+	for(int m = MODULATION_BPSK_1_2; m < NUM_MODULATIONS; ++m) {
+		if(Mcs_array::modulation_bits[m-1] != Mcs_array::modulation_bits[m]) continue;
+		int different (0);
+		for(int i = 0; i < tables.num_points; ++i) {
+			if(fabs(tables.per[tables.TableIndex(0, m) + i] - tables.per[tables.TableIndex(0, m + 1) + i]) > 1e-6) {
+				different = 1;
+			}
+		}
+		CHECK(different);
+	}
+
+	// Interpolated lookups stay between the points (and saturate outside the grid)
+	CHECK(tables.GetPer(MODULATION_BPSK_1_2, 0, 0) == tables.per[tables.TableIndex(0, MODULATION_BPSK_1_2)]);
+	CHECK(tables.GetPer(NUM_MODULATIONS, 0, pow(10, 10)) < 1e-9);
+
+	return TestResult("test_link_abstraction");
+}
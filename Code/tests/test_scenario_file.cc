@@ -0,0 +1,175 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file tests the compiled scenarios (structures/scenario_file.h): a compiled scenario must be
+ *   mapped back byte-identical to the records and arrays it was written from, rejected if it was
+ *   compiled from other inputs, and the writes to its private mapping must not reach the file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "../structures/scenario_file.h"
+#include "check.h"
+
+#define TEST_SYSTEM_FILE	"../input/input_example/input_system_conf.csv"
+#define TEST_NODES_FILE		"../input/input_example/input_nodes_spatial_reuse.csv"
+
+/*
+ * ReadFile(): contents of a file (empty if it cannot be read)
+ */
+std::string ReadFile(const std::string &filename){
+	std::string content;
+	FILE *file = fopen(filename.c_str(), "rb");
+	if(file == NULL) return content;
+	char buffer[4096];
+	size_t bytes_read;
+	while((bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0) content.append(buffer, bytes_read);
+	fclose(file);
+	return content;
+}
+
+int main(){
+
+	// Records read from the input files
+	CsvFile system_file;
+	system_file.Load(TEST_SYSTEM_FILE);
+	SystemRecord system_record;
+	for(int r = 0; r < system_file.NumRows(); ++r) system_record.ReadFromCsv(system_file, r);
+	CsvFile nodes_file;
+	nodes_file.Load(TEST_NODES_FILE);
+	int total_nodes_number (nodes_file.NumRows());
+	std::vector<NodeRecord> node_records (total_nodes_number);
+	for(int r = 0; r < total_nodes_number; ++r) node_records[r].ReadFromCsv(nodes_file, r);
+	CHECK(total_nodes_number > 2);
+
+	// Path gain arrays (arbitrary values, distinct per node)
+	int total_wlans_number (0);
+	for(int n = 0; n < total_nodes_number; ++n) if(node_records[n].node_type == NODE_TYPE_AP) ++total_wlans_number;
+	std::vector<double*> distances (total_nodes_number);
+	std::vector<double*> received_power (total_nodes_number);
+	std::vector<double*> max_received_power_per_wlan (total_nodes_number);
+	for(int i = 0; i < total_nodes_number; ++i){
+		distances[i] = new double[total_nodes_number];
+		received_power[i] = new double[total_nodes_number];
+		max_received_power_per_wlan[i] = NULL;
+		for(int j = 0; j < total_nodes_number; ++j){
+			distances[i][j] = hypot(node_records[i].x - node_records[j].x, node_records[i].y - node_records[j].y);
+			received_power[i][j] = -40.0 - i * 0.5 - j * 0.25;
+		}
+		if(node_records[i].node_type == NODE_TYPE_AP){
+			max_received_power_per_wlan[i] = new double[total_wlans_number];
+			for(int w = 0; w < total_wlans_number; ++w) max_received_power_per_wlan[i][w] = -60.0 - i - w * 0.125;
+		}
+	}
+
+	char directory[] = "/tmp/komondor_test_scenario_XXXXXX";
+	CHECK(mkdtemp(directory) != NULL);
+	unsigned long long input_hash (ScenarioFile::InputHash(TEST_SYSTEM_FILE, TEST_NODES_FILE, NODE_ORDER_FILE));
+	CHECK(input_hash != ScenarioFile::InputHash(TEST_SYSTEM_FILE, TEST_NODES_FILE, NODE_ORDER_HILBERT));
+	std::string path (ScenarioFile::CachePath(directory, input_hash));
+	ScenarioFile::Write(path.c_str(), input_hash, system_record, node_records, total_wlans_number,
+		distances.data(), received_power.data(), max_received_power_per_wlan.data());
+	std::string written (ReadFile(path));
+
+	// Byte-identical remap
+	ScenarioFile scenario;
+	CHECK(scenario.Load(path.c_str(), input_hash));
+	if(scenario.data != NULL){
+		CHECK(scenario.header->total_nodes_number == total_nodes_number);
+		CHECK(scenario.header->total_wlans_number == total_wlans_number);
+		CHECK(memcmp(scenario.system_record, &system_record, sizeof(SystemRecord)) == 0);
+		CHECK(memcmp(scenario.node_records, node_records.data(), sizeof(NodeRecord) * total_nodes_number) == 0);
+		int ap_ix (0);
+		for(int i = 0; i < total_nodes_number; ++i){
+			CHECK(memcmp(scenario.distances + i * total_nodes_number, distances[i],
+				sizeof(double) * total_nodes_number) == 0);
+			CHECK(memcmp(scenario.received_power + i * total_nodes_number, received_power[i],
+				sizeof(double) * total_nodes_number) == 0);
+			if(max_received_power_per_wlan[i] == NULL) continue;
+			CHECK(memcmp(scenario.max_received_power_per_wlan + ap_ix * total_wlans_number,
+				max_received_power_per_wlan[i], sizeof(double) * total_wlans_number) == 0);
+			++ap_ix;
+		}
+
+		// Writes to the private mapping do not reach the file
+		scenario.received_power[1] = 42;
+		scenario.distances[0] = 42;
+		scenario.Close();
+	}
+	CHECK(ReadFile(path) == written);
+	CHECK(scenario.Load(path.c_str(), input_hash));
+	if(scenario.data != NULL){
+		CHECK(scenario.received_power[1] == received_power[0][1]);
+		CHECK(scenario.distances[0] == distances[0][0]);
+		scenario.Close();
+	}
+
+	// Scenarios compiled from other inputs (or truncated) are rejected
+	ScenarioFile other;
+	CHECK(!other.Load(path.c_str(), input_hash + 1));
+	CHECK(other.data == NULL);
+	std::string truncated_path (std::string(directory) + "/truncated" + SCENARIO_FILE_EXTENSION);
+	FILE *truncated_file = fopen(truncated_path.c_str(), "wb");
+	fwrite(written.data(), 1, written.size() - sizeof(double), truncated_file);
+	fclose(truncated_file);
+	CHECK(!other.Load(truncated_path.c_str(), input_hash));
+
+	remove(truncated_path.c_str());
+	remove(path.c_str());
+	rmdir(directory);
+	for(int i = 0; i < total_nodes_number; ++i){
+		delete[] distances[i];
+		delete[] received_power[i];
+		delete[] max_received_power_per_wlan[i];
+	}
+
+	return TestResult("test_scenario_file");
+}
@@ -0,0 +1,153 @@
+/* Komondor IEEE 802.11ax Simulator
+ *
+ * Copyright (c) 2017, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ * -----------------------------------------------------------------
+ * File description: this is the main Komondor file
+ *
+ * - This file checks the round trip of the binary node traces (structures/trace.h): node log lines
+ *   written through their LOGS call sites (fixed-schema TRACE_RECORD_LOG records and generic
+ *   TRACE_RECORD_EVENT records) and LogPrintf() lines must be decoded by DecodeTraceFile() (the
+ *   decoder of 'trace_decoder') into exactly the text that printf writes, renumbered node ids included.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "../list_of_macros.h"
+#include "../structures/logger.h"
+#include "check.h"
+
+// Same call site handling as the LOGS macro of main/node.h (without the log filter)
+#define LOG_SITE_FORMAT(format,...)    format
+#define TEST_LOGS(logger,...) { \
+	static const LogSite log_site(LOG_SITE_FORMAT(__VA_ARGS__, 0)); \
+	(void) sizeof(LogFormatCheck(__VA_ARGS__)); \
+	LogPrintf(logger, log_site, ##__VA_ARGS__);}
+
+std::string expected_text;	// Text that the decoder must regenerate
+
+/*
+ * Expect(): appends the printf text of a line to the expected text
+ */
+void Expect(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+void Expect(const char *format, ...){
+	char line[CHAR_BUFFER_SIZE];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(line, sizeof(line), format, args);
+	va_end(args);
+	expected_text += line;
+}
+
+int main(){
+
+	// Nodes 0-3 were renumbered: their original ids are written
+	std::vector<int> original_ids;
+	for(int n = 0; n < 4; ++n) original_ids.push_back(10 + 3 * n);
+	original_node_ids = original_ids;
+
+	TraceWriter trace;
+	trace.Open(0);
+	Logger logger;
+	logger.trace = &trace;
+
+	std::string dynamic_string("dynamic string");
+
+	// First line of a site with the fixed header: site definition, then TRACE_RECORD_LOG
+	TEST_LOGS(logger, "%.15f;N%d;S%d;%s;%s Start of the trace\n", 0.000012345678901, 1, 0, LOG_D07, LOG_LVL3);
+	Expect("%.15f;N%d;S%d;%s;%s Start of the trace\n", 0.000012345678901, 13, 0, LOG_D07, LOG_LVL3);
+	size_t definition_size = 1 + 4 + (4 + strlen("%.15f;N%d;S%d;%s;%s Start of the trace\n"))
+		+ (4 + strlen(LOG_D07)) + (4 + strlen(LOG_LVL3));
+	CHECK(trace.buffer[TRACE_MAGIC_SIZE] == TRACE_RECORD_FORMAT);
+	CHECK(trace.buffer[TRACE_MAGIC_SIZE + definition_size] == TRACE_RECORD_LOG);
+	uint16_t code_id;
+	memcpy(&code_id, &trace.buffer[TRACE_MAGIC_SIZE + definition_size + 1], sizeof(code_id));
+	CHECK(code_id == 307);
+	// Fixed header: code id, site id, timestamp, node id and state (no arguments left)
+	CHECK(trace.buffer.size() == TRACE_MAGIC_SIZE + definition_size + 1 + 2 + 4 + 8 + 4 + 4);
+
+	for(int i = 0; i < 50; ++i){
+		TEST_LOGS(logger, "%.15f;N%d;S%d;%s;%s From N%d: %u %lld %*d [%s] [%s] %.2e %p %%\n",
+			i * 0.001 + 1e-9, i % 4, i % 7, LOG_E03, LOG_LVL4, (i + 1) % 4, 7u * i, -(1ll << 40) * i,
+			6, -i, dynamic_string.c_str(), LOG_F00, 1.5 * i, (void *) 0x1234);
+		Expect("%.15f;N%d;S%d;%s;%s From N%d: %u %lld %*d [%s] [%s] %.2e %p %%\n",
+			i * 0.001 + 1e-9, 10 + 3 * (i % 4), i % 7, LOG_E03, LOG_LVL4, 10 + 3 * ((i + 1) % 4), 7u * i,
+			-(1ll << 40) * i, 6, -i, dynamic_string.c_str(), LOG_F00, 1.5 * i, (void *) 0x1234);
+
+		// Lines without the fixed header are written as generic events
+		TEST_LOGS(logger, "%d ", i);
+		Expect("%d ", i);
+		TEST_LOGS(logger, "%.18f;N%d;S%d;%s;%s Start()\n", i * 0.5, 2, -1, LOG_B00, LOG_LVL1);
+		Expect("%.18f;N%d;S%d;%s;%s Start()\n", i * 0.5, 16, -1, LOG_B00, LOG_LVL1);
+		TEST_LOGS(logger, "\n");
+		Expect("\n");
+
+		// LogPrintf() calls outside the LOGS macro
+		LogPrintf(logger, "%s - ap_id: %d (%s)\n", LOG_LVL2, OriginalNodeId(i % 4), dynamic_string.c_str());
+		Expect("%s - ap_id: %d (%s)\n", LOG_LVL2, 10 + 3 * (i % 4), dynamic_string.c_str());
+	}
+
+	// Decode the trace as 'trace_decoder' does
+	FILE *trace_file = tmpfile();
+	FILE *text_file = tmpfile();
+	fwrite(&trace.buffer[0], 1, trace.buffer.size(), trace_file);
+	rewind(trace_file);
+	DecodeTraceFile(trace_file, "test trace", text_file);
+	std::string decoded_text(ftell(text_file), '\0');
+	rewind(text_file);
+	CHECK(fread(&decoded_text[0], 1, decoded_text.size(), text_file) == decoded_text.size());
+	fclose(trace_file);
+	fclose(text_file);
+
+	CHECK(decoded_text == expected_text);
+	if(decoded_text != expected_text){
+		printf("Expected:\n%s\nDecoded:\n%s\n", expected_text.c_str(), decoded_text.c_str());
+	}
+
+	return TestResult("test_trace");
+}